@@ -0,0 +1,229 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   BenchmarkRunner.cpp
+//! \author Alex Robinson
+//! \brief  The benchmark runner class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <fstream>
+#include <cstdlib>
+
+// Boost Includes
+#include <boost/timer/timer.hpp>
+
+// GDev Includes
+#include "BenchmarkRunner.hpp"
+#include "ExceptionTestMacros.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const unsigned long BenchmarkRunner::s_max_iterations = 1ul << 30;
+
+// Constructor
+/*! \details Only benchmarks whose names contain the filter will be run (an
+ * empty filter selects all benchmarks).
+ */
+BenchmarkRunner::BenchmarkRunner( const double min_sample_time,
+				  const unsigned number_of_samples,
+				  const std::string& filter )
+  : d_min_sample_time( min_sample_time ),
+    d_number_of_samples( number_of_samples ),
+    d_filter( filter ),
+    d_results()
+{
+  // Make sure the sample time is valid
+  testPrecondition( min_sample_time > 0.0 );
+  // Make sure the number of samples is valid
+  testPrecondition( number_of_samples > 0u );
+}
+
+// Check if a benchmark will be run (its name matches the filter)
+bool BenchmarkRunner::isSelected( const std::string& name ) const
+{
+  return name.find( d_filter ) != std::string::npos;
+}
+
+// Run a benchmark
+/*! \details The result will be printed to std::cerr as soon as the
+ * benchmark has finished.
+ */
+void BenchmarkRunner::run( const std::string& name,
+			   const std::function<void()>& operation )
+{
+  if( !this->isSelected( name ) )
+    return;
+
+  // Calibrate the number of iterations in a sample
+  unsigned long iterations = 1ul;
+
+  while( iterations < s_max_iterations &&
+	 BenchmarkRunner::timeSample( operation, iterations ) <
+	 d_min_sample_time )
+    iterations *= 2;
+
+  // Time the samples
+  std::vector<double> sample_times( d_number_of_samples );
+
+  for( unsigned i = 0; i < d_number_of_samples; ++i )
+  {
+    sample_times[i] =
+      BenchmarkRunner::timeSample( operation, iterations )*1e9/iterations;
+  }
+
+  std::sort( sample_times.begin(), sample_times.end() );
+
+  Result result;
+  result.name = name;
+  result.iterations = iterations;
+  result.samples = d_number_of_samples;
+  result.ns_per_op = sample_times[d_number_of_samples/2];
+  result.min_ns_per_op = sample_times.front();
+  result.max_ns_per_op = sample_times.back();
+
+  d_results.push_back( result );
+
+  std::cerr << name << ": " << result.ns_per_op << " ns/op ("
+	    << iterations << " iterations x " << d_number_of_samples
+	    << " samples)" << std::endl;
+}
+
+// Get the results
+const std::vector<BenchmarkRunner::Result>&
+BenchmarkRunner::getResults() const
+{
+  return d_results;
+}
+
+// Write the results as JSON
+/*! \details Each result is written on a single line (see readBaseline).
+ */
+void BenchmarkRunner::writeJSON( std::ostream& os ) const
+{
+  os << "{\n  \"benchmarks\": [\n";
+
+  for( unsigned i = 0; i < d_results.size(); ++i )
+  {
+    os << "    {\"name\": \"" << d_results[i].name << "\", "
+       << "\"iterations\": " << d_results[i].iterations << ", "
+       << "\"samples\": " << d_results[i].samples << ", "
+       << "\"ns_per_op\": " << d_results[i].ns_per_op << ", "
+       << "\"min_ns_per_op\": " << d_results[i].min_ns_per_op << ", "
+       << "\"max_ns_per_op\": " << d_results[i].max_ns_per_op << "}";
+
+    if( i+1 < d_results.size() )
+      os << ",";
+
+    os << "\n";
+  }
+
+  os << "  ]\n}\n";
+}
+
+// Read the results written by a previous run (name -> ns per op)
+/*! \details Only files written by writeJSON can be read.
+ */
+std::map<std::string,double> BenchmarkRunner::readBaseline(
+					      const std::string& baseline_name )
+{
+  std::ifstream baseline_file( baseline_name.c_str() );
+
+  TEST_FOR_EXCEPTION( !baseline_file.good(),
+		      ExceptionType,
+		      "Error: The baseline file " << baseline_name <<
+		      " could not be opened!" );
+
+  std::map<std::string,double> baseline;
+
+  const std::string name_tag( "\"name\": \"" );
+  const std::string time_tag( "\"ns_per_op\": " );
+
+  std::string line;
+
+  while( std::getline( baseline_file, line ) )
+  {
+    size_t name_start = line.find( name_tag );
+    size_t time_start = line.find( time_tag );
+
+    if( name_start == std::string::npos || time_start == std::string::npos )
+      continue;
+
+    name_start += name_tag.size();
+
+    size_t name_end = line.find( '"', name_start );
+
+    TEST_FOR_EXCEPTION( name_end == std::string::npos,
+			ExceptionType,
+			"Error: The baseline file " << baseline_name <<
+			" has a malformed line (" << line << ")!" );
+
+    baseline[line.substr( name_start, name_end-name_start )] =
+      std::atof( line.c_str() + time_start + time_tag.size() );
+  }
+
+  return baseline;
+}
+
+// Compare the results to a baseline (returns the number of regressions)
+/*! \details A regression occurs when the time per operation exceeds the
+ * baseline time per operation by more than the tolerance (a fraction of the
+ * baseline time). Results that are not in the baseline are ignored.
+ */
+unsigned BenchmarkRunner::compareToBaseline(
+			       const std::map<std::string,double>& baseline,
+			       const double tolerance,
+			       std::ostream& os ) const
+{
+  // Make sure the tolerance is valid
+  testPrecondition( tolerance >= 0.0 );
+
+  unsigned regressions = 0;
+
+  for( unsigned i = 0; i < d_results.size(); ++i )
+  {
+    std::map<std::string,double>::const_iterator baseline_result =
+      baseline.find( d_results[i].name );
+
+    if( baseline_result == baseline.end() || baseline_result->second <= 0.0 )
+      continue;
+
+    double ratio = d_results[i].ns_per_op/baseline_result->second;
+
+    os << d_results[i].name << ": " << ratio << "x baseline";
+
+    if( ratio > 1.0 + tolerance )
+    {
+      os << " (REGRESSION)";
+
+      ++regressions;
+    }
+
+    os << std::endl;
+  }
+
+  return regressions;
+}
+
+// Time a sample (seconds)
+double BenchmarkRunner::timeSample( const std::function<void()>& operation,
+				    const unsigned long iterations )
+{
+  boost::timer::cpu_timer timer;
+
+  for( unsigned long i = 0; i < iterations; ++i )
+    operation();
+
+  timer.stop();
+
+  return timer.elapsed().wall*1e-9;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end BenchmarkRunner.cpp
+//---------------------------------------------------------------------------//
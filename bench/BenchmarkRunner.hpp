@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   BenchmarkRunner.hpp
+//! \author Alex Robinson
+//! \brief  The benchmark runner class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_BENCHMARK_RUNNER_HPP
+#define GDEV_BENCHMARK_RUNNER_HPP
+
+// Std Lib Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <functional>
+#include <stdexcept>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+namespace GDev{
+
+//! The benchmark exception class
+class BenchmarkException : public std::runtime_error
+{
+public:
+  BenchmarkException( const std::string& message )
+    : std::runtime_error( message )
+  { /* ... */ }
+
+  ~BenchmarkException() throw()
+  { /* ... */ }
+};
+
+/*! The benchmark runner class
+ * \details Each benchmark operation is first calibrated: the number of
+ * iterations in a sample is doubled until a sample takes at least the
+ * minimum sample time. The desired number of samples is then timed (wall
+ * clock) and the median, minimum and maximum time per operation are
+ * recorded. The results can be written as JSON and compared against the
+ * results of a previous run (the baseline).
+ */
+class BenchmarkRunner : private boost::noncopyable
+{
+
+public:
+
+  //! The exception type
+  typedef BenchmarkException ExceptionType;
+
+  //! The benchmark result
+  struct Result
+  {
+    //! The benchmark name
+    std::string name;
+
+    //! The number of iterations in each sample
+    unsigned long iterations;
+
+    //! The number of samples
+    unsigned samples;
+
+    //! The median time per operation (ns)
+    double ns_per_op;
+
+    //! The minimum time per operation (ns)
+    double min_ns_per_op;
+
+    //! The maximum time per operation (ns)
+    double max_ns_per_op;
+  };
+
+  //! Constructor
+  BenchmarkRunner( const double min_sample_time = 0.01,
+		   const unsigned number_of_samples = 5u,
+		   const std::string& filter = "" );
+
+  //! Destructor
+  ~BenchmarkRunner()
+  { /* ... */ }
+
+  //! Check if a benchmark will be run (its name matches the filter)
+  bool isSelected( const std::string& name ) const;
+
+  //! Run a benchmark
+  void run( const std::string& name, const std::function<void()>& operation );
+
+  //! Get the results
+  const std::vector<Result>& getResults() const;
+
+  //! Write the results as JSON
+  void writeJSON( std::ostream& os ) const;
+
+  //! Read the results written by a previous run (name -> ns per op)
+  static std::map<std::string,double> readBaseline(
+					     const std::string& baseline_name );
+
+  //! Compare the results to a baseline (returns the number of regressions)
+  unsigned compareToBaseline( const std::map<std::string,double>& baseline,
+			      const double tolerance,
+			      std::ostream& os ) const;
+
+private:
+
+  // Time a sample (seconds)
+  static double timeSample( const std::function<void()>& operation,
+			    const unsigned long iterations );
+
+  // The maximum number of iterations in a sample
+  static const unsigned long s_max_iterations;
+
+  // The minimum sample time (seconds)
+  double d_min_sample_time;
+
+  // The number of samples
+  unsigned d_number_of_samples;
+
+  // The benchmark name filter
+  std::string d_filter;
+
+  // The results
+  std::vector<Result> d_results;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_BENCHMARK_RUNNER_HPP
+
+//---------------------------------------------------------------------------//
+// end BenchmarkRunner.hpp
+//---------------------------------------------------------------------------//
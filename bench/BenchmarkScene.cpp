@@ -0,0 +1,155 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   BenchmarkScene.cpp
+//! \author Alex Robinson
+//! \brief  The benchmark scene base class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// Boost Includes
+#include <boost/timer/timer.hpp>
+
+// GDev Includes
+#include "BenchmarkScene.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Constructor
+BenchmarkScene::BenchmarkScene( const std::string& name )
+  : d_name( name )
+{ /* ... */ }
+
+// Get the scene name
+const std::string& BenchmarkScene::getName() const
+{
+  return d_name;
+}
+
+// Run the scene
+/*! \details The scene initialization is not timed.
+ */
+BenchmarkScene::Result BenchmarkScene::run(
+				     const std::shared_ptr<Renderer>& renderer,
+				     const unsigned number_of_sprites,
+				     const unsigned number_of_frames )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+  // Make sure the number of frames is valid
+  testPrecondition( number_of_frames > 0u );
+
+  this->initialize( renderer, number_of_sprites );
+
+  renderer->resetStateChangeCounters();
+  renderer->resetDrawCallCounter();
+
+  std::vector<double> frame_times( number_of_frames );
+
+  SDL_Color clear_color = {0xFF,0xFF,0xFF,0xFF};
+
+  boost::timer::cpu_timer scene_timer;
+
+  for( unsigned frame = 0; frame < number_of_frames; ++frame )
+  {
+    boost::timer::cpu_timer frame_timer;
+
+    renderer->setDrawColor( clear_color );
+    renderer->clear();
+
+    this->renderFrame( renderer, frame );
+
+    renderer->present();
+
+    frame_timer.stop();
+
+    frame_times[frame] = frame_timer.elapsed().wall*1e-6;
+  }
+
+  scene_timer.stop();
+
+  Result result;
+  result.name = d_name;
+  result.sprites = number_of_sprites;
+  result.frames = number_of_frames;
+  result.frames_per_second =
+    number_of_frames/(scene_timer.elapsed().wall*1e-9);
+  result.draw_calls_per_frame =
+    (double)renderer->getNumberOfDrawCalls()/number_of_frames;
+  result.state_changes_per_frame =
+    (double)renderer->getNumberOfStateChanges()/number_of_frames;
+  result.skipped_state_changes_per_frame =
+    (double)renderer->getNumberOfSkippedStateChanges()/number_of_frames;
+
+  std::sort( frame_times.begin(), frame_times.end() );
+
+  result.p50_frame_time = BenchmarkScene::getPercentile( frame_times, 0.5 );
+  result.p90_frame_time = BenchmarkScene::getPercentile( frame_times, 0.9 );
+  result.p99_frame_time = BenchmarkScene::getPercentile( frame_times, 0.99 );
+  result.max_frame_time = frame_times.back();
+
+  this->finalize();
+
+  std::cerr << d_name << " (" << number_of_sprites << " sprites): "
+	    << result.frames_per_second << " fps, p50 "
+	    << result.p50_frame_time << " ms, p99 "
+	    << result.p99_frame_time << " ms, "
+	    << result.draw_calls_per_frame << " draw calls/frame" << std::endl;
+
+  return result;
+}
+
+// Write scene results as JSON
+/*! \details Each result is written on a single line.
+ */
+void BenchmarkScene::writeJSON( const std::vector<Result>& results,
+				std::ostream& os )
+{
+  os << "{\n  \"scenes\": [\n";
+
+  for( unsigned i = 0; i < results.size(); ++i )
+  {
+    os << "    {\"name\": \"" << results[i].name << "\", "
+       << "\"sprites\": " << results[i].sprites << ", "
+       << "\"frames\": " << results[i].frames << ", "
+       << "\"fps\": " << results[i].frames_per_second << ", "
+       << "\"p50_ms\": " << results[i].p50_frame_time << ", "
+       << "\"p90_ms\": " << results[i].p90_frame_time << ", "
+       << "\"p99_ms\": " << results[i].p99_frame_time << ", "
+       << "\"max_ms\": " << results[i].max_frame_time << ", "
+       << "\"draw_calls_per_frame\": "
+       << results[i].draw_calls_per_frame << ", "
+       << "\"state_changes_per_frame\": "
+       << results[i].state_changes_per_frame << ", "
+       << "\"skipped_state_changes_per_frame\": "
+       << results[i].skipped_state_changes_per_frame << "}";
+
+    if( i+1 < results.size() )
+      os << ",";
+
+    os << "\n";
+  }
+
+  os << "  ]\n}\n";
+}
+
+// Get a percentile of the sorted frame times
+double BenchmarkScene::getPercentile( const std::vector<double>& frame_times,
+				      const double percentile )
+{
+  unsigned index = (unsigned)(percentile*frame_times.size());
+
+  if( index >= frame_times.size() )
+    index = frame_times.size() - 1;
+
+  return frame_times[index];
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end BenchmarkScene.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,121 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   BenchmarkScene.hpp
+//! \author Alex Robinson
+//! \brief  The benchmark scene base class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_BENCHMARK_SCENE_HPP
+#define GDEV_BENCHMARK_SCENE_HPP
+
+// Std Lib Includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// GDev Includes
+#include "Renderer.hpp"
+
+namespace GDev{
+
+/*! The benchmark scene base class
+ * \details A scene is initialized with a number of sprites and then a fixed
+ * number of frames are rendered. Each frame is cleared, rendered and
+ * presented. The frame times and the renderer call counts are recorded.
+ */
+class BenchmarkScene : private boost::noncopyable
+{
+
+public:
+
+  //! The scene result
+  struct Result
+  {
+    //! The scene name
+    std::string name;
+
+    //! The number of sprites
+    unsigned sprites;
+
+    //! The number of frames
+    unsigned frames;
+
+    //! The frames per second
+    double frames_per_second;
+
+    //! The median frame time (ms)
+    double p50_frame_time;
+
+    //! The 90th percentile frame time (ms)
+    double p90_frame_time;
+
+    //! The 99th percentile frame time (ms)
+    double p99_frame_time;
+
+    //! The maximum frame time (ms)
+    double max_frame_time;
+
+    //! The draw calls per frame
+    double draw_calls_per_frame;
+
+    //! The state changes per frame
+    double state_changes_per_frame;
+
+    //! The skipped state changes per frame
+    double skipped_state_changes_per_frame;
+  };
+
+  //! Constructor
+  BenchmarkScene( const std::string& name );
+
+  //! Destructor
+  virtual ~BenchmarkScene()
+  { /* ... */ }
+
+  //! Get the scene name
+  const std::string& getName() const;
+
+  //! Run the scene
+  Result run( const std::shared_ptr<Renderer>& renderer,
+	      const unsigned number_of_sprites,
+	      const unsigned number_of_frames );
+
+  //! Write scene results as JSON
+  static void writeJSON( const std::vector<Result>& results,
+			 std::ostream& os );
+
+protected:
+
+  //! Initialize the scene
+  virtual void initialize( const std::shared_ptr<Renderer>& renderer,
+			   const unsigned number_of_sprites ) = 0;
+
+  //! Render a frame
+  virtual void renderFrame( const std::shared_ptr<Renderer>& renderer,
+			    const unsigned frame ) = 0;
+
+  //! Finalize the scene (free the scene resources)
+  virtual void finalize() = 0;
+
+private:
+
+  // Get a percentile of the sorted frame times
+  static double getPercentile( const std::vector<double>& frame_times,
+			       const double percentile );
+
+  // The scene name
+  std::string d_name;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_BENCHMARK_SCENE_HPP
+
+//---------------------------------------------------------------------------//
+// end BenchmarkScene.hpp
+//---------------------------------------------------------------------------//
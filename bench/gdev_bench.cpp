@@ -0,0 +1,507 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   gdev_bench.cpp
+//! \author Alex Robinson
+//! \brief  The GDev micro-benchmarks
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+// Boost Includes
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/cmdline.hpp>
+#include <boost/program_options/parsers.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "BenchmarkRunner.hpp"
+#include "GlobalSDLSession.hpp"
+#include "Surface.hpp"
+#include "SurfaceBlitter.hpp"
+#include "PixelFormatConverter.hpp"
+#include "SurfaceRenderer.hpp"
+#include "StreamingTexture.hpp"
+#include "Font.hpp"
+#include "Rectangle.hpp"
+#include "Ellipse.hpp"
+#include "Button.hpp"
+
+//---------------------------------------------------------------------------//
+// Benchmark Structs
+//---------------------------------------------------------------------------//
+
+// A button that only records the handled actions
+class BenchmarkButton : public GDev::Button
+{
+
+public:
+
+  // Constructor
+  BenchmarkButton( const GDev::Shape& area )
+    : d_area( area ),
+      d_mouse_x_position( 0 ),
+      d_mouse_y_position( 0 ),
+      d_handled_actions( 0 )
+  { /* ... */ }
+
+  // Render the button
+  void render() const
+  { /* ... */ }
+
+  // Set the mouse position
+  void setMousePosition( const int x_position, const int y_position )
+  {
+    d_mouse_x_position = x_position;
+    d_mouse_y_position = y_position;
+  }
+
+  // Get the number of handled actions
+  unsigned long getNumberOfHandledActions() const
+  {
+    return d_handled_actions;
+  }
+
+protected:
+
+  // Handle default
+  void handleDefault()
+  { ++d_handled_actions; }
+
+  // Handle button scroll over
+  void handleButtonScrollOver()
+  { ++d_handled_actions; }
+
+  // Handle button press
+  void handleButtonPress()
+  { ++d_handled_actions; }
+
+  // Handle button release
+  void handleButtonRelease()
+  { ++d_handled_actions; }
+
+  // Test if the mouse position is inside of the button
+  bool isMouseInButton() const
+  { return d_area.isPointIn( d_mouse_x_position, d_mouse_y_position ); }
+
+private:
+
+  // The button area
+  const GDev::Shape& d_area;
+
+  // The mouse x position
+  int d_mouse_x_position;
+
+  // The mouse y position
+  int d_mouse_y_position;
+
+  // The number of handled actions
+  unsigned long d_handled_actions;
+};
+
+//---------------------------------------------------------------------------//
+// Benchmarks
+//---------------------------------------------------------------------------//
+
+// Benchmark the shape surface rasterization
+void benchmarkShapeSurfaces( GDev::BenchmarkRunner& runner )
+{
+  SDL_Color inside_color = {0xFF,0,0,0xFF};
+  SDL_Color edge_color = {0,0,0,0xFF};
+  SDL_Color outside_color = {0xFF,0xFF,0xFF,0};
+
+  GDev::Rectangle small_rectangle( 0, 0, 64, 64, 2 );
+  GDev::Rectangle large_rectangle( 0, 0, 256, 256, 2 );
+  GDev::Ellipse small_ellipse( 32, 32, 32, 32, 2 );
+  GDev::Ellipse large_ellipse( 128, 128, 128, 128, 2 );
+
+  runner.run( "shape_surface/rectangle_64x64", [&](){
+      GDev::Surface surface( small_rectangle,
+			     inside_color, edge_color, outside_color ); } );
+
+  runner.run( "shape_surface/rectangle_256x256", [&](){
+      GDev::Surface surface( large_rectangle,
+			     inside_color, edge_color, outside_color ); } );
+
+  runner.run( "shape_surface/ellipse_64x64", [&](){
+      GDev::Surface surface( small_ellipse,
+			     inside_color, edge_color, outside_color ); } );
+
+  runner.run( "shape_surface/ellipse_256x256", [&](){
+      GDev::Surface surface( large_ellipse,
+			     inside_color, edge_color, outside_color ); } );
+}
+
+// Benchmark the surface blits
+void benchmarkSurfaceBlits( GDev::BenchmarkRunner& runner )
+{
+  GDev::Surface source_surface( 256, 256, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 512, 512, SDL_PIXELFORMAT_ARGB8888 );
+
+  runner.run( "surface/blit_256x256", [&](){
+      source_surface.blitSurface( destination_surface ); } );
+
+  source_surface.setBlendMode( SDL_BLENDMODE_BLEND );
+
+  runner.run( "surface/blit_blend_256x256", [&](){
+      source_surface.blitSurface( destination_surface ); } );
+
+  // Compare the blit kernels
+  const GDev::SimdKernel kernels[3] =
+    {GDev::SCALAR_KERNEL,
+     GDev::SSE2_KERNEL,
+     GDev::AVX2_KERNEL};
+
+  source_surface.setColorMod( 0xFF, 0x80, 0x40 );
+
+  for( unsigned i = 0; i < 3; ++i )
+  {
+    if( !GDev::SurfaceBlitter::isKernelSupported( kernels[i] ) )
+      continue;
+
+    GDev::SurfaceBlitter::setKernel( kernels[i] );
+
+    runner.run( std::string( "surface/blit_blend_modulated_256x256_" ) +
+		GDev::SurfaceBlitter::getKernelName( kernels[i] ), [&](){
+		  source_surface.blitSurface( destination_surface ); } );
+  }
+
+  GDev::SurfaceBlitter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+
+  source_surface.setColorMod( 0xFF, 0xFF, 0xFF );
+  source_surface.setBlendMode( SDL_BLENDMODE_NONE );
+
+  // Compare the scale filters
+  const GDev::SurfaceScaler::Filter filters[3] =
+    {GDev::SurfaceScaler::NEAREST_FILTER,
+     GDev::SurfaceScaler::BILINEAR_FILTER,
+     GDev::SurfaceScaler::BOX_FILTER};
+
+  for( unsigned i = 0; i < 3; ++i )
+  {
+    const std::string filter_name =
+      GDev::SurfaceScaler::getFilterName( filters[i] );
+
+    runner.run( "surface/blit_scaled_256x256_to_512x512_" + filter_name,
+		[&](){
+		  SDL_Rect destination_rectangle = {0,0,512,512};
+		  source_surface.blitScaled( destination_surface,
+					     &destination_rectangle,
+					     NULL,
+					     filters[i] ); } );
+
+    runner.run( "surface/blit_scaled_512x512_to_100x100_" + filter_name,
+		[&](){
+		  SDL_Rect destination_rectangle = {0,0,100,100};
+		  destination_surface.blitScaled( source_surface,
+						  &destination_rectangle,
+						  NULL,
+						  filters[i] ); } );
+  }
+}
+
+// Benchmark the surface format conversions
+void benchmarkFormatConversions( GDev::BenchmarkRunner& runner )
+{
+  GDev::Surface source_surface( 256, 256, SDL_PIXELFORMAT_ARGB8888 );
+
+  std::vector<Uint32> formats;
+  formats.push_back( SDL_PIXELFORMAT_ABGR8888 );
+  formats.push_back( SDL_PIXELFORMAT_RGBA8888 );
+  formats.push_back( SDL_PIXELFORMAT_RGB888 );
+  formats.push_back( SDL_PIXELFORMAT_RGB565 );
+
+  for( unsigned i = 0; i < formats.size(); ++i )
+  {
+    const Uint32 format = formats[i];
+
+    runner.run( std::string( "surface/convert_256x256_ARGB8888_to_" ) +
+		(SDL_GetPixelFormatName( format ) + 16),
+		[&](){ GDev::Surface surface( source_surface, format ); } );
+  }
+
+  // Compare the conversion kernels
+  GDev::Surface rgb24_surface( 256, 256, SDL_PIXELFORMAT_RGB24 );
+
+  const GDev::SimdKernel kernels[3] =
+    {GDev::SCALAR_KERNEL,
+     GDev::SSE2_KERNEL,
+     GDev::AVX2_KERNEL};
+
+  for( unsigned i = 0; i < 3; ++i )
+  {
+    if( !GDev::SurfaceBlitter::isKernelSupported( kernels[i] ) )
+      continue;
+
+    GDev::PixelFormatConverter::setKernel( kernels[i] );
+
+    const std::string kernel_name =
+      GDev::SurfaceBlitter::getKernelName( kernels[i] );
+
+    runner.run( "surface/convert_256x256_RGB24_to_ARGB8888_" + kernel_name,
+		[&](){ GDev::Surface surface( rgb24_surface,
+					      SDL_PIXELFORMAT_ARGB8888 ); } );
+  }
+
+  GDev::PixelFormatConverter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+
+  // Compare the single threaded and the multi-threaded conversions
+  GDev::Surface large_surface( 2048, 2048, SDL_PIXELFORMAT_ABGR8888 );
+
+  const unsigned number_of_threads =
+    GDev::PixelFormatConverter::getNumberOfThreads();
+
+  GDev::PixelFormatConverter::setNumberOfThreads( 1 );
+
+  runner.run( "surface/convert_2048x2048_ABGR8888_to_ARGB8888_1_thread",
+	      [&](){ GDev::Surface surface( large_surface,
+					    SDL_PIXELFORMAT_ARGB8888 ); } );
+
+  GDev::PixelFormatConverter::setNumberOfThreads( number_of_threads );
+
+  runner.run( "surface/convert_2048x2048_ABGR8888_to_ARGB8888_threaded",
+	      [&](){ GDev::Surface surface( large_surface,
+					    SDL_PIXELFORMAT_ARGB8888 ); } );
+}
+
+// Benchmark the streaming texture copies
+void benchmarkStreamingTextureCopies(
+			    GDev::BenchmarkRunner& runner,
+			    const std::shared_ptr<GDev::Renderer>& renderer )
+{
+  GDev::StreamingTexture texture( renderer, 256, 256 );
+
+  GDev::Surface same_format_surface( 256, 256, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface other_format_surface( 256, 256, SDL_PIXELFORMAT_ABGR8888 );
+
+  runner.run( "streaming_texture/copy_256x256", [&](){
+      texture.copy( same_format_surface ); } );
+
+  runner.run( "streaming_texture/copy_256x256_convert", [&](){
+      texture.copy( other_format_surface ); } );
+
+  // A few percent of the pixels change (e.g. a live minimap)
+  std::vector<SDL_Rect> changed_areas( 4 );
+
+  for( unsigned i = 0; i < changed_areas.size(); ++i )
+  {
+    changed_areas[i].x = 10 + 60*i;
+    changed_areas[i].y = 20 + 50*i;
+    changed_areas[i].w = 16;
+    changed_areas[i].h = 16;
+  }
+
+  runner.run( "streaming_texture/copy_256x256_changed_areas", [&](){
+      texture.copy( same_format_surface, changed_areas ); } );
+}
+
+// Benchmark the text surface creation
+void benchmarkTextSurfaces( GDev::BenchmarkRunner& runner,
+			    const std::string& font_name )
+{
+  GDev::Font font( font_name, 20 );
+
+  SDL_Color text_color = {0,0,0,0xFF};
+  SDL_Color background_color = {0xFF,0xFF,0xFF,0xFF};
+
+  runner.run( "text_surface/solid", [&](){
+      GDev::Surface surface( "Score: 1234567", font, text_color ); } );
+
+  runner.run( "text_surface/shaded", [&](){
+      GDev::Surface surface( "Score: 1234567", font, text_color,
+			     &background_color ); } );
+}
+
+// Benchmark the renderer primitive draws
+void benchmarkRendererPrimitives(
+			    GDev::BenchmarkRunner& runner,
+			    const std::shared_ptr<GDev::Renderer>& renderer )
+{
+  SDL_Color draw_color = {0xFF,0,0,0xFF};
+
+  renderer->setDrawColor( draw_color );
+
+  runner.run( "renderer/clear", [&](){ renderer->clear(); } );
+
+  runner.run( "renderer/draw_point", [&](){ renderer->drawPoint( 10, 10 ); } );
+
+  runner.run( "renderer/draw_line", [&](){
+      renderer->drawLine( 0, 0, 255, 127 ); } );
+
+  SDL_Rect rectangle = {16,16,64,64};
+
+  runner.run( "renderer/draw_rectangle", [&](){
+      renderer->drawRectangle( rectangle, false ); } );
+
+  runner.run( "renderer/draw_rectangle_fill", [&](){
+      renderer->drawRectangle( rectangle, true ); } );
+
+  std::vector<SDL_Rect> rectangles( 100 );
+
+  for( unsigned i = 0; i < rectangles.size(); ++i )
+  {
+    rectangles[i].x = (i%10)*25;
+    rectangles[i].y = (i/10)*12;
+    rectangles[i].w = 20;
+    rectangles[i].h = 10;
+  }
+
+  runner.run( "renderer/draw_rectangles_fill_100", [&](){
+      renderer->drawRectangles( rectangles, true ); } );
+
+  GDev::Ellipse ellipse( 64, 64, 32, 32 );
+
+  runner.run( "renderer/draw_shape_ellipse", [&](){
+      renderer->drawShape( ellipse, true ); } );
+}
+
+// Benchmark the button action dispatch
+void benchmarkButtonDispatch( GDev::BenchmarkRunner& runner )
+{
+  GDev::Rectangle area( 0, 0, 100, 50 );
+
+  BenchmarkButton button( area );
+
+  SDL_Event motion_event;
+  motion_event.type = SDL_MOUSEMOTION;
+
+  SDL_Event press_event;
+  press_event.type = SDL_MOUSEBUTTONDOWN;
+
+  SDL_Event key_event;
+  key_event.type = SDL_KEYDOWN;
+
+  button.setMousePosition( 10, 10 );
+
+  runner.run( "button/handle_action_motion_inside", [&](){
+      button.handleAction( motion_event ); } );
+
+  runner.run( "button/handle_action_press_inside", [&](){
+      button.handleAction( press_event ); } );
+
+  runner.run( "button/handle_action_ignored", [&](){
+      button.handleAction( key_event ); } );
+
+  button.setMousePosition( 200, 200 );
+
+  runner.run( "button/handle_action_motion_outside", [&](){
+      button.handleAction( motion_event ); } );
+}
+
+//---------------------------------------------------------------------------//
+// Main
+//---------------------------------------------------------------------------//
+
+int main( int argc, char** argv )
+{
+  // Create the optional arguments
+  boost::program_options::options_description generic( "Allowed options" );
+  generic.add_options()
+    ("help,h", "produce help message")
+    ("output,o",
+     boost::program_options::value<std::string>(),
+     "the JSON file that the results will be written to (default: stdout)")
+    ("baseline,b",
+     boost::program_options::value<std::string>(),
+     "the JSON results of a previous run to compare against")
+    ("tolerance,t",
+     boost::program_options::value<double>()->default_value( 0.1 ),
+     "the allowed slowdown relative to the baseline (fraction)")
+    ("filter,f",
+     boost::program_options::value<std::string>()->default_value( "" ),
+     "only run the benchmarks whose names contain the filter")
+    ("sample_time",
+     boost::program_options::value<double>()->default_value( 0.01 ),
+     "the minimum time of each sample (s)")
+    ("samples",
+     boost::program_options::value<unsigned>()->default_value( 5u ),
+     "the number of samples")
+    ("font",
+     boost::program_options::value<std::string>(),
+     "the font (with path) used by the text benchmarks");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store( boost::program_options::command_line_parser(argc, argv).options(generic).run(), vm );
+  boost::program_options::notify( vm );
+
+  // Check if the help message was requested
+  if( vm.count( "help" ) )
+  {
+    std::cerr << generic << std::endl;
+
+    return 0;
+  }
+
+  // Run headless unless another video driver has been requested
+  setenv( "SDL_VIDEODRIVER", "dummy", 0 );
+
+  GDev::GlobalSDLSession session( &std::cerr );
+
+  GDev::BenchmarkRunner runner( vm["sample_time"].as<double>(),
+				vm["samples"].as<unsigned>(),
+				vm["filter"].as<std::string>() );
+
+  std::shared_ptr<GDev::Surface> target_surface(
+		    new GDev::Surface( 640, 480, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  std::shared_ptr<GDev::Renderer> renderer(
+				new GDev::SurfaceRenderer( target_surface ) );
+
+  benchmarkShapeSurfaces( runner );
+  benchmarkSurfaceBlits( runner );
+  benchmarkFormatConversions( runner );
+  benchmarkStreamingTextureCopies( runner, renderer );
+
+  if( vm.count( "font" ) )
+    benchmarkTextSurfaces( runner, vm["font"].as<std::string>() );
+  else
+    std::cerr << "No font was specified: skipping the text benchmarks."
+	      << std::endl;
+
+  benchmarkRendererPrimitives( runner, renderer );
+  benchmarkButtonDispatch( runner );
+
+  // Write the results
+  if( vm.count( "output" ) )
+  {
+    std::ofstream output_file( vm["output"].as<std::string>().c_str() );
+
+    runner.writeJSON( output_file );
+  }
+  else
+    runner.writeJSON( std::cout );
+
+  // Compare the results to the baseline
+  if( vm.count( "baseline" ) )
+  {
+    unsigned regressions = runner.compareToBaseline(
+		 GDev::BenchmarkRunner::readBaseline(
+					 vm["baseline"].as<std::string>() ),
+		 vm["tolerance"].as<double>(),
+		 std::cerr );
+
+    if( regressions > 0 )
+    {
+      std::cerr << regressions << " benchmark(s) regressed!" << std::endl;
+
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------//
+// end gdev_bench.cpp
+//---------------------------------------------------------------------------//
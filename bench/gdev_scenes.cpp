@@ -0,0 +1,690 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   gdev_scenes.cpp
+//! \author Alex Robinson
+//! \brief  The GDev macro-benchmark scenes (based on the cli tutorials)
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+// Boost Includes
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/cmdline.hpp>
+#include <boost/program_options/parsers.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "BenchmarkScene.hpp"
+#include "GlobalSDLSession.hpp"
+#include "Surface.hpp"
+#include "SurfaceRenderer.hpp"
+#include "StaticTexture.hpp"
+#include "Font.hpp"
+#include "Rectangle.hpp"
+#include "Ellipse.hpp"
+#include "Button.hpp"
+
+//---------------------------------------------------------------------------//
+// Scene Parameters
+//---------------------------------------------------------------------------//
+
+// The target width
+const int target_width = 640;
+
+// The target height
+const int target_height = 480;
+
+// The sprite size
+const int sprite_size = 32;
+
+//---------------------------------------------------------------------------//
+// Scene Functions
+//---------------------------------------------------------------------------//
+
+// Create a sprite surface (a circle on a cyan background)
+std::shared_ptr<GDev::Surface> createSpriteSurface( const SDL_Color& color )
+{
+  SDL_Color edge_color = {0,0,0,0xFF};
+  SDL_Color background_color = {0,0xFF,0xFF,0xFF};
+
+  GDev::Ellipse area( sprite_size/2, sprite_size/2,
+		      sprite_size/2, sprite_size/2, 1 );
+
+  return std::shared_ptr<GDev::Surface>(
+	      new GDev::Surface( area, color, edge_color, background_color ) );
+}
+
+// Create a sprite sheet texture (four sprites in a row)
+std::shared_ptr<GDev::Texture> createSpriteSheet(
+			    const std::shared_ptr<GDev::Renderer>& renderer )
+{
+  GDev::Surface sheet_surface( 4*sprite_size, sprite_size,
+			       SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_Color colors[4] = {{0xFF,0,0,0xFF},
+			 {0,0xFF,0,0xFF},
+			 {0,0,0xFF,0xFF},
+			 {0xFF,0xFF,0,0xFF}};
+
+  for( int i = 0; i < 4; ++i )
+  {
+    SDL_Rect destination = {i*sprite_size, 0, sprite_size, sprite_size};
+
+    createSpriteSurface( colors[i] )->blitSurface( sheet_surface,
+						   &destination );
+  }
+
+  return std::shared_ptr<GDev::Texture>(
+			  new GDev::StaticTexture( renderer, sheet_surface ) );
+}
+
+// Create a background texture
+std::shared_ptr<GDev::Texture> createBackground(
+			    const std::shared_ptr<GDev::Renderer>& renderer )
+{
+  SDL_Color inside_color = {0x40,0x80,0x40,0xFF};
+  SDL_Color edge_color = {0,0,0,0xFF};
+
+  GDev::Rectangle area( 0, 0, target_width, target_height, 4 );
+
+  return std::shared_ptr<GDev::Texture>(
+       new GDev::StaticTexture( renderer, area,
+				inside_color, edge_color, inside_color ) );
+}
+
+// Create deterministic sprite positions
+std::vector<SDL_Point> createSpritePositions(
+					const unsigned number_of_sprites )
+{
+  std::vector<SDL_Point> positions( number_of_sprites );
+
+  unsigned long state = 12345ul;
+
+  for( unsigned i = 0; i < number_of_sprites; ++i )
+  {
+    state = (state*1103515245ul + 12345ul) & 0x7FFFFFFFul;
+    positions[i].x = state % (target_width - sprite_size);
+
+    state = (state*1103515245ul + 12345ul) & 0x7FFFFFFFul;
+    positions[i].y = state % (target_height - sprite_size);
+  }
+
+  return positions;
+}
+
+//---------------------------------------------------------------------------//
+// Scenes
+//---------------------------------------------------------------------------//
+
+// Color keyed sprites over a background (sdl_test_10)
+class ColorKeyingScene : public GDev::BenchmarkScene
+{
+public:
+
+  ColorKeyingScene()
+    : GDev::BenchmarkScene( "color_keying" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    SDL_Color color = {0xFF,0x80,0,0xFF};
+
+    std::shared_ptr<GDev::Surface> sprite_surface =
+      createSpriteSurface( color );
+
+    sprite_surface->setColorKey(
+	      SDL_MapRGB( &sprite_surface->getPixelFormat(), 0, 0xFF, 0xFF ) );
+
+    d_sprite.reset( new GDev::StaticTexture( renderer, *sprite_surface ) );
+    d_background = createBackground( renderer );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&, const unsigned )
+  {
+    d_background->render();
+
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+      d_sprite->render( d_positions[i].x, d_positions[i].y );
+  }
+
+  void finalize()
+  {
+    d_sprite.reset();
+    d_background.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sprite;
+  std::shared_ptr<GDev::Texture> d_background;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Sprite sheet clipping (sdl_test_11)
+class SpriteSheetScene : public GDev::BenchmarkScene
+{
+public:
+
+  SpriteSheetScene()
+    : GDev::BenchmarkScene( "sprite_sheet" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    d_sheet = createSpriteSheet( renderer );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&, const unsigned )
+  {
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      SDL_Rect clip = {(int)(i%4)*sprite_size, 0, sprite_size, sprite_size};
+
+      d_sheet->render( d_positions[i].x, d_positions[i].y, &clip );
+    }
+  }
+
+  void finalize()
+  {
+    d_sheet.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sheet;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Color modulated sprites (sdl_test_12)
+class ColorModulationScene : public GDev::BenchmarkScene
+{
+public:
+
+  ColorModulationScene()
+    : GDev::BenchmarkScene( "color_modulation" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+    d_sprite.reset( new GDev::StaticTexture( renderer,
+					     *createSpriteSurface( white ) ) );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&,
+		    const unsigned frame )
+  {
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      d_sprite->setColorMod( (i*32 + frame) & 0xFF,
+			     (i*64 + frame) & 0xFF,
+			     (i*96 + frame) & 0xFF );
+
+      d_sprite->render( d_positions[i].x, d_positions[i].y );
+    }
+  }
+
+  void finalize()
+  {
+    d_sprite.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sprite;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Alpha blended sprites over a background (sdl_test_13)
+class AlphaBlendingScene : public GDev::BenchmarkScene
+{
+public:
+
+  AlphaBlendingScene()
+    : GDev::BenchmarkScene( "alpha_blending" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    SDL_Color color = {0xFF,0,0xFF,0xFF};
+
+    d_sprite.reset( new GDev::StaticTexture( renderer,
+					     *createSpriteSurface( color ) ) );
+    d_sprite->setBlendMode( SDL_BLENDMODE_BLEND );
+
+    d_background = createBackground( renderer );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&,
+		    const unsigned frame )
+  {
+    d_background->render();
+
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      d_sprite->setAlphaMod( (i*8 + frame) & 0xFF );
+
+      d_sprite->render( d_positions[i].x, d_positions[i].y );
+    }
+  }
+
+  void finalize()
+  {
+    d_sprite.reset();
+    d_background.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sprite;
+  std::shared_ptr<GDev::Texture> d_background;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Animated sprites (sdl_test_14)
+class AnimationScene : public GDev::BenchmarkScene
+{
+public:
+
+  AnimationScene()
+    : GDev::BenchmarkScene( "animation" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    d_sheet = createSpriteSheet( renderer );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&,
+		    const unsigned frame )
+  {
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      // Each animation frame is shown for four frames
+      const int animation_frame = (frame/4 + i)%4;
+
+      SDL_Rect clip = {animation_frame*sprite_size, 0,
+		       sprite_size, sprite_size};
+
+      d_sheet->render( (d_positions[i].x + frame)%
+		       (target_width - sprite_size),
+		       d_positions[i].y,
+		       &clip );
+    }
+  }
+
+  void finalize()
+  {
+    d_sheet.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sheet;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Rotated and flipped sprites (sdl_test_15)
+class RotationFlipScene : public GDev::BenchmarkScene
+{
+public:
+
+  RotationFlipScene()
+    : GDev::BenchmarkScene( "rotation_flip" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    d_sheet = createSpriteSheet( renderer );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&,
+		    const unsigned frame )
+  {
+    const SDL_RendererFlip flips[3] =
+      {SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL};
+
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      SDL_Rect clip = {(int)(i%4)*sprite_size, 0, sprite_size, sprite_size};
+
+      d_sheet->render( d_positions[i].x,
+		       d_positions[i].y,
+		       &clip,
+		       (double)((frame*3 + i*7)%360),
+		       NULL,
+		       flips[i%3] );
+    }
+  }
+
+  void finalize()
+  {
+    d_sheet.reset();
+  }
+
+private:
+
+  std::shared_ptr<GDev::Texture> d_sheet;
+  std::vector<SDL_Point> d_positions;
+};
+
+// Changing text labels (sdl_test_16)
+class TextScene : public GDev::BenchmarkScene
+{
+public:
+
+  TextScene( const std::string& font_name )
+    : GDev::BenchmarkScene( "text" ),
+      d_font_name( font_name )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>&,
+		   const unsigned number_of_sprites )
+  {
+    d_font.reset( new GDev::Font( d_font_name, 16 ) );
+    d_positions = createSpritePositions( number_of_sprites );
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>& renderer,
+		    const unsigned frame )
+  {
+    SDL_Color text_color = {0,0,0,0xFF};
+
+    for( unsigned i = 0; i < d_positions.size(); ++i )
+    {
+      std::ostringstream label;
+      label << "Score: " << frame*100 + i;
+
+      d_font->renderText( renderer,
+			  label.str(),
+			  d_positions[i].x,
+			  d_positions[i].y,
+			  text_color );
+    }
+  }
+
+  void finalize()
+  {
+    d_font.reset();
+  }
+
+private:
+
+  std::string d_font_name;
+  std::shared_ptr<GDev::Font> d_font;
+  std::vector<SDL_Point> d_positions;
+};
+
+// A button with a texture for each state (see GeneralButton)
+class SceneButton : public GDev::Button
+{
+public:
+
+  SceneButton( const SDL_Point& position,
+	       const std::vector<std::shared_ptr<GDev::Texture> >& textures )
+    : d_area( position.x, position.y, sprite_size, sprite_size ),
+      d_textures( textures ),
+      d_active_texture( 0 )
+  { /* ... */ }
+
+  void render() const
+  {
+    d_textures[d_active_texture]->render( d_area.getBoundingBoxXPosition(),
+					  d_area.getBoundingBoxYPosition() );
+  }
+
+  // The simulated mouse position
+  static SDL_Point s_mouse_position;
+
+protected:
+
+  void handleDefault()
+  { d_active_texture = 0; }
+
+  void handleButtonScrollOver()
+  { d_active_texture = 1; }
+
+  void handleButtonPress()
+  { d_active_texture = 2; }
+
+  void handleButtonRelease()
+  { d_active_texture = 3; }
+
+  bool isMouseInButton() const
+  { return d_area.isPointIn( s_mouse_position.x, s_mouse_position.y ); }
+
+private:
+
+  GDev::Rectangle d_area;
+  const std::vector<std::shared_ptr<GDev::Texture> >& d_textures;
+  unsigned d_active_texture;
+};
+
+SDL_Point SceneButton::s_mouse_position = {0,0};
+
+// Buttons driven by mouse events (sdl_test_17)
+class ButtonScene : public GDev::BenchmarkScene
+{
+public:
+
+  ButtonScene()
+    : GDev::BenchmarkScene( "buttons" )
+  { /* ... */ }
+
+protected:
+
+  void initialize( const std::shared_ptr<GDev::Renderer>& renderer,
+		   const unsigned number_of_sprites )
+  {
+    SDL_Color colors[4] = {{0x80,0x80,0x80,0xFF},
+			   {0xFF,0xFF,0,0xFF},
+			   {0,0xFF,0,0xFF},
+			   {0,0,0xFF,0xFF}};
+    SDL_Color edge_color = {0,0,0,0xFF};
+
+    GDev::Rectangle area( 0, 0, sprite_size, sprite_size, 2 );
+
+    for( int i = 0; i < 4; ++i )
+    {
+      d_textures.push_back( std::shared_ptr<GDev::Texture>(
+		 new GDev::StaticTexture( renderer, area,
+					  colors[i], edge_color, colors[i] ) ) );
+    }
+
+    std::vector<SDL_Point> positions =
+      createSpritePositions( number_of_sprites );
+
+    for( unsigned i = 0; i < positions.size(); ++i )
+    {
+      d_buttons.push_back( std::shared_ptr<SceneButton>(
+				   new SceneButton( positions[i], d_textures ) ) );
+    }
+  }
+
+  void renderFrame( const std::shared_ptr<GDev::Renderer>&,
+		    const unsigned frame )
+  {
+    // Move the mouse across the target and alternate the button state
+    SceneButton::s_mouse_position.x = (frame*7)%target_width;
+    SceneButton::s_mouse_position.y = (frame*5)%target_height;
+
+    SDL_Event events[3];
+    events[0].type = SDL_MOUSEMOTION;
+    events[1].type = SDL_MOUSEBUTTONDOWN;
+    events[2].type = SDL_MOUSEBUTTONUP;
+
+    const SDL_Event& event = events[frame%3];
+
+    for( unsigned i = 0; i < d_buttons.size(); ++i )
+      d_buttons[i]->handleAction( event );
+
+    for( unsigned i = 0; i < d_buttons.size(); ++i )
+      d_buttons[i]->render();
+  }
+
+  void finalize()
+  {
+    d_buttons.clear();
+    d_textures.clear();
+  }
+
+private:
+
+  std::vector<std::shared_ptr<GDev::Texture> > d_textures;
+  std::vector<std::shared_ptr<SceneButton> > d_buttons;
+};
+
+//---------------------------------------------------------------------------//
+// Main
+//---------------------------------------------------------------------------//
+
+int main( int argc, char** argv )
+{
+  // Create the optional arguments
+  boost::program_options::options_description generic( "Allowed options" );
+  generic.add_options()
+    ("help,h", "produce help message")
+    ("output,o",
+     boost::program_options::value<std::string>(),
+     "the JSON file that the results will be written to (default: stdout)")
+    ("filter,f",
+     boost::program_options::value<std::string>()->default_value( "" ),
+     "only run the scenes whose names contain the filter")
+    ("frames",
+     boost::program_options::value<unsigned>()->default_value( 300u ),
+     "the number of frames rendered in each scene")
+    ("sprites",
+     boost::program_options::value<unsigned>()->default_value( 100u ),
+     "the initial number of sprites in each scene")
+    ("max_sprites",
+     boost::program_options::value<unsigned>()->default_value( 1600u ),
+     "the number of sprites is doubled until it exceeds this value")
+    ("font",
+     boost::program_options::value<std::string>(),
+     "the font (with path) used by the text scene");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store( boost::program_options::command_line_parser(argc, argv).options(generic).run(), vm );
+  boost::program_options::notify( vm );
+
+  // Check if the help message was requested
+  if( vm.count( "help" ) )
+  {
+    std::cerr << generic << std::endl;
+
+    return 0;
+  }
+
+  const std::string filter = vm["filter"].as<std::string>();
+  const unsigned frames = vm["frames"].as<unsigned>();
+  const unsigned min_sprites = vm["sprites"].as<unsigned>();
+  const unsigned max_sprites = vm["max_sprites"].as<unsigned>();
+
+  if( frames == 0u || min_sprites == 0u )
+  {
+    std::cerr << "The number of frames and sprites must be positive."
+	      << std::endl;
+
+    return 1;
+  }
+
+  // Run headless unless another video driver has been requested
+  setenv( "SDL_VIDEODRIVER", "dummy", 0 );
+
+  GDev::GlobalSDLSession session( &std::cerr );
+
+  std::shared_ptr<GDev::Surface> target_surface(
+		      new GDev::Surface( target_width, target_height,
+					 SDL_PIXELFORMAT_ARGB8888 ) );
+
+  std::shared_ptr<GDev::Renderer> renderer(
+				new GDev::SurfaceRenderer( target_surface ) );
+
+  // Create the scenes
+  std::vector<std::shared_ptr<GDev::BenchmarkScene> > scenes;
+  scenes.push_back( std::make_shared<ColorKeyingScene>() );
+  scenes.push_back( std::make_shared<SpriteSheetScene>() );
+  scenes.push_back( std::make_shared<ColorModulationScene>() );
+  scenes.push_back( std::make_shared<AlphaBlendingScene>() );
+  scenes.push_back( std::make_shared<AnimationScene>() );
+  scenes.push_back( std::make_shared<RotationFlipScene>() );
+
+  if( vm.count( "font" ) )
+  {
+    scenes.push_back(
+	     std::make_shared<TextScene>( vm["font"].as<std::string>() ) );
+  }
+  else
+    std::cerr << "No font was specified: skipping the text scene."
+	      << std::endl;
+
+  scenes.push_back( std::make_shared<ButtonScene>() );
+
+  // Run the scenes
+  std::vector<GDev::BenchmarkScene::Result> results;
+
+  for( unsigned i = 0; i < scenes.size(); ++i )
+  {
+    if( scenes[i]->getName().find( filter ) == std::string::npos )
+      continue;
+
+    for( unsigned sprites = min_sprites;
+	 sprites <= max_sprites;
+	 sprites *= 2 )
+      results.push_back( scenes[i]->run( renderer, sprites, frames ) );
+  }
+
+  // Write the results
+  if( vm.count( "output" ) )
+  {
+    std::ofstream output_file( vm["output"].as<std::string>().c_str() );
+
+    GDev::BenchmarkScene::writeJSON( results, output_file );
+  }
+  else
+    GDev::BenchmarkScene::writeJSON( results, std::cout );
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------//
+// end gdev_scenes.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,270 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   DirtyRegion.cpp
+//! \author Alex Robinson
+//! \brief  The dirty region class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "DirtyRegion.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const double DirtyRegion::s_default_full_frame_threshold = 0.5;
+const unsigned DirtyRegion::s_default_max_number_of_rectangles = 16u;
+
+// Constructor
+DirtyRegion::DirtyRegion( const int width,
+			  const int height,
+			  const double full_frame_threshold )
+  : d_width( width ),
+    d_height( height ),
+    d_full_frame_threshold( full_frame_threshold ),
+    d_max_number_of_rectangles( s_default_max_number_of_rectangles ),
+    d_full_frame( false ),
+    d_rectangles()
+{
+  // Make sure the size is valid
+  testPrecondition( width >= 0 );
+  testPrecondition( height >= 0 );
+  // Make sure the threshold is valid
+  testPrecondition( full_frame_threshold >= 0.0 );
+  testPrecondition( full_frame_threshold <= 1.0 );
+}
+
+// Get the width of the target
+int DirtyRegion::getWidth() const
+{
+  return d_width;
+}
+
+// Get the height of the target
+int DirtyRegion::getHeight() const
+{
+  return d_height;
+}
+
+// Set the size of the target
+/*! \details If the size changes the entire target will be invalidated.
+ */
+void DirtyRegion::setSize( const int width, const int height )
+{
+  // Make sure the size is valid
+  testPrecondition( width >= 0 );
+  testPrecondition( height >= 0 );
+
+  if( width != d_width || height != d_height )
+  {
+    d_width = width;
+    d_height = height;
+
+    this->clear();
+    this->invalidateAll();
+  }
+}
+
+// Get the full frame threshold (fraction of the target area)
+double DirtyRegion::getFullFrameThreshold() const
+{
+  return d_full_frame_threshold;
+}
+
+// Set the full frame threshold (fraction of the target area)
+/*! \details A threshold of zero will cause any invalidated area to
+ * invalidate the entire target.
+ */
+void DirtyRegion::setFullFrameThreshold( const double full_frame_threshold )
+{
+  // Make sure the threshold is valid
+  testPrecondition( full_frame_threshold >= 0.0 );
+  testPrecondition( full_frame_threshold <= 1.0 );
+
+  d_full_frame_threshold = full_frame_threshold;
+}
+
+// Get the max number of rectangles
+unsigned DirtyRegion::getMaxNumberOfRectangles() const
+{
+  return d_max_number_of_rectangles;
+}
+
+// Set the max number of rectangles
+void DirtyRegion::setMaxNumberOfRectangles(
+				      const unsigned max_number_of_rectangles )
+{
+  // Make sure the max number of rectangles is valid
+  testPrecondition( max_number_of_rectangles > 0 );
+
+  d_max_number_of_rectangles = max_number_of_rectangles;
+}
+
+// Invalidate an area of the target
+/*! \details The area will be clipped to the target. It will then be merged
+ * with the existing rectangles that it can be combined with without covering
+ * extra pixels. If the max number of rectangles has been reached, the area
+ * will be merged with the rectangle that grows the least.
+ */
+void DirtyRegion::invalidate( const SDL_Rect& area )
+{
+  if( d_full_frame )
+    return;
+
+  SDL_Rect target = {0, 0, d_width, d_height};
+  SDL_Rect dirty_rectangle;
+
+  if( !SDL_IntersectRect( &area, &target, &dirty_rectangle ) )
+    return;
+
+  bool merged = true;
+
+  while( merged )
+  {
+    merged = false;
+
+    for( unsigned i = 0; i < d_rectangles.size(); ++i )
+    {
+      SDL_Rect union_rectangle;
+
+      SDL_UnionRect( &d_rectangles[i], &dirty_rectangle, &union_rectangle );
+
+      if( DirtyRegion::calculateArea( union_rectangle ) <=
+	  DirtyRegion::calculateArea( d_rectangles[i] ) +
+	  DirtyRegion::calculateArea( dirty_rectangle ) )
+      {
+	dirty_rectangle = union_rectangle;
+
+	d_rectangles.erase( d_rectangles.begin()+i );
+
+	merged = true;
+
+	break;
+      }
+    }
+
+    // Merge with the rectangle that grows the least
+    if( !merged && d_rectangles.size() >= d_max_number_of_rectangles )
+    {
+      unsigned best_index = 0;
+      unsigned long best_growth = 0;
+      SDL_Rect best_union_rectangle;
+
+      for( unsigned i = 0; i < d_rectangles.size(); ++i )
+      {
+	SDL_Rect union_rectangle;
+
+	SDL_UnionRect( &d_rectangles[i], &dirty_rectangle, &union_rectangle );
+
+	unsigned long growth = DirtyRegion::calculateArea( union_rectangle ) -
+	  DirtyRegion::calculateArea( d_rectangles[i] );
+
+	if( i == 0 || growth < best_growth )
+	{
+	  best_index = i;
+	  best_growth = growth;
+	  best_union_rectangle = union_rectangle;
+	}
+      }
+
+      dirty_rectangle = best_union_rectangle;
+
+      d_rectangles.erase( d_rectangles.begin()+best_index );
+
+      merged = true;
+    }
+  }
+
+  d_rectangles.push_back( dirty_rectangle );
+
+  // Check if the entire target should be invalidated
+  if( this->getArea() >
+      d_full_frame_threshold*DirtyRegion::calculateArea( target ) )
+    this->invalidateAll();
+}
+
+// Invalidate the entire target
+void DirtyRegion::invalidateAll()
+{
+  d_rectangles.clear();
+
+  if( d_width > 0 && d_height > 0 )
+  {
+    SDL_Rect target = {0, 0, d_width, d_height};
+
+    d_rectangles.push_back( target );
+
+    d_full_frame = true;
+  }
+}
+
+// Check if the region is empty
+bool DirtyRegion::isEmpty() const
+{
+  return d_rectangles.empty();
+}
+
+// Check if the entire target is dirty
+bool DirtyRegion::isFullFrame() const
+{
+  return d_full_frame;
+}
+
+// Check if an area intersects the region
+/*! \details This can be used to determine if an object that covers the
+ * area must be redrawn.
+ */
+bool DirtyRegion::intersects( const SDL_Rect& area ) const
+{
+  for( unsigned i = 0; i < d_rectangles.size(); ++i )
+  {
+    if( SDL_HasIntersection( &d_rectangles[i], &area ) )
+      return true;
+  }
+
+  return false;
+}
+
+// Get the rectangles that cover the region
+/*! \details If the entire target is dirty a single rectangle that covers
+ * the target will be returned.
+ */
+const std::vector<SDL_Rect>& DirtyRegion::getRectangles() const
+{
+  return d_rectangles;
+}
+
+// Get the area of the region (pixels)
+/*! \details Pixels covered by overlapping rectangles will be counted more
+ * than once.
+ */
+unsigned long DirtyRegion::getArea() const
+{
+  unsigned long area = 0;
+
+  for( unsigned i = 0; i < d_rectangles.size(); ++i )
+    area += DirtyRegion::calculateArea( d_rectangles[i] );
+
+  return area;
+}
+
+// Remove all areas from the region
+void DirtyRegion::clear()
+{
+  d_rectangles.clear();
+
+  d_full_frame = false;
+}
+
+// Calculate the area of a rectangle
+unsigned long DirtyRegion::calculateArea( const SDL_Rect& rectangle )
+{
+  return (unsigned long)rectangle.w*rectangle.h;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end DirtyRegion.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   DirtyRegion.hpp
+//! \author Alex Robinson
+//! \brief  The dirty region class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_DIRTY_REGION_HPP
+#define GDEV_DIRTY_REGION_HPP
+
+// Std Lib Includes
+#include <vector>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+namespace GDev{
+
+/*! The dirty region class
+ * \details The dirty region stores the areas of a target that have been
+ * invalidated (must be redrawn) as a small set of rectangles. Overlapping
+ * or nearby rectangles are merged when the merged rectangle does not cover
+ * more pixels than the rectangles that it replaces. Once the invalidated
+ * area exceeds the full frame threshold (fraction of the target area) the
+ * entire target will be considered dirty.
+ */
+class DirtyRegion
+{
+
+public:
+
+  //! Constructor
+  DirtyRegion( const int width = 0,
+	       const int height = 0,
+	       const double full_frame_threshold = s_default_full_frame_threshold );
+
+  //! Destructor
+  ~DirtyRegion()
+  { /* ... */ }
+
+  //! Get the width of the target
+  int getWidth() const;
+
+  //! Get the height of the target
+  int getHeight() const;
+
+  //! Set the size of the target
+  void setSize( const int width, const int height );
+
+  //! Get the full frame threshold (fraction of the target area)
+  double getFullFrameThreshold() const;
+
+  //! Set the full frame threshold (fraction of the target area)
+  void setFullFrameThreshold( const double full_frame_threshold );
+
+  //! Get the max number of rectangles
+  unsigned getMaxNumberOfRectangles() const;
+
+  //! Set the max number of rectangles
+  void setMaxNumberOfRectangles( const unsigned max_number_of_rectangles );
+
+  //! Invalidate an area of the target
+  void invalidate( const SDL_Rect& area );
+
+  //! Invalidate the entire target
+  void invalidateAll();
+
+  //! Check if the region is empty
+  bool isEmpty() const;
+
+  //! Check if the entire target is dirty
+  bool isFullFrame() const;
+
+  //! Check if an area intersects the region
+  bool intersects( const SDL_Rect& area ) const;
+
+  //! Get the rectangles that cover the region
+  const std::vector<SDL_Rect>& getRectangles() const;
+
+  //! Get the area of the region (pixels)
+  unsigned long getArea() const;
+
+  //! Remove all areas from the region
+  void clear();
+
+private:
+
+  // Calculate the area of a rectangle
+  static unsigned long calculateArea( const SDL_Rect& rectangle );
+
+  // The default full frame threshold
+  static const double s_default_full_frame_threshold;
+
+  // The default max number of rectangles
+  static const unsigned s_default_max_number_of_rectangles;
+
+  // The width of the target
+  int d_width;
+
+  // The height of the target
+  int d_height;
+
+  // The full frame threshold
+  double d_full_frame_threshold;
+
+  // The max number of rectangles
+  unsigned d_max_number_of_rectangles;
+
+  // Records if the entire target is dirty
+  bool d_full_frame;
+
+  // The rectangles that cover the region
+  std::vector<SDL_Rect> d_rectangles;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_DIRTY_REGION_HPP
+
+//---------------------------------------------------------------------------//
+// end DirtyRegion.hpp
+//---------------------------------------------------------------------------//
@@ -6,10 +6,20 @@
 //!
 //---------------------------------------------------------------------------//
 
+// Std Lib Includes
+#include <cmath>
+#include <algorithm>
+
 // GDev Includes
 #include "Ellipse.hpp"
 #include "DBCMacros.hpp"
 
+// The SIMD kernels are only available with gcc compatible x86 compilers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GDEV_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace GDev{
 
 // Constructor
@@ -114,6 +124,165 @@ bool Ellipse::isPointOn( const int x_position,
   return is_on;
 }
 
+// Check if points are in (or on) the shape (one mask bit per point)
+/*! \details The points are tested with the reciprocal axis squares so that
+ * there are no divisions in the kernels. A point that is within rounding
+ * error of the ellipse can therefore get a different result than the one
+ * returned by isPointIn (e.g. (5,72) relative to the center of a 13x78
+ * ellipse). Every kernel returns identical results.
+ */
+void Ellipse::arePointsIn( const int* x_positions,
+			   const int* y_positions,
+			   const unsigned number_of_points,
+			   Uint32* mask ) const
+{
+  PointTestCoefficients coefficients = 
+    {(double)d_center_x_position,
+     (double)d_center_y_position,
+     1.0/((double)d_x_axis_size*d_x_axis_size),
+     1.0/((double)d_y_axis_size*d_y_axis_size),
+     0.0, 0.0,
+     false};
+
+  Ellipse::testPoints( x_positions,
+		       y_positions,
+		       number_of_points,
+		       coefficients,
+		       mask );
+}
+
+// Check if points are on the shape boundary (one mask bit per point)
+/*! \details A point that is within rounding error of one of the ellipses can
+ * get a different result than the one returned by isPointOn (see 
+ * arePointsIn). An edge that is as thick as an axis gives an infinite
+ * reciprocal axis square, which passes every point like evaluateInner does.
+ */
+void Ellipse::arePointsOn( const int* x_positions,
+			   const int* y_positions,
+			   const unsigned number_of_points,
+			   Uint32* mask ) const
+{
+  if( d_edge_thickness > 0u )
+  {
+    // The inner axis sizes are computed like in evaluateInner
+    const double inner_x_axis_size = d_x_axis_size - d_edge_thickness;
+    const double inner_y_axis_size = d_y_axis_size - d_edge_thickness;
+    
+    PointTestCoefficients coefficients = 
+      {(double)d_center_x_position,
+       (double)d_center_y_position,
+       1.0/((double)d_x_axis_size*d_x_axis_size),
+       1.0/((double)d_y_axis_size*d_y_axis_size),
+       1.0/(inner_x_axis_size*inner_x_axis_size),
+       1.0/(inner_y_axis_size*inner_y_axis_size),
+       true};
+
+    Ellipse::testPoints( x_positions,
+			 y_positions,
+			 number_of_points,
+			 coefficients,
+			 mask );
+  }
+  else
+    Shape::clearMask( number_of_points, mask );
+}
+
+// Get the geometry parameters
+bool Ellipse::getGeometry( ShapeGeometry& geometry ) const
+{
+  geometry[0] = d_x_axis_size;
+  geometry[1] = d_y_axis_size;
+  geometry[2] = d_edge_thickness;
+  geometry[3] = 0;
+  geometry[4] = 0;
+
+  return true;
+}
+
+// Check if the row spans are computed without testing every pixel
+bool Ellipse::hasAnalyticRowSpans() const
+{
+  return true;
+}
+
+// Get the coverage spans of a bounding box row
+/*! \details The ellipse coverage only depends on the distance from the 
+ * center x position. The boundary offsets are estimated analytically and then
+ * refined with the ellipse equations so that the spans agree exactly with
+ * isPointOn and isPointIn. An edge that is at least as thick as one of the
+ * axes degenerates the inner ellipse - the generic spans are used then.
+ */
+void Ellipse::getRowSpans( const int y_position,
+			   std::vector<ShapeSpan>& spans ) const
+{
+  // Make sure the row is in the bounding box
+  testPrecondition( y_position >= this->getBoundingBoxYPosition() );
+  testPrecondition( y_position < this->getBoundingBoxYPosition() +
+		    this->getBoundingBoxHeight() );
+
+  if( d_edge_thickness >= (unsigned)d_x_axis_size ||
+      d_edge_thickness >= (unsigned)d_y_axis_size )
+  {
+    Shape::getRowSpans( y_position, spans );
+  }
+  else
+  {
+    spans.clear();
+    
+    const int start_x_position = d_center_x_position - d_x_axis_size;
+    const int end_x_position = d_center_x_position + d_x_axis_size;
+    
+    // Pixels with a larger offset are outside of the ellipse
+    const int max_outer_offset = this->findMaxOuterXOffset( y_position );
+
+    if( max_outer_offset < 0 )
+    {
+      Shape::addSpan( spans, start_x_position, end_x_position, OUTSIDE_SHAPE );
+    }
+    else
+    {
+      // Pixels with a smaller offset are inside of the ellipse
+      int min_edge_offset = max_outer_offset + 1;
+
+      if( d_edge_thickness > 0u )
+      {
+	min_edge_offset = std::min( this->findMinInnerXOffset( y_position ),
+				    min_edge_offset );
+      }
+
+      // Left half of the row (negative offsets)
+      Shape::addSpan( spans, 
+		      start_x_position,
+		      d_center_x_position - max_outer_offset,
+		      OUTSIDE_SHAPE );
+      Shape::addSpan( spans,
+		      d_center_x_position - max_outer_offset,
+		      d_center_x_position - std::max( min_edge_offset, 1 ) + 1,
+		      ON_SHAPE_EDGE );
+      Shape::addSpan( spans,
+		      d_center_x_position - min_edge_offset + 1,
+		      d_center_x_position,
+		      INSIDE_SHAPE );
+
+      // Right half of the row (non-negative offsets)
+      Shape::addSpan( spans,
+		      d_center_x_position,
+		      std::min( d_center_x_position + min_edge_offset, 
+				end_x_position ),
+		      INSIDE_SHAPE );
+      Shape::addSpan( spans,
+		      d_center_x_position + min_edge_offset,
+		      std::min( d_center_x_position + max_outer_offset + 1,
+				end_x_position ),
+		      ON_SHAPE_EDGE );
+      Shape::addSpan( spans,
+		      d_center_x_position + max_outer_offset + 1,
+		      end_x_position,
+		      OUTSIDE_SHAPE );
+    }
+  }
+}
+
 // Evaluate the outer ellipse equation (== 0.0 on, > 0.0 out, < 0.0 in)
 double Ellipse::evaluateOuter( const double x_position, 
 			       const double y_position ) const
@@ -142,6 +311,312 @@ double Ellipse::evaluateInner( const double x_position,
   return x_term + y_term - 1.0;    
 }
 
+// Find the largest x offset from the center that is in the outer ellipse
+/*! \details The offset will be in [-1,a], where -1 indicates that no pixel
+ * in the row is in the outer ellipse.
+ */
+int Ellipse::findMaxOuterXOffset( const int y_position ) const
+{
+  double y_term = (y_position - d_center_y_position)/(double)d_y_axis_size;
+  y_term *= y_term;
+
+  int offset;
+
+  if( y_term > 1.0 )
+    offset = -1;
+  else
+  {
+    offset = (int)std::floor( d_x_axis_size*std::sqrt( 1.0 - y_term ) );
+    offset = std::min( std::max( offset, -1 ), d_x_axis_size );
+  }
+
+  // Correct the estimate using the exact ellipse equation
+  while( offset < d_x_axis_size &&
+	 this->evaluateOuter( d_center_x_position + offset + 1, 
+			      y_position ) <= 0.0 )
+    ++offset;
+
+  while( offset >= 0 &&
+	 this->evaluateOuter( d_center_x_position + offset,
+			      y_position ) > 0.0 )
+    --offset;
+
+  return offset;
+}
+
+// Find the smallest x offset from the center that is out of the inner ellipse
+/*! \details The offset will be in [0,a+1], where a+1 indicates that no pixel
+ * in the row is out of the inner ellipse. Points on the inner ellipse are
+ * considered to be out of it.
+ */
+int Ellipse::findMinInnerXOffset( const int y_position ) const
+{
+  const int inner_x_axis_size = d_x_axis_size - d_edge_thickness;
+  const int inner_y_axis_size = d_y_axis_size - d_edge_thickness;
+  
+  double y_term = 
+    (y_position - d_center_y_position)/(double)inner_y_axis_size;
+  y_term *= y_term;
+
+  int offset;
+
+  if( y_term >= 1.0 )
+    offset = 0;
+  else
+  {
+    offset = (int)std::ceil( inner_x_axis_size*std::sqrt( 1.0 - y_term ) );
+    offset = std::min( std::max( offset, 0 ), d_x_axis_size + 1 );
+  }
+
+  // Correct the estimate using the exact ellipse equation
+  while( offset > 0 &&
+	 this->evaluateInner( d_center_x_position + offset - 1,
+			      y_position ) >= 0.0 )
+    --offset;
+
+  while( offset <= d_x_axis_size &&
+	 this->evaluateInner( d_center_x_position + offset,
+			      y_position ) < 0.0 )
+    ++offset;
+
+  return offset;
+}
+
+// Test points against the ellipses (one mask bit per point)
+/*! \details The SIMD kernels test the largest multiple of their width and
+ * the scalar kernel tests the remaining points.
+ */
+void Ellipse::testPoints( const int* x_positions,
+			  const int* y_positions,
+			  const unsigned number_of_points,
+			  const PointTestCoefficients& coefficients,
+			  Uint32* mask )
+{
+  Shape::clearMask( number_of_points, mask );
+
+  unsigned number_of_tested_points = 0u;
+
+  switch( Shape::getKernel() )
+  {
+  case AVX2_KERNEL:
+    number_of_tested_points = Ellipse::testPointsAVX2( x_positions,
+						       y_positions,
+						       number_of_points,
+						       coefficients,
+						       mask );
+    break;
+  case SSE2_KERNEL:
+    number_of_tested_points = Ellipse::testPointsSSE2( x_positions,
+						       y_positions,
+						       number_of_points,
+						       coefficients,
+						       mask );
+    break;
+  default:
+    break;
+  }
+
+  Ellipse::testPointsScalar( x_positions,
+			     y_positions,
+			     number_of_tested_points,
+			     number_of_points,
+			     coefficients,
+			     mask );
+}
+
+// Test points against the ellipses (scalar kernel)
+/*! \details The mask bits of the points must already be cleared. The
+ * operations are done in the same order as in the SIMD kernels so that the
+ * results are identical. The comparisons are negated so that a NaN (from
+ * an infinite inner reciprocal axis square) passes the inner test.
+ */
+void Ellipse::testPointsScalar( const int* x_positions,
+				const int* y_positions,
+				const unsigned start_point_index,
+				const unsigned end_point_index,
+				const PointTestCoefficients& coefficients,
+				Uint32* mask )
+{
+  for( unsigned i = start_point_index; i < end_point_index; ++i )
+  {
+    const double x_offset = x_positions[i] - coefficients.center_x;
+    const double y_offset = y_positions[i] - coefficients.center_y;
+
+    const double x_squared = x_offset*x_offset;
+    const double y_squared = y_offset*y_offset;
+
+    bool passed = !(x_squared*coefficients.outer_x + 
+		    y_squared*coefficients.outer_y > 1.0);
+
+    if( passed && coefficients.test_inner )
+    {
+      passed = !(x_squared*coefficients.inner_x +
+		 y_squared*coefficients.inner_y < 1.0);
+    }
+
+    if( passed )
+      Shape::setMaskBit( mask, i );
+  }
+}
+
+#ifdef GDEV_X86_SIMD_KERNELS
+
+// Test points against the ellipses (SSE2 kernel)
+/*! \details Four points are tested at a time (two per double register).
+ * The number of tested points is returned.
+ */
+__attribute__((target("sse2")))
+unsigned Ellipse::testPointsSSE2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestCoefficients& coefficients,
+				  Uint32* mask )
+{
+  const __m128d center_x = _mm_set1_pd( coefficients.center_x );
+  const __m128d center_y = _mm_set1_pd( coefficients.center_y );
+  const __m128d outer_x = _mm_set1_pd( coefficients.outer_x );
+  const __m128d outer_y = _mm_set1_pd( coefficients.outer_y );
+  const __m128d inner_x = _mm_set1_pd( coefficients.inner_x );
+  const __m128d inner_y = _mm_set1_pd( coefficients.inner_y );
+  const __m128d one = _mm_set1_pd( 1.0 );
+
+  unsigned i = 0u;
+
+  for( ; i + 4u <= number_of_points; i += 4u )
+  {
+    const __m128i x = _mm_loadu_si128(
+		       reinterpret_cast<const __m128i*>( x_positions + i ) );
+    const __m128i y = _mm_loadu_si128(
+		       reinterpret_cast<const __m128i*>( y_positions + i ) );
+
+    int passed = 0;
+
+    // Test the low pair and then the high pair of points
+    for( int half = 0; half < 2; ++half )
+    {
+      const __m128i half_x = half == 0 ? x : _mm_unpackhi_epi64( x, x );
+      const __m128i half_y = half == 0 ? y : _mm_unpackhi_epi64( y, y );
+
+      const __m128d x_offset = _mm_sub_pd( _mm_cvtepi32_pd( half_x ), 
+					   center_x );
+      const __m128d y_offset = _mm_sub_pd( _mm_cvtepi32_pd( half_y ), 
+					   center_y );
+
+      const __m128d x_squared = _mm_mul_pd( x_offset, x_offset );
+      const __m128d y_squared = _mm_mul_pd( y_offset, y_offset );
+
+      __m128d result = _mm_cmpngt_pd( 
+		       _mm_add_pd( _mm_mul_pd( x_squared, outer_x ),
+				   _mm_mul_pd( y_squared, outer_y ) ),
+		       one );
+
+      if( coefficients.test_inner )
+      {
+	result = _mm_and_pd( result, _mm_cmpnlt_pd(
+		       _mm_add_pd( _mm_mul_pd( x_squared, inner_x ),
+				   _mm_mul_pd( y_squared, inner_y ) ),
+		       one ) );
+      }
+
+      passed |= _mm_movemask_pd( result ) << (2*half);
+    }
+
+    mask[i/32u] |= (Uint32)passed << (i%32u);
+  }
+
+  return i;
+}
+
+// Test points against the ellipses (AVX2 kernel)
+/*! \details Eight points are tested at a time (four per double register).
+ * FMA instructions are not used so that the results are identical to the
+ * ones from the other kernels. The number of tested points is returned.
+ */
+__attribute__((target("avx2")))
+unsigned Ellipse::testPointsAVX2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestCoefficients& coefficients,
+				  Uint32* mask )
+{
+  const __m256d center_x = _mm256_set1_pd( coefficients.center_x );
+  const __m256d center_y = _mm256_set1_pd( coefficients.center_y );
+  const __m256d outer_x = _mm256_set1_pd( coefficients.outer_x );
+  const __m256d outer_y = _mm256_set1_pd( coefficients.outer_y );
+  const __m256d inner_x = _mm256_set1_pd( coefficients.inner_x );
+  const __m256d inner_y = _mm256_set1_pd( coefficients.inner_y );
+  const __m256d one = _mm256_set1_pd( 1.0 );
+
+  unsigned i = 0u;
+
+  for( ; i + 8u <= number_of_points; i += 8u )
+  {
+    int passed = 0;
+
+    // Test the low four and then the high four points
+    for( unsigned half = 0u; half < 2u; ++half )
+    {
+      const __m128i x = _mm_loadu_si128(
+	      reinterpret_cast<const __m128i*>( x_positions + i + 4u*half ) );
+      const __m128i y = _mm_loadu_si128(
+	      reinterpret_cast<const __m128i*>( y_positions + i + 4u*half ) );
+
+      const __m256d x_offset = _mm256_sub_pd( _mm256_cvtepi32_pd( x ), 
+					      center_x );
+      const __m256d y_offset = _mm256_sub_pd( _mm256_cvtepi32_pd( y ), 
+					      center_y );
+
+      const __m256d x_squared = _mm256_mul_pd( x_offset, x_offset );
+      const __m256d y_squared = _mm256_mul_pd( y_offset, y_offset );
+
+      __m256d result = _mm256_cmp_pd( 
+		       _mm256_add_pd( _mm256_mul_pd( x_squared, outer_x ),
+				      _mm256_mul_pd( y_squared, outer_y ) ),
+		       one,
+		       _CMP_NGT_UQ );
+
+      if( coefficients.test_inner )
+      {
+	result = _mm256_and_pd( result, _mm256_cmp_pd(
+		       _mm256_add_pd( _mm256_mul_pd( x_squared, inner_x ),
+				      _mm256_mul_pd( y_squared, inner_y ) ),
+		       one,
+		       _CMP_NLT_UQ ) );
+      }
+
+      passed |= _mm256_movemask_pd( result ) << (4u*half);
+    }
+
+    mask[i/32u] |= (Uint32)passed << (i%32u);
+  }
+
+  return i;
+}
+
+#else // GDEV_X86_SIMD_KERNELS
+
+// Test points against the ellipses (SSE2 kernel - not available)
+unsigned Ellipse::testPointsSSE2( const int*,
+				  const int*,
+				  const unsigned,
+				  const PointTestCoefficients&,
+				  Uint32* )
+{
+  return 0u;
+}
+
+// Test points against the ellipses (AVX2 kernel - not available)
+unsigned Ellipse::testPointsAVX2( const int*,
+				  const int*,
+				  const unsigned,
+				  const PointTestCoefficients&,
+				  Uint32* )
+{
+  return 0u;
+}
+
+#endif // end GDEV_X86_SIMD_KERNELS
+
 } // end GDev namespace
 
 //---------------------------------------------------------------------------//
@@ -65,8 +65,76 @@ public:
   bool isPointOn( const int x_position,
 		  const int y_position ) const;
 
+  //! Check if points are in (or on) the shape (one mask bit per point)
+  void arePointsIn( const int* x_positions,
+		    const int* y_positions,
+		    const unsigned number_of_points,
+		    Uint32* mask ) const;
+
+  //! Check if points are on the shape boundary (one mask bit per point)
+  void arePointsOn( const int* x_positions,
+		    const int* y_positions,
+		    const unsigned number_of_points,
+		    Uint32* mask ) const;
+
+  //! Get the geometry parameters
+  bool getGeometry( ShapeGeometry& geometry ) const;
+
+  //! Check if the row spans are computed without testing every pixel
+  bool hasAnalyticRowSpans() const;
+
+  //! Get the coverage spans of a bounding box row
+  void getRowSpans( const int y_position,
+		    std::vector<ShapeSpan>& spans ) const;
+
 private:
 
+  // The point test coefficients (a point passes if it is in the outer
+  // ellipse and, when the inner ellipse is tested, not in the inner ellipse)
+  struct PointTestCoefficients
+  {
+    // The center position
+    double center_x, center_y;
+
+    // The outer ellipse reciprocal axis squares (1/a^2 and 1/b^2)
+    double outer_x, outer_y;
+
+    // The inner ellipse reciprocal axis squares
+    double inner_x, inner_y;
+
+    // Flag that indicates if the inner ellipse is tested
+    bool test_inner;
+  };
+
+  // Test points against the ellipses (one mask bit per point)
+  static void testPoints( const int* x_positions,
+			  const int* y_positions,
+			  const unsigned number_of_points,
+			  const PointTestCoefficients& coefficients,
+			  Uint32* mask );
+
+  // Test points against the ellipses (scalar kernel)
+  static void testPointsScalar( const int* x_positions,
+				const int* y_positions,
+				const unsigned start_point_index,
+				const unsigned end_point_index,
+				const PointTestCoefficients& coefficients,
+				Uint32* mask );
+
+  // Test points against the ellipses (SSE2 kernel)
+  static unsigned testPointsSSE2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestCoefficients& coefficients,
+				  Uint32* mask );
+
+  // Test points against the ellipses (AVX2 kernel)
+  static unsigned testPointsAVX2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestCoefficients& coefficients,
+				  Uint32* mask );
+
   // Evaluate the outer ellipse equation (== 0.0 on, > 0.0 out, < 0.0 in)
   double evaluateOuter( const double x_position, 
 			const double y_position ) const;
@@ -75,6 +143,12 @@ private:
   double evaluateInner( const double x_position,
 			const double y_position ) const;
 
+  // Find the largest x offset from the center that is in the outer ellipse
+  int findMaxOuterXOffset( const int y_position ) const;
+
+  // Find the smallest x offset from the center that is out of the inner ellipse
+  int findMinInnerXOffset( const int y_position ) const;
+
   // The center x position
   int d_center_x_position;
 
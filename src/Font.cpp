@@ -6,17 +6,48 @@
 //!
 //---------------------------------------------------------------------------//
 
+// Std Lib Includes
+#include <algorithm>
+
 // SDL Includes
 #include "Font.hpp"
+#include "Renderer.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureRegion.hpp"
+#include "SpriteBatch.hpp"
 #include "ExceptionTestMacros.hpp"
 #include "DBCMacros.hpp"
 
 namespace GDev{
 
+// The glyph atlas of a renderer
+struct Font::GlyphAtlas
+{
+  // Constructor
+  GlyphAtlas( const std::shared_ptr<Renderer>& renderer )
+    : atlas( renderer, 512, 512 ),
+      regions()
+  { /* ... */ }
+
+  // The atlas that stores the glyph surfaces
+  TextureAtlas atlas;
+
+  // The glyph regions (empty if the glyph could not be rasterized)
+  std::map<Uint16,TextureRegion> regions;
+};
+
 // Constructor
 Font::Font( const std::string& font_filename, const unsigned font_size )
   : d_font( NULL ),
-    d_font_size( font_size )
+    d_font_filename( font_filename ),
+    d_font_size( font_size ),
+    d_height( 0 ),
+    d_line_skip( 0 ),
+    d_kerning( false ),
+    d_glyph_metrics(),
+    d_kerning_cache(),
+    d_glyph_atlases(),
+    d_positioned_glyphs()
 {
   // Make sure the font filename is valid
   testPrecondition( font_filename.size() > 0 );
@@ -29,6 +60,75 @@ Font::Font( const std::string& font_filename, const unsigned font_size )
 		      ExceptionType,
 		      "Unable to load font from file " << font_filename <<
 		      "! SDL_ttf Error: " << TTF_GetError() );
+
+  d_height = TTF_FontHeight( d_font );
+  d_line_skip = TTF_FontLineSkip( d_font );
+  d_kerning = (TTF_GetFontKerning( d_font ) != 0);
+}
+
+// Move constructor
+/*! \details The TTF font, the cached metrics and the glyph atlases are
+ * transferred. The other font will be empty (it can only be destroyed or
+ * assigned to).
+ */
+Font::Font( Font&& other_font )
+  : d_font( other_font.d_font ),
+    d_font_filename( std::move( other_font.d_font_filename ) ),
+    d_font_size( other_font.d_font_size ),
+    d_height( other_font.d_height ),
+    d_line_skip( other_font.d_line_skip ),
+    d_kerning( other_font.d_kerning ),
+    d_glyph_metrics( std::move( other_font.d_glyph_metrics ) ),
+    d_kerning_cache( std::move( other_font.d_kerning_cache ) ),
+    d_glyph_atlases( std::move( other_font.d_glyph_atlases ) ),
+    d_positioned_glyphs( std::move( other_font.d_positioned_glyphs ) )
+{
+  other_font.d_font = NULL;
+  other_font.d_font_filename.clear();
+  other_font.d_font_size = 0u;
+  other_font.d_height = 0;
+  other_font.d_line_skip = 0;
+  other_font.d_kerning = false;
+  other_font.d_glyph_metrics.clear();
+  other_font.d_kerning_cache.clear();
+  other_font.d_glyph_atlases.clear();
+  other_font.d_positioned_glyphs.clear();
+}
+
+// Move assignment operator
+/*! \details The current font and its glyph atlases will be freed before 
+ * the other font is transferred.
+ */
+Font& Font::operator=( Font&& other_font )
+{
+  if( this != &other_font )
+  {
+    this->free();
+
+    d_font = other_font.d_font;
+    d_font_filename = std::move( other_font.d_font_filename );
+    d_font_size = other_font.d_font_size;
+    d_height = other_font.d_height;
+    d_line_skip = other_font.d_line_skip;
+    d_kerning = other_font.d_kerning;
+    d_glyph_metrics = std::move( other_font.d_glyph_metrics );
+    d_kerning_cache = std::move( other_font.d_kerning_cache );
+    d_glyph_atlases = std::move( other_font.d_glyph_atlases );
+    d_positioned_glyphs = std::move( other_font.d_positioned_glyphs );
+
+    other_font.d_font = NULL;
+    other_font.d_font_filename.clear();
+    other_font.d_font_size = 0u;
+    other_font.d_height = 0;
+    other_font.d_line_skip = 0;
+    other_font.d_kerning = false;
+    other_font.d_glyph_metrics.clear();
+    other_font.d_kerning_cache.clear();
+    other_font.d_glyph_atlases.clear();
+    other_font.d_positioned_glyphs.clear();
+  }
+
+  return *this;
 }
 
 // Destructor
@@ -37,12 +137,173 @@ Font::~Font()
   this->free();
 }
 
+// Get the font filename
+const std::string& Font::getFontFilename() const
+{
+  return d_font_filename;
+}
+
 // Get the font size
 unsigned Font::getFontSize() const
 {
   return d_font_size;
 }
 
+// Get the font height (pixels)
+int Font::getHeight() const
+{
+  return d_height;
+}
+
+// Get the font line skip (pixels)
+int Font::getLineSkip() const
+{
+  return d_line_skip;
+}
+
+// Get the size of rendered text (pixels)
+/*! \details Only the cached glyph metrics are used once the glyphs of the
+ * text have been used. New lines start a new line of text. The width of a
+ * line is measured from the left most to the right most glyph surface edge
+ * (like TTF_SizeText).
+ */
+void Font::getTextSize( const std::string& text, int& width, int& height )
+{
+  width = 0;
+  height = 0;
+
+  if( text.size() > 0 )
+  {
+    int pen_x = 0;
+    int min_x = 0;
+    int max_x = 0;
+
+    Uint16 previous_glyph = 0;
+
+    height = d_height;
+
+    for( unsigned i = 0; i < text.size(); ++i )
+    {
+      if( text[i] == '\n' )
+      {
+	width = std::max( width, max_x - min_x );
+
+	pen_x = 0;
+	min_x = 0;
+	max_x = 0;
+	previous_glyph = 0;
+	height += d_line_skip;
+
+	continue;
+      }
+
+      Uint16 glyph = (unsigned char)text[i];
+
+      if( previous_glyph != 0 )
+	pen_x += this->getKerning( previous_glyph, glyph );
+
+      const GlyphMetrics& metrics = this->getGlyphMetrics( glyph );
+
+      min_x = std::min( min_x, pen_x + metrics.x_offset );
+      max_x = std::max( max_x, pen_x + metrics.x_extent );
+
+      pen_x += metrics.advance;
+
+      previous_glyph = glyph;
+    }
+
+    width = std::max( width, max_x - min_x );
+  }
+}
+
+// Render text at the desired point
+/*! \details The glyphs are rendered from the glyph atlas of the renderer
+ * (rasterized glyphs are added to the atlas as needed). The top left corner
+ * of the text will be placed at the desired point.
+ */
+void Font::renderText( const std::shared_ptr<Renderer>& renderer,
+		       const std::string& text,
+		       const int target_x_position,
+		       const int target_y_position,
+		       const SDL_Color& text_color )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+
+  GlyphAtlas& glyph_atlas = this->getGlyphAtlas( renderer );
+
+  this->layoutText( glyph_atlas, text, target_x_position, target_y_position );
+
+  Font::setGlyphAtlasColor( glyph_atlas, text_color );
+
+  for( unsigned i = 0; i < d_positioned_glyphs.size(); ++i )
+  {
+    d_positioned_glyphs[i].region->render( d_positioned_glyphs[i].x_position,
+					   d_positioned_glyphs[i].y_position );
+  }
+
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+  Font::setGlyphAtlasColor( glyph_atlas, white );
+}
+
+// Add text at the desired point to a sprite batch
+/*! \details The text color is recorded by the sprite batch. Text that
+ * uses the same font, renderer and color will be rendered in a single
+ * sprite group.
+ */
+void Font::addText( SpriteBatch& batch,
+		    const std::shared_ptr<Renderer>& renderer,
+		    const int layer,
+		    const std::string& text,
+		    const int target_x_position,
+		    const int target_y_position,
+		    const SDL_Color& text_color )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+
+  GlyphAtlas& glyph_atlas = this->getGlyphAtlas( renderer );
+
+  this->layoutText( glyph_atlas, text, target_x_position, target_y_position );
+
+  Font::setGlyphAtlasColor( glyph_atlas, text_color );
+
+  for( unsigned i = 0; i < d_positioned_glyphs.size(); ++i )
+  {
+    batch.add( *d_positioned_glyphs[i].region,
+	       layer,
+	       d_positioned_glyphs[i].x_position,
+	       d_positioned_glyphs[i].y_position );
+  }
+
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+  Font::setGlyphAtlasColor( glyph_atlas, white );
+}
+
+// Get the number of glyphs in the glyph atlas of a renderer
+unsigned Font::getNumberOfCachedGlyphs(
+			    const std::shared_ptr<Renderer>& renderer ) const
+{
+  std::map<const Renderer*,std::shared_ptr<GlyphAtlas> >::const_iterator
+    glyph_atlas = d_glyph_atlases.find( renderer.get() );
+
+  if( glyph_atlas != d_glyph_atlases.end() )
+    return glyph_atlas->second->regions.size();
+  else
+    return 0u;
+}
+
+// Release the glyph atlas of a renderer
+/*! \details The glyph atlas keeps the renderer alive. Release the atlas
+ * when text will no longer be rendered with the renderer.
+ */
+void Font::releaseGlyphAtlas( const std::shared_ptr<Renderer>& renderer )
+{
+  d_glyph_atlases.erase( renderer.get() );
+}
+
 // Get the raw font pointer (potentially dangerous)
 /*! \details Use this with the SDL C interface when necessary.
  */
@@ -59,15 +320,209 @@ TTF_Font* Font::getRawFontPtr()
   return d_font;
 }
 
+// Get the glyph metrics
+/*! \details The glyph surface starts at the left edge of the glyph when
+ * the glyph extends to the left of the pen position.
+ */
+const Font::GlyphMetrics& Font::getGlyphMetrics( const Uint16 glyph )
+{
+  std::map<Uint16,GlyphMetrics>::iterator metrics =
+    d_glyph_metrics.find( glyph );
+
+  if( metrics == d_glyph_metrics.end() )
+  {
+    GlyphMetrics new_metrics;
+
+    int min_x, max_x, min_y, max_y, advance;
+
+    if( TTF_GlyphMetrics( d_font, glyph,
+			  &min_x, &max_x, &min_y, &max_y, &advance ) == 0 )
+    {
+      new_metrics.advance = advance;
+      new_metrics.x_offset = std::min( min_x, 0 );
+      new_metrics.x_extent = std::max( max_x, advance );
+    }
+    else
+    {
+      new_metrics.advance = 0;
+      new_metrics.x_offset = 0;
+      new_metrics.x_extent = 0;
+    }
+
+    metrics = d_glyph_metrics.insert(
+			   std::make_pair( glyph, new_metrics ) ).first;
+  }
+
+  return metrics->second;
+}
+
+// Get the kerning between two glyphs
+/*! \details The kerning is the change in the pen position between the two
+ * glyphs. Older versions of SDL_ttf cannot return the kerning of a glyph
+ * pair, so it is recovered from the width of the pair text instead. The
+ * width of the pair text is measured from the left edge of the first glyph
+ * surface to the right edge of the second glyph surface, so the bearings of
+ * both glyphs must be removed (only the pen positions may differ).
+ */
+int Font::getKerning( const Uint16 previous_glyph, const Uint16 glyph )
+{
+  if( !d_kerning )
+    return 0;
+
+  std::pair<Uint16,Uint16> glyph_pair( previous_glyph, glyph );
+
+  std::map<std::pair<Uint16,Uint16>,int>::const_iterator kerning =
+    d_kerning_cache.find( glyph_pair );
+
+  if( kerning == d_kerning_cache.end() )
+  {
+#if SDL_VERSIONNUM(SDL_TTF_MAJOR_VERSION, SDL_TTF_MINOR_VERSION, \
+		   SDL_TTF_PATCHLEVEL) >= SDL_VERSIONNUM(2, 0, 14)
+    int pair_kerning =
+      TTF_GetFontKerningSizeGlyphs( d_font, previous_glyph, glyph );
+#else
+    const char pair_text[3] = {(char)previous_glyph, (char)glyph, '\0'};
+
+    int pair_width, height;
+
+    int pair_kerning = 0;
+
+    if( TTF_SizeText( d_font, pair_text, &pair_width, &height ) == 0 )
+    {
+      const GlyphMetrics& previous_metrics =
+	this->getGlyphMetrics( previous_glyph );
+
+      const GlyphMetrics& metrics = this->getGlyphMetrics( glyph );
+
+      pair_kerning = pair_width + previous_metrics.x_offset -
+	previous_metrics.advance - metrics.x_extent;
+    }
+#endif
+
+    kerning = d_kerning_cache.insert(
+			   std::make_pair( glyph_pair, pair_kerning ) ).first;
+  }
+
+  return kerning->second;
+}
+
+// Get the glyph atlas of a renderer (created if necessary)
+Font::GlyphAtlas&
+Font::getGlyphAtlas( const std::shared_ptr<Renderer>& renderer )
+{
+  std::shared_ptr<GlyphAtlas>& glyph_atlas = d_glyph_atlases[renderer.get()];
+
+  if( !glyph_atlas )
+    glyph_atlas.reset( new GlyphAtlas( renderer ) );
+
+  return *glyph_atlas;
+}
+
+// Get the region of a glyph (rasterized if necessary)
+/*! \details The glyph is rasterized in white so that the text color can be
+ * set with the texture color and alpha modulation.
+ */
+const TextureRegion& Font::getGlyphRegion( GlyphAtlas& glyph_atlas,
+					   const Uint16 glyph )
+{
+  std::map<Uint16,TextureRegion>::const_iterator region =
+    glyph_atlas.regions.find( glyph );
+
+  if( region == glyph_atlas.regions.end() )
+  {
+    TextureRegion new_region;
+
+    const char glyph_text[2] = {(char)glyph, '\0'};
+
+    SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+    std::unique_ptr<SDL_Surface,void (*)(SDL_Surface*)> glyph_surface(
+		      TTF_RenderText_Blended( d_font, glyph_text, white ),
+		      SDL_FreeSurface );
+
+    if( glyph_surface )
+      new_region = glyph_atlas.atlas.insert( Surface( glyph_surface.get() ) );
+
+    region = glyph_atlas.regions.insert(
+			       std::make_pair( glyph, new_region ) ).first;
+  }
+
+  return region->second;
+}
+
+// Position the glyphs of the text
+void Font::layoutText( GlyphAtlas& glyph_atlas,
+		       const std::string& text,
+		       const int target_x_position,
+		       const int target_y_position )
+{
+  d_positioned_glyphs.clear();
+
+  int pen_x = target_x_position;
+  int pen_y = target_y_position;
+
+  Uint16 previous_glyph = 0;
+
+  for( unsigned i = 0; i < text.size(); ++i )
+  {
+    if( text[i] == '\n' )
+    {
+      pen_x = target_x_position;
+      pen_y += d_line_skip;
+      previous_glyph = 0;
+
+      continue;
+    }
+
+    Uint16 glyph = (unsigned char)text[i];
+
+    if( previous_glyph != 0 )
+      pen_x += this->getKerning( previous_glyph, glyph );
+
+    const GlyphMetrics& metrics = this->getGlyphMetrics( glyph );
+
+    const TextureRegion& region = this->getGlyphRegion( glyph_atlas, glyph );
+
+    if( !region.isEmpty() )
+    {
+      PositionedGlyph positioned_glyph;
+      positioned_glyph.region = &region;
+      positioned_glyph.x_position = pen_x + metrics.x_offset;
+      positioned_glyph.y_position = pen_y;
+
+      d_positioned_glyphs.push_back( positioned_glyph );
+    }
+
+    pen_x += metrics.advance;
+
+    previous_glyph = glyph;
+  }
+}
+
+// Set the color of the glyph atlas pages
+void Font::setGlyphAtlasColor( GlyphAtlas& glyph_atlas,
+			       const SDL_Color& color )
+{
+  for( unsigned i = 0; i < glyph_atlas.atlas.getNumberOfPages(); ++i )
+  {
+    const std::shared_ptr<Texture>& page = glyph_atlas.atlas.getPage( i );
+
+    page->setColorMod( color.r, color.g, color.b );
+    page->setAlphaMod( color.a );
+  }
+}
+
 // Free the font
 void Font::free()
 {
   // Close the font
-  TTF_CloseFont( d_font );
+  if( d_font != NULL )
+    TTF_CloseFont( d_font );
 
   d_font = NULL;
   
-  // Reset the font size
+  // Reset the font filename and size
+  d_font_filename.clear();
   d_font_size = 0u;
 }
 
@@ -11,6 +11,9 @@
 
 // Std Lib Includes
 #include <string>
+#include <vector>
+#include <map>
+#include <memory>
 #include <stdexcept>
 
 // Boost Includes
@@ -21,6 +24,11 @@
 
 namespace GDev{
 
+// Forward declare the renderer, texture region and sprite batch classes
+class Renderer;
+class TextureRegion;
+class SpriteBatch;
+
 //! The font exception class
 class FontException : public std::runtime_error
 {
@@ -34,8 +42,14 @@ public:
 };
 
 /*! The font wrapper class
- * \details The wrapper class does not allow copy construction or assignment.
- * If multiple "copies" are needed, use a smart pointer class.
+ * \details The wrapper class does not allow copy construction or assignment
+ * but fonts can be moved (the TTF font and the caches are transferred). If
+ * multiple "copies" are needed, use a smart pointer class. Text can be
+ * rendered directly with a renderer. The glyphs are rasterized once and
+ * stored in a glyph atlas that is kept for each renderer. The glyph metrics
+ * and kerning are also cached so that once the glyphs of a string have been
+ * used no SDL_ttf calls are needed to render the string. The text is
+ * treated as Latin-1 (like the text surface and texture constructors).
  */
 class Font : private boost::noncopyable
 {
@@ -48,12 +62,53 @@ public:
   //! Constructor
   Font( const std::string& font_filename, const unsigned font_size );
 
+  //! Move constructor
+  Font( Font&& other_font );
+
+  //! Move assignment operator
+  Font& operator=( Font&& other_font );
+
   //! Destructor
   ~Font();
 
+  //! Get the font filename
+  const std::string& getFontFilename() const;
+
   //! Get the font size
   unsigned getFontSize() const;
 
+  //! Get the font height (pixels)
+  int getHeight() const;
+
+  //! Get the font line skip (pixels)
+  int getLineSkip() const;
+
+  //! Get the size of rendered text (pixels)
+  void getTextSize( const std::string& text, int& width, int& height );
+
+  //! Render text at the desired point
+  void renderText( const std::shared_ptr<Renderer>& renderer,
+		   const std::string& text,
+		   const int target_x_position,
+		   const int target_y_position,
+		   const SDL_Color& text_color );
+
+  //! Add text at the desired point to a sprite batch
+  void addText( SpriteBatch& batch,
+		const std::shared_ptr<Renderer>& renderer,
+		const int layer,
+		const std::string& text,
+		const int target_x_position,
+		const int target_y_position,
+		const SDL_Color& text_color );
+
+  //! Get the number of glyphs in the glyph atlas of a renderer
+  unsigned getNumberOfCachedGlyphs(
+			   const std::shared_ptr<Renderer>& renderer ) const;
+
+  //! Release the glyph atlas of a renderer
+  void releaseGlyphAtlas( const std::shared_ptr<Renderer>& renderer );
+
   //! Get the raw font pointer (potentially dangerous)
   const TTF_Font* getRawFontPtr() const;
 
@@ -62,6 +117,58 @@ public:
 
 private:
 
+  // The glyph metrics
+  struct GlyphMetrics
+  {
+    // The horizontal advance
+    int advance;
+
+    // The horizontal offset of the glyph surface from the pen position
+    int x_offset;
+
+    // The right edge of the glyph surface relative to the pen position
+    int x_extent;
+  };
+
+  // The glyph atlas of a renderer (defined in Font.cpp)
+  struct GlyphAtlas;
+
+  // A glyph that has been positioned on the target
+  struct PositionedGlyph
+  {
+    // The glyph region
+    const TextureRegion* region;
+
+    // The target x position
+    int x_position;
+
+    // The target y position
+    int y_position;
+  };
+
+  // Get the glyph metrics
+  const GlyphMetrics& getGlyphMetrics( const Uint16 glyph );
+
+  // Get the kerning between two glyphs
+  int getKerning( const Uint16 previous_glyph, const Uint16 glyph );
+
+  // Get the glyph atlas of a renderer (created if necessary)
+  GlyphAtlas& getGlyphAtlas( const std::shared_ptr<Renderer>& renderer );
+
+  // Get the region of a glyph (rasterized if necessary)
+  const TextureRegion& getGlyphRegion( GlyphAtlas& glyph_atlas,
+				       const Uint16 glyph );
+
+  // Position the glyphs of the text
+  void layoutText( GlyphAtlas& glyph_atlas,
+		   const std::string& text,
+		   const int target_x_position,
+		   const int target_y_position );
+
+  // Set the color of the glyph atlas pages
+  static void setGlyphAtlasColor( GlyphAtlas& glyph_atlas,
+				  const SDL_Color& color );
+
   // Free the font
   void free();
 
@@ -71,8 +178,32 @@ private:
   // The TTF font
   TTF_Font* d_font;
 
+  // The font filename
+  std::string d_font_filename;
+
   // The font size
   unsigned d_font_size;
+
+  // The font height
+  int d_height;
+
+  // The font line skip
+  int d_line_skip;
+
+  // Records if kerning is used
+  bool d_kerning;
+
+  // The cached glyph metrics
+  std::map<Uint16,GlyphMetrics> d_glyph_metrics;
+
+  // The cached kerning
+  std::map<std::pair<Uint16,Uint16>,int> d_kerning_cache;
+
+  // The glyph atlases (one for each renderer)
+  std::map<const Renderer*,std::shared_ptr<GlyphAtlas> > d_glyph_atlases;
+
+  // The positioned glyphs of the last layout
+  std::vector<PositionedGlyph> d_positioned_glyphs;
 };
 
 } // end GDev namespace
@@ -19,7 +19,9 @@ namespace GDev{
 
 // Constructor
 /*! \details A NULL background color will result in the button area being
- * transparent.
+ * transparent. If a text texture cache is given the message textures will
+ * be taken from the cache (so rebuilding a button with an unchanged message
+ * does not render the message again).
  */
 GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			      const std::shared_ptr<const Shape>& button_area,
@@ -30,8 +32,10 @@ GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			      const SDL_Color& default_background_color,
 			      const SDL_Color& press_background_color,
 			      const SDL_Color& scroll_over_background_color,
-			      const SDL_Color& release_background_color )
-  : d_area( button_area )
+			      const SDL_Color& release_background_color,
+			      TextTextureCache* text_texture_cache )
+  : d_area( button_area ),
+    d_active_texture( NULL )
 {
   // Make sure the window renderer is valid
   testPrecondition( renderer );
@@ -48,7 +52,8 @@ GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			   font,
 			   text_color,
 			   edge_color,
-			   default_background_color );
+			   default_background_color,
+			   text_texture_cache );
 
   // Create the scroll over texture
   this->initializeTexture( d_scroll_over_texture,
@@ -58,7 +63,8 @@ GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			   font,
 			   text_color,
 			   edge_color,
-			   scroll_over_background_color );
+			   scroll_over_background_color,
+			   text_texture_cache );
 
   // Create the press texture
   this->initializeTexture( d_press_texture,
@@ -68,7 +74,8 @@ GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			   font,
 			   text_color,
 			   edge_color,
-			   press_background_color );
+			   press_background_color,
+			   text_texture_cache );
 
   // Create the release texture
   this->initializeTexture( d_release_texture,
@@ -78,10 +85,11 @@ GeneralButton::GeneralButton( const std::shared_ptr<WindowRenderer>& renderer,
 			   font,
 			   text_color,
 			   edge_color,
-			   release_background_color );
+			   release_background_color,
+			   text_texture_cache );
   
   // Set the active texture to the default texture
-  d_active_texture = d_default_texture;
+  d_active_texture = d_default_texture.get();
 }
 
 // Render the button
@@ -94,25 +102,25 @@ void GeneralButton::render() const
 // Handle default
 void GeneralButton::handleDefault()
 {
-  d_active_texture = d_default_texture;
+  d_active_texture = d_default_texture.get();
 }
   
 //! Handle button scroll over 
 void GeneralButton::handleButtonScrollOver()
 {
-  d_active_texture = d_scroll_over_texture;
+  d_active_texture = d_scroll_over_texture.get();
 }
 
 // Handle button press
 void GeneralButton::handleButtonPress()
 {
-  d_active_texture = d_press_texture;
+  d_active_texture = d_press_texture.get();
 }
 
 // Handle button release
 void GeneralButton::handleButtonRelease()
 {
-  d_active_texture = d_release_texture;
+  d_active_texture = d_release_texture.get();
 }
 
 // Test if the mouse position is inside of the button
@@ -135,7 +143,8 @@ void GeneralButton::initializeTexture(
 			       const Font& font,
 			       const SDL_Color& text_color,
 			       const SDL_Color& edge_color,
-			       const SDL_Color& background_color )
+			       const SDL_Color& background_color,
+			       TextTextureCache* text_texture_cache )
 {
   std::shared_ptr<TargetTexture> target_texture( new TargetTexture( 
 					 renderer,
@@ -146,11 +155,24 @@ void GeneralButton::initializeTexture(
   target_texture->setAsRenderTarget();
 
   // Create the message texture
-  StaticTexture message_texture( renderer,
-				 message,
-				 font,
-				 text_color,
-				 &background_color );
+  std::shared_ptr<StaticTexture> message_texture;
+
+  if( text_texture_cache != NULL )
+  {
+    message_texture = text_texture_cache->getTexture( renderer,
+						      message,
+						      font,
+						      text_color,
+						      &background_color );
+  }
+  else
+  {
+    message_texture.reset( new StaticTexture( renderer,
+					      message,
+					      font,
+					      text_color,
+					      &background_color ) );
+  }
   
   // Create the area texture
   SDL_Color outside_color = {0xFF,0xFF,0xFF,0};
@@ -162,7 +184,7 @@ void GeneralButton::initializeTexture(
 			      outside_color );
   
   // Render the textures to the target texture
-  message_texture.render();
+  message_texture->render();
   area_texture.render();
   
   target_texture->unsetAsRenderTarget();
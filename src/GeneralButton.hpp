@@ -18,6 +18,7 @@
 #include "Font.hpp"
 #include "WindowRenderer.hpp"
 #include "Texture.hpp"
+#include "TextTextureCache.hpp"
 
 namespace GDev{
 
@@ -37,7 +38,8 @@ public:
 		 const SDL_Color& default_background_color,
 		 const SDL_Color& press_background_color,
 		 const SDL_Color& scroll_over_background_color,
-		 const SDL_Color& release_background_color );
+		 const SDL_Color& release_background_color,
+		 TextTextureCache* text_texture_cache = NULL );
 		 
 
   //! Destructor
@@ -75,7 +77,8 @@ private:
 			       const Font& font,
 			       const SDL_Color& text_color,
 			       const SDL_Color& edge_color,
-			       const SDL_Color& background_color );
+			       const SDL_Color& background_color,
+			       TextTextureCache* text_texture_cache );
 
   // The button area
   std::shared_ptr<const Shape> d_area;
@@ -92,8 +95,8 @@ private:
   // The release button texture
   std::shared_ptr<Texture> d_release_texture;
 
-  // The active texture
-  std::shared_ptr<Texture> d_active_texture;
+  // The active texture (one of the button textures)
+  const Texture* d_active_texture;
 };
 
 } // end GDev namespace
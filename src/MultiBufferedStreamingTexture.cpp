@@ -0,0 +1,288 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MultiBufferedStreamingTexture.cpp
+//! \author Alex Robinson
+//! \brief  The multi-buffered streaming texture class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "MultiBufferedStreamingTexture.hpp"
+#include "StreamingTextureLock.hpp"
+#include "PixelFormatConverter.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Constructor
+/*! \details The staging buffers are allocated up front (rows are padded
+ * to a multiple of four bytes). The buffer pitch is computed from the
+ * texture format, which is resolved by the base class (e.g. the native
+ * format when SDL_PIXELFORMAT_UNKNOWN is passed).
+ */
+MultiBufferedStreamingTexture::MultiBufferedStreamingTexture(
+			       const std::shared_ptr<Renderer>& renderer,
+			       const int width,
+			       const int height,
+			       const unsigned number_of_buffers,
+			       const Uint32 format )
+  : StreamingTexture( renderer, width, height, format ),
+    d_number_of_buffers( number_of_buffers ),
+    d_buffer_pitch( 0 ),
+    d_buffers( new Buffer[number_of_buffers] ),
+    d_last_publication( 0ul ),
+    d_uploaded_publication( 0ul ),
+    d_number_of_dropped_buffers( 0ul )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+  // Make sure the number of buffers is valid
+  testPrecondition( number_of_buffers >= 2 );
+  // Make sure the format can be copied
+  testPrecondition( PixelFormatConverter::canConvert( this->getFormat(),
+						      this->getFormat() ) );
+
+  d_buffer_pitch = (width*SDL_BYTESPERPIXEL( this->getFormat() ) + 3) & ~3;
+
+  for( unsigned i = 0; i < d_number_of_buffers; ++i )
+  {
+    d_buffers[i].pixels.resize( d_buffer_pitch*height );
+    d_buffers[i].state.store( FREE_BUFFER );
+    d_buffers[i].publication.store( 0ul );
+  }
+}
+
+// Get the number of staging buffers
+unsigned MultiBufferedStreamingTexture::getNumberOfBuffers() const
+{
+  return d_number_of_buffers;
+}
+
+// Get the length of a row of staging buffer pixels in bytes (pitch)
+int MultiBufferedStreamingTexture::getBufferPitch() const
+{
+  return d_buffer_pitch;
+}
+
+// Acquire a staging buffer (producer threads)
+/*! \details A free buffer will be returned if there is one. Otherwise the
+ * oldest published buffer will be dropped and returned. If every buffer is
+ * being written or uploaded -1 will be returned (the producer should skip
+ * the frame or try again later). The acquired buffer must be published or
+ * released.
+ */
+int MultiBufferedStreamingTexture::acquireBuffer()
+{
+  for( unsigned i = 0; i < d_number_of_buffers; ++i )
+  {
+    int expected_state = FREE_BUFFER;
+
+    if( d_buffers[i].state.compare_exchange_strong( expected_state,
+						    WRITING_BUFFER,
+						    std::memory_order_acquire ) )
+      return i;
+  }
+
+  // Recycle the oldest published buffer
+  int buffer = this->findPublishedBuffer( false );
+
+  while( buffer >= 0 )
+  {
+    int expected_state = PUBLISHED_BUFFER;
+
+    if( d_buffers[buffer].state.compare_exchange_strong(
+						  expected_state,
+						  WRITING_BUFFER,
+						  std::memory_order_acquire ) )
+    {
+      ++d_number_of_dropped_buffers;
+
+      return buffer;
+    }
+
+    buffer = this->findPublishedBuffer( false );
+  }
+
+  return -1;
+}
+
+// Get the pixels of an acquired staging buffer
+/*! \details The pixels are stored in the texture format with the buffer
+ * pitch.
+ */
+void* MultiBufferedStreamingTexture::getBufferPixels( const int buffer )
+{
+  // Make sure the buffer is valid
+  testPrecondition( buffer >= 0 );
+  testPrecondition( buffer < (int)d_number_of_buffers );
+  testPrecondition( d_buffers[buffer].state.load() == WRITING_BUFFER );
+
+  return &d_buffers[buffer].pixels[0];
+}
+
+// Publish an acquired staging buffer (producer threads)
+void MultiBufferedStreamingTexture::publishBuffer( const int buffer )
+{
+  // Make sure the buffer is valid
+  testPrecondition( buffer >= 0 );
+  testPrecondition( buffer < (int)d_number_of_buffers );
+  testPrecondition( d_buffers[buffer].state.load() == WRITING_BUFFER );
+
+  d_buffers[buffer].publication.store( ++d_last_publication,
+				       std::memory_order_relaxed );
+  d_buffers[buffer].state.store( PUBLISHED_BUFFER,
+				 std::memory_order_release );
+}
+
+// Release an acquired staging buffer without publishing it
+void MultiBufferedStreamingTexture::releaseBuffer( const int buffer )
+{
+  // Make sure the buffer is valid
+  testPrecondition( buffer >= 0 );
+  testPrecondition( buffer < (int)d_number_of_buffers );
+  testPrecondition( d_buffers[buffer].state.load() == WRITING_BUFFER );
+
+  d_buffers[buffer].state.store( FREE_BUFFER, std::memory_order_release );
+}
+
+// Upload the newest published staging buffer (render thread)
+/*! \details The older published buffers will be dropped. A producer
+ * reserves its publication number before it marks the buffer as published,
+ * so a buffer with an older number can be published after a newer buffer
+ * has been uploaded. These buffers will also be dropped so that the frames
+ * never go backwards. False will be returned if no buffer has been
+ * published since the last update (the texture keeps its pixels). This
+ * must be called from the thread that owns the renderer.
+ */
+bool MultiBufferedStreamingTexture::update()
+{
+  int buffer = this->findPublishedBuffer( true );
+
+  unsigned long publication = 0;
+
+  while( buffer >= 0 )
+  {
+    int expected_state = PUBLISHED_BUFFER;
+
+    if( d_buffers[buffer].state.compare_exchange_strong(
+						  expected_state,
+						  UPLOADING_BUFFER,
+						  std::memory_order_acquire ) )
+    {
+      publication = d_buffers[buffer].publication.load();
+
+      if( publication > d_uploaded_publication.load() )
+	break;
+
+      // The buffer is older than the uploaded buffer
+      d_buffers[buffer].state.store( FREE_BUFFER, std::memory_order_release );
+
+      ++d_number_of_dropped_buffers;
+    }
+
+    buffer = this->findPublishedBuffer( true );
+  }
+
+  if( buffer < 0 )
+    return false;
+
+  // Drop the stale buffers (a buffer is claimed before its publication
+  // number is checked because a producer could republish it)
+  for( unsigned i = 0; i < d_number_of_buffers; ++i )
+  {
+    int expected_state = PUBLISHED_BUFFER;
+
+    if( d_buffers[i].state.compare_exchange_strong( expected_state,
+						    UPLOADING_BUFFER,
+						    std::memory_order_acquire ) )
+    {
+      if( d_buffers[i].publication.load() < publication )
+      {
+	d_buffers[i].state.store( FREE_BUFFER, std::memory_order_release );
+
+	++d_number_of_dropped_buffers;
+      }
+      else
+      {
+	d_buffers[i].state.store( PUBLISHED_BUFFER,
+				  std::memory_order_release );
+      }
+    }
+  }
+
+  // Upload the buffer
+  try{
+    StreamingTextureLock lock( *this );
+
+    PixelFormatConverter::convertRows( this->getFormat(),
+				       &d_buffers[buffer].pixels[0],
+				       d_buffer_pitch,
+				       NULL,
+				       this->getFormat(),
+				       lock.getPixels(),
+				       lock.getPitch(),
+				       this->getWidth(),
+				       this->getHeight() );
+  }
+  catch( const ExceptionType& )
+  {
+    d_buffers[buffer].state.store( FREE_BUFFER, std::memory_order_release );
+
+    throw;
+  }
+
+  d_uploaded_publication.store( publication );
+
+  d_buffers[buffer].state.store( FREE_BUFFER, std::memory_order_release );
+
+  return true;
+}
+
+// Get the number of published buffers that were dropped
+unsigned long MultiBufferedStreamingTexture::getNumberOfDroppedBuffers() const
+{
+  return d_number_of_dropped_buffers.load();
+}
+
+// Get the publication number of the last uploaded buffer
+/*! \details Zero will be returned if no buffer has been uploaded.
+ */
+unsigned long MultiBufferedStreamingTexture::getUploadedPublication() const
+{
+  return d_uploaded_publication.load();
+}
+
+// Find the oldest or the newest published buffer
+/*! \details -1 will be returned if no buffer has been published.
+ */
+int MultiBufferedStreamingTexture::findPublishedBuffer(
+						      const bool newest ) const
+{
+  int found_buffer = -1;
+  unsigned long found_publication = 0;
+
+  for( unsigned i = 0; i < d_number_of_buffers; ++i )
+  {
+    if( d_buffers[i].state.load( std::memory_order_acquire ) ==
+	PUBLISHED_BUFFER )
+    {
+      const unsigned long publication = d_buffers[i].publication.load();
+
+      if( found_buffer < 0 ||
+	  (newest && publication > found_publication) ||
+	  (!newest && publication < found_publication) )
+      {
+	found_buffer = i;
+	found_publication = publication;
+      }
+    }
+  }
+
+  return found_buffer;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end MultiBufferedStreamingTexture.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,132 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   MultiBufferedStreamingTexture.hpp
+//! \author Alex Robinson
+//! \brief  The multi-buffered streaming texture class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_MULTI_BUFFERED_STREAMING_TEXTURE_HPP
+#define GDEV_MULTI_BUFFERED_STREAMING_TEXTURE_HPP
+
+// Std Lib Includes
+#include <vector>
+#include <memory>
+#include <atomic>
+
+// GDev Includes
+#include "StreamingTexture.hpp"
+
+namespace GDev{
+
+/*! The multi-buffered streaming texture class
+ * \details The texture owns a number of CPU staging buffers that can be
+ * filled by producer threads (e.g. video decoders or procedural
+ * generators). A producer acquires a free buffer, writes the pixels (in
+ * the texture format) and publishes it. The buffers are handed off without
+ * locks. The render thread calls update before drawing the texture: only
+ * the newest published buffer is uploaded and older published buffers are
+ * dropped (including buffers that are published by a slower producer after
+ * a newer buffer has been uploaded). If no buffer is free when a producer
+ * needs one, the oldest published buffer is recycled. At least three
+ * buffers are needed so that a producer never has to wait for the upload
+ * (one buffer is uploaded, one is published and one is written).
+ */
+class MultiBufferedStreamingTexture : public StreamingTexture
+{
+
+public:
+
+  //! Constructor
+  MultiBufferedStreamingTexture( const std::shared_ptr<Renderer>& renderer,
+				 const int width,
+				 const int height,
+				 const unsigned number_of_buffers = 3,
+				 const Uint32 format = SDL_PIXELFORMAT_ARGB8888 );
+
+  //! Destructor
+  ~MultiBufferedStreamingTexture()
+  { /* ... */ }
+
+  //! Get the number of staging buffers
+  unsigned getNumberOfBuffers() const;
+
+  //! Get the length of a row of staging buffer pixels in bytes (pitch)
+  int getBufferPitch() const;
+
+  //! Acquire a staging buffer (producer threads)
+  int acquireBuffer();
+
+  //! Get the pixels of an acquired staging buffer
+  void* getBufferPixels( const int buffer );
+
+  //! Publish an acquired staging buffer (producer threads)
+  void publishBuffer( const int buffer );
+
+  //! Release an acquired staging buffer without publishing it
+  void releaseBuffer( const int buffer );
+
+  //! Upload the newest published staging buffer (render thread)
+  bool update();
+
+  //! Get the number of published buffers that were dropped
+  unsigned long getNumberOfDroppedBuffers() const;
+
+  //! Get the publication number of the last uploaded buffer
+  unsigned long getUploadedPublication() const;
+
+private:
+
+  // The staging buffer states
+  enum BufferState{
+    FREE_BUFFER = 0,
+    WRITING_BUFFER,
+    PUBLISHED_BUFFER,
+    UPLOADING_BUFFER
+  };
+
+  // The staging buffer
+  struct Buffer
+  {
+    // The pixels
+    std::vector<Uint8> pixels;
+
+    // The state
+    std::atomic<int> state;
+
+    // The publication number (higher is newer)
+    std::atomic<unsigned long> publication;
+  };
+
+  // Find the oldest or the newest published buffer
+  int findPublishedBuffer( const bool newest ) const;
+
+  //! Do not allow default construction
+  MultiBufferedStreamingTexture();
+
+  // The number of staging buffers
+  unsigned d_number_of_buffers;
+
+  // The staging buffer pitch
+  int d_buffer_pitch;
+
+  // The staging buffers
+  std::unique_ptr<Buffer[]> d_buffers;
+
+  // The last publication number
+  std::atomic<unsigned long> d_last_publication;
+
+  // The publication number of the last uploaded buffer
+  std::atomic<unsigned long> d_uploaded_publication;
+
+  // The number of published buffers that were dropped
+  std::atomic<unsigned long> d_number_of_dropped_buffers;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_MULTI_BUFFERED_STREAMING_TEXTURE_HPP
+
+//---------------------------------------------------------------------------//
+// end MultiBufferedStreamingTexture.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,946 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   PixelFormatConverter.cpp
+//! \author Alex Robinson
+//! \brief  The pixel format converter class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <system_error>
+
+// GDev Includes
+#include "PixelFormatConverter.hpp"
+#include "SurfaceBlitter.hpp"
+#include "DBCMacros.hpp"
+
+// The SIMD kernels are only available with gcc compatible x86 compilers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GDEV_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace GDev{
+
+// Initialize static member data
+const unsigned PixelFormatConverter::s_min_number_of_pixels_per_thread =
+  128*1024;
+
+PixelFormatConverter::Kernel PixelFormatConverter::s_kernel =
+  SurfaceBlitter::getBestSupportedKernel();
+
+unsigned PixelFormatConverter::s_number_of_threads =
+  std::max( std::thread::hardware_concurrency(), 1u );
+
+// Get the kernel that is used for conversions
+PixelFormatConverter::Kernel PixelFormatConverter::getKernel()
+{
+  return s_kernel;
+}
+
+// Set the kernel that is used for conversions
+/*! \details This is mostly useful for testing and benchmarking the kernels.
+ */
+void PixelFormatConverter::setKernel( const Kernel kernel )
+{
+  // Make sure the kernel is supported
+  testPrecondition( SurfaceBlitter::isKernelSupported( kernel ) );
+
+  s_kernel = kernel;
+}
+
+// Get the max number of threads that are used for a conversion
+/*! \details The default is the number of hardware threads.
+ */
+unsigned PixelFormatConverter::getNumberOfThreads()
+{
+  return s_number_of_threads;
+}
+
+// Set the max number of threads that are used for a conversion
+void PixelFormatConverter::setNumberOfThreads(
+					      const unsigned number_of_threads )
+{
+  // Make sure the number of threads is valid
+  testPrecondition( number_of_threads > 0 );
+
+  s_number_of_threads = number_of_threads;
+}
+
+// Get the min number of pixels converted by a thread
+/*! \details Conversions that are smaller than twice this number are never
+ * split between threads (starting a thread costs more than it saves).
+ */
+unsigned PixelFormatConverter::getMinNumberOfPixelsPerThread()
+{
+  return s_min_number_of_pixels_per_thread;
+}
+
+// Check if a conversion between the pixel formats is supported
+bool PixelFormatConverter::canConvert( const Uint32 source_format,
+				       const Uint32 destination_format )
+{
+  if( source_format == destination_format )
+  {
+    return source_format != SDL_PIXELFORMAT_UNKNOWN &&
+      !SDL_ISPIXELFORMAT_FOURCC( source_format ) &&
+      !SDL_ISPIXELFORMAT_INDEXED( source_format );
+  }
+  else
+    return PixelFormatConverter::getRowConverter( source_format,
+						  destination_format ) != NULL;
+}
+
+// Check if a surface can be converted to the pixel format
+/*! \details Color keyed surfaces cannot be converted (SDL converts the color
+ * key to an alpha channel). Indexed surfaces must have a palette.
+ */
+bool PixelFormatConverter::canConvert( const SDL_Surface& source_surface,
+				       const Uint32 destination_format )
+{
+  if( !PixelFormatConverter::canConvert( source_surface.format->format,
+					 destination_format ) )
+    return false;
+
+  if( SDL_MUSTLOCK( &source_surface ) )
+    return false;
+
+  if( source_surface.format->format == SDL_PIXELFORMAT_INDEX8 &&
+      source_surface.format->palette == NULL )
+    return false;
+
+  Uint32 color_key;
+
+  return SDL_GetColorKey( const_cast<SDL_Surface*>( &source_surface ),
+			  &color_key ) != 0;
+}
+
+// Convert rows of pixels
+/*! \details The palette is only used by indexed source formats. Pixels of
+ * formats without an alpha channel are converted to opaque pixels.
+ */
+void PixelFormatConverter::convertRows( const Uint32 source_format,
+					const void* source_pixels,
+					const int source_pitch,
+					const SDL_Palette* source_palette,
+					const Uint32 destination_format,
+					void* destination_pixels,
+					const int destination_pitch,
+					const int width,
+					const int height )
+{
+  // Make sure the conversion is supported
+  testPrecondition( PixelFormatConverter::canConvert( source_format,
+						      destination_format ) );
+  // Make sure the palette is valid
+  testPrecondition( source_format != SDL_PIXELFORMAT_INDEX8 ||
+		    source_palette != NULL );
+  // Make sure the pixels are valid
+  testPrecondition( source_pixels != NULL );
+  testPrecondition( destination_pixels != NULL );
+  testPrecondition( width >= 0 );
+  testPrecondition( height >= 0 );
+
+  if( width == 0 || height == 0 )
+    return;
+
+  // Same formats are copied (the row converter will be NULL)
+  RowConverter row_converter = NULL;
+
+  if( source_format != destination_format )
+  {
+    row_converter = PixelFormatConverter::getRowConverter(
+						 source_format,
+						 destination_format );
+  }
+
+  const int row_size = width*SDL_BYTESPERPIXEL( source_format );
+
+  // Create the palette lookup table
+  Uint32 palette[256];
+
+  if( source_format == SDL_PIXELFORMAT_INDEX8 )
+  {
+    for( int i = 0; i < 256; ++i )
+    {
+      if( i < source_palette->ncolors )
+      {
+	const SDL_Color& color = source_palette->colors[i];
+
+	palette[i] = ((Uint32)color.a << 24) | ((Uint32)color.r << 16) |
+	  ((Uint32)color.g << 8) | color.b;
+      }
+      else
+	palette[i] = 0;
+    }
+  }
+
+  const Uint8* source_bytes = static_cast<const Uint8*>( source_pixels );
+  Uint8* destination_bytes = static_cast<Uint8*>( destination_pixels );
+
+  // Split the rows into bands
+  unsigned long number_of_bands =
+    (unsigned long)width*height/s_min_number_of_pixels_per_thread;
+
+  number_of_bands = std::min( number_of_bands,
+			      (unsigned long)s_number_of_threads );
+  number_of_bands = std::min( number_of_bands, (unsigned long)height );
+  number_of_bands = std::max( number_of_bands, 1ul );
+
+  std::vector<std::thread> workers;
+
+  for( unsigned long band = 1; band < number_of_bands; ++band )
+  {
+    const int first_row = (int)(band*height/number_of_bands);
+    const int end_row = (int)((band+1)*height/number_of_bands);
+
+    try{
+      workers.push_back( std::thread( &PixelFormatConverter::convertBand,
+				      row_converter,
+				      source_bytes,
+				      source_pitch,
+				      destination_bytes,
+				      destination_pitch,
+				      row_size,
+				      width,
+				      first_row,
+				      end_row,
+				      palette ) );
+    }
+    // Convert the band on this thread if a new thread cannot be started
+    catch( const std::system_error& )
+    {
+      PixelFormatConverter::convertBand( row_converter,
+					 source_bytes,
+					 source_pitch,
+					 destination_bytes,
+					 destination_pitch,
+					 row_size,
+					 width,
+					 first_row,
+					 end_row,
+					 palette );
+    }
+  }
+
+  PixelFormatConverter::convertBand( row_converter,
+				     source_bytes,
+				     source_pitch,
+				     destination_bytes,
+				     destination_pitch,
+				     row_size,
+				     width,
+				     0,
+				     (int)(height/number_of_bands),
+				     palette );
+
+  for( unsigned i = 0; i < workers.size(); ++i )
+    workers[i].join();
+}
+
+// Convert a surface (the destination must have the same size)
+void PixelFormatConverter::convert( const SDL_Surface& source_surface,
+				    SDL_Surface& destination_surface )
+{
+  // Make sure the surfaces can be converted
+  testPrecondition( PixelFormatConverter::canConvert(
+				      source_surface,
+				      destination_surface.format->format ) );
+  testPrecondition( !SDL_MUSTLOCK( &destination_surface ) );
+  // Make sure the surfaces have the same size
+  testPrecondition( source_surface.w == destination_surface.w );
+  testPrecondition( source_surface.h == destination_surface.h );
+
+  PixelFormatConverter::convertRows( source_surface.format->format,
+				     source_surface.pixels,
+				     source_surface.pitch,
+				     source_surface.format->palette,
+				     destination_surface.format->format,
+				     destination_surface.pixels,
+				     destination_surface.pitch,
+				     source_surface.w,
+				     source_surface.h );
+}
+
+// Get the row converter for the pixel formats
+/*! \details NULL will be returned if the conversion is not supported.
+ */
+PixelFormatConverter::RowConverter
+PixelFormatConverter::getRowConverter( const Uint32 source_format,
+				       const Uint32 destination_format )
+{
+  const bool sse2 = (s_kernel == SSE2_KERNEL);
+  const bool avx2 = (s_kernel == AVX2_KERNEL);
+
+  // RGB888 has the ARGB8888 layout (the unused byte is ignored)
+  if( destination_format == SDL_PIXELFORMAT_ARGB8888 ||
+      destination_format == SDL_PIXELFORMAT_RGB888 )
+  {
+    switch( source_format )
+    {
+    case SDL_PIXELFORMAT_ARGB8888:
+      return &PixelFormatConverter::copyRow32;
+    case SDL_PIXELFORMAT_RGB888:
+      return avx2 ? &PixelFormatConverter::convertRGB888ToARGBAVX2 :
+	sse2 ? &PixelFormatConverter::convertRGB888ToARGBSSE2 :
+	&PixelFormatConverter::convertRGB888ToARGBScalar;
+    case SDL_PIXELFORMAT_ABGR8888:
+      return avx2 ? &PixelFormatConverter::swapRedBlueAVX2 :
+	sse2 ? &PixelFormatConverter::swapRedBlueSSE2 :
+	&PixelFormatConverter::swapRedBlueScalar;
+    case SDL_PIXELFORMAT_RGBA8888:
+      return avx2 ? &PixelFormatConverter::convertRGBAToARGBAVX2 :
+	sse2 ? &PixelFormatConverter::convertRGBAToARGBSSE2 :
+	&PixelFormatConverter::convertRGBAToARGBScalar;
+    case SDL_PIXELFORMAT_RGB24:
+      return avx2 ? &PixelFormatConverter::convertRGB24ToARGBAVX2 :
+	&PixelFormatConverter::convertRGB24ToARGBScalar;
+    case SDL_PIXELFORMAT_INDEX8:
+      return avx2 ? &PixelFormatConverter::convertIndex8ToARGBAVX2 :
+	&PixelFormatConverter::convertIndex8ToARGBScalar;
+    default:
+      return NULL;
+    }
+  }
+  else if( source_format == SDL_PIXELFORMAT_ARGB8888 )
+  {
+    switch( destination_format )
+    {
+    case SDL_PIXELFORMAT_ABGR8888:
+      return avx2 ? &PixelFormatConverter::swapRedBlueAVX2 :
+	sse2 ? &PixelFormatConverter::swapRedBlueSSE2 :
+	&PixelFormatConverter::swapRedBlueScalar;
+    case SDL_PIXELFORMAT_RGBA8888:
+      return avx2 ? &PixelFormatConverter::convertARGBToRGBAAVX2 :
+	sse2 ? &PixelFormatConverter::convertARGBToRGBASSE2 :
+	&PixelFormatConverter::convertARGBToRGBAScalar;
+    case SDL_PIXELFORMAT_RGB24:
+      return avx2 ? &PixelFormatConverter::convertARGBToRGB24AVX2 :
+	&PixelFormatConverter::convertARGBToRGB24Scalar;
+    default:
+      return NULL;
+    }
+  }
+  else
+    return NULL;
+}
+
+// Convert a band of rows
+void PixelFormatConverter::convertBand( const RowConverter row_converter,
+					const Uint8* source_pixels,
+					const int source_pitch,
+					Uint8* destination_pixels,
+					const int destination_pitch,
+					const int row_size,
+					const int width,
+					const int first_row,
+					const int end_row,
+					const Uint32* palette )
+{
+  for( int row = first_row; row < end_row; ++row )
+  {
+    const Uint8* source_row = source_pixels + row*source_pitch;
+    Uint8* destination_row = destination_pixels + row*destination_pitch;
+
+    if( row_converter )
+      row_converter( source_row, destination_row, width, palette );
+    else
+      memcpy( destination_row, source_row, row_size );
+  }
+}
+
+// Copy a row of 32 bit pixels (ARGB8888 -> RGB888)
+void PixelFormatConverter::copyRow32( const Uint8* source_row,
+				      Uint8* destination_row,
+				      const int width,
+				      const Uint32* )
+{
+  memcpy( destination_row, source_row, 4*width );
+}
+
+// Convert RGB888 to ARGB8888 (the pixels will be opaque)
+void PixelFormatConverter::convertRGB888ToARGBScalar( const Uint8* source_row,
+						      Uint8* destination_row,
+						      const int width,
+						      const Uint32* )
+{
+  const Uint32* source = reinterpret_cast<const Uint32*>( source_row );
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+    destination[i] = source[i] | 0xFF000000;
+}
+
+// Swap the red and blue channels (ABGR8888 <-> ARGB8888)
+void PixelFormatConverter::swapRedBlueScalar( const Uint8* source_row,
+					      Uint8* destination_row,
+					      const int width,
+					      const Uint32* )
+{
+  const Uint32* source = reinterpret_cast<const Uint32*>( source_row );
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+  {
+    const Uint32 pixel = source[i];
+
+    destination[i] = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) |
+      ((pixel & 0xFF) << 16);
+  }
+}
+
+// Convert RGBA8888 to ARGB8888
+void PixelFormatConverter::convertRGBAToARGBScalar( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* )
+{
+  const Uint32* source = reinterpret_cast<const Uint32*>( source_row );
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+    destination[i] = (source[i] >> 8) | (source[i] << 24);
+}
+
+// Convert ARGB8888 to RGBA8888
+void PixelFormatConverter::convertARGBToRGBAScalar( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* )
+{
+  const Uint32* source = reinterpret_cast<const Uint32*>( source_row );
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+    destination[i] = (source[i] << 8) | (source[i] >> 24);
+}
+
+// Convert RGB24 to ARGB8888
+/*! \details The RGB24 bytes are stored in red, green, blue order.
+ */
+void PixelFormatConverter::convertRGB24ToARGBScalar( const Uint8* source_row,
+						     Uint8* destination_row,
+						     const int width,
+						     const Uint32* )
+{
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+  {
+    const Uint8* source = source_row + 3*i;
+
+    destination[i] = 0xFF000000 | ((Uint32)source[0] << 16) |
+      ((Uint32)source[1] << 8) | source[2];
+  }
+}
+
+// Convert ARGB8888 to RGB24
+void PixelFormatConverter::convertARGBToRGB24Scalar( const Uint8* source_row,
+						     Uint8* destination_row,
+						     const int width,
+						     const Uint32* )
+{
+  const Uint32* source = reinterpret_cast<const Uint32*>( source_row );
+
+  for( int i = 0; i < width; ++i )
+  {
+    Uint8* destination = destination_row + 3*i;
+
+    destination[0] = (source[i] >> 16) & 0xFF;
+    destination[1] = (source[i] >> 8) & 0xFF;
+    destination[2] = source[i] & 0xFF;
+  }
+}
+
+// Convert INDEX8 to ARGB8888
+void PixelFormatConverter::convertIndex8ToARGBScalar( const Uint8* source_row,
+						      Uint8* destination_row,
+						      const int width,
+						      const Uint32* palette )
+{
+  Uint32* destination = reinterpret_cast<Uint32*>( destination_row );
+
+  for( int i = 0; i < width; ++i )
+    destination[i] = palette[source_row[i]];
+}
+
+#ifdef GDEV_X86_SIMD_KERNELS
+
+// Convert RGB888 to ARGB8888 (SSE2 kernel)
+__attribute__((target("sse2")))
+void PixelFormatConverter::convertRGB888ToARGBSSE2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  const __m128i alpha = _mm_set1_epi32( 0xFF000000 );
+
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i pixels = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i*>( source_row + 4*i ) );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( destination_row + 4*i ),
+		      _mm_or_si128( pixels, alpha ) );
+  }
+
+  PixelFormatConverter::convertRGB888ToARGBScalar( source_row + 4*i,
+						   destination_row + 4*i,
+						   width - i,
+						   palette );
+}
+
+// Convert RGB888 to ARGB8888 (AVX2 kernel)
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertRGB888ToARGBAVX2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  const __m256i alpha = _mm256_set1_epi32( 0xFF000000 );
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i pixels = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 4*i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 _mm256_or_si256( pixels, alpha ) );
+  }
+
+  PixelFormatConverter::convertRGB888ToARGBScalar( source_row + 4*i,
+						   destination_row + 4*i,
+						   width - i,
+						   palette );
+}
+
+// Swap the red and blue channels (SSE2 kernel)
+/*! \details SSE2 has no byte shuffle, so the channels are moved with
+ * shifts and masks (four pixels at a time).
+ */
+__attribute__((target("sse2")))
+void PixelFormatConverter::swapRedBlueSSE2( const Uint8* source_row,
+					    Uint8* destination_row,
+					    const int width,
+					    const Uint32* palette )
+{
+  const __m128i green_alpha_mask = _mm_set1_epi32( 0xFF00FF00 );
+  const __m128i low_byte_mask = _mm_set1_epi32( 0x000000FF );
+
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i pixels = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i*>( source_row + 4*i ) );
+
+    const __m128i swapped = _mm_or_si128(
+       _mm_and_si128( pixels, green_alpha_mask ),
+       _mm_or_si128(
+	  _mm_and_si128( _mm_srli_epi32( pixels, 16 ), low_byte_mask ),
+	  _mm_slli_epi32( _mm_and_si128( pixels, low_byte_mask ), 16 ) ) );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( destination_row + 4*i ),
+		      swapped );
+  }
+
+  PixelFormatConverter::swapRedBlueScalar( source_row + 4*i,
+					   destination_row + 4*i,
+					   width - i,
+					   palette );
+}
+
+// Swap the red and blue channels (AVX2 kernel)
+__attribute__((target("avx2")))
+void PixelFormatConverter::swapRedBlueAVX2( const Uint8* source_row,
+					    Uint8* destination_row,
+					    const int width,
+					    const Uint32* palette )
+{
+  const __m256i shuffle = _mm256_setr_epi8( 2, 1, 0, 3, 6, 5, 4, 7,
+					    10, 9, 8, 11, 14, 13, 12, 15,
+					    2, 1, 0, 3, 6, 5, 4, 7,
+					    10, 9, 8, 11, 14, 13, 12, 15 );
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i pixels = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 4*i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 _mm256_shuffle_epi8( pixels, shuffle ) );
+  }
+
+  PixelFormatConverter::swapRedBlueScalar( source_row + 4*i,
+					   destination_row + 4*i,
+					   width - i,
+					   palette );
+}
+
+// Convert RGBA8888 to ARGB8888 (SSE2 kernel)
+__attribute__((target("sse2")))
+void PixelFormatConverter::convertRGBAToARGBSSE2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i pixels = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i*>( source_row + 4*i ) );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( destination_row + 4*i ),
+		      _mm_or_si128( _mm_srli_epi32( pixels, 8 ),
+				    _mm_slli_epi32( pixels, 24 ) ) );
+  }
+
+  PixelFormatConverter::convertRGBAToARGBScalar( source_row + 4*i,
+						 destination_row + 4*i,
+						 width - i,
+						 palette );
+}
+
+// Convert RGBA8888 to ARGB8888 (AVX2 kernel)
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertRGBAToARGBAVX2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  const __m256i shuffle = _mm256_setr_epi8( 1, 2, 3, 0, 5, 6, 7, 4,
+					    9, 10, 11, 8, 13, 14, 15, 12,
+					    1, 2, 3, 0, 5, 6, 7, 4,
+					    9, 10, 11, 8, 13, 14, 15, 12 );
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i pixels = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 4*i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 _mm256_shuffle_epi8( pixels, shuffle ) );
+  }
+
+  PixelFormatConverter::convertRGBAToARGBScalar( source_row + 4*i,
+						 destination_row + 4*i,
+						 width - i,
+						 palette );
+}
+
+// Convert ARGB8888 to RGBA8888 (SSE2 kernel)
+__attribute__((target("sse2")))
+void PixelFormatConverter::convertARGBToRGBASSE2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i pixels = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i*>( source_row + 4*i ) );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( destination_row + 4*i ),
+		      _mm_or_si128( _mm_slli_epi32( pixels, 8 ),
+				    _mm_srli_epi32( pixels, 24 ) ) );
+  }
+
+  PixelFormatConverter::convertARGBToRGBAScalar( source_row + 4*i,
+						 destination_row + 4*i,
+						 width - i,
+						 palette );
+}
+
+// Convert ARGB8888 to RGBA8888 (AVX2 kernel)
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertARGBToRGBAAVX2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  const __m256i shuffle = _mm256_setr_epi8( 3, 0, 1, 2, 7, 4, 5, 6,
+					    11, 8, 9, 10, 15, 12, 13, 14,
+					    3, 0, 1, 2, 7, 4, 5, 6,
+					    11, 8, 9, 10, 15, 12, 13, 14 );
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i pixels = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 4*i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 _mm256_shuffle_epi8( pixels, shuffle ) );
+  }
+
+  PixelFormatConverter::convertARGBToRGBAScalar( source_row + 4*i,
+						 destination_row + 4*i,
+						 width - i,
+						 palette );
+}
+
+// Convert RGB24 to ARGB8888 (AVX2 kernel)
+/*! \details Eight pixels (24 bytes) are loaded at a time. The second group
+ * of 12 bytes is moved to the upper 128 bit half before the in-lane byte
+ * shuffle. The loads read 8 bytes past the 24 that are converted, so the
+ * last pixels are always converted by the scalar loop.
+ */
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertRGB24ToARGBAVX2( const Uint8* source_row,
+						   Uint8* destination_row,
+						   const int width,
+						   const Uint32* palette )
+{
+  const __m256i permute = _mm256_setr_epi32( 0, 1, 2, 3, 3, 4, 5, 6 );
+  const __m256i shuffle = _mm256_setr_epi8( 2, 1, 0, -128, 5, 4, 3, -128,
+					    8, 7, 6, -128, 11, 10, 9, -128,
+					    2, 1, 0, -128, 5, 4, 3, -128,
+					    8, 7, 6, -128, 11, 10, 9, -128 );
+  const __m256i alpha = _mm256_set1_epi32( 0xFF000000 );
+
+  int i = 0;
+
+  for( ; i + 11 <= width; i += 8 )
+  {
+    const __m256i bytes = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 3*i ) );
+
+    const __m256i pixels = _mm256_or_si256(
+	_mm256_shuffle_epi8( _mm256_permutevar8x32_epi32( bytes, permute ),
+			     shuffle ),
+	alpha );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 pixels );
+  }
+
+  PixelFormatConverter::convertRGB24ToARGBScalar( source_row + 3*i,
+						  destination_row + 4*i,
+						  width - i,
+						  palette );
+}
+
+// Convert ARGB8888 to RGB24 (AVX2 kernel)
+/*! \details Eight pixels are converted at a time. The 12 bytes produced in
+ * each 128 bit half are packed together before they are stored. The stores
+ * write 8 bytes past the 24 that are converted, so the last pixels are
+ * always converted by the scalar loop.
+ */
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertARGBToRGB24AVX2( const Uint8* source_row,
+						   Uint8* destination_row,
+						   const int width,
+						   const Uint32* palette )
+{
+  const __m256i shuffle = _mm256_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9,
+					    8, 14, 13, 12, -128, -128, -128, -128,
+					    2, 1, 0, 6, 5, 4, 10, 9,
+					    8, 14, 13, 12, -128, -128, -128, -128 );
+  const __m256i permute = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 7, 7 );
+
+  int i = 0;
+
+  for( ; i + 11 <= width; i += 8 )
+  {
+    const __m256i pixels = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i*>( source_row + 4*i ) );
+
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+			   _mm256_shuffle_epi8( pixels, shuffle ), permute );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 3*i ),
+			 bytes );
+  }
+
+  PixelFormatConverter::convertARGBToRGB24Scalar( source_row + 4*i,
+						  destination_row + 3*i,
+						  width - i,
+						  palette );
+}
+
+// Convert INDEX8 to ARGB8888 (AVX2 kernel)
+/*! \details Eight palette entries are gathered at a time.
+ */
+__attribute__((target("avx2")))
+void PixelFormatConverter::convertIndex8ToARGBAVX2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i indices = _mm256_cvtepu8_epi32( _mm_loadl_epi64(
+		      reinterpret_cast<const __m128i*>( source_row + i ) ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + 4*i ),
+			 _mm256_i32gather_epi32(
+				   reinterpret_cast<const int*>( palette ),
+				   indices,
+				   4 ) );
+  }
+
+  PixelFormatConverter::convertIndex8ToARGBScalar( source_row + i,
+						   destination_row + 4*i,
+						   width - i,
+						   palette );
+}
+
+#else // GDEV_X86_SIMD_KERNELS
+
+// Convert RGB888 to ARGB8888 (SSE2 kernel - not available)
+void PixelFormatConverter::convertRGB888ToARGBSSE2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  PixelFormatConverter::convertRGB888ToARGBScalar( source_row,
+						   destination_row,
+						   width,
+						   palette );
+}
+
+// Convert RGB888 to ARGB8888 (AVX2 kernel - not available)
+void PixelFormatConverter::convertRGB888ToARGBAVX2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  PixelFormatConverter::convertRGB888ToARGBScalar( source_row,
+						   destination_row,
+						   width,
+						   palette );
+}
+
+// Swap the red and blue channels (SSE2 kernel - not available)
+void PixelFormatConverter::swapRedBlueSSE2( const Uint8* source_row,
+					    Uint8* destination_row,
+					    const int width,
+					    const Uint32* palette )
+{
+  PixelFormatConverter::swapRedBlueScalar( source_row,
+					   destination_row,
+					   width,
+					   palette );
+}
+
+// Swap the red and blue channels (AVX2 kernel - not available)
+void PixelFormatConverter::swapRedBlueAVX2( const Uint8* source_row,
+					    Uint8* destination_row,
+					    const int width,
+					    const Uint32* palette )
+{
+  PixelFormatConverter::swapRedBlueScalar( source_row,
+					   destination_row,
+					   width,
+					   palette );
+}
+
+// Convert RGBA8888 to ARGB8888 (SSE2 kernel - not available)
+void PixelFormatConverter::convertRGBAToARGBSSE2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  PixelFormatConverter::convertRGBAToARGBScalar( source_row,
+						 destination_row,
+						 width,
+						 palette );
+}
+
+// Convert RGBA8888 to ARGB8888 (AVX2 kernel - not available)
+void PixelFormatConverter::convertRGBAToARGBAVX2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  PixelFormatConverter::convertRGBAToARGBScalar( source_row,
+						 destination_row,
+						 width,
+						 palette );
+}
+
+// Convert ARGB8888 to RGBA8888 (SSE2 kernel - not available)
+void PixelFormatConverter::convertARGBToRGBASSE2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  PixelFormatConverter::convertARGBToRGBAScalar( source_row,
+						 destination_row,
+						 width,
+						 palette );
+}
+
+// Convert ARGB8888 to RGBA8888 (AVX2 kernel - not available)
+void PixelFormatConverter::convertARGBToRGBAAVX2( const Uint8* source_row,
+						  Uint8* destination_row,
+						  const int width,
+						  const Uint32* palette )
+{
+  PixelFormatConverter::convertARGBToRGBAScalar( source_row,
+						 destination_row,
+						 width,
+						 palette );
+}
+
+// Convert RGB24 to ARGB8888 (AVX2 kernel - not available)
+void PixelFormatConverter::convertRGB24ToARGBAVX2( const Uint8* source_row,
+						   Uint8* destination_row,
+						   const int width,
+						   const Uint32* palette )
+{
+  PixelFormatConverter::convertRGB24ToARGBScalar( source_row,
+						  destination_row,
+						  width,
+						  palette );
+}
+
+// Convert ARGB8888 to RGB24 (AVX2 kernel - not available)
+void PixelFormatConverter::convertARGBToRGB24AVX2( const Uint8* source_row,
+						   Uint8* destination_row,
+						   const int width,
+						   const Uint32* palette )
+{
+  PixelFormatConverter::convertARGBToRGB24Scalar( source_row,
+						  destination_row,
+						  width,
+						  palette );
+}
+
+// Convert INDEX8 to ARGB8888 (AVX2 kernel - not available)
+void PixelFormatConverter::convertIndex8ToARGBAVX2( const Uint8* source_row,
+						    Uint8* destination_row,
+						    const int width,
+						    const Uint32* palette )
+{
+  PixelFormatConverter::convertIndex8ToARGBScalar( source_row,
+						   destination_row,
+						   width,
+						   palette );
+}
+
+#endif // end GDEV_X86_SIMD_KERNELS
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end PixelFormatConverter.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,232 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   PixelFormatConverter.hpp
+//! \author Alex Robinson
+//! \brief  The pixel format converter class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_PIXEL_FORMAT_CONVERTER_HPP
+#define GDEV_PIXEL_FORMAT_CONVERTER_HPP
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "SimdKernel.hpp"
+
+namespace GDev{
+
+/*! The pixel format converter class
+ * \details The pixel format converter converts pixels between the formats
+ * that are most common when loading images without going through the
+ * generic SDL blitters. The following conversions are supported:
+ * RGB24 <-> ARGB8888, ABGR8888 <-> ARGB8888, RGBA8888 <-> ARGB8888,
+ * RGB888 <-> ARGB8888, INDEX8 -> ARGB8888 (palette lookup), RGB24,
+ * ABGR8888, RGBA8888, INDEX8 -> RGB888 and copies between surfaces with the
+ * same (non-indexed) format. The byte shuffles are done with SSE2 or AVX2
+ * kernels when they are available (the kernels are selected like the
+ * surface blitter kernels). Large conversions are split into bands of rows
+ * that are converted by separate threads.
+ */
+class PixelFormatConverter
+{
+
+public:
+
+  //! The kernel type
+  typedef SimdKernel Kernel;
+
+  //! Get the kernel that is used for conversions
+  static Kernel getKernel();
+
+  //! Set the kernel that is used for conversions
+  static void setKernel( const Kernel kernel );
+
+  //! Get the max number of threads that are used for a conversion
+  static unsigned getNumberOfThreads();
+
+  //! Set the max number of threads that are used for a conversion
+  static void setNumberOfThreads( const unsigned number_of_threads );
+
+  //! Get the min number of pixels converted by a thread
+  static unsigned getMinNumberOfPixelsPerThread();
+
+  //! Check if a conversion between the pixel formats is supported
+  static bool canConvert( const Uint32 source_format,
+			  const Uint32 destination_format );
+
+  //! Check if a surface can be converted to the pixel format
+  static bool canConvert( const SDL_Surface& source_surface,
+			  const Uint32 destination_format );
+
+  //! Convert rows of pixels
+  static void convertRows( const Uint32 source_format,
+			   const void* source_pixels,
+			   const int source_pitch,
+			   const SDL_Palette* source_palette,
+			   const Uint32 destination_format,
+			   void* destination_pixels,
+			   const int destination_pitch,
+			   const int width,
+			   const int height );
+
+  //! Convert a surface (the destination must have the same size)
+  static void convert( const SDL_Surface& source_surface,
+		       SDL_Surface& destination_surface );
+
+private:
+
+  // The row converter type
+  typedef void (*RowConverter)( const Uint8* source_row,
+				Uint8* destination_row,
+				const int width,
+				const Uint32* palette );
+
+  // Get the row converter for the pixel formats
+  static RowConverter getRowConverter( const Uint32 source_format,
+				       const Uint32 destination_format );
+
+  // Convert a band of rows
+  static void convertBand( const RowConverter row_converter,
+			   const Uint8* source_pixels,
+			   const int source_pitch,
+			   Uint8* destination_pixels,
+			   const int destination_pitch,
+			   const int row_size,
+			   const int width,
+			   const int first_row,
+			   const int end_row,
+			   const Uint32* palette );
+
+  // Copy a row of 32 bit pixels (ARGB8888 -> RGB888)
+  static void copyRow32( const Uint8* source_row,
+			 Uint8* destination_row,
+			 const int width,
+			 const Uint32* palette );
+
+  // Convert RGB888 to ARGB8888 (the pixels will be opaque)
+  static void convertRGB888ToARGBScalar( const Uint8* source_row,
+					 Uint8* destination_row,
+					 const int width,
+					 const Uint32* palette );
+
+  // Convert RGB888 to ARGB8888 (SSE2 kernel)
+  static void convertRGB888ToARGBSSE2( const Uint8* source_row,
+				       Uint8* destination_row,
+				       const int width,
+				       const Uint32* palette );
+
+  // Convert RGB888 to ARGB8888 (AVX2 kernel)
+  static void convertRGB888ToARGBAVX2( const Uint8* source_row,
+				       Uint8* destination_row,
+				       const int width,
+				       const Uint32* palette );
+
+  // Swap the red and blue channels (ABGR8888 <-> ARGB8888)
+  static void swapRedBlueScalar( const Uint8* source_row,
+				 Uint8* destination_row,
+				 const int width,
+				 const Uint32* palette );
+
+  // Swap the red and blue channels (SSE2 kernel)
+  static void swapRedBlueSSE2( const Uint8* source_row,
+			       Uint8* destination_row,
+			       const int width,
+			       const Uint32* palette );
+
+  // Swap the red and blue channels (AVX2 kernel)
+  static void swapRedBlueAVX2( const Uint8* source_row,
+			       Uint8* destination_row,
+			       const int width,
+			       const Uint32* palette );
+
+  // Convert RGBA8888 to ARGB8888
+  static void convertRGBAToARGBScalar( const Uint8* source_row,
+				       Uint8* destination_row,
+				       const int width,
+				       const Uint32* palette );
+
+  // Convert RGBA8888 to ARGB8888 (SSE2 kernel)
+  static void convertRGBAToARGBSSE2( const Uint8* source_row,
+				     Uint8* destination_row,
+				     const int width,
+				     const Uint32* palette );
+
+  // Convert RGBA8888 to ARGB8888 (AVX2 kernel)
+  static void convertRGBAToARGBAVX2( const Uint8* source_row,
+				     Uint8* destination_row,
+				     const int width,
+				     const Uint32* palette );
+
+  // Convert ARGB8888 to RGBA8888
+  static void convertARGBToRGBAScalar( const Uint8* source_row,
+				       Uint8* destination_row,
+				       const int width,
+				       const Uint32* palette );
+
+  // Convert ARGB8888 to RGBA8888 (SSE2 kernel)
+  static void convertARGBToRGBASSE2( const Uint8* source_row,
+				     Uint8* destination_row,
+				     const int width,
+				     const Uint32* palette );
+
+  // Convert ARGB8888 to RGBA8888 (AVX2 kernel)
+  static void convertARGBToRGBAAVX2( const Uint8* source_row,
+				     Uint8* destination_row,
+				     const int width,
+				     const Uint32* palette );
+
+  // Convert RGB24 to ARGB8888
+  static void convertRGB24ToARGBScalar( const Uint8* source_row,
+					Uint8* destination_row,
+					const int width,
+					const Uint32* palette );
+
+  // Convert RGB24 to ARGB8888 (AVX2 kernel)
+  static void convertRGB24ToARGBAVX2( const Uint8* source_row,
+				      Uint8* destination_row,
+				      const int width,
+				      const Uint32* palette );
+
+  // Convert ARGB8888 to RGB24
+  static void convertARGBToRGB24Scalar( const Uint8* source_row,
+					Uint8* destination_row,
+					const int width,
+					const Uint32* palette );
+
+  // Convert ARGB8888 to RGB24 (AVX2 kernel)
+  static void convertARGBToRGB24AVX2( const Uint8* source_row,
+				      Uint8* destination_row,
+				      const int width,
+				      const Uint32* palette );
+
+  // Convert INDEX8 to ARGB8888
+  static void convertIndex8ToARGBScalar( const Uint8* source_row,
+					 Uint8* destination_row,
+					 const int width,
+					 const Uint32* palette );
+
+  // Convert INDEX8 to ARGB8888 (AVX2 kernel)
+  static void convertIndex8ToARGBAVX2( const Uint8* source_row,
+				       Uint8* destination_row,
+				       const int width,
+				       const Uint32* palette );
+
+  // The min number of pixels converted by a thread
+  static const unsigned s_min_number_of_pixels_per_thread;
+
+  // The kernel that is used for conversions
+  static Kernel s_kernel;
+
+  // The max number of threads that are used for a conversion
+  static unsigned s_number_of_threads;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_PIXEL_FORMAT_CONVERTER_HPP
+
+//---------------------------------------------------------------------------//
+// end PixelFormatConverter.hpp
+//---------------------------------------------------------------------------//
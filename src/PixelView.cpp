@@ -0,0 +1,58 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   PixelView.cpp
+//! \author Alex Robinson
+//! \brief  The pixel format traits and pixel view definitions
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "PixelView.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const int PixelFormatTraits<SDL_PIXELFORMAT_ARGB8888>::bytes_per_pixel;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_ARGB8888>::has_alpha;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_ARGB8888>::is_indexed;
+
+const int PixelFormatTraits<SDL_PIXELFORMAT_ABGR8888>::bytes_per_pixel;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_ABGR8888>::has_alpha;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_ABGR8888>::is_indexed;
+
+const int PixelFormatTraits<SDL_PIXELFORMAT_RGB24>::bytes_per_pixel;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_RGB24>::has_alpha;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_RGB24>::is_indexed;
+
+const int PixelFormatTraits<SDL_PIXELFORMAT_RGB565>::bytes_per_pixel;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_RGB565>::has_alpha;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_RGB565>::is_indexed;
+
+const int PixelFormatTraits<SDL_PIXELFORMAT_INDEX8>::bytes_per_pixel;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_INDEX8>::has_alpha;
+const bool PixelFormatTraits<SDL_PIXELFORMAT_INDEX8>::is_indexed;
+
+// Check if a pixel format has compile-time traits
+/*! \details The formats that are specialized are the ones that can be
+ * passed to dispatchPixelFormat.
+ */
+bool isPixelFormatSpecialized( const Uint32 format )
+{
+  switch( format )
+  {
+  case SDL_PIXELFORMAT_ARGB8888:
+  case SDL_PIXELFORMAT_ABGR8888:
+  case SDL_PIXELFORMAT_RGB24:
+  case SDL_PIXELFORMAT_RGB565:
+  case SDL_PIXELFORMAT_INDEX8:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end PixelView.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,975 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   PixelView.hpp
+//! \author Alex Robinson
+//! \brief  The pixel format traits and pixel view class declarations
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_PIXEL_VIEW_HPP
+#define GDEV_PIXEL_VIEW_HPP
+
+// Std Lib Includes
+#include <cstring>
+#include <algorithm>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Surface.hpp"
+#include "StreamingTextureLock.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+/*! The pixel format traits
+ * \details The traits describe the storage of a pixel format at compile
+ * time: the value type, the number of bytes per pixel and the conversions
+ * to and from ARGB8888 values. Only the formats that are specialized below
+ * are supported (see dispatchPixelFormat).
+ */
+template<Uint32 Format>
+struct PixelFormatTraits;
+
+//! The ARGB8888 pixel format traits
+template<>
+struct PixelFormatTraits<SDL_PIXELFORMAT_ARGB8888>
+{
+  //! The pixel value type
+  typedef Uint32 ValueType;
+
+  //! The number of bytes per pixel
+  static const int bytes_per_pixel = 4;
+
+  //! Records if the format has an alpha channel
+  static const bool has_alpha = true;
+
+  //! Records if the format is indexed (uses a palette)
+  static const bool is_indexed = false;
+
+  //! Load a pixel value
+  static ValueType load( const Uint8* pixel )
+  { ValueType value; std::memcpy( &value, pixel, 4 ); return value; }
+
+  //! Store a pixel value
+  static void store( Uint8* pixel, const ValueType value )
+  { std::memcpy( pixel, &value, 4 ); }
+
+  //! Convert a pixel value to an ARGB8888 value
+  static Uint32 toARGB( const ValueType value, const SDL_Palette* )
+  { return value; }
+
+  //! Convert an ARGB8888 value to a pixel value
+  static ValueType fromARGB( const Uint32 argb )
+  { return argb; }
+};
+
+//! The ABGR8888 pixel format traits
+template<>
+struct PixelFormatTraits<SDL_PIXELFORMAT_ABGR8888>
+{
+  //! The pixel value type
+  typedef Uint32 ValueType;
+
+  //! The number of bytes per pixel
+  static const int bytes_per_pixel = 4;
+
+  //! Records if the format has an alpha channel
+  static const bool has_alpha = true;
+
+  //! Records if the format is indexed (uses a palette)
+  static const bool is_indexed = false;
+
+  //! Load a pixel value
+  static ValueType load( const Uint8* pixel )
+  { ValueType value; std::memcpy( &value, pixel, 4 ); return value; }
+
+  //! Store a pixel value
+  static void store( Uint8* pixel, const ValueType value )
+  { std::memcpy( pixel, &value, 4 ); }
+
+  //! Convert a pixel value to an ARGB8888 value (swap red and blue)
+  static Uint32 toARGB( const ValueType value, const SDL_Palette* )
+  { return (value & 0xFF00FF00) | ((value >> 16) & 0xFF) |
+      ((value & 0xFF) << 16); }
+
+  //! Convert an ARGB8888 value to a pixel value (swap red and blue)
+  static ValueType fromARGB( const Uint32 argb )
+  { return toARGB( argb, NULL ); }
+};
+
+//! The RGB24 pixel format traits (the bytes are stored as R, G, B)
+template<>
+struct PixelFormatTraits<SDL_PIXELFORMAT_RGB24>
+{
+  //! The pixel value type (0x00RRGGBB)
+  typedef Uint32 ValueType;
+
+  //! The number of bytes per pixel
+  static const int bytes_per_pixel = 3;
+
+  //! Records if the format has an alpha channel
+  static const bool has_alpha = false;
+
+  //! Records if the format is indexed (uses a palette)
+  static const bool is_indexed = false;
+
+  //! Load a pixel value
+  static ValueType load( const Uint8* pixel )
+  { return ((Uint32)pixel[0] << 16) | ((Uint32)pixel[1] << 8) | pixel[2]; }
+
+  //! Store a pixel value
+  static void store( Uint8* pixel, const ValueType value )
+  { pixel[0] = value >> 16; pixel[1] = value >> 8; pixel[2] = value; }
+
+  //! Convert a pixel value to an ARGB8888 value (the pixel is opaque)
+  static Uint32 toARGB( const ValueType value, const SDL_Palette* )
+  { return 0xFF000000 | value; }
+
+  //! Convert an ARGB8888 value to a pixel value (the alpha is dropped)
+  static ValueType fromARGB( const Uint32 argb )
+  { return argb & 0x00FFFFFF; }
+};
+
+//! The RGB565 pixel format traits
+template<>
+struct PixelFormatTraits<SDL_PIXELFORMAT_RGB565>
+{
+  //! The pixel value type
+  typedef Uint16 ValueType;
+
+  //! The number of bytes per pixel
+  static const int bytes_per_pixel = 2;
+
+  //! Records if the format has an alpha channel
+  static const bool has_alpha = false;
+
+  //! Records if the format is indexed (uses a palette)
+  static const bool is_indexed = false;
+
+  //! Load a pixel value
+  static ValueType load( const Uint8* pixel )
+  { ValueType value; std::memcpy( &value, pixel, 2 ); return value; }
+
+  //! Store a pixel value
+  static void store( Uint8* pixel, const ValueType value )
+  { std::memcpy( pixel, &value, 2 ); }
+
+  //! Convert a pixel value to an ARGB8888 value (the bits are replicated)
+  static Uint32 toARGB( const ValueType value, const SDL_Palette* )
+  {
+    const Uint32 red = (value >> 11) & 0x1F;
+    const Uint32 green = (value >> 5) & 0x3F;
+    const Uint32 blue = value & 0x1F;
+
+    return 0xFF000000 |
+      (((red << 3) | (red >> 2)) << 16) |
+      (((green << 2) | (green >> 4)) << 8) |
+      ((blue << 3) | (blue >> 2));
+  }
+
+  //! Convert an ARGB8888 value to a pixel value (the low bits are dropped)
+  static ValueType fromARGB( const Uint32 argb )
+  { return ((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) |
+      ((argb >> 3) & 0x001F); }
+};
+
+//! The INDEX8 pixel format traits
+template<>
+struct PixelFormatTraits<SDL_PIXELFORMAT_INDEX8>
+{
+  //! The pixel value type (the palette index)
+  typedef Uint8 ValueType;
+
+  //! The number of bytes per pixel
+  static const int bytes_per_pixel = 1;
+
+  //! Records if the format has an alpha channel
+  static const bool has_alpha = false;
+
+  //! Records if the format is indexed (uses a palette)
+  static const bool is_indexed = true;
+
+  //! Load a pixel value
+  static ValueType load( const Uint8* pixel )
+  { return *pixel; }
+
+  //! Store a pixel value
+  static void store( Uint8* pixel, const ValueType value )
+  { *pixel = value; }
+
+  //! Convert a pixel value to an ARGB8888 value (palette lookup)
+  static Uint32 toARGB( const ValueType value, const SDL_Palette* palette )
+  {
+    const SDL_Color& color = palette->colors[value];
+
+    return ((Uint32)color.a << 24) | ((Uint32)color.r << 16) |
+      ((Uint32)color.g << 8) | color.b;
+  }
+
+  // Note: ARGB8888 values cannot be converted without a palette search
+};
+
+/*! The pixel reference class
+ * \details The reference is a proxy for a pixel stored in the format. A
+ * reference to a const pixel can be created by using const Uint8 as the
+ * byte type.
+ */
+template<Uint32 Format, typename ByteType = Uint8>
+class PixelRef
+{
+
+public:
+
+  //! The format traits
+  typedef PixelFormatTraits<Format> Traits;
+
+  //! The pixel value type
+  typedef typename Traits::ValueType ValueType;
+
+  //! Constructor
+  explicit PixelRef( ByteType* pixel );
+
+  //! Get the pixel value
+  operator ValueType() const;
+
+  //! Set the pixel value
+  PixelRef& operator=( const ValueType value );
+
+  //! Set the pixel value (copy the value of another pixel)
+  PixelRef& operator=( const PixelRef& other_pixel );
+
+  //! Get the pixel value
+  ValueType getValue() const;
+
+  //! Get the pixel as an ARGB8888 value
+  Uint32 getARGB( const SDL_Palette* palette = NULL ) const;
+
+  //! Set the pixel from an ARGB8888 value
+  void setARGB( const Uint32 argb );
+
+private:
+
+  // The pixel
+  ByteType* d_pixel;
+};
+
+/*! The pixel iterator class
+ * \details The iterator steps through the pixels of a row (the stride is
+ * known at compile time).
+ */
+template<Uint32 Format, typename ByteType = Uint8>
+class PixelIterator
+{
+
+public:
+
+  //! The pixel reference type
+  typedef PixelRef<Format,ByteType> Reference;
+
+  //! Constructor
+  explicit PixelIterator( ByteType* pixel );
+
+  //! Get the pixel
+  Reference operator*() const;
+
+  //! Move to the next pixel
+  PixelIterator& operator++();
+
+  //! Move by a number of pixels
+  PixelIterator& operator+=( const int number_of_pixels );
+
+  //! Get the number of pixels between two iterators
+  int operator-( const PixelIterator& other_iterator ) const;
+
+  //! Check if two iterators point to the same pixel
+  bool operator==( const PixelIterator& other_iterator ) const;
+
+  //! Check if two iterators point to different pixels
+  bool operator!=( const PixelIterator& other_iterator ) const;
+
+private:
+
+  // The pixel
+  ByteType* d_pixel;
+};
+
+/*! The pixel row class
+ * \details The row is a range of pixels (it can be used with range-based
+ * for loops).
+ */
+template<Uint32 Format, typename ByteType = Uint8>
+class PixelRow
+{
+
+public:
+
+  //! The pixel reference type
+  typedef PixelRef<Format,ByteType> Reference;
+
+  //! The pixel iterator type
+  typedef PixelIterator<Format,ByteType> Iterator;
+
+  //! Constructor
+  PixelRow( ByteType* pixels, const int width );
+
+  //! Get the width of the row
+  int getWidth() const;
+
+  //! Get an iterator to the first pixel
+  Iterator begin() const;
+
+  //! Get an iterator past the last pixel
+  Iterator end() const;
+
+  //! Get a pixel (not bounds checked)
+  Reference operator[]( const int x ) const;
+
+private:
+
+  // The pixels
+  ByteType* d_pixels;
+
+  // The width
+  int d_width;
+};
+
+/*! The pixel row iterator class
+ * \details The iterator steps through the rows of a view (the stride is the
+ * pitch of the view).
+ */
+template<Uint32 Format, typename ByteType = Uint8>
+class PixelRowIterator
+{
+
+public:
+
+  //! The row type
+  typedef PixelRow<Format,ByteType> Row;
+
+  //! Constructor
+  PixelRowIterator( ByteType* row, const int width, const int pitch );
+
+  //! Get the row
+  Row operator*() const;
+
+  //! Move to the next row
+  PixelRowIterator& operator++();
+
+  //! Check if two iterators point to the same row
+  bool operator==( const PixelRowIterator& other_iterator ) const;
+
+  //! Check if two iterators point to different rows
+  bool operator!=( const PixelRowIterator& other_iterator ) const;
+
+private:
+
+  // The row
+  ByteType* d_row;
+
+  // The width of a row
+  int d_width;
+
+  // The pitch
+  int d_pitch;
+};
+
+/*! The pixel view class
+ * \details The view is a pitch-aware 2D view of pixels stored in the
+ * format. The format (and therefore the pixel stride and the conversions)
+ * is known at compile time, so loops over a view can be specialized and
+ * vectorized by the compiler. A view of const pixels can be created by
+ * using const Uint8 as the byte type (see ConstPixelView). The view does
+ * not own the pixels. Use dispatchPixelFormat to select the view for a
+ * format that is only known at runtime.
+ */
+template<Uint32 Format, typename ByteType = Uint8>
+class PixelView
+{
+
+public:
+
+  //! The format traits
+  typedef PixelFormatTraits<Format> Traits;
+
+  //! The pixel value type
+  typedef typename Traits::ValueType ValueType;
+
+  //! The pixel reference type
+  typedef PixelRef<Format,ByteType> Reference;
+
+  //! The pixel iterator type
+  typedef PixelIterator<Format,ByteType> Iterator;
+
+  //! The pixel row type
+  typedef PixelRow<Format,ByteType> Row;
+
+  //! The pixel row iterator type
+  typedef PixelRowIterator<Format,ByteType> RowIterator;
+
+  //! Constructor
+  PixelView( ByteType* pixels,
+	     const int width,
+	     const int height,
+	     const int pitch,
+	     const SDL_Palette* palette = NULL );
+
+  //! Surface constructor (the surface must not require locking)
+  explicit PixelView( Surface& surface );
+
+  //! Const surface constructor (const pixel views only)
+  explicit PixelView( const Surface& surface );
+
+  //! Streaming texture lock constructor
+  explicit PixelView( StreamingTextureLock& lock );
+
+  //! Get the width of the view
+  int getWidth() const;
+
+  //! Get the height of the view
+  int getHeight() const;
+
+  //! Get the length of a row of pixels in bytes (pitch)
+  int getPitch() const;
+
+  //! Get the palette (NULL if the format is not indexed)
+  const SDL_Palette* getPalette() const;
+
+  //! Get a row of pixels
+  ByteType* getRowPointer( const int y ) const;
+
+  //! Get an iterator to the first pixel of a row
+  Iterator rowBegin( const int y ) const;
+
+  //! Get an iterator past the last pixel of a row
+  Iterator rowEnd( const int y ) const;
+
+  //! Get a row
+  Row getRow( const int y ) const;
+
+  //! Get an iterator to the first row
+  RowIterator rowsBegin() const;
+
+  //! Get an iterator past the last row
+  RowIterator rowsEnd() const;
+
+  //! Get a pixel
+  Reference operator()( const int x, const int y ) const;
+
+  //! Get a pixel as an ARGB8888 value
+  Uint32 getARGB( const int x, const int y ) const;
+
+  //! Fill a span of a row with a pixel value
+  void fillRow( const int y,
+		const int x,
+		const int length,
+		const ValueType value ) const;
+
+  //! Fill the view with a pixel value
+  void fill( const ValueType value ) const;
+
+  //! Call a function for every pixel (row by row)
+  template<typename Function>
+  void forEachPixel( Function function ) const;
+
+private:
+
+  // The pixels
+  ByteType* d_pixels;
+
+  // The width
+  int d_width;
+
+  // The height
+  int d_height;
+
+  // The pitch
+  int d_pitch;
+
+  // The palette
+  const SDL_Palette* d_palette;
+};
+
+//! The const pixel view
+template<Uint32 Format>
+using ConstPixelView = PixelView<Format,const Uint8>;
+
+//! The pixel format tag (used to dispatch runtime formats)
+template<Uint32 Format>
+struct PixelFormatTag
+{
+  //! The format
+  static const Uint32 format = Format;
+};
+
+//! Check if a pixel format has compile-time traits
+bool isPixelFormatSpecialized( const Uint32 format );
+
+//! Call a function with the tag of a runtime pixel format
+template<typename Function>
+bool dispatchPixelFormat( const Uint32 format, Function function );
+
+// Constructor
+template<Uint32 Format, typename ByteType>
+inline PixelRef<Format,ByteType>::PixelRef( ByteType* pixel )
+  : d_pixel( pixel )
+{ /* ... */ }
+
+// Get the pixel value
+template<Uint32 Format, typename ByteType>
+inline PixelRef<Format,ByteType>::operator ValueType() const
+{
+  return Traits::load( d_pixel );
+}
+
+// Set the pixel value
+template<Uint32 Format, typename ByteType>
+inline PixelRef<Format,ByteType>&
+PixelRef<Format,ByteType>::operator=( const ValueType value )
+{
+  Traits::store( d_pixel, value );
+
+  return *this;
+}
+
+// Set the pixel value (copy the value of another pixel)
+template<Uint32 Format, typename ByteType>
+inline PixelRef<Format,ByteType>&
+PixelRef<Format,ByteType>::operator=( const PixelRef& other_pixel )
+{
+  Traits::store( d_pixel, other_pixel.getValue() );
+
+  return *this;
+}
+
+// Get the pixel value
+template<Uint32 Format, typename ByteType>
+inline typename PixelRef<Format,ByteType>::ValueType
+PixelRef<Format,ByteType>::getValue() const
+{
+  return Traits::load( d_pixel );
+}
+
+// Get the pixel as an ARGB8888 value
+/*! \details The palette is only used by indexed formats.
+ */
+template<Uint32 Format, typename ByteType>
+inline Uint32 PixelRef<Format,ByteType>::getARGB(
+					   const SDL_Palette* palette ) const
+{
+  return Traits::toARGB( Traits::load( d_pixel ), palette );
+}
+
+// Set the pixel from an ARGB8888 value
+/*! \details This is not available for indexed formats.
+ */
+template<Uint32 Format, typename ByteType>
+inline void PixelRef<Format,ByteType>::setARGB( const Uint32 argb )
+{
+  Traits::store( d_pixel, Traits::fromARGB( argb ) );
+}
+
+// Constructor
+template<Uint32 Format, typename ByteType>
+inline PixelIterator<Format,ByteType>::PixelIterator( ByteType* pixel )
+  : d_pixel( pixel )
+{ /* ... */ }
+
+// Get the pixel
+template<Uint32 Format, typename ByteType>
+inline typename PixelIterator<Format,ByteType>::Reference
+PixelIterator<Format,ByteType>::operator*() const
+{
+  return Reference( d_pixel );
+}
+
+// Move to the next pixel
+template<Uint32 Format, typename ByteType>
+inline PixelIterator<Format,ByteType>&
+PixelIterator<Format,ByteType>::operator++()
+{
+  d_pixel += PixelFormatTraits<Format>::bytes_per_pixel;
+
+  return *this;
+}
+
+// Move by a number of pixels
+template<Uint32 Format, typename ByteType>
+inline PixelIterator<Format,ByteType>&
+PixelIterator<Format,ByteType>::operator+=( const int number_of_pixels )
+{
+  d_pixel += number_of_pixels*PixelFormatTraits<Format>::bytes_per_pixel;
+
+  return *this;
+}
+
+// Get the number of pixels between two iterators
+template<Uint32 Format, typename ByteType>
+inline int PixelIterator<Format,ByteType>::operator-(
+			      const PixelIterator& other_iterator ) const
+{
+  return (d_pixel - other_iterator.d_pixel)/
+    PixelFormatTraits<Format>::bytes_per_pixel;
+}
+
+// Check if two iterators point to the same pixel
+template<Uint32 Format, typename ByteType>
+inline bool PixelIterator<Format,ByteType>::operator==(
+			      const PixelIterator& other_iterator ) const
+{
+  return d_pixel == other_iterator.d_pixel;
+}
+
+// Check if two iterators point to different pixels
+template<Uint32 Format, typename ByteType>
+inline bool PixelIterator<Format,ByteType>::operator!=(
+			      const PixelIterator& other_iterator ) const
+{
+  return d_pixel != other_iterator.d_pixel;
+}
+
+// Constructor
+template<Uint32 Format, typename ByteType>
+inline PixelRow<Format,ByteType>::PixelRow( ByteType* pixels,
+					    const int width )
+  : d_pixels( pixels ),
+    d_width( width )
+{ /* ... */ }
+
+// Get the width of the row
+template<Uint32 Format, typename ByteType>
+inline int PixelRow<Format,ByteType>::getWidth() const
+{
+  return d_width;
+}
+
+// Get an iterator to the first pixel
+template<Uint32 Format, typename ByteType>
+inline typename PixelRow<Format,ByteType>::Iterator
+PixelRow<Format,ByteType>::begin() const
+{
+  return Iterator( d_pixels );
+}
+
+// Get an iterator past the last pixel
+template<Uint32 Format, typename ByteType>
+inline typename PixelRow<Format,ByteType>::Iterator
+PixelRow<Format,ByteType>::end() const
+{
+  return Iterator( d_pixels +
+		   d_width*PixelFormatTraits<Format>::bytes_per_pixel );
+}
+
+// Get a pixel (not bounds checked)
+template<Uint32 Format, typename ByteType>
+inline typename PixelRow<Format,ByteType>::Reference
+PixelRow<Format,ByteType>::operator[]( const int x ) const
+{
+  return Reference( d_pixels + x*PixelFormatTraits<Format>::bytes_per_pixel );
+}
+
+// Constructor
+template<Uint32 Format, typename ByteType>
+inline PixelRowIterator<Format,ByteType>::PixelRowIterator(
+							 ByteType* row,
+							 const int width,
+							 const int pitch )
+  : d_row( row ),
+    d_width( width ),
+    d_pitch( pitch )
+{ /* ... */ }
+
+// Get the row
+template<Uint32 Format, typename ByteType>
+inline typename PixelRowIterator<Format,ByteType>::Row
+PixelRowIterator<Format,ByteType>::operator*() const
+{
+  return Row( d_row, d_width );
+}
+
+// Move to the next row
+template<Uint32 Format, typename ByteType>
+inline PixelRowIterator<Format,ByteType>&
+PixelRowIterator<Format,ByteType>::operator++()
+{
+  d_row += d_pitch;
+
+  return *this;
+}
+
+// Check if two iterators point to the same row
+template<Uint32 Format, typename ByteType>
+inline bool PixelRowIterator<Format,ByteType>::operator==(
+				   const PixelRowIterator& other_iterator ) const
+{
+  return d_row == other_iterator.d_row;
+}
+
+// Check if two iterators point to different rows
+template<Uint32 Format, typename ByteType>
+inline bool PixelRowIterator<Format,ByteType>::operator!=(
+				   const PixelRowIterator& other_iterator ) const
+{
+  return d_row != other_iterator.d_row;
+}
+
+// Constructor
+template<Uint32 Format, typename ByteType>
+inline PixelView<Format,ByteType>::PixelView( ByteType* pixels,
+					      const int width,
+					      const int height,
+					      const int pitch,
+					      const SDL_Palette* palette )
+  : d_pixels( pixels ),
+    d_width( width ),
+    d_height( height ),
+    d_pitch( pitch ),
+    d_palette( palette )
+{
+  // Make sure the pixels are valid
+  testPrecondition( pixels != NULL );
+  // Make sure the dimensions are valid
+  testPrecondition( width >= 0 );
+  testPrecondition( height >= 0 );
+  testPrecondition( pitch >= width*Traits::bytes_per_pixel );
+  // Make sure indexed pixels have a palette
+  testPrecondition( !Traits::is_indexed || palette != NULL );
+}
+
+// Surface constructor (the surface must not require locking)
+template<Uint32 Format, typename ByteType>
+inline PixelView<Format,ByteType>::PixelView( Surface& surface )
+  : d_pixels( static_cast<ByteType*>( surface.getRawSurfacePtr()->pixels ) ),
+    d_width( surface.getWidth() ),
+    d_height( surface.getHeight() ),
+    d_pitch( surface.getPitch() ),
+    d_palette( surface.getPixelFormat().palette )
+{
+  // Make sure the surface format is valid
+  testPrecondition( surface.getPixelFormatValue() == Format );
+  // Make sure the surface pixels can be accessed
+  testPrecondition( !surface.mustLock() || surface.isLocked() );
+}
+
+// Const surface constructor (const pixel views only)
+template<Uint32 Format, typename ByteType>
+inline PixelView<Format,ByteType>::PixelView( const Surface& surface )
+  : d_pixels( static_cast<ByteType*>( surface.getPixels() ) ),
+    d_width( surface.getWidth() ),
+    d_height( surface.getHeight() ),
+    d_pitch( surface.getPitch() ),
+    d_palette( surface.getPixelFormat().palette )
+{
+  // Make sure the surface format is valid
+  testPrecondition( surface.getPixelFormatValue() == Format );
+  // Make sure the surface pixels can be accessed
+  testPrecondition( !surface.mustLock() || surface.isLocked() );
+}
+
+// Streaming texture lock constructor
+template<Uint32 Format, typename ByteType>
+inline PixelView<Format,ByteType>::PixelView( StreamingTextureLock& lock )
+  : d_pixels( static_cast<ByteType*>( lock.getPixels() ) ),
+    d_width( lock.getWidth() ),
+    d_height( lock.getHeight() ),
+    d_pitch( lock.getPitch() ),
+    d_palette( NULL )
+{
+  // Make sure the texture format is valid
+  testPrecondition( lock.getFormat() == Format );
+}
+
+// Get the width of the view
+template<Uint32 Format, typename ByteType>
+inline int PixelView<Format,ByteType>::getWidth() const
+{
+  return d_width;
+}
+
+// Get the height of the view
+template<Uint32 Format, typename ByteType>
+inline int PixelView<Format,ByteType>::getHeight() const
+{
+  return d_height;
+}
+
+// Get the length of a row of pixels in bytes (pitch)
+template<Uint32 Format, typename ByteType>
+inline int PixelView<Format,ByteType>::getPitch() const
+{
+  return d_pitch;
+}
+
+// Get the palette (NULL if the format is not indexed)
+template<Uint32 Format, typename ByteType>
+inline const SDL_Palette* PixelView<Format,ByteType>::getPalette() const
+{
+  return d_palette;
+}
+
+// Get a row of pixels
+template<Uint32 Format, typename ByteType>
+inline ByteType* PixelView<Format,ByteType>::getRowPointer( const int y ) const
+{
+  // Make sure the row is valid
+  testPrecondition( y >= 0 );
+  testPrecondition( y < d_height );
+
+  return d_pixels + y*d_pitch;
+}
+
+// Get an iterator to the first pixel of a row
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::Iterator
+PixelView<Format,ByteType>::rowBegin( const int y ) const
+{
+  return Iterator( this->getRowPointer( y ) );
+}
+
+// Get an iterator past the last pixel of a row
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::Iterator
+PixelView<Format,ByteType>::rowEnd( const int y ) const
+{
+  return Iterator( this->getRowPointer( y ) +
+		   d_width*Traits::bytes_per_pixel );
+}
+
+// Get a row
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::Row
+PixelView<Format,ByteType>::getRow( const int y ) const
+{
+  return Row( this->getRowPointer( y ), d_width );
+}
+
+// Get an iterator to the first row
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::RowIterator
+PixelView<Format,ByteType>::rowsBegin() const
+{
+  return RowIterator( d_pixels, d_width, d_pitch );
+}
+
+// Get an iterator past the last row
+/*! \details The iterator is never dereferenced (so it can point past the
+ * pixels).
+ */
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::RowIterator
+PixelView<Format,ByteType>::rowsEnd() const
+{
+  return RowIterator( d_pixels + d_height*d_pitch, d_width, d_pitch );
+}
+
+// Get a pixel
+/*! \details The pixel is not bounds checked (only the row is).
+ */
+template<Uint32 Format, typename ByteType>
+inline typename PixelView<Format,ByteType>::Reference
+PixelView<Format,ByteType>::operator()( const int x, const int y ) const
+{
+  return Reference( this->getRowPointer( y ) + x*Traits::bytes_per_pixel );
+}
+
+// Get a pixel as an ARGB8888 value
+template<Uint32 Format, typename ByteType>
+inline Uint32 PixelView<Format,ByteType>::getARGB( const int x,
+						   const int y ) const
+{
+  return (*this)( x, y ).getARGB( d_palette );
+}
+
+// Fill a span of a row with a pixel value
+template<Uint32 Format, typename ByteType>
+inline void PixelView<Format,ByteType>::fillRow( const int y,
+						 const int x,
+						 const int length,
+						 const ValueType value ) const
+{
+  // Make sure the span is valid
+  testPrecondition( x >= 0 );
+  testPrecondition( length >= 0 );
+  testPrecondition( x + length <= d_width );
+
+  ByteType* pixel = this->getRowPointer( y ) + x*Traits::bytes_per_pixel;
+
+  for( int i = 0; i < length; ++i )
+  {
+    Traits::store( pixel, value );
+
+    pixel += Traits::bytes_per_pixel;
+  }
+}
+
+// Fill the view with a pixel value
+template<Uint32 Format, typename ByteType>
+inline void PixelView<Format,ByteType>::fill( const ValueType value ) const
+{
+  for( int y = 0; y < d_height; ++y )
+    this->fillRow( y, 0, d_width, value );
+}
+
+// Call a function for every pixel (row by row)
+/*! \details The function is called with a pixel reference. It is inlined
+ * into the row loop so simple functions will be vectorized.
+ */
+template<Uint32 Format, typename ByteType>
+template<typename Function>
+inline void PixelView<Format,ByteType>::forEachPixel(
+					       Function function ) const
+{
+  for( int y = 0; y < d_height; ++y )
+  {
+    ByteType* pixel = d_pixels + y*d_pitch;
+
+    for( int x = 0; x < d_width; ++x )
+    {
+      function( Reference( pixel ) );
+
+      pixel += Traits::bytes_per_pixel;
+    }
+  }
+}
+
+// Call a function with the tag of a runtime pixel format
+/*! \details The function must have a call operator template that takes a
+ * PixelFormatTag (so a kernel is written once and compiled for every
+ * specialized format). The function is taken by value (like the standard
+ * algorithms) - use std::ref to get results out of a stateful function.
+ * False will be returned if the format is not specialized (the function is
+ * not called).
+ */
+template<typename Function>
+inline bool dispatchPixelFormat( const Uint32 format, Function function )
+{
+  switch( format )
+  {
+  case SDL_PIXELFORMAT_ARGB8888:
+    function( PixelFormatTag<SDL_PIXELFORMAT_ARGB8888>() );
+    return true;
+  case SDL_PIXELFORMAT_ABGR8888:
+    function( PixelFormatTag<SDL_PIXELFORMAT_ABGR8888>() );
+    return true;
+  case SDL_PIXELFORMAT_RGB24:
+    function( PixelFormatTag<SDL_PIXELFORMAT_RGB24>() );
+    return true;
+  case SDL_PIXELFORMAT_RGB565:
+    function( PixelFormatTag<SDL_PIXELFORMAT_RGB565>() );
+    return true;
+  case SDL_PIXELFORMAT_INDEX8:
+    function( PixelFormatTag<SDL_PIXELFORMAT_INDEX8>() );
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // end GDev namespace
+
+#endif // end GDEV_PIXEL_VIEW_HPP
+
+//---------------------------------------------------------------------------//
+// end PixelView.hpp
+//---------------------------------------------------------------------------//
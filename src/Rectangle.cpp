@@ -10,6 +10,12 @@
 #include "Rectangle.hpp"
 #include "DBCMacros.hpp"
 
+// The SIMD kernels are only available with gcc compatible x86 compilers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GDEV_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace GDev{
 
 // Constructor
@@ -137,6 +143,368 @@ bool Rectangle::isPointOn( const int x_position,
   return is_on;
 }
 
+// Check if points are in (or on) the shape (one mask bit per point)
+/*! \details The results are identical to the ones returned by isPointIn.
+ */
+void Rectangle::arePointsIn( const int* x_positions,
+			     const int* y_positions,
+			     const unsigned number_of_points,
+			     Uint32* mask ) const
+{
+  // The inner bounds are empty
+  PointTestBounds bounds = {d_x_position,
+			    d_x_position + d_width,
+			    d_y_position,
+			    d_y_position + d_height,
+			    0xFFFFFFFF, 0u, 0xFFFFFFFF, 0u};
+
+  Rectangle::testPoints( x_positions, 
+			 y_positions, 
+			 number_of_points, 
+			 bounds, 
+			 mask );
+}
+
+// Check if points are on the shape boundary (one mask bit per point)
+/*! \details The results are identical to the ones returned by isPointOn
+ * (the inner bounds are compared as unsigned values).
+ */
+void Rectangle::arePointsOn( const int* x_positions,
+			     const int* y_positions,
+			     const unsigned number_of_points,
+			     Uint32* mask ) const
+{
+  if( d_edge_thickness > 0u )
+  {
+    PointTestBounds bounds = {d_x_position,
+			      d_x_position + d_width,
+			      d_y_position,
+			      d_y_position + d_height,
+			      d_x_position + d_edge_thickness,
+			      d_x_position + d_width - d_edge_thickness,
+			      d_y_position + d_edge_thickness,
+			      d_y_position + d_height - d_edge_thickness};
+
+    Rectangle::testPoints( x_positions, 
+			   y_positions, 
+			   number_of_points, 
+			   bounds, 
+			   mask );
+  }
+  else
+    Shape::clearMask( number_of_points, mask );
+}
+
+// Get the geometry parameters
+/*! \details isPointOn compares the edge boundaries as unsigned values, so
+ * the edge pixels of an outlined rectangle with a negative position depend
+ * on the position - false will be returned for these rectangles.
+ */
+bool Rectangle::getGeometry( ShapeGeometry& geometry ) const
+{
+  if( d_edge_thickness > 0u && (d_x_position < 0 || d_y_position < 0) )
+    return false;
+  
+  geometry[0] = d_width;
+  geometry[1] = d_height;
+  geometry[2] = d_edge_thickness;
+  geometry[3] = 0;
+  geometry[4] = 0;
+
+  return true;
+}
+
+// Check if the row spans are computed without testing every pixel
+bool Rectangle::hasAnalyticRowSpans() const
+{
+  return true;
+}
+
+// Check if the covered pixels form a few axis aligned rectangles
+/*! \details A rectangle is covered by at most five rectangles (one for a
+ * filled rectangle and the four edges of an outlined rectangle).
+ */
+bool Rectangle::hasRectangularCoverage() const
+{
+  return true;
+}
+
+// Get the coverage spans of a bounding box row
+/*! \details Every bounding box pixel is in the rectangle so only the edge
+ * spans need to be determined. isPointOn compares the edge boundaries as
+ * unsigned values, which only agrees with the analytic (signed) spans when
+ * all of the boundaries are non-negative - the generic spans are used 
+ * otherwise.
+ */
+void Rectangle::getRowSpans( const int y_position,
+			     std::vector<ShapeSpan>& spans ) const
+{
+  // Make sure the row is in the bounding box
+  testPrecondition( y_position >= d_y_position );
+  testPrecondition( y_position < d_y_position + d_height );
+
+  if( d_edge_thickness > 0u &&
+      (d_x_position < 0 || d_y_position < 0 ||
+       d_edge_thickness > (unsigned)d_width ||
+       d_edge_thickness > (unsigned)d_height) )
+  {
+    Shape::getRowSpans( y_position, spans );
+  }
+  else
+  {
+    spans.clear();
+
+    const int end_x_position = d_x_position + d_width;
+    
+    if( d_edge_thickness > 0u )
+    {
+      // Check if the row passes through the rectangle interior
+      if( y_position > d_y_position + (int)d_edge_thickness &&
+	  y_position < d_y_position + d_height - (int)d_edge_thickness )
+      {
+	int inner_start_x_position = d_x_position + d_edge_thickness + 1;
+	int inner_end_x_position = end_x_position - d_edge_thickness;
+
+	if( inner_start_x_position > end_x_position )
+	  inner_start_x_position = end_x_position;
+	
+	if( inner_end_x_position < inner_start_x_position )
+	  inner_end_x_position = inner_start_x_position;
+
+	Shape::addSpan( spans, 
+			d_x_position, 
+			inner_start_x_position, 
+			ON_SHAPE_EDGE );
+	Shape::addSpan( spans,
+			inner_start_x_position,
+			inner_end_x_position,
+			INSIDE_SHAPE );
+	Shape::addSpan( spans,
+			inner_end_x_position,
+			end_x_position,
+			ON_SHAPE_EDGE );
+      }
+      else
+	Shape::addSpan( spans, d_x_position, end_x_position, ON_SHAPE_EDGE );
+    }
+    else
+      Shape::addSpan( spans, d_x_position, end_x_position, INSIDE_SHAPE );
+  }
+}
+
+// Test points against the bounds (one mask bit per point)
+/*! \details The SIMD kernels test the largest multiple of their width and
+ * the scalar kernel tests the remaining points.
+ */
+void Rectangle::testPoints( const int* x_positions,
+			    const int* y_positions,
+			    const unsigned number_of_points,
+			    const PointTestBounds& bounds,
+			    Uint32* mask )
+{
+  Shape::clearMask( number_of_points, mask );
+
+  unsigned number_of_tested_points = 0u;
+
+  switch( Shape::getKernel() )
+  {
+  case AVX2_KERNEL:
+    number_of_tested_points = Rectangle::testPointsAVX2( x_positions,
+							 y_positions,
+							 number_of_points,
+							 bounds,
+							 mask );
+    break;
+  case SSE2_KERNEL:
+    number_of_tested_points = Rectangle::testPointsSSE2( x_positions,
+							 y_positions,
+							 number_of_points,
+							 bounds,
+							 mask );
+    break;
+  default:
+    break;
+  }
+
+  Rectangle::testPointsScalar( x_positions,
+			       y_positions,
+			       number_of_tested_points,
+			       number_of_points,
+			       bounds,
+			       mask );
+}
+
+// Test points against the bounds (scalar kernel)
+/*! \details The mask bits of the points must already be cleared.
+ */
+void Rectangle::testPointsScalar( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned start_point_index,
+				  const unsigned end_point_index,
+				  const PointTestBounds& bounds,
+				  Uint32* mask )
+{
+  for( unsigned i = start_point_index; i < end_point_index; ++i )
+  {
+    const int x = x_positions[i];
+    const int y = y_positions[i];
+
+    const bool outer = x >= bounds.left && x <= bounds.right &&
+      y >= bounds.top && y <= bounds.bottom;
+
+    const bool inner = 
+      (Uint32)x > bounds.inner_left && (Uint32)x < bounds.inner_right &&
+      (Uint32)y > bounds.inner_top && (Uint32)y < bounds.inner_bottom;
+
+    if( outer && !inner )
+      Shape::setMaskBit( mask, i );
+  }
+}
+
+#ifdef GDEV_X86_SIMD_KERNELS
+
+// Test points against the bounds (SSE2 kernel)
+/*! \details Four points are tested at a time. The unsigned comparisons are
+ * done by flipping the sign bits. The number of tested points is returned.
+ */
+__attribute__((target("sse2")))
+unsigned Rectangle::testPointsSSE2( const int* x_positions,
+				    const int* y_positions,
+				    const unsigned number_of_points,
+				    const PointTestBounds& bounds,
+				    Uint32* mask )
+{
+  const __m128i sign_bit = _mm_set1_epi32( 0x80000000 );
+  
+  const __m128i left = _mm_set1_epi32( bounds.left );
+  const __m128i right = _mm_set1_epi32( bounds.right );
+  const __m128i top = _mm_set1_epi32( bounds.top );
+  const __m128i bottom = _mm_set1_epi32( bounds.bottom );
+
+  const __m128i inner_left = _mm_set1_epi32( bounds.inner_left ^ 0x80000000 );
+  const __m128i inner_right = _mm_set1_epi32( bounds.inner_right ^ 0x80000000 );
+  const __m128i inner_top = _mm_set1_epi32( bounds.inner_top ^ 0x80000000 );
+  const __m128i inner_bottom = 
+    _mm_set1_epi32( bounds.inner_bottom ^ 0x80000000 );
+
+  unsigned i = 0u;
+
+  for( ; i + 4u <= number_of_points; i += 4u )
+  {
+    const __m128i x = _mm_loadu_si128( 
+		       reinterpret_cast<const __m128i*>( x_positions + i ) );
+    const __m128i y = _mm_loadu_si128( 
+		       reinterpret_cast<const __m128i*>( y_positions + i ) );
+
+    const __m128i outside = _mm_or_si128(
+			     _mm_or_si128( _mm_cmplt_epi32( x, left ),
+					   _mm_cmpgt_epi32( x, right ) ),
+			     _mm_or_si128( _mm_cmplt_epi32( y, top ),
+					   _mm_cmpgt_epi32( y, bottom ) ) );
+
+    const __m128i biased_x = _mm_xor_si128( x, sign_bit );
+    const __m128i biased_y = _mm_xor_si128( y, sign_bit );
+
+    const __m128i inside = _mm_and_si128(
+		    _mm_and_si128( _mm_cmpgt_epi32( biased_x, inner_left ),
+				   _mm_cmplt_epi32( biased_x, inner_right ) ),
+		    _mm_and_si128( _mm_cmpgt_epi32( biased_y, inner_top ),
+				   _mm_cmplt_epi32( biased_y, inner_bottom ) ) );
+
+    const int rejected = _mm_movemask_ps( 
+			 _mm_castsi128_ps( _mm_or_si128( outside, inside ) ) );
+
+    mask[i/32u] |= (Uint32)(~rejected & 0xF) << (i%32u);
+  }
+
+  return i;
+}
+
+// Test points against the bounds (AVX2 kernel)
+/*! \details Eight points are tested at a time. The number of tested points
+ * is returned.
+ */
+__attribute__((target("avx2")))
+unsigned Rectangle::testPointsAVX2( const int* x_positions,
+				    const int* y_positions,
+				    const unsigned number_of_points,
+				    const PointTestBounds& bounds,
+				    Uint32* mask )
+{
+  const __m256i sign_bit = _mm256_set1_epi32( 0x80000000 );
+  
+  const __m256i left = _mm256_set1_epi32( bounds.left );
+  const __m256i right = _mm256_set1_epi32( bounds.right );
+  const __m256i top = _mm256_set1_epi32( bounds.top );
+  const __m256i bottom = _mm256_set1_epi32( bounds.bottom );
+
+  const __m256i inner_left = 
+    _mm256_set1_epi32( bounds.inner_left ^ 0x80000000 );
+  const __m256i inner_right = 
+    _mm256_set1_epi32( bounds.inner_right ^ 0x80000000 );
+  const __m256i inner_top = 
+    _mm256_set1_epi32( bounds.inner_top ^ 0x80000000 );
+  const __m256i inner_bottom = 
+    _mm256_set1_epi32( bounds.inner_bottom ^ 0x80000000 );
+
+  unsigned i = 0u;
+
+  for( ; i + 8u <= number_of_points; i += 8u )
+  {
+    const __m256i x = _mm256_loadu_si256( 
+		       reinterpret_cast<const __m256i*>( x_positions + i ) );
+    const __m256i y = _mm256_loadu_si256( 
+		       reinterpret_cast<const __m256i*>( y_positions + i ) );
+
+    // Only greater than comparisons are available
+    const __m256i outside = _mm256_or_si256(
+			     _mm256_or_si256( _mm256_cmpgt_epi32( left, x ),
+					      _mm256_cmpgt_epi32( x, right ) ),
+			     _mm256_or_si256( _mm256_cmpgt_epi32( top, y ),
+					      _mm256_cmpgt_epi32( y, bottom ) ) );
+
+    const __m256i biased_x = _mm256_xor_si256( x, sign_bit );
+    const __m256i biased_y = _mm256_xor_si256( y, sign_bit );
+
+    const __m256i inside = _mm256_and_si256(
+	       _mm256_and_si256( _mm256_cmpgt_epi32( biased_x, inner_left ),
+				 _mm256_cmpgt_epi32( inner_right, biased_x ) ),
+	       _mm256_and_si256( _mm256_cmpgt_epi32( biased_y, inner_top ),
+				 _mm256_cmpgt_epi32( inner_bottom, biased_y ) ) );
+
+    const int rejected = _mm256_movemask_ps( 
+		   _mm256_castsi256_ps( _mm256_or_si256( outside, inside ) ) );
+
+    mask[i/32u] |= (Uint32)(~rejected & 0xFF) << (i%32u);
+  }
+
+  return i;
+}
+
+#else // GDEV_X86_SIMD_KERNELS
+
+// Test points against the bounds (SSE2 kernel - not available)
+unsigned Rectangle::testPointsSSE2( const int*,
+				    const int*,
+				    const unsigned,
+				    const PointTestBounds&,
+				    Uint32* )
+{
+  return 0u;
+}
+
+// Test points against the bounds (AVX2 kernel - not available)
+unsigned Rectangle::testPointsAVX2( const int*,
+				    const int*,
+				    const unsigned,
+				    const PointTestBounds&,
+				    Uint32* )
+{
+  return 0u;
+}
+
+#endif // end GDEV_X86_SIMD_KERNELS
+
 } // end GDev namespace
 
 //---------------------------------------------------------------------------//
@@ -63,8 +63,73 @@ public:
   bool isPointOn( const int x_position,
 		  const int y_position ) const;
 
+  //! Check if points are in (or on) the shape (one mask bit per point)
+  void arePointsIn( const int* x_positions,
+		    const int* y_positions,
+		    const unsigned number_of_points,
+		    Uint32* mask ) const;
+
+  //! Check if points are on the shape boundary (one mask bit per point)
+  void arePointsOn( const int* x_positions,
+		    const int* y_positions,
+		    const unsigned number_of_points,
+		    Uint32* mask ) const;
+
+  //! Get the geometry parameters
+  bool getGeometry( ShapeGeometry& geometry ) const;
+
+  //! Check if the row spans are computed without testing every pixel
+  bool hasAnalyticRowSpans() const;
+
+  //! Check if the covered pixels form a few axis aligned rectangles
+  bool hasRectangularCoverage() const;
+
+  //! Get the coverage spans of a bounding box row
+  void getRowSpans( const int y_position,
+		    std::vector<ShapeSpan>& spans ) const;
+
 private:
 
+  // The point test bounds (a point passes if it is in the outer bounds and
+  // not in the inner bounds)
+  struct PointTestBounds
+  {
+    // The outer bounds (inclusive, signed)
+    int left, right, top, bottom;
+
+    // The inner bounds (exclusive, unsigned)
+    Uint32 inner_left, inner_right, inner_top, inner_bottom;
+  };
+
+  // Test points against the bounds (one mask bit per point)
+  static void testPoints( const int* x_positions,
+			  const int* y_positions,
+			  const unsigned number_of_points,
+			  const PointTestBounds& bounds,
+			  Uint32* mask );
+
+  // Test points against the bounds (scalar kernel)
+  static void testPointsScalar( const int* x_positions,
+				const int* y_positions,
+				const unsigned start_point_index,
+				const unsigned end_point_index,
+				const PointTestBounds& bounds,
+				Uint32* mask );
+
+  // Test points against the bounds (SSE2 kernel)
+  static unsigned testPointsSSE2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestBounds& bounds,
+				  Uint32* mask );
+
+  // Test points against the bounds (AVX2 kernel)
+  static unsigned testPointsAVX2( const int* x_positions,
+				  const int* y_positions,
+				  const unsigned number_of_points,
+				  const PointTestBounds& bounds,
+				  Uint32* mask );
+
   // The x position
   int d_x_position;
   
@@ -0,0 +1,246 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   RectanglePacker.cpp
+//! \author Alex Robinson
+//! \brief  The rectangle packer class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// GDev Includes
+#include "RectanglePacker.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Constructor
+RectanglePacker::RectanglePacker( const int width, const int height )
+  : d_width( width ),
+    d_height( height ),
+    d_number_of_rectangles( 0 ),
+    d_used_area( 0 ),
+    d_free_rectangles()
+{
+  // Make sure the bin size is valid
+  testPrecondition( width > 0 );
+  testPrecondition( height > 0 );
+
+  this->clear();
+}
+
+// Get the width of the bin
+int RectanglePacker::getWidth() const
+{
+  return d_width;
+}
+
+// Get the height of the bin
+int RectanglePacker::getHeight() const
+{
+  return d_height;
+}
+
+// Insert a rectangle (returns false if the rectangle does not fit)
+/*! \details The placement will only be set if the rectangle fits.
+ */
+bool RectanglePacker::insert( const int width,
+			      const int height,
+			      SDL_Rect& placement )
+{
+  // Make sure the rectangle is valid
+  testPrecondition( width > 0 );
+  testPrecondition( height > 0 );
+
+  bool found = false;
+  int best_short_side_fit = 0;
+  int best_long_side_fit = 0;
+  SDL_Rect best_placement = {0, 0, width, height};
+
+  for( unsigned i = 0; i < d_free_rectangles.size(); ++i )
+  {
+    const SDL_Rect& free_rectangle = d_free_rectangles[i];
+
+    if( free_rectangle.w >= width && free_rectangle.h >= height )
+    {
+      int leftover_width = free_rectangle.w - width;
+      int leftover_height = free_rectangle.h - height;
+
+      int short_side_fit = std::min( leftover_width, leftover_height );
+      int long_side_fit = std::max( leftover_width, leftover_height );
+
+      if( !found ||
+	  short_side_fit < best_short_side_fit ||
+	  (short_side_fit == best_short_side_fit &&
+	   long_side_fit < best_long_side_fit) )
+      {
+	found = true;
+	best_short_side_fit = short_side_fit;
+	best_long_side_fit = long_side_fit;
+	best_placement.x = free_rectangle.x;
+	best_placement.y = free_rectangle.y;
+      }
+    }
+  }
+
+  if( found )
+  {
+    this->splitFreeRectangles( best_placement );
+    this->pruneFreeRectangles();
+
+    ++d_number_of_rectangles;
+    d_used_area += (unsigned long)width*height;
+
+    placement = best_placement;
+  }
+
+  return found;
+}
+
+// Get the number of rectangles that have been inserted
+unsigned RectanglePacker::getNumberOfRectangles() const
+{
+  return d_number_of_rectangles;
+}
+
+// Get the area used by the inserted rectangles
+unsigned long RectanglePacker::getUsedArea() const
+{
+  return d_used_area;
+}
+
+// Get the fraction of the bin area that is used
+double RectanglePacker::getOccupancy() const
+{
+  return (double)d_used_area/((double)d_width*d_height);
+}
+
+// Get the number of free rectangles
+unsigned RectanglePacker::getNumberOfFreeRectangles() const
+{
+  return d_free_rectangles.size();
+}
+
+// Remove all rectangles from the bin
+void RectanglePacker::clear()
+{
+  d_number_of_rectangles = 0;
+  d_used_area = 0;
+
+  d_free_rectangles.clear();
+
+  SDL_Rect bin = {0, 0, d_width, d_height};
+
+  d_free_rectangles.push_back( bin );
+}
+
+// Split the free rectangles that intersect the placed rectangle
+/*! \details Each intersected free rectangle is replaced by the (up to four)
+ * maximal rectangles that remain above, below, left and right of the
+ * placed rectangle.
+ */
+void RectanglePacker::splitFreeRectangles( const SDL_Rect& placement )
+{
+  std::vector<SDL_Rect> new_free_rectangles;
+
+  for( unsigned i = 0; i < d_free_rectangles.size(); ++i )
+  {
+    const SDL_Rect& free_rectangle = d_free_rectangles[i];
+
+    // Check if the free rectangle intersects the placed rectangle
+    if( placement.x >= free_rectangle.x + free_rectangle.w ||
+	placement.x + placement.w <= free_rectangle.x ||
+	placement.y >= free_rectangle.y + free_rectangle.h ||
+	placement.y + placement.h <= free_rectangle.y )
+    {
+      new_free_rectangles.push_back( free_rectangle );
+
+      continue;
+    }
+
+    // The space above the placed rectangle
+    if( placement.y > free_rectangle.y )
+    {
+      SDL_Rect split_rectangle = free_rectangle;
+      split_rectangle.h = placement.y - free_rectangle.y;
+
+      new_free_rectangles.push_back( split_rectangle );
+    }
+
+    // The space below the placed rectangle
+    if( placement.y + placement.h < free_rectangle.y + free_rectangle.h )
+    {
+      SDL_Rect split_rectangle = free_rectangle;
+      split_rectangle.y = placement.y + placement.h;
+      split_rectangle.h = free_rectangle.y + free_rectangle.h -
+	split_rectangle.y;
+
+      new_free_rectangles.push_back( split_rectangle );
+    }
+
+    // The space left of the placed rectangle
+    if( placement.x > free_rectangle.x )
+    {
+      SDL_Rect split_rectangle = free_rectangle;
+      split_rectangle.w = placement.x - free_rectangle.x;
+
+      new_free_rectangles.push_back( split_rectangle );
+    }
+
+    // The space right of the placed rectangle
+    if( placement.x + placement.w < free_rectangle.x + free_rectangle.w )
+    {
+      SDL_Rect split_rectangle = free_rectangle;
+      split_rectangle.x = placement.x + placement.w;
+      split_rectangle.w = free_rectangle.x + free_rectangle.w -
+	split_rectangle.x;
+
+      new_free_rectangles.push_back( split_rectangle );
+    }
+  }
+
+  d_free_rectangles.swap( new_free_rectangles );
+}
+
+// Remove the free rectangles that are contained in other free rectangles
+void RectanglePacker::pruneFreeRectangles()
+{
+  for( unsigned i = 0; i < d_free_rectangles.size(); ++i )
+  {
+    for( unsigned j = i+1; j < d_free_rectangles.size(); ++j )
+    {
+      if( RectanglePacker::isContainedIn( d_free_rectangles[i],
+					  d_free_rectangles[j] ) )
+      {
+	d_free_rectangles.erase( d_free_rectangles.begin()+i );
+	--i;
+
+	break;
+      }
+
+      if( RectanglePacker::isContainedIn( d_free_rectangles[j],
+					  d_free_rectangles[i] ) )
+      {
+	d_free_rectangles.erase( d_free_rectangles.begin()+j );
+	--j;
+      }
+    }
+  }
+}
+
+// Check if a rectangle is contained in another rectangle
+bool RectanglePacker::isContainedIn( const SDL_Rect& rectangle,
+				     const SDL_Rect& other_rectangle )
+{
+  return rectangle.x >= other_rectangle.x &&
+    rectangle.y >= other_rectangle.y &&
+    rectangle.x + rectangle.w <= other_rectangle.x + other_rectangle.w &&
+    rectangle.y + rectangle.h <= other_rectangle.y + other_rectangle.h;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end RectanglePacker.cpp
+//---------------------------------------------------------------------------//
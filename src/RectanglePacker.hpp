@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   RectanglePacker.hpp
+//! \author Alex Robinson
+//! \brief  The rectangle packer class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_RECTANGLE_PACKER_HPP
+#define GDEV_RECTANGLE_PACKER_HPP
+
+// Std Lib Includes
+#include <vector>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+namespace GDev{
+
+/*! The rectangle packer class
+ * \details The packer places rectangles in a bin using the MaxRects
+ * algorithm with the best short side fit heuristic. The free space of the
+ * bin is stored as a list of maximal (possibly overlapping) free
+ * rectangles. Each rectangle is placed in the free rectangle that leaves
+ * the smallest leftover side.
+ */
+class RectanglePacker
+{
+
+public:
+
+  //! Constructor
+  RectanglePacker( const int width, const int height );
+
+  //! Destructor
+  ~RectanglePacker()
+  { /* ... */ }
+
+  //! Get the width of the bin
+  int getWidth() const;
+
+  //! Get the height of the bin
+  int getHeight() const;
+
+  //! Insert a rectangle (returns false if the rectangle does not fit)
+  bool insert( const int width, const int height, SDL_Rect& placement );
+
+  //! Get the number of rectangles that have been inserted
+  unsigned getNumberOfRectangles() const;
+
+  //! Get the area used by the inserted rectangles
+  unsigned long getUsedArea() const;
+
+  //! Get the fraction of the bin area that is used
+  double getOccupancy() const;
+
+  //! Get the number of free rectangles
+  unsigned getNumberOfFreeRectangles() const;
+
+  //! Remove all rectangles from the bin
+  void clear();
+
+private:
+
+  // Split the free rectangles that intersect the placed rectangle
+  void splitFreeRectangles( const SDL_Rect& placement );
+
+  // Remove the free rectangles that are contained in other free rectangles
+  void pruneFreeRectangles();
+
+  // Check if a rectangle is contained in another rectangle
+  static bool isContainedIn( const SDL_Rect& rectangle,
+			     const SDL_Rect& other_rectangle );
+
+  // The width of the bin
+  int d_width;
+
+  // The height of the bin
+  int d_height;
+
+  // The number of rectangles that have been inserted
+  unsigned d_number_of_rectangles;
+
+  // The area used by the inserted rectangles
+  unsigned long d_used_area;
+
+  // The free rectangles
+  std::vector<SDL_Rect> d_free_rectangles;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_RECTANGLE_PACKER_HPP
+
+//---------------------------------------------------------------------------//
+// end RectanglePacker.hpp
+//---------------------------------------------------------------------------//
@@ -9,6 +9,7 @@
 // Std Lib Includes
 #include <algorithm>
 #include <limits>
+#include <iostream>
 
 // GDev Includes
 #include "Renderer.hpp"
@@ -30,7 +31,24 @@ Renderer::Renderer( Window& window,
     d_max_texture_width(),
     d_max_texture_height(),
     d_supported_flags(),
-    d_supported_texture_formats()
+    d_supported_texture_formats(),
+    d_draw_color(),
+    d_draw_blend_mode( SDL_BLENDMODE_NONE ),
+    d_window_id( window.getId() ),
+    d_target( NULL ),
+    d_x_scale( 1.0f ),
+    d_y_scale( 1.0f ),
+    d_viewport(),
+    d_clip_rectangle(),
+    d_saved_states(),
+    d_state_changes( 0 ),
+    d_skipped_state_changes( 0 ),
+    d_draw_calls( 0 ),
+    d_slow_texture_conversions( 0 ),
+    d_shape_texture_cache( new ShapeTextureCache ),
+    d_texture_registry( new TextureRegistry(
+			    std::shared_ptr<Renderer>( this, DummyDeleter() ) ) ),
+    d_dirty_region()
 {
   // Make sure the renderer was created successfully
   TEST_FOR_EXCEPTION( d_renderer == NULL,
@@ -40,6 +58,12 @@ Renderer::Renderer( Window& window,
 		      << SDL_GetError() );
 
   this->loadRendererInfo();
+
+  this->synchronizeState();
+
+  // SDL updates the viewport of the renderer in its own event watch (added
+  // when the renderer was created), so this watch will see the new state
+  SDL_AddEventWatch( &Renderer::handleWindowEvent, this );
 }
 
 // Surface constructor
@@ -49,7 +73,24 @@ Renderer::Renderer( Surface& surface )
     d_max_texture_width(),
     d_max_texture_height(),
     d_supported_flags(),
-    d_supported_texture_formats()
+    d_supported_texture_formats(),
+    d_draw_color(),
+    d_draw_blend_mode( SDL_BLENDMODE_NONE ),
+    d_window_id( 0 ),
+    d_target( NULL ),
+    d_x_scale( 1.0f ),
+    d_y_scale( 1.0f ),
+    d_viewport(),
+    d_clip_rectangle(),
+    d_saved_states(),
+    d_state_changes( 0 ),
+    d_skipped_state_changes( 0 ),
+    d_draw_calls( 0 ),
+    d_slow_texture_conversions( 0 ),
+    d_shape_texture_cache( new ShapeTextureCache ),
+    d_texture_registry( new TextureRegistry(
+			    std::shared_ptr<Renderer>( this, DummyDeleter() ) ) ),
+    d_dirty_region()
 {
   // Make sure the renderer was created successfully
   TEST_FOR_EXCEPTION( d_renderer == NULL,
@@ -58,6 +99,8 @@ Renderer::Renderer( Surface& surface )
 		      "surface! SDL_Error: " << SDL_GetError() );
 
   this->loadRendererInfo();
+
+  this->synchronizeState();
 }
 
 // Destructor
@@ -96,6 +139,37 @@ bool Renderer::isValidTextureFormat( const Uint32 format ) const
   return it != d_supported_texture_formats.end();
 }
 
+// Get the native (preferred) texture format
+/*! \details The format is chosen the same way that SDL_CreateTextureFromSurface
+ * chooses it: the first valid texture format that is not a FOURCC (YUV) 
+ * format and that has an alpha channel if one is requested (or does not 
+ * have one if one is not requested). Textures created in this format can
+ * be uploaded without conversions.
+ */
+Uint32 Renderer::getNativeTextureFormat( const bool alpha ) const
+{
+  Uint32 native_format = SDL_PIXELFORMAT_UNKNOWN;
+  
+  for( unsigned i = 0; i < d_supported_texture_formats.size(); ++i )
+  {
+    const Uint32 format = d_supported_texture_formats[i];
+    
+    if( SDL_ISPIXELFORMAT_FOURCC( format ) )
+      continue;
+
+    if( (SDL_ISPIXELFORMAT_ALPHA( format ) != 0) == alpha )
+      return format;
+
+    if( native_format == SDL_PIXELFORMAT_UNKNOWN )
+      native_format = format;
+  }
+
+  if( native_format == SDL_PIXELFORMAT_UNKNOWN )
+    native_format = SDL_PIXELFORMAT_ARGB8888;
+
+  return native_format;
+}
+
 // Get the max texture width
 int Renderer::getMaxTextureWidth() const
 {
@@ -168,7 +242,8 @@ void Renderer::getLogicalSize( int& logical_width, int& logical_height ) const
 
 // Set the logical size of the renderer
 /*! \details This will set the device independent resolution of the renderer.
- * If this has not been set zero will be returned.
+ * If this has not been set zero will be returned. The scale and viewport of
+ * the current target will be reloaded.
  */
 void Renderer::setLogicalSize( const int logical_width,
 			       const int logical_height )
@@ -180,78 +255,103 @@ void Renderer::setLogicalSize( const int logical_width,
 		      ExceptionType,
 		      "Error: The renderer logical size could not be "
 		      "retrieved! SDL_Error: " << SDL_GetError() );
+
+  // The logical size changes the scale and viewport
+  this->loadTargetState();
 }
 
 // Get the drawing scale for the current target
 void Renderer::getScale( float& x_scale, float& y_scale ) const
 {
-  SDL_RenderGetScale( const_cast<SDL_Renderer*>( d_renderer ),
-		      &x_scale,
-		      &y_scale );
+  x_scale = d_x_scale;
+  y_scale = d_y_scale;
 }
 
 // Set the drawing scale for the current target
-void Renderer::setScale( const float x_scale, const float y_scale ) const
+/*! \details The scale will only be passed to SDL if it differs from the
+ * current scale.
+ */
+void Renderer::setScale( const float x_scale, const float y_scale )
 {
   // Make sure the scale is valid
   testPrecondition( x_scale > 0.0 );
   testPrecondition( y_scale > 0.0 );
 
+  if( x_scale == d_x_scale && y_scale == d_y_scale )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+
   int return_value = SDL_RenderSetScale( d_renderer, x_scale, y_scale );
 
   TEST_FOR_EXCEPTION( return_value != 0,
 		      ExceptionType,
 		      "Error: The renderer scale could not be set! "
 		      "SDL_Error: " << SDL_GetError() );
+
+  // SDL reports the viewport and clip rectangle in scaled coordinates
+  this->loadTargetState();
 }
 
 // Get the draw blend mode
 SDL_BlendMode Renderer::getDrawBlendMode() const
 {
-  SDL_BlendMode mode;
-  
-  int return_value = 
-    SDL_GetRenderDrawBlendMode( const_cast<SDL_Renderer*>( d_renderer ),
-				&mode );
-
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The renderer blend mode could not be retrieved! "
-		      "SDL_Error: " << SDL_GetError() );
-
-  return mode;
+  return d_draw_blend_mode;
 }
 
 // Set the draw blend mode
+/*! \details The blend mode will only be passed to SDL if it differs from the
+ * current blend mode.
+ */
 void Renderer::setDrawBlendMode( const SDL_BlendMode blend_mode )
 {
+  if( blend_mode == d_draw_blend_mode )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+  
   int return_value = SDL_SetRenderDrawBlendMode( d_renderer, blend_mode );
 
   TEST_FOR_EXCEPTION( return_value != 0,
 		      ExceptionType,
 		      "Error: The renderer blend mode could not be set! "
 		      "SDL_Error: " << SDL_GetError() );
+
+  d_draw_blend_mode = blend_mode;
 }
 
 // Get the color used for drawing operations (Rect, Line, Clear)
 void Renderer::getDrawColor( SDL_Color& draw_color ) const
 {
-  int return_value = 
-    SDL_GetRenderDrawColor( const_cast<SDL_Renderer*>( d_renderer ),
-			    &draw_color.r,
-			    &draw_color.g,
-			    &draw_color.b,
-			    &draw_color.a );
-
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The renderer draw color could not be retrieved! "
-		      "SDL_Error: " << SDL_GetError() );
+  draw_color = d_draw_color;
 }
 
 // Set the color used for drawing operations (Rect, Line, Clear)
+/*! \details The color will only be passed to SDL if it differs from the
+ * current draw color.
+ */
 void Renderer::setDrawColor( const SDL_Color& draw_color )
 {
+  if( draw_color.r == d_draw_color.r &&
+      draw_color.g == d_draw_color.g &&
+      draw_color.b == d_draw_color.b &&
+      draw_color.a == d_draw_color.a )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+  
   int return_value = 
     SDL_SetRenderDrawColor( d_renderer, 
 			    draw_color.r,
@@ -263,6 +363,8 @@ void Renderer::setDrawColor( const SDL_Color& draw_color )
 		      ExceptionType,
 		      "Error: The renderer draw color could not be set! "
 		      "SDL_Error: " << SDL_GetError() );
+
+  d_draw_color = draw_color;
 }
 
 // Check if clipping is enabled
@@ -275,19 +377,16 @@ void Renderer::setDrawColor( const SDL_Color& draw_color )
 // Get the clip rectangle for the current target
 void Renderer::getClipRectangle( SDL_Rect& clip_rectangle ) const
 {
-  SDL_RenderGetClipRect( const_cast<SDL_Renderer*>( d_renderer ),
-			 &clip_rectangle );
+  clip_rectangle = d_clip_rectangle;
 }
 
 // Set the clip rectangle for the current target
+/*! \details The clip rectangle will only be passed to SDL if it differs 
+ * from the current clip rectangle.
+ */
 void Renderer::setClipRectangle( const SDL_Rect& clip_rectangle )
 {
-  int return_value = SDL_RenderSetClipRect( d_renderer, &clip_rectangle );
-
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The renderer clip rectangle could not be set! "
-		      "SDL_Error: " << SDL_GetError() );
+  this->setClipRectangle( &clip_rectangle );
 }
 
 // Get the drawing area for the current target
@@ -295,19 +394,33 @@ void Renderer::setClipRectangle( const SDL_Rect& clip_rectangle )
  */ 
 void Renderer::getViewport( SDL_Rect& viewport_rectangle ) const
 {
-  SDL_RenderGetViewport( const_cast<SDL_Renderer*>( d_renderer ),
-			 &viewport_rectangle );
+  viewport_rectangle = d_viewport;
 }
 
 // Set the drawing area for the current target
+/*! \details The viewport will only be passed to SDL if it differs from the
+ * current viewport.
+ */
 void Renderer::setViewport( const SDL_Rect& viewport_rectangle )
 {
+  if( SDL_RectEquals( &viewport_rectangle, &d_viewport ) )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+  
   int return_value = SDL_RenderSetViewport( d_renderer, &viewport_rectangle );
 
   TEST_FOR_EXCEPTION( return_value != 0,
 		      ExceptionType,
 		      "Error: The renderer viewport could not be set! "
 		      "SDL_Error: " << SDL_GetError() );
+
+  // The viewport is scaled by SDL (reload the rounded rectangle)
+  SDL_RenderGetViewport( d_renderer, &d_viewport );
 }
 
 // Get the raw renderer pointer
@@ -325,7 +438,7 @@ SDL_Renderer* Renderer::getRawRendererPtr()
 // Check if the current rendering target is the default target
 bool Renderer::isCurrentTargetDefault() const
 {
-  return SDL_GetRenderTarget(const_cast<SDL_Renderer*>( d_renderer )) == NULL;
+  return d_target == NULL;
 }
 
 // Check if non-default targets are supported
@@ -338,12 +451,7 @@ bool Renderer::isNonDefaultTargetSupported() const
 // Set the current target to the default
 void Renderer::setCurrentTargetDefault()
 {
-  int return_value = SDL_SetRenderTarget( d_renderer, NULL );
-
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The default rendering target could not be set! "
-		      "SDL_Error: " << SDL_GetError() );
+  this->setCurrentTarget( NULL );
 }
 
 // Clear the current rendering target with the drawing color
@@ -351,6 +459,8 @@ void Renderer::setCurrentTargetDefault()
  */
 void Renderer::clear()
 {
+  ++d_draw_calls;
+
   int return_value = SDL_RenderClear( d_renderer );
 
   TEST_FOR_EXCEPTION( return_value != 0,
@@ -365,6 +475,8 @@ void Renderer::drawLine( const int start_x_position,
 			 const int end_x_position,
 			 const int end_y_position )
 {
+  ++d_draw_calls;
+
   int return_value = SDL_RenderDrawLine( d_renderer,
 					 start_x_position,
 					 start_y_position,
@@ -383,6 +495,8 @@ void Renderer::drawLines( const std::vector<SDL_Point>& end_points )
   // Make sure there is at least one line
   testPrecondition( end_points.size() > 1 );
   
+  ++d_draw_calls;
+
   int return_value = SDL_RenderDrawLines( d_renderer,
 					  &end_points[0],
 					  end_points.size() );
@@ -396,6 +510,8 @@ void Renderer::drawLines( const std::vector<SDL_Point>& end_points )
 // Draw a point on the current rendering target
 void Renderer::drawPoint( const int x_position, const int y_position )
 {
+  ++d_draw_calls;
+
   int return_value = SDL_RenderDrawPoint( d_renderer,
 					  x_position,
 					  y_position );
@@ -412,6 +528,8 @@ void Renderer::drawPoints( const std::vector<SDL_Point>& points )
   // Make sure there is at least one point
   testPrecondition( points.size() > 0 );
 
+  ++d_draw_calls;
+
   int return_value = SDL_RenderDrawPoints( d_renderer,
 					   &points[0],
 					   points.size() );
@@ -426,6 +544,8 @@ void Renderer::drawPoints( const std::vector<SDL_Point>& points )
 void Renderer::drawRectangle( const SDL_Rect& rectangle, 
 			      const bool fill )
 {
+  ++d_draw_calls;
+
   int return_value;
   
   if( fill )
@@ -446,6 +566,8 @@ void Renderer::drawRectangles( const std::vector<SDL_Rect>& rectangles,
   // Make sure there is at least one rectangle
   testPrecondition( rectangles.size() > 0 );
 
+  ++d_draw_calls;
+
   int return_value;
 
   if( fill )
@@ -468,68 +590,234 @@ void Renderer::drawRectangles( const std::vector<SDL_Rect>& rectangles,
 }
 
 // Draw an arbitrary shape on the current rendering target
-/*! \details The implementation of this function has introduced a circular
- * reference.
+/*! \details Shapes with rectangular coverage (rectangles) are drawn 
+ * directly as filled rectangles. Other shapes (e.g. ellipses) are drawn with
+ * a texture, which is stored in the shape texture cache so that redrawing a
+ * shape with the same geometry and color (at any position) only requires a
+ * texture copy.
  */
 void Renderer::drawShape( const Shape& shape, const bool fill )
 {
-  // Get the draw colors
-  SDL_Color edge_color;
-  this->getDrawColor( edge_color );
+  // Get the draw color
+  SDL_Color draw_color;
+  this->getDrawColor( draw_color );
 
-  SDL_Color outside_color = {0xFF,0xFF,0xFF,0};
+  if( shape.hasRectangularCoverage() )
+  {
+    std::vector<SDL_Rect> rectangles;
 
-  SDL_Color inside_color;
+    this->addShapeRectangles( shape, fill, rectangles );
 
-  if( fill )
-    inside_color = edge_color;
+    this->fillShapeRectangles( rectangles, draw_color );
+  }
   else
-    inside_color = outside_color;
-  
-  // Create a static texture with the shape
-  StaticTexture texture( std::shared_ptr<Renderer>( this, DummyDeleter() ),
-			 shape, 
-			 inside_color, 
-			 edge_color, 
-			 outside_color );
-
-  // Render the shape
-  texture.render( shape.getBoundingBoxXPosition(),
-		  shape.getBoundingBoxYPosition() );
+  {
+    std::shared_ptr<Texture> texture = 
+      this->getShapeTexture( shape, fill, draw_color );
+    
+    // Render the shape
+    texture->render( shape.getBoundingBoxXPosition(),
+		     shape.getBoundingBoxYPosition() );
+  }
 }
 
 // Draw arbitrary shapes on the current rendering target
-/*! \details The implementation of this function has introduced a circular
- * reference.
+/*! \details Consecutive shapes with rectangular coverage are drawn 
+ * together with a single rectangle fill. Other shapes are drawn with a 
+ * (cached) texture. The shapes will be drawn in order.
  */
 void Renderer::drawShapes( 
 		      const std::vector<std::shared_ptr<const Shape> >& shapes,
 		      const bool fill )
 {
-  // Get the draw colors
-  SDL_Color edge_color;
-  this->getDrawColor( edge_color );
-
-  SDL_Color outside_color = {0xFF,0xFF,0xFF,0};
+  // Get the draw color
+  SDL_Color draw_color;
+  this->getDrawColor( draw_color );
 
-  SDL_Color inside_color;
-  if( fill )
-    inside_color = edge_color;
-  else
-    inside_color = outside_color;
+  std::vector<SDL_Rect> rectangles;
 
   for( unsigned i = 0; i < shapes.size(); ++i )
   {
-    StaticTexture texture( std::shared_ptr<Renderer>( this, DummyDeleter() ),
-    			   *shapes[i],
-    			   inside_color,
-    			   edge_color,
-    			   outside_color );
+    if( shapes[i]->hasRectangularCoverage() )
+      this->addShapeRectangles( *shapes[i], fill, rectangles );
+    else
+    {
+      // Draw the pending shapes first to preserve the drawing order
+      this->fillShapeRectangles( rectangles, draw_color );
+
+      rectangles.clear();
+      
+      std::shared_ptr<Texture> texture = 
+	this->getShapeTexture( *shapes[i], fill, draw_color );
     
-    // Render the shape
-    texture.render( shapes[i]->getBoundingBoxXPosition(),
-		    shapes[i]->getBoundingBoxYPosition() );
+      // Render the shape
+      texture->render( shapes[i]->getBoundingBoxXPosition(),
+		       shapes[i]->getBoundingBoxYPosition() );
+    }
   }
+
+  this->fillShapeRectangles( rectangles, draw_color );
+}
+
+// Save the current renderer state
+/*! \details The draw color, draw blend mode, rendering target, scale,
+ * viewport and clip rectangle will be saved.
+ */
+void Renderer::pushState()
+{
+  State state;
+
+  state.draw_color = d_draw_color;
+  state.draw_blend_mode = d_draw_blend_mode;
+  state.target = d_target;
+  state.x_scale = d_x_scale;
+  state.y_scale = d_y_scale;
+  state.viewport = d_viewport;
+  state.clip_rectangle = d_clip_rectangle;
+
+  d_saved_states.push_back( state );
+}
+
+// Restore the last saved renderer state
+/*! \details Only the parts of the saved state that differ from the current
+ * state will be passed to SDL. The target is restored first since changing
+ * the target also changes the scale, viewport and clip rectangle.
+ */
+void Renderer::popState()
+{
+  // Make sure there is a saved state
+  testPrecondition( d_saved_states.size() > 0 );
+
+  const State state = d_saved_states.back();
+
+  d_saved_states.pop_back();
+
+  this->setCurrentTarget( state.target );
+  this->setScale( state.x_scale, state.y_scale );
+  this->setViewport( state.viewport );
+  
+  if( SDL_RectEmpty( &state.clip_rectangle ) )
+    this->setClipRectangle( NULL );
+  else
+    this->setClipRectangle( &state.clip_rectangle );
+
+  this->setDrawBlendMode( state.draw_blend_mode );
+  this->setDrawColor( state.draw_color );
+}
+
+// Get the number of saved renderer states
+unsigned Renderer::getNumberOfSavedStates() const
+{
+  return d_saved_states.size();
+}
+
+// Reload the renderer state after using the raw renderer pointer
+/*! \details The draw color, draw blend mode, rendering target, scale,
+ * viewport and clip rectangle are stored by the renderer. If they are changed
+ * using the raw renderer pointer this must be called before using the
+ * renderer again.
+ */
+void Renderer::synchronizeState()
+{
+  int return_value = SDL_GetRenderDrawColor( d_renderer,
+					     &d_draw_color.r,
+					     &d_draw_color.g,
+					     &d_draw_color.b,
+					     &d_draw_color.a );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The renderer draw color could not be retrieved! "
+		      "SDL_Error: " << SDL_GetError() );
+
+  return_value = SDL_GetRenderDrawBlendMode( d_renderer, &d_draw_blend_mode );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The renderer blend mode could not be retrieved! "
+		      "SDL_Error: " << SDL_GetError() );
+
+  this->loadTargetState();
+}
+
+// Get the number of state changes that were passed to SDL
+unsigned long Renderer::getNumberOfStateChanges() const
+{
+  return d_state_changes;
+}
+
+// Get the number of state changes that were skipped (redundant)
+unsigned long Renderer::getNumberOfSkippedStateChanges() const
+{
+  return d_skipped_state_changes;
+}
+
+// Reset the state change counters
+void Renderer::resetStateChangeCounters()
+{
+  d_state_changes = 0;
+  d_skipped_state_changes = 0;
+}
+
+// Get the number of draw calls that were passed to SDL
+/*! \details Clears, primitive draws and texture copies are counted.
+ */
+unsigned long Renderer::getNumberOfDrawCalls() const
+{
+  return d_draw_calls;
+}
+
+// Reset the draw call counter
+void Renderer::resetDrawCallCounter()
+{
+  d_draw_calls = 0;
+}
+
+// Get the number of textures that were converted by SDL (slow path)
+/*! \details Textures are normally created from surfaces in the native 
+ * texture format (the surfaces are converted with the 
+ * GDev::PixelFormatConverter if necessary). Color keyed surfaces and 
+ * surfaces with formats that the converter does not support are converted
+ * by SDL instead.
+ */
+unsigned long Renderer::getNumberOfSlowTextureConversions() const
+{
+  return d_slow_texture_conversions;
+}
+
+// Reset the slow texture conversion counter
+void Renderer::resetSlowTextureConversionCounter()
+{
+  d_slow_texture_conversions = 0;
+}
+
+// Get the shape texture cache
+const ShapeTextureCache& Renderer::getShapeTextureCache() const
+{
+  return *d_shape_texture_cache;
+}
+
+// Get the shape texture cache
+/*! \details The cache memory budget can be adjusted (or set to zero to
+ * disable caching) using the returned cache.
+ */
+ShapeTextureCache& Renderer::getShapeTextureCache()
+{
+  return *d_shape_texture_cache;
+}
+
+// Get the texture registry
+const TextureRegistry& Renderer::getTextureRegistry() const
+{
+  return *d_texture_registry;
+}
+
+// Get the texture registry
+/*! \details The registered textures are destroyed with the renderer.
+ */
+TextureRegistry& Renderer::getTextureRegistry()
+{
+  return *d_texture_registry;
 }
 
 // Present the drawing
@@ -543,9 +831,415 @@ void Renderer::present()
   SDL_RenderPresent( d_renderer );
 }
 
+// Invalidate an area of the default target (it must be redrawn)
+/*! \details The area is in target (output) coordinates. If areas of the
+ * drawing cannot be presented the entire target will be invalidated.
+ */
+void Renderer::invalidate( const SDL_Rect& area )
+{
+  this->updateDirtyRegionSize();
+  
+  if( this->isPartialPresentSupported() )
+    d_dirty_region.invalidate( area );
+  else
+    d_dirty_region.invalidateAll();
+}
+
+// Invalidate the entire default target
+void Renderer::invalidateAll()
+{
+  this->updateDirtyRegionSize();
+
+  d_dirty_region.invalidateAll();
+}
+
+// Get the dirty region of the default target
+const DirtyRegion& Renderer::getDirtyRegion() const
+{
+  return d_dirty_region;
+}
+
+// Get the dirty region of the default target
+/*! \details The full frame threshold and the max number of rectangles can
+ * be adjusted using the returned region.
+ */
+DirtyRegion& Renderer::getDirtyRegion()
+{
+  return d_dirty_region;
+}
+
+// Clear the dirty region of the default target with the drawing color
+/*! \details Like the clear function, the drawing color will not be blended.
+ * The viewport and scale should be the defaults when this is called.
+ */
+void Renderer::clearDirtyRegion()
+{
+  this->updateDirtyRegionSize();
+  
+  if( d_dirty_region.isFullFrame() )
+    this->clear();
+  else if( !d_dirty_region.isEmpty() )
+  {
+    SDL_BlendMode blend_mode = this->getDrawBlendMode();
+
+    this->setDrawBlendMode( SDL_BLENDMODE_NONE );
+
+    this->drawRectangles( d_dirty_region.getRectangles(), true );
+
+    this->setDrawBlendMode( blend_mode );
+  }
+}
+
+// Present the dirty region of the drawing
+/*! \details Only the dirty region needs to be redrawn before this is 
+ * called (objects can be checked with DirtyRegion::intersects). If the 
+ * region is empty nothing will be presented. If the entire target is dirty
+ * or areas of the drawing cannot be presented the entire drawing will be 
+ * presented. The dirty region will be emptied.
+ */
+void Renderer::presentDirtyRegion()
+{
+  this->updateDirtyRegionSize();
+  
+  if( !d_dirty_region.isEmpty() )
+  {
+    if( d_dirty_region.isFullFrame() || !this->isPartialPresentSupported() )
+      this->present();
+    else
+      this->presentAreas( d_dirty_region.getRectangles() );
+
+    d_dirty_region.clear();
+  }
+}
+
+// Present areas of the drawing
+/*! \details The default implementation ignores the areas and presents the
+ * entire drawing (renderers that can present parts of their target, like the
+ * software window renderer, override this).
+ */
+void Renderer::presentAreas( const std::vector<SDL_Rect>& )
+{
+  this->present();
+}
+
+// Add the rectangles that cover the drawn pixels of a shape
+/*! \details The edge spans (and the inside spans if the shape is filled) of
+ * each row become rectangles. Consecutive rows with the same spans share
+ * the same rectangles.
+ */
+void Renderer::addShapeRectangles( const Shape& shape,
+				   const bool fill,
+				   std::vector<SDL_Rect>& rectangles )
+{
+  std::vector<ShapeSpan> spans;
+  std::vector<SDL_Rect> row_rectangles, last_row_rectangles;
+  
+  // The index of the first rectangle of the last row
+  size_t last_row_index = rectangles.size();
+
+  const int start_y_position = shape.getBoundingBoxYPosition();
+  const int end_y_position = start_y_position + shape.getBoundingBoxHeight();
+  
+  for( int y_position = start_y_position;
+       y_position < end_y_position;
+       ++y_position )
+  {
+    shape.getRowSpans( y_position, spans );
+
+    row_rectangles.clear();
+
+    for( unsigned i = 0; i < spans.size(); ++i )
+    {
+      if( spans[i].coverage == ON_SHAPE_EDGE ||
+	  (fill && spans[i].coverage == INSIDE_SHAPE) )
+      {
+	// The edge and inside have the same color when filled
+	if( row_rectangles.size() > 0 &&
+	    row_rectangles.back().x + row_rectangles.back().w == 
+	    spans[i].x_position )
+	{
+	  row_rectangles.back().w += spans[i].length;
+	}
+	else
+	{
+	  SDL_Rect rectangle = 
+	    {spans[i].x_position, y_position, spans[i].length, 1};
+
+	  row_rectangles.push_back( rectangle );
+	}
+      }
+    }
+
+    // Check if the row rectangles extend the last row rectangles
+    bool extend = row_rectangles.size() == last_row_rectangles.size();
+    
+    for( unsigned i = 0; i < row_rectangles.size() && extend; ++i )
+    {
+      if( row_rectangles[i].x != last_row_rectangles[i].x ||
+	  row_rectangles[i].w != last_row_rectangles[i].w )
+	extend = false;
+    }
+
+    if( extend )
+    {
+      for( unsigned i = 0; i < row_rectangles.size(); ++i )
+	++rectangles[last_row_index+i].h;
+    }
+    else
+    {
+      last_row_index = rectangles.size();
+
+      rectangles.insert( rectangles.end(), 
+			 row_rectangles.begin(),
+			 row_rectangles.end() );
+
+      last_row_rectangles.swap( row_rectangles );
+    }
+  }
+}
+
+// Fill the shape rectangles with the draw color
+/*! \details Shape textures are always alpha blended. The rectangles will be
+ * drawn the same way regardless of the current draw blend mode (the mode 
+ * will be restored after drawing).
+ */
+void Renderer::fillShapeRectangles( const std::vector<SDL_Rect>& rectangles,
+				    const SDL_Color& draw_color )
+{
+  if( rectangles.size() > 0 )
+  {
+    SDL_BlendMode blend_mode = this->getDrawBlendMode();
+
+    // No blending and blending are equivalent for opaque colors
+    bool change_blend_mode = blend_mode != SDL_BLENDMODE_BLEND &&
+      (blend_mode != SDL_BLENDMODE_NONE || draw_color.a != 0xFF);
+
+    if( change_blend_mode )
+      this->setDrawBlendMode( SDL_BLENDMODE_BLEND );
+
+    this->drawRectangles( rectangles, true );
+
+    if( change_blend_mode )
+      this->setDrawBlendMode( blend_mode );
+  }
+}
+
+// Get the texture for a shape (from the shape texture cache if possible)
+/*! \details Shapes that cannot be identified by their geometry will not be
+ * cached. The key does not include the shape position (the texture is
+ * copied to the bounding box of the shape), so a moving shape will reuse
+ * its texture.
+ */
+std::shared_ptr<Texture> Renderer::getShapeTexture( 
+					       const Shape& shape,
+					       const bool fill,
+					       const SDL_Color& draw_color )
+{
+  ShapeGeometry geometry;
+
+  bool cacheable = shape.getGeometry( geometry );
+  
+  std::shared_ptr<Texture> texture;
+
+  if( cacheable )
+  {
+    texture = d_shape_texture_cache->find( 
+	       ShapeTextureCache::Key( shape, geometry, fill, draw_color ) );
+  }
+
+  if( !texture )
+  {
+    SDL_Color outside_color = {0xFF,0xFF,0xFF,0};
+    
+    SDL_Color inside_color;
+    
+    if( fill )
+      inside_color = draw_color;
+    else
+      inside_color = outside_color;
+    
+    // Create a static texture with the shape
+    texture.reset( new StaticTexture( 
+			       std::shared_ptr<Renderer>( this, DummyDeleter() ),
+			       shape,
+			       inside_color,
+			       draw_color,
+			       outside_color ) );
+
+    if( cacheable )
+    {
+      d_shape_texture_cache->insert( 
+		  ShapeTextureCache::Key( shape, geometry, fill, draw_color ),
+		  texture );
+    }
+  }
+
+  return texture;
+}
+
+// Record a texture draw call
+void Renderer::recordDrawCall()
+{
+  ++d_draw_calls;
+}
+
+// Set the current rendering target (NULL for the default target)
+/*! \details SDL stores a scale, viewport and clip rectangle for each
+ * target, so they will be reloaded when the target changes.
+ */
+void Renderer::setCurrentTarget( SDL_Texture* target )
+{
+  if( this->isCurrentTarget( target ) )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+  
+  int return_value = SDL_SetRenderTarget( d_renderer, target );
+
+  if( target == NULL )
+  {
+    TEST_FOR_EXCEPTION( return_value != 0,
+			ExceptionType,
+			"Error: The default rendering target could not be "
+			"set! SDL_Error: " << SDL_GetError() );
+  }
+  else
+  {
+    TEST_FOR_EXCEPTION( return_value != 0,
+			ExceptionType,
+			"Error: The texture could not be set as the rendering "
+			"target! SDL_Error: " << SDL_GetError() );
+  }
+
+  this->loadTargetState();
+}
+
+// Check if the texture is the current rendering target
+bool Renderer::isCurrentTarget( const SDL_Texture* target ) const
+{
+  return d_target == target;
+}
+
+// Release a rendering target that is about to be destroyed
+/*! \details SDL sets the default target when the current target is
+ * destroyed, so the default target is set here to keep the stored target
+ * state in step (no exception is thrown since this is called by the texture
+ * destructor). Saved states that use the texture as the target will use the
+ * default target instead (so that popState never sets a destroyed texture).
+ */
+void Renderer::releaseTarget( const SDL_Texture* target )
+{
+  // Make sure the target is valid
+  testPrecondition( target != NULL );
+
+  if( d_target == target )
+  {
+    ++d_state_changes;
+
+    SDL_SetRenderTarget( d_renderer, NULL );
+
+    this->loadTargetState();
+  }
+
+  for( unsigned i = 0; i < d_saved_states.size(); ++i )
+  {
+    if( d_saved_states[i].target == target )
+      d_saved_states[i].target = NULL;
+  }
+}
+
+// Set the clip rectangle (NULL to disable clipping)
+void Renderer::setClipRectangle( const SDL_Rect* clip_rectangle )
+{
+  bool redundant;
+  
+  if( clip_rectangle == NULL )
+    redundant = SDL_RectEmpty( &d_clip_rectangle );
+  else
+    redundant = SDL_RectEquals( clip_rectangle, &d_clip_rectangle );
+
+  if( redundant )
+  {
+    ++d_skipped_state_changes;
+
+    return;
+  }
+
+  ++d_state_changes;
+  
+  int return_value = SDL_RenderSetClipRect( d_renderer, clip_rectangle );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The renderer clip rectangle could not be set! "
+		      "SDL_Error: " << SDL_GetError() );
+
+  // The clip rectangle is scaled by SDL (reload the rounded rectangle)
+  SDL_RenderGetClipRect( d_renderer, &d_clip_rectangle );
+}
+
+// Load the target, scale, viewport and clip rectangle from SDL
+void Renderer::loadTargetState()
+{
+  d_target = SDL_GetRenderTarget( d_renderer );
+
+  SDL_RenderGetScale( d_renderer, &d_x_scale, &d_y_scale );
+  SDL_RenderGetViewport( d_renderer, &d_viewport );
+  SDL_RenderGetClipRect( d_renderer, &d_clip_rectangle );
+}
+
+// Reload the target state when the window size changes
+/*! \details SDL resets the viewport of the default target when the window
+ * size changes (and updates the scale if a logical size has been set).
+ */
+int Renderer::handleWindowEvent( void* renderer, SDL_Event* event )
+{
+  Renderer* window_renderer = static_cast<Renderer*>( renderer );
+  
+  if( event->type == SDL_WINDOWEVENT &&
+      event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED &&
+      event->window.windowID == window_renderer->d_window_id )
+    window_renderer->loadTargetState();
+
+  return 0;
+}
+
+// Update the size of the dirty region
+/*! \details The output size is only the size of the default target when it
+ * is the current target. If the size has changed the entire target will be
+ * invalidated.
+ */
+void Renderer::updateDirtyRegionSize()
+{
+  if( this->isCurrentTargetDefault() )
+  {
+    int output_width, output_height;
+
+    this->getOutputSize( output_width, output_height );
+
+    d_dirty_region.setSize( output_width, output_height );
+  }
+}
+
 // Free the renderer
+/*! \details The cached shape textures and the registered textures must be
+ * destroyed before the SDL renderer that owns them.
+ */
 void Renderer::free()
 {
+  if( d_window_id != 0 )
+    SDL_DelEventWatch( &Renderer::handleWindowEvent, this );
+  
+  if( d_shape_texture_cache )
+    d_shape_texture_cache->clear();
+
+  if( d_texture_registry )
+    d_texture_registry->clear();
+  
   SDL_DestroyRenderer( d_renderer );
 
   d_renderer = NULL;
@@ -581,6 +1275,28 @@ void Renderer::loadRendererInfo()
     d_supported_texture_formats[i] = info.texture_formats[i];
 }
 
+// Constructor
+RendererStateScope::RendererStateScope( Renderer& renderer )
+  : d_renderer( renderer )
+{
+  d_renderer.pushState();
+}
+
+// Destructor
+/*! \details Exceptions cannot be thrown from the destructor. If the state
+ * cannot be restored an error will be reported.
+ */
+RendererStateScope::~RendererStateScope()
+{
+  try{
+    d_renderer.popState();
+  }
+  catch( const std::exception& exception )
+  {
+    std::cerr << exception.what() << std::endl;
+  }
+}
+
 } // end GDev namespace
 
 //---------------------------------------------------------------------------//
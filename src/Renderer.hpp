@@ -15,6 +15,10 @@
 #include <stdexcept>
 #include <memory>
 
+// Boost Includes
+#include <boost/scoped_ptr.hpp>
+#include <boost/core/noncopyable.hpp>
+
 // SDL Includes
 #include <SDL2/SDL.h>
 
@@ -22,9 +26,15 @@
 #include "Surface.hpp"
 #include "Window.hpp"
 #include "Shape.hpp"
+#include "ShapeTextureCache.hpp"
+#include "TextureRegistry.hpp"
+#include "DirtyRegion.hpp"
 
 namespace GDev{
 
+// Forward declare the texture class
+class Texture;
+
 //! The renderer exception class
 class RendererException : public std::runtime_error
 {
@@ -64,6 +74,9 @@ public:
   //! Check if the texture format is valid
   bool isValidTextureFormat( const Uint32 format ) const;
 
+  //! Get the native (preferred) texture format
+  Uint32 getNativeTextureFormat( const bool alpha = true ) const;
+
   //! Get the max texture width
   int getMaxTextureWidth() const;
 
@@ -89,7 +102,7 @@ public:
   void getScale( float& x_scale, float& y_scale ) const;
 
   //! Set the drawing scale for the current target
-  void setScale( const float x_scale, const float y_scale ) const;
+  void setScale( const float x_scale, const float y_scale );
 
   //! Get the draw blend mode
   SDL_BlendMode getDrawBlendMode() const;
@@ -169,11 +182,80 @@ public:
   void drawShapes( const std::vector<std::shared_ptr<const Shape> >& shapes,
 		   const bool fill );
 
+  //! Save the current renderer state
+  void pushState();
+
+  //! Restore the last saved renderer state
+  void popState();
+
+  //! Get the number of saved renderer states
+  unsigned getNumberOfSavedStates() const;
+
+  //! Reload the renderer state after using the raw renderer pointer
+  void synchronizeState();
+
+  //! Get the number of state changes that were passed to SDL
+  unsigned long getNumberOfStateChanges() const;
+
+  //! Get the number of state changes that were skipped (redundant)
+  unsigned long getNumberOfSkippedStateChanges() const;
+
+  //! Reset the state change counters
+  void resetStateChangeCounters();
+
+  //! Get the number of draw calls that were passed to SDL
+  unsigned long getNumberOfDrawCalls() const;
+
+  //! Reset the draw call counter
+  void resetDrawCallCounter();
+
+  //! Get the number of textures that were converted by SDL (slow path)
+  unsigned long getNumberOfSlowTextureConversions() const;
+
+  //! Reset the slow texture conversion counter
+  void resetSlowTextureConversionCounter();
+
+  //! Get the shape texture cache
+  const ShapeTextureCache& getShapeTextureCache() const;
+
+  //! Get the shape texture cache
+  ShapeTextureCache& getShapeTextureCache();
+
+  //! Get the texture registry
+  const TextureRegistry& getTextureRegistry() const;
+
+  //! Get the texture registry
+  TextureRegistry& getTextureRegistry();
+
   //! Present the drawing
   void present();
 
+  //! Invalidate an area of the default target (it must be redrawn)
+  void invalidate( const SDL_Rect& area );
+
+  //! Invalidate the entire default target
+  void invalidateAll();
+
+  //! Get the dirty region of the default target
+  const DirtyRegion& getDirtyRegion() const;
+
+  //! Get the dirty region of the default target
+  DirtyRegion& getDirtyRegion();
+
+  //! Clear the dirty region of the default target with the drawing color
+  void clearDirtyRegion();
+
+  //! Present the dirty region of the drawing
+  void presentDirtyRegion();
+
+  //! Check if areas of the drawing can be presented
+  virtual bool isPartialPresentSupported() const = 0;
+
 protected:
 
+  //! Present areas of the drawing
+  virtual void presentAreas( const std::vector<SDL_Rect>& areas );
+
   //! Window constructor
   Renderer( Window& window,
 	    const int driver_index,
@@ -184,6 +266,35 @@ protected:
 
 private:
 
+  // The target texture can set the current target
+  friend class TargetTexture;
+
+  // The texture records its draw calls and slow conversions
+  friend class Texture;
+
+  // The renderer state
+  struct State
+  {
+    // The draw color
+    SDL_Color draw_color;
+
+    // The draw blend mode
+    SDL_BlendMode draw_blend_mode;
+
+    // The rendering target (NULL for the default target)
+    SDL_Texture* target;
+
+    // The drawing scale
+    float x_scale;
+    float y_scale;
+
+    // The viewport
+    SDL_Rect viewport;
+
+    // The clip rectangle (empty if clipping is disabled)
+    SDL_Rect clip_rectangle;
+  };
+
   // Dummy deleter
   struct DummyDeleter
   {
@@ -191,6 +302,44 @@ private:
     { /* ... */ }
   };
 
+  // Add the rectangles that cover the drawn pixels of a shape
+  static void addShapeRectangles( const Shape& shape,
+				  const bool fill,
+				  std::vector<SDL_Rect>& rectangles );
+
+  // Fill the shape rectangles with the draw color
+  void fillShapeRectangles( const std::vector<SDL_Rect>& rectangles,
+			    const SDL_Color& draw_color );
+
+  // Get the texture for a shape (from the shape texture cache if possible)
+  std::shared_ptr<Texture> getShapeTexture( const Shape& shape,
+					    const bool fill,
+					    const SDL_Color& draw_color );
+
+  // Set the current rendering target (NULL for the default target)
+  void setCurrentTarget( SDL_Texture* target );
+
+  // Check if the texture is the current rendering target
+  bool isCurrentTarget( const SDL_Texture* target ) const;
+
+  // Release a rendering target that is about to be destroyed
+  void releaseTarget( const SDL_Texture* target );
+
+  // Set the clip rectangle (NULL to disable clipping)
+  void setClipRectangle( const SDL_Rect* clip_rectangle );
+
+  // Load the target, scale, viewport and clip rectangle from SDL
+  void loadTargetState();
+
+  // Reload the target state when the window size changes
+  static int handleWindowEvent( void* renderer, SDL_Event* event );
+
+  // Record a texture draw call
+  void recordDrawCall();
+
+  // Update the size of the dirty region
+  void updateDirtyRegionSize();
+
   // Free the renderer
   void free();
 
@@ -217,6 +366,74 @@ private:
 
   // Supported texture formats
   std::vector<Uint32> d_supported_texture_formats;
+
+  // The draw color
+  SDL_Color d_draw_color;
+
+  // The draw blend mode
+  SDL_BlendMode d_draw_blend_mode;
+
+  // The window id (0 for a surface renderer)
+  Uint32 d_window_id;
+
+  // The current rendering target (NULL for the default target)
+  SDL_Texture* d_target;
+
+  // The drawing scale of the current target
+  float d_x_scale;
+  float d_y_scale;
+
+  // The viewport of the current target
+  SDL_Rect d_viewport;
+
+  // The clip rectangle of the current target (empty if clipping is disabled)
+  SDL_Rect d_clip_rectangle;
+
+  // The saved renderer states
+  std::vector<State> d_saved_states;
+
+  // The number of state changes that were passed to SDL
+  unsigned long d_state_changes;
+
+  // The number of state changes that were skipped
+  unsigned long d_skipped_state_changes;
+
+  // The number of draw calls that were passed to SDL
+  unsigned long d_draw_calls;
+
+  // The number of textures that were converted by SDL
+  unsigned long d_slow_texture_conversions;
+
+  // The shape texture cache
+  boost::scoped_ptr<ShapeTextureCache> d_shape_texture_cache;
+
+  // The texture registry
+  boost::scoped_ptr<TextureRegistry> d_texture_registry;
+
+  // The dirty region of the default target
+  DirtyRegion d_dirty_region;
+};
+
+/*! The renderer state scope class
+ * \details The renderer state is saved when the scope is created and 
+ * restored when the scope is destroyed. A rendering target that is current
+ * when the scope is created must outlive the scope.
+ */
+class RendererStateScope : private boost::noncopyable
+{
+
+public:
+
+  //! Constructor
+  RendererStateScope( Renderer& renderer );
+
+  //! Destructor
+  ~RendererStateScope();
+
+private:
+
+  // The renderer
+  Renderer& d_renderer;
 };
 
 } // end GDev
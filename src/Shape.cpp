@@ -0,0 +1,199 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   Shape.cpp
+//! \author Alex Robinson
+//! \brief  The shape base class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// GDev Includes
+#include "Shape.hpp"
+#include "SurfaceBlitter.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+Shape::Kernel Shape::s_kernel = SurfaceBlitter::getBestSupportedKernel();
+
+// Get the kernel that is used for batched point queries
+Shape::Kernel Shape::getKernel()
+{
+  return s_kernel;
+}
+
+// Set the kernel that is used for batched point queries
+/*! \details This is mostly useful for testing and benchmarking the kernels.
+ */
+void Shape::setKernel( const Kernel kernel )
+{
+  // Make sure the kernel is supported
+  testPrecondition( SurfaceBlitter::isKernelSupported( kernel ) );
+
+  s_kernel = kernel;
+}
+
+// Get the number of mask words needed for a number of points
+unsigned Shape::getNumberOfMaskWords( const unsigned number_of_points )
+{
+  return (number_of_points + 31u)/32u;
+}
+
+// Check if the bit of a point is set in a mask
+bool Shape::isMaskBitSet( const Uint32* mask, const unsigned point_index )
+{
+  return (mask[point_index/32u] >> (point_index%32u)) & 1u;
+}
+
+// Check if points are in (or on) the shape (one mask bit per point)
+/*! \details The mask must have room for getNumberOfMaskWords words. The
+ * bits past the last point in the last word will be cleared. This default
+ * implementation calls isPointIn for every point - derived classes should
+ * override it with a vectorized version when possible.
+ */
+void Shape::arePointsIn( const int* x_positions,
+			 const int* y_positions,
+			 const unsigned number_of_points,
+			 Uint32* mask ) const
+{
+  Shape::clearMask( number_of_points, mask );
+
+  for( unsigned i = 0; i < number_of_points; ++i )
+  {
+    if( this->isPointIn( x_positions[i], y_positions[i] ) )
+      Shape::setMaskBit( mask, i );
+  }
+}
+
+// Check if points are on the shape boundary (one mask bit per point)
+/*! \details The mask must have room for getNumberOfMaskWords words. The
+ * bits past the last point in the last word will be cleared. This default
+ * implementation calls isPointOn for every point - derived classes should
+ * override it with a vectorized version when possible.
+ */
+void Shape::arePointsOn( const int* x_positions,
+			 const int* y_positions,
+			 const unsigned number_of_points,
+			 Uint32* mask ) const
+{
+  Shape::clearMask( number_of_points, mask );
+
+  for( unsigned i = 0; i < number_of_points; ++i )
+  {
+    if( this->isPointOn( x_positions[i], y_positions[i] ) )
+      Shape::setMaskBit( mask, i );
+  }
+}
+
+// Get the geometry parameters (false if the shape can't be identified)
+/*! \details Two shapes of the same type with the same geometry parameters 
+ * must cover exactly the same pixels relative to their bounding boxes (the
+ * bounding box position must not be part of the parameters, so that moved
+ * shapes can share a cached texture). Shapes that cannot be described by 
+ * their geometry parameters should return false (the default).
+ */
+bool Shape::getGeometry( ShapeGeometry& ) const
+{
+  return false;
+}
+
+// Check if the row spans are computed without testing every pixel
+/*! \details Shapes with analytic row spans are cheap enough to rasterize
+ * every time they are drawn.
+ */
+bool Shape::hasAnalyticRowSpans() const
+{
+  return false;
+}
+
+// Check if the covered pixels form a few axis aligned rectangles
+/*! \details Shapes with rectangular coverage are drawn by the renderer as
+ * filled rectangles. Other shapes are drawn with a (cached) texture.
+ */
+bool Shape::hasRectangularCoverage() const
+{
+  return false;
+}
+
+// Get the coverage spans of a bounding box row
+/*! \details The spans will cover the entire bounding box row (from left to
+ * right) and adjacent spans will always have different coverages. A pixel
+ * that is on the shape boundary takes precedence over a pixel that is in the
+ * shape, which is the same ordering used when shape surfaces are created.
+ * This default implementation evaluates every pixel in the row - derived
+ * classes should override it with an analytic version when possible.
+ */
+void Shape::getRowSpans( const int y_position,
+			 std::vector<ShapeSpan>& spans ) const
+{
+  // Make sure the row is in the bounding box
+  testPrecondition( y_position >= this->getBoundingBoxYPosition() );
+  testPrecondition( y_position < this->getBoundingBoxYPosition() +
+		    this->getBoundingBoxHeight() );
+
+  spans.clear();
+
+  const int start_x_position = this->getBoundingBoxXPosition();
+  const int end_x_position = start_x_position + this->getBoundingBoxWidth();
+
+  for( int x_position = start_x_position;
+       x_position < end_x_position;
+       ++x_position )
+  {
+    ShapeCoverage coverage;
+
+    if( this->isPointOn( x_position, y_position ) )
+      coverage = ON_SHAPE_EDGE;
+    else if( this->isPointIn( x_position, y_position ) )
+      coverage = INSIDE_SHAPE;
+    else
+      coverage = OUTSIDE_SHAPE;
+
+    Shape::addSpan( spans, x_position, x_position+1, coverage );
+  }
+}
+
+// Add a span to the end of the row (empty spans will be ignored)
+/*! \details The end x position is not included in the span. If the last
+ * span in the row has the same coverage it will simply be extended.
+ */
+void Shape::addSpan( std::vector<ShapeSpan>& spans,
+		     const int start_x_position,
+		     const int end_x_position,
+		     const ShapeCoverage coverage )
+{
+  if( end_x_position > start_x_position )
+  {
+    if( spans.size() > 0 && spans.back().coverage == coverage )
+      spans.back().length += end_x_position - start_x_position;
+    else
+    {
+      ShapeSpan span = {start_x_position,
+			end_x_position - start_x_position,
+			coverage};
+
+      spans.push_back( span );
+    }
+  }
+}
+
+// Clear the mask words of a number of points
+void Shape::clearMask( const unsigned number_of_points, Uint32* mask )
+{
+  std::fill_n( mask, Shape::getNumberOfMaskWords( number_of_points ), 0u );
+}
+
+// Set the bit of a point in a mask
+void Shape::setMaskBit( Uint32* mask, const unsigned point_index )
+{
+  mask[point_index/32u] |= 1u << (point_index%32u);
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end Shape.cpp
+//---------------------------------------------------------------------------//
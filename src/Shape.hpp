@@ -9,17 +9,69 @@
 #ifndef GDEV_SHAPE_HPP
 #define GDEV_SHAPE_HPP
 
+// Std Lib Includes
+#include <vector>
+#include <array>
+
 // SDL Includes
 #include <SDL2/SDL.h>
 
+// GDev Includes
+#include "SimdKernel.hpp"
+
 namespace GDev{
 
-//! The shape base class
+//! The shape coverage of a pixel
+enum ShapeCoverage{
+  OUTSIDE_SHAPE = 0,
+  ON_SHAPE_EDGE,
+  INSIDE_SHAPE
+};
+
+//! A run of pixels in a bounding box row that have the same coverage
+struct ShapeSpan
+{
+  //! The x position of the first pixel in the run
+  int x_position;
+
+  //! The number of pixels in the run
+  int length;
+
+  //! The coverage of the pixels in the run
+  ShapeCoverage coverage;
+};
+
+//! The shape geometry parameters (identifies shapes with identical pixels
+//! relative to their bounding box - the position is not included)
+typedef std::array<int,5> ShapeGeometry;
+
+/*! The shape base class
+ * \details Points can be tested one at a time (isPointIn and isPointOn) or
+ * in batches (arePointsIn and arePointsOn). The batched queries take the x
+ * and y positions in separate arrays and set one bit per point in a mask
+ * (bit i%32 of word i/32), so derived classes can test many points per
+ * virtual call with SIMD kernels.
+ */
 class Shape
 {
   
 public:
 
+  //! The kernel type
+  typedef SimdKernel Kernel;
+
+  //! Get the kernel that is used for batched point queries
+  static Kernel getKernel();
+
+  //! Set the kernel that is used for batched point queries
+  static void setKernel( const Kernel kernel );
+
+  //! Get the number of mask words needed for a number of points
+  static unsigned getNumberOfMaskWords( const unsigned number_of_points );
+
+  //! Check if the bit of a point is set in a mask
+  static bool isMaskBitSet( const Uint32* mask, const unsigned point_index );
+
   //! Default constructor
   Shape()
   { /* ... */ }
@@ -59,6 +111,50 @@ public:
   //! Check if a point is on the shape boundary
   virtual bool isPointOn( const int x_position,
 			  const int y_position ) const = 0;
+
+  //! Check if points are in (or on) the shape (one mask bit per point)
+  virtual void arePointsIn( const int* x_positions,
+			    const int* y_positions,
+			    const unsigned number_of_points,
+			    Uint32* mask ) const;
+
+  //! Check if points are on the shape boundary (one mask bit per point)
+  virtual void arePointsOn( const int* x_positions,
+			    const int* y_positions,
+			    const unsigned number_of_points,
+			    Uint32* mask ) const;
+
+  //! Get the geometry parameters (false if the shape can't be identified)
+  virtual bool getGeometry( ShapeGeometry& geometry ) const;
+
+  //! Check if the row spans are computed without testing every pixel
+  virtual bool hasAnalyticRowSpans() const;
+
+  //! Check if the covered pixels form a few axis aligned rectangles
+  virtual bool hasRectangularCoverage() const;
+
+  //! Get the coverage spans of a bounding box row
+  virtual void getRowSpans( const int y_position,
+			    std::vector<ShapeSpan>& spans ) const;
+
+protected:
+
+  //! Add a span to the end of the row (empty spans will be ignored)
+  static void addSpan( std::vector<ShapeSpan>& spans,
+		       const int start_x_position,
+		       const int end_x_position,
+		       const ShapeCoverage coverage );
+
+  //! Clear the mask words of a number of points
+  static void clearMask( const unsigned number_of_points, Uint32* mask );
+
+  //! Set the bit of a point in a mask
+  static void setMaskBit( Uint32* mask, const unsigned point_index );
+
+private:
+
+  // The kernel that is used for batched point queries
+  static Kernel s_kernel;
 };
 
 } // end GDev namespace
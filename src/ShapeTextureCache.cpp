@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ShapeTextureCache.cpp
+//! \author Alex Robinson
+//! \brief  The shape texture cache class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "ShapeTextureCache.hpp"
+#include "Texture.hpp"
+
+namespace GDev{
+
+// The default memory budget (bytes)
+const size_t ShapeTextureCache::s_default_memory_budget = 16*1024*1024;
+
+// Constructor
+ShapeTextureCacheKey::ShapeTextureCacheKey( const Shape& shape,
+					    const ShapeGeometry& geometry,
+					    const bool fill,
+					    const SDL_Color& color )
+  : type( typeid( shape ) ),
+    geometry( geometry ),
+    fill( fill ),
+    color( (color.r << 24) | (color.g << 16) | (color.b << 8) | color.a )
+{ /* ... */ }
+
+// Less than operator
+bool ShapeTextureCacheKey::operator<( 
+				const ShapeTextureCacheKey& other_key ) const
+{
+  if( type != other_key.type )
+    return type < other_key.type;
+  else if( geometry != other_key.geometry )
+    return geometry < other_key.geometry;
+  else if( fill != other_key.fill )
+    return fill < other_key.fill;
+  else
+    return color < other_key.color;
+}
+
+// Constructor
+ShapeTextureCache::ShapeTextureCache( const size_t memory_budget )
+  : TextureCache<ShapeTextureCacheKey,Texture>( memory_budget )
+{ /* ... */ }
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end ShapeTextureCache.cpp
+//---------------------------------------------------------------------------//
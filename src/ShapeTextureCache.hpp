@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   ShapeTextureCache.hpp
+//! \author Alex Robinson
+//! \brief  The shape texture cache class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SHAPE_TEXTURE_CACHE_HPP
+#define GDEV_SHAPE_TEXTURE_CACHE_HPP
+
+// Std Lib Includes
+#include <typeindex>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Shape.hpp"
+#include "TextureCache.hpp"
+
+namespace GDev{
+
+// Forward declare the texture class
+class Texture;
+
+//! The shape texture cache key
+struct ShapeTextureCacheKey
+{
+  //! Constructor
+  ShapeTextureCacheKey( const Shape& shape,
+			const ShapeGeometry& geometry,
+			const bool fill,
+			const SDL_Color& color );
+
+  //! Less than operator
+  bool operator<( const ShapeTextureCacheKey& other_key ) const;
+
+  //! The shape type
+  std::type_index type;
+
+  //! The shape geometry
+  ShapeGeometry geometry;
+
+  //! The fill mode
+  bool fill;
+
+  //! The packed draw color (RGBA)
+  Uint32 color;
+};
+
+/*! The shape texture cache class
+ * \details The cache stores the textures created for shapes drawn with the
+ * renderer. The textures are keyed by the shape type, the shape geometry
+ * (which does not include the position), the fill mode and the draw color.
+ * When the memory used by the cached textures exceeds the memory
+ * budget the least recently used textures will be evicted.
+ */
+class ShapeTextureCache : public TextureCache<ShapeTextureCacheKey,Texture>
+{
+
+public:
+
+  //! Constructor
+  ShapeTextureCache( const size_t memory_budget = s_default_memory_budget );
+
+  //! Destructor
+  ~ShapeTextureCache()
+  { /* ... */ }
+
+private:
+
+  // The default memory budget (bytes)
+  static const size_t s_default_memory_budget;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SHAPE_TEXTURE_CACHE_HPP
+
+//---------------------------------------------------------------------------//
+// end ShapeTextureCache.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,31 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SimdKernel.hpp
+//! \author Alex Robinson
+//! \brief  The simd kernel enumeration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SIMD_KERNEL_HPP
+#define GDEV_SIMD_KERNEL_HPP
+
+namespace GDev{
+
+/*! The simd kernels
+ * \details The surface blitter, the surface scaler, the pixel format
+ * converter and the shapes all select one of these kernels. Use
+ * SurfaceBlitter::isKernelSupported to check if the CPU supports a kernel.
+ */
+enum SimdKernel{
+  SCALAR_KERNEL = 0,
+  SSE2_KERNEL,
+  AVX2_KERNEL
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SIMD_KERNEL_HPP
+
+//---------------------------------------------------------------------------//
+// end SimdKernel.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,301 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SpriteBatch.cpp
+//! \author Alex Robinson
+//! \brief  The sprite batch class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+#include <functional>
+
+// GDev Includes
+#include "SpriteBatch.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Constructor
+SpriteBatch::SpriteBatch()
+  : d_sprites(),
+    d_textures(),
+    d_submitted_groups( 0 )
+{ /* ... */ }
+
+// Add the whole texture clip at the desired point
+void SpriteBatch::add( const std::shared_ptr<Texture>& texture,
+		       const int layer,
+		       const int target_x_position,
+		       const int target_y_position,
+		       const SDL_Rect* texture_clip,
+		       const double rotation_angle,
+		       const SDL_Point* rotation_center,
+		       const SDL_RendererFlip flip )
+{
+  // Make sure the texture is valid
+  testPrecondition( texture );
+
+  // Set the target rectangle where the texture clip will be rendered
+  SDL_Rect target_clip = {target_x_position,
+			  target_y_position,
+			  texture->getWidth(),
+			  texture->getHeight()};
+
+  // Set the clip rendering dimensions
+  if( texture_clip != NULL )
+  {
+    target_clip.w = texture_clip->w;
+    target_clip.h = texture_clip->h;
+  }
+
+  this->add( texture,
+	     layer,
+	     &target_clip,
+	     texture_clip,
+	     rotation_angle,
+	     rotation_center,
+	     flip );
+}
+
+// Add the texture clip
+/*! \details The rotation center is the point on the target around which
+ * the target clip will be rotated. The default is the center of the target.
+ */
+void SpriteBatch::add( const std::shared_ptr<Texture>& texture,
+		       const int layer,
+		       const SDL_Rect* target_clip,
+		       const SDL_Rect* texture_clip,
+		       const double rotation_angle,
+		       const SDL_Point* rotation_center,
+		       const SDL_RendererFlip flip )
+{
+  // Make sure the texture is valid
+  testPrecondition( texture );
+
+  Sprite sprite;
+  sprite.texture = texture.get();
+  sprite.layer = layer;
+  sprite.texture_state = SpriteBatch::packTextureState( *texture );
+  sprite.use_whole_target = (target_clip == NULL);
+  sprite.use_whole_texture = (texture_clip == NULL);
+  sprite.rotation_angle = rotation_angle;
+  sprite.use_default_rotation_center = (rotation_center == NULL);
+  sprite.flip = flip;
+  sprite.order = d_sprites.size();
+
+  if( target_clip != NULL )
+    sprite.target_clip = *target_clip;
+
+  if( texture_clip != NULL )
+    sprite.texture_clip = *texture_clip;
+
+  if( rotation_center != NULL )
+    sprite.rotation_center = *rotation_center;
+
+  d_sprites.push_back( sprite );
+
+  // Keep the texture alive until the batch has been rendered
+  if( d_textures.empty() || d_textures.back() != texture )
+    d_textures.push_back( texture );
+}
+
+// Add the whole texture region clip at the desired point
+/*! \details The region clip is relative to the region. Regions that share
+ * a texture (e.g. regions in the same texture atlas page) will be rendered
+ * in the same sprite group.
+ */
+void SpriteBatch::add( const TextureRegion& region,
+		       const int layer,
+		       const int target_x_position,
+		       const int target_y_position,
+		       const SDL_Rect* region_clip,
+		       const double rotation_angle,
+		       const SDL_Point* rotation_center,
+		       const SDL_RendererFlip flip )
+{
+  // Make sure the region is not empty
+  testPrecondition( !region.isEmpty() );
+
+  SDL_Rect texture_clip = region.convertClip( region_clip );
+
+  this->add( region.getTexture(),
+	     layer,
+	     target_x_position,
+	     target_y_position,
+	     &texture_clip,
+	     rotation_angle,
+	     rotation_center,
+	     flip );
+}
+
+// Add the texture region clip
+/*! \details The region clip is relative to the region. The rotation center
+ * is the point on the target around which the target clip will be rotated.
+ * The default is the center of the target.
+ */
+void SpriteBatch::add( const TextureRegion& region,
+		       const int layer,
+		       const SDL_Rect* target_clip,
+		       const SDL_Rect* region_clip,
+		       const double rotation_angle,
+		       const SDL_Point* rotation_center,
+		       const SDL_RendererFlip flip )
+{
+  // Make sure the region is not empty
+  testPrecondition( !region.isEmpty() );
+
+  SDL_Rect texture_clip = region.convertClip( region_clip );
+
+  this->add( region.getTexture(),
+	     layer,
+	     target_clip,
+	     &texture_clip,
+	     rotation_angle,
+	     rotation_center,
+	     flip );
+}
+
+// Get the number of sprites in the batch
+unsigned SpriteBatch::getNumberOfSprites() const
+{
+  return d_sprites.size();
+}
+
+// Check if the batch is empty
+bool SpriteBatch::isEmpty() const
+{
+  return d_sprites.empty();
+}
+
+// Get the number of sprite groups submitted by the last render
+/*! \details A sprite group is a run of sprites in the same layer that use
+ * the same texture and texture state.
+ */
+unsigned SpriteBatch::getNumberOfSubmittedGroups() const
+{
+  return d_submitted_groups;
+}
+
+// Render the sprites in the batch and empty the batch
+/*! \details The texture state (color modulation, alpha modulation and
+ * blend mode) is only set when it changes between sprite groups. The state
+ * that a texture had before the batch was rendered will be restored once all
+ * of its sprite groups in a layer have been rendered.
+ */
+void SpriteBatch::render()
+{
+  d_submitted_groups = 0;
+
+  std::sort( d_sprites.begin(), d_sprites.end(),
+	     SpriteBatch::compareSprites );
+
+  std::vector<Sprite>::const_iterator sprite = d_sprites.begin();
+
+  while( sprite != d_sprites.end() )
+  {
+    Texture& texture = *sprite->texture;
+
+    const int layer = sprite->layer;
+
+    const unsigned long long original_texture_state =
+      SpriteBatch::packTextureState( texture );
+
+    unsigned long long texture_state = original_texture_state;
+
+    // Render all of the sprites in this layer that use this texture
+    while( sprite != d_sprites.end() &&
+	   sprite->texture == &texture &&
+	   sprite->layer == layer )
+    {
+      // Set the texture state of the sprite group
+      if( sprite->texture_state != texture_state )
+      {
+	SpriteBatch::setTextureState( texture, sprite->texture_state );
+
+	texture_state = sprite->texture_state;
+      }
+
+      ++d_submitted_groups;
+
+      while( sprite != d_sprites.end() &&
+	     sprite->texture == &texture &&
+	     sprite->layer == layer &&
+	     sprite->texture_state == texture_state )
+      {
+	texture.render(
+		 (sprite->use_whole_target ? NULL : &sprite->target_clip),
+		 (sprite->use_whole_texture ? NULL : &sprite->texture_clip),
+		 sprite->rotation_angle,
+		 (sprite->use_default_rotation_center ?
+		  NULL : &sprite->rotation_center),
+		 sprite->flip );
+
+	++sprite;
+      }
+    }
+
+    // Restore the original texture state
+    if( texture_state != original_texture_state )
+      SpriteBatch::setTextureState( texture, original_texture_state );
+  }
+
+  this->clear();
+}
+
+// Remove all sprites from the batch
+void SpriteBatch::clear()
+{
+  d_sprites.clear();
+  d_textures.clear();
+}
+
+// Sprite comparison function (layer, texture, texture state, order)
+bool SpriteBatch::compareSprites( const Sprite& sprite_a,
+				  const Sprite& sprite_b )
+{
+  if( sprite_a.layer != sprite_b.layer )
+    return sprite_a.layer < sprite_b.layer;
+  else if( sprite_a.texture != sprite_b.texture )
+    return std::less<const Texture*>()( sprite_a.texture, sprite_b.texture );
+  else if( sprite_a.texture_state != sprite_b.texture_state )
+    return sprite_a.texture_state < sprite_b.texture_state;
+  else
+    return sprite_a.order < sprite_b.order;
+}
+
+// Pack the texture state
+/*! \details The blend mode is stored in the upper 32 bits and the color
+ * and alpha modulation are stored in the lower 32 bits (RGBA).
+ */
+unsigned long long SpriteBatch::packTextureState( const Texture& texture )
+{
+  Uint8 red, green, blue;
+
+  texture.getColorMod( red, green, blue );
+
+  unsigned long long texture_state = texture.getBlendMode();
+
+  texture_state <<= 32;
+  texture_state |= ((Uint32)red << 24) | ((Uint32)green << 16) |
+    ((Uint32)blue << 8) | texture.getAlphaMod();
+
+  return texture_state;
+}
+
+// Set the texture state
+void SpriteBatch::setTextureState( Texture& texture,
+				   const unsigned long long texture_state )
+{
+  texture.setBlendMode( (SDL_BlendMode)(texture_state >> 32) );
+  texture.setColorMod( (texture_state >> 24) & 0xFF,
+		       (texture_state >> 16) & 0xFF,
+		       (texture_state >> 8) & 0xFF );
+  texture.setAlphaMod( texture_state & 0xFF );
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end SpriteBatch.cpp
+//---------------------------------------------------------------------------//
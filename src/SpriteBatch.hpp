@@ -0,0 +1,172 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SpriteBatch.hpp
+//! \author Alex Robinson
+//! \brief  The sprite batch class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SPRITE_BATCH_HPP
+#define GDEV_SPRITE_BATCH_HPP
+
+// Std Lib Includes
+#include <vector>
+#include <memory>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Texture.hpp"
+#include "TextureRegion.hpp"
+
+namespace GDev{
+
+/*! The sprite batch class
+ * \details Sprites (texture clips) that are added to the batch are not
+ * rendered until the batch is rendered. The color modulation, alpha
+ * modulation and blend mode of the texture are recorded when a sprite is
+ * added. When the batch is rendered the sprites are sorted by layer, texture
+ * and texture state so that the texture state only needs to be set once for
+ * each group of sprites. Layers are rendered in increasing order. Sprites in
+ * the same layer that use the same texture and texture state are rendered in
+ * the order that they were added, but no order is guaranteed between sprites
+ * in the same layer that use different textures.
+ */
+class SpriteBatch : private boost::noncopyable
+{
+
+public:
+
+  //! Constructor
+  SpriteBatch();
+
+  //! Destructor
+  ~SpriteBatch()
+  { /* ... */ }
+
+  //! Add the whole texture clip at the desired point
+  void add( const std::shared_ptr<Texture>& texture,
+	    const int layer,
+	    const int target_x_position,
+	    const int target_y_position,
+	    const SDL_Rect* texture_clip = NULL,
+	    const double rotation_angle = 0.0,
+	    const SDL_Point* rotation_center = NULL,
+	    const SDL_RendererFlip flip = SDL_FLIP_NONE );
+
+  //! Add the texture clip
+  void add( const std::shared_ptr<Texture>& texture,
+	    const int layer,
+	    const SDL_Rect* target_clip,
+	    const SDL_Rect* texture_clip = NULL,
+	    const double rotation_angle = 0.0,
+	    const SDL_Point* rotation_center = NULL,
+	    const SDL_RendererFlip flip = SDL_FLIP_NONE );
+
+  //! Add the whole texture region clip at the desired point
+  void add( const TextureRegion& region,
+	    const int layer,
+	    const int target_x_position,
+	    const int target_y_position,
+	    const SDL_Rect* region_clip = NULL,
+	    const double rotation_angle = 0.0,
+	    const SDL_Point* rotation_center = NULL,
+	    const SDL_RendererFlip flip = SDL_FLIP_NONE );
+
+  //! Add the texture region clip
+  void add( const TextureRegion& region,
+	    const int layer,
+	    const SDL_Rect* target_clip,
+	    const SDL_Rect* region_clip = NULL,
+	    const double rotation_angle = 0.0,
+	    const SDL_Point* rotation_center = NULL,
+	    const SDL_RendererFlip flip = SDL_FLIP_NONE );
+
+  //! Get the number of sprites in the batch
+  unsigned getNumberOfSprites() const;
+
+  //! Check if the batch is empty
+  bool isEmpty() const;
+
+  //! Get the number of sprite groups submitted by the last render
+  unsigned getNumberOfSubmittedGroups() const;
+
+  //! Render the sprites in the batch and empty the batch
+  void render();
+
+  //! Remove all sprites from the batch
+  void clear();
+
+private:
+
+  // The sprite
+  struct Sprite
+  {
+    // The texture
+    Texture* texture;
+
+    // The layer
+    int layer;
+
+    // The packed texture state (blend mode, color mod, alpha mod)
+    unsigned long long texture_state;
+
+    // The target clip
+    SDL_Rect target_clip;
+
+    // The texture clip
+    SDL_Rect texture_clip;
+
+    // Records if the whole target should be used
+    bool use_whole_target;
+
+    // Records if the whole texture should be used
+    bool use_whole_texture;
+
+    // The rotation angle
+    double rotation_angle;
+
+    // The rotation center
+    SDL_Point rotation_center;
+
+    // Records if the default rotation center should be used
+    bool use_default_rotation_center;
+
+    // The flip
+    SDL_RendererFlip flip;
+
+    // The order that the sprite was added in
+    unsigned order;
+  };
+
+  // Sprite comparison function (layer, texture, texture state, order)
+  static bool compareSprites( const Sprite& sprite_a, const Sprite& sprite_b );
+
+  // Pack the texture state
+  static unsigned long long packTextureState( const Texture& texture );
+
+  // Set the texture state
+  static void setTextureState( Texture& texture,
+			       const unsigned long long texture_state );
+
+  // The sprites
+  std::vector<Sprite> d_sprites;
+
+  // The textures used by the sprites (kept alive until the batch is rendered)
+  std::vector<std::shared_ptr<Texture> > d_textures;
+
+  // The number of sprite groups submitted by the last render
+  unsigned d_submitted_groups;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SPRITE_BATCH_HPP
+
+//---------------------------------------------------------------------------//
+// end SpriteBatch.hpp
+//---------------------------------------------------------------------------//
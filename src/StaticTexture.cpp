@@ -55,6 +55,19 @@ StaticTexture::StaticTexture( const std::shared_ptr<Renderer>& renderer,
   testPrecondition( renderer );
 }
 
+// Move constructor
+StaticTexture::StaticTexture( StaticTexture&& other_texture )
+  : Texture( std::move( other_texture ) )
+{ /* ... */ }
+
+// Move assignment operator
+StaticTexture& StaticTexture::operator=( StaticTexture&& other_texture )
+{
+  Texture::operator=( std::move( other_texture ) );
+
+  return *this;
+}
+
 // Get the access pattern
 SDL_TextureAccess StaticTexture::getAccessPattern() const
 {
@@ -41,6 +41,12 @@ public:
 		 const Font& font,
 		 const SDL_Color& text_color,
 		 const SDL_Color* background_color = NULL );
+
+  //! Move constructor
+  StaticTexture( StaticTexture&& other_texture );
+
+  //! Move assignment operator
+  StaticTexture& operator=( StaticTexture&& other_texture );
   
   //! Destructor
   ~StaticTexture()
@@ -8,41 +8,153 @@
 
 // Std Lib Includes
 #include <cstring>
+#include <algorithm>
+#include <type_traits>
 
 // GDev Includes
 #include "StreamingTexture.hpp"
+#include "PixelFormatConverter.hpp"
+#include "PixelView.hpp"
 #include "ExceptionTestMacros.hpp"
 #include "DBCMacros.hpp"
 
 namespace GDev{
 
+// Copies a section of pixels with pixel views
+/*! \details The source format and the destination format are dispatched
+ * separately so that the row loop is compiled for every pair of formats.
+ */
+struct StreamingTexture::PixelViewCopier
+{
+  // Dispatches the destination format for a source format
+  template<Uint32 SourceFormat>
+  struct DestinationStage
+  {
+    // The copier
+    const PixelViewCopier& copier;
+
+    // Copy the rows
+    template<Uint32 DestinationFormat>
+    void operator()( PixelFormatTag<DestinationFormat> ) const
+    {
+      copier.copyRows<SourceFormat,DestinationFormat>(
+	std::integral_constant<bool,
+	    PixelFormatTraits<DestinationFormat>::is_indexed>() );
+    }
+  };
+
+  // Dispatch the destination format
+  template<Uint32 SourceFormat>
+  void operator()( PixelFormatTag<SourceFormat> ) const
+  {
+    DestinationStage<SourceFormat> stage = {*this};
+
+    dispatchPixelFormat( destination_format, stage );
+  }
+
+  // Copy the rows to a destination format that is not indexed
+  template<Uint32 SourceFormat, Uint32 DestinationFormat>
+  void copyRows( std::false_type ) const
+  {
+    ConstPixelView<SourceFormat> source( source_pixels,
+					 width,
+					 height,
+					 source_pitch,
+					 source_palette );
+
+    PixelView<DestinationFormat> destination( destination_pixels,
+					      width,
+					      height,
+					      destination_pitch );
+
+    typename PixelView<DestinationFormat>::RowIterator destination_row =
+      destination.rowsBegin();
+
+    for( typename ConstPixelView<SourceFormat>::RowIterator source_row =
+	   source.rowsBegin();
+	 source_row != source.rowsEnd();
+	 ++source_row, ++destination_row )
+    {
+      typename PixelView<DestinationFormat>::Iterator destination_pixel =
+	(*destination_row).begin();
+
+      for( PixelRef<SourceFormat,const Uint8> source_pixel : *source_row )
+      {
+	(*destination_pixel).setARGB( source_pixel.getARGB( source_palette ) );
+
+	++destination_pixel;
+      }
+    }
+  }
+
+  // Indexed destination formats are not supported (never called)
+  template<Uint32 SourceFormat, Uint32 DestinationFormat>
+  void copyRows( std::true_type ) const
+  { /* ... */ }
+
+  // The source pixels
+  const Uint8* source_pixels;
+
+  // The source pitch
+  int source_pitch;
+
+  // The source palette
+  const SDL_Palette* source_palette;
+
+  // The destination format
+  Uint32 destination_format;
+
+  // The destination pixels
+  Uint8* destination_pixels;
+
+  // The destination pitch
+  int destination_pitch;
+
+  // The width of the section
+  int width;
+
+  // The height of the section
+  int height;
+};
+
+// Initialize static member data
+const int StreamingTexture::s_change_tile_size = 32;
+
+const unsigned StreamingTexture::s_default_max_number_of_copy_sections = 8u;
+
 // Blank constructor 
+/*! \details If the format is unknown the native texture format of the 
+ * renderer will be used.
+ */
 StreamingTexture::StreamingTexture( const std::shared_ptr<Renderer>& renderer,
 				    const int width,
 				    const int height,
 				    const Uint32 format )
   : Texture( renderer, SDL_TEXTUREACCESS_STREAMING, format, width, height ),
+    d_max_number_of_copy_sections( s_default_max_number_of_copy_sections ),
     d_is_locked( false ),
     d_pixels( NULL ),
-    d_pitch( 0 ),
-    d_num_locked_pixels( 0 )
+    d_pitch( 0 )
 {
   // Make sure the renderer is valid
   testPrecondition( renderer );
 }
 
 // Surface constructor
+/*! \details The native texture format of the renderer will be used.
+ */
 StreamingTexture::StreamingTexture( const std::shared_ptr<Renderer>& renderer,
 				    const Surface& surface )
   : Texture( renderer, 
 	     SDL_TEXTUREACCESS_STREAMING, 
-	     SDL_PIXELFORMAT_ARGB8888,
+	     renderer->getNativeTextureFormat( 
+				  surface.getPixelFormat().Amask != 0 ),
 	     surface.getWidth(),
 	     surface.getHeight() ),
+    d_max_number_of_copy_sections( s_default_max_number_of_copy_sections ),
     d_is_locked( false ),
     d_pixels( NULL ),
-    d_pitch( 0 ),
-    d_num_locked_pixels( 0 )
+    d_pitch( 0 )
 {
   // Make sure the renderer is valid
   testPrecondition( renderer );
@@ -51,6 +163,38 @@ StreamingTexture::StreamingTexture( const std::shared_ptr<Renderer>& renderer,
   this->copy( surface );
 }	   
 
+// Move constructor
+/*! \details Locked textures cannot be moved.
+ */
+StreamingTexture::StreamingTexture( StreamingTexture&& other_texture )
+  : Texture( std::move( other_texture ) ),
+    d_max_number_of_copy_sections( 
+			       other_texture.d_max_number_of_copy_sections ),
+    d_is_locked( false ),
+    d_pixels( NULL ),
+    d_pitch( 0 )
+{
+  // Make sure the other texture is unlocked
+  testPrecondition( !other_texture.d_is_locked );
+}
+
+// Move assignment operator
+/*! \details Locked textures cannot be moved or assigned to.
+ */
+StreamingTexture& StreamingTexture::operator=( 
+					   StreamingTexture&& other_texture )
+{
+  // Make sure the textures are unlocked
+  testPrecondition( !d_is_locked );
+  testPrecondition( !other_texture.d_is_locked );
+  
+  Texture::operator=( std::move( other_texture ) );
+
+  d_max_number_of_copy_sections = other_texture.d_max_number_of_copy_sections;
+
+  return *this;
+}
+
 // Get the access pattern
 SDL_TextureAccess StreamingTexture::getAccessPattern() const
 {
@@ -64,40 +208,253 @@ bool StreamingTexture::isLocked()
 }
 
 // Copy the surface to the texture
+/*! \details The surface pixels are converted straight into the locked
+ * texture memory when the pixel format converter supports the conversion
+ * (its SIMD kernels are the fastest path). Other conversions between
+ * formats with compile-time traits are done with pixel views (see
+ * GDev::PixelView). Otherwise the surface is converted by SDL first. Only
+ * the part of the surface that overlaps the texture is copied.
+ */
 void StreamingTexture::copy( const Surface& surface )
 {
-  // Make sure the surface is valid 
+  SDL_Rect section = {0,
+		      0,
+		      std::min( surface.getWidth(), this->getWidth() ),
+		      std::min( surface.getHeight(), this->getHeight() )};
+
+  this->copySections( surface, std::vector<SDL_Rect>( 1, section ) );
+}
+
+// Copy the changed areas of the surface to the texture
+/*! \details The areas are coalesced (see GDev::DirtyRegion) so that at
+ * most the max number of copy sections will be locked. If the areas cover
+ * more than half of the texture the entire surface will be copied.
+ */
+void StreamingTexture::copy( const Surface& surface,
+			     const std::vector<SDL_Rect>& changed_areas )
+{
+  DirtyRegion changed_region( 
+			    std::min( surface.getWidth(), this->getWidth() ),
+			    std::min( surface.getHeight(), this->getHeight() ) );
+
+  changed_region.setMaxNumberOfRectangles( d_max_number_of_copy_sections );
+
+  for( unsigned i = 0; i < changed_areas.size(); ++i )
+    changed_region.invalidate( changed_areas[i] );
+
+  this->copy( surface, changed_region );
+}
+
+// Copy the changed region of the surface to the texture
+/*! \details Each rectangle of the region will be locked and copied
+ * separately (the rectangles are clipped to the surface and the texture).
+ */
+void StreamingTexture::copy( const Surface& surface,
+			     const DirtyRegion& changed_region )
+{
+  if( changed_region.isEmpty() )
+    return;
+  
+  const SDL_Rect copy_area = 
+    {0,
+     0,
+     std::min( surface.getWidth(), this->getWidth() ),
+     std::min( surface.getHeight(), this->getHeight() )};
+
+  const std::vector<SDL_Rect>& rectangles = changed_region.getRectangles();
+
+  std::vector<SDL_Rect> sections;
+  sections.reserve( rectangles.size() );
+
+  for( unsigned i = 0; i < rectangles.size(); ++i )
+  {
+    SDL_Rect section;
     
-  if( surface.getPixelFormat().format == this->getFormat() )
-    this->copy( surface.getPixels(), surface.getNumberOfPixels() );
-  else
+    if( SDL_IntersectRect( &rectangles[i], &copy_area, &section ) )
+      sections.push_back( section );
+  }
+
+  if( !sections.empty() )
+    this->copySections( surface, sections );
+}
+
+// Copy the areas of the surface that differ from the previous surface
+/*! \details The surfaces are compared in square tiles. The tiles that 
+ * differ are coalesced and copied (see the changed areas copy method). The
+ * surfaces must have the same size and format.
+ */
+void StreamingTexture::copyChanges( const Surface& surface,
+				    const Surface& previous_surface )
+{
+  // Make sure the surfaces are comparable
+  testPrecondition( surface.getWidth() == previous_surface.getWidth() );
+  testPrecondition( surface.getHeight() == previous_surface.getHeight() );
+  testPrecondition( surface.getPixelFormat().format ==
+		    previous_surface.getPixelFormat().format );
+  testPrecondition( !SDL_MUSTLOCK( surface.getRawSurfacePtr() ) );
+  testPrecondition( !SDL_MUSTLOCK( previous_surface.getRawSurfacePtr() ) );
+
+  const int width = std::min( surface.getWidth(), this->getWidth() );
+  const int height = std::min( surface.getHeight(), this->getHeight() );
+  
+  const int bytes_per_pixel = surface.getPixelFormat().BytesPerPixel;
+  
+  const Uint8* pixels = static_cast<const Uint8*>( surface.getPixels() );
+  const Uint8* previous_pixels = 
+    static_cast<const Uint8*>( previous_surface.getPixels() );
+
+  std::vector<SDL_Rect> changed_areas;
+
+  for( int tile_y = 0; tile_y < height; tile_y += s_change_tile_size )
   {
-    Surface converted_surface( surface, this->getFormat() );
+    const int tile_height = std::min( s_change_tile_size, height - tile_y );
+    
+    for( int tile_x = 0; tile_x < width; tile_x += s_change_tile_size )
+    {
+      const int tile_width = std::min( s_change_tile_size, width - tile_x );
+      
+      for( int y = tile_y; y < tile_y + tile_height; ++y )
+      {
+	const int offset = y*surface.getPitch() + tile_x*bytes_per_pixel;
+	const int previous_offset = 
+	  y*previous_surface.getPitch() + tile_x*bytes_per_pixel;
+	
+	if( memcmp( pixels + offset, 
+		    previous_pixels + previous_offset,
+		    tile_width*bytes_per_pixel ) != 0 )
+	{
+	  SDL_Rect changed_area = {tile_x, tile_y, tile_width, tile_height};
+	  
+	  changed_areas.push_back( changed_area );
 
-    this->copy( surface.getPixels(), surface.getNumberOfPixels() );
+	  break;
+	}
+      }
+    }
   }
+
+  if( !changed_areas.empty() )
+    this->copy( surface, changed_areas );
+}
+
+// Get the max number of sections that are locked by a partial copy
+unsigned StreamingTexture::getMaxNumberOfCopySections() const
+{
+  return d_max_number_of_copy_sections;
 }
 
-// Copy the pixels to the texture
-void StreamingTexture::copy( const void* pixels, const unsigned num_pixels )
+// Set the max number of sections that are locked by a partial copy
+/*! \details Every locked section has a fixed cost (with most renderers
+ * the section is uploaded with a separate call). Nearby changed areas are
+ * merged once this number of sections has been reached. The default is 8.
+ */
+void StreamingTexture::setMaxNumberOfCopySections( 
+				    const unsigned max_number_of_sections )
 {
-  // Make sure there is at least one pixel
-  this->lock();
+  // Make sure the max number of sections is valid
+  testPrecondition( max_number_of_sections > 0 );
 
-  // Determine the number of pixels to copy
-  size_t num_pixels_to_copy;
+  d_max_number_of_copy_sections = max_number_of_sections;
+}
+
+// Copy sections of the surface to the texture
+void StreamingTexture::copySections( const Surface& surface,
+				     const std::vector<SDL_Rect>& sections )
+{
+  const SDL_Surface& raw_surface = *surface.getRawSurfacePtr();
   
-  if( num_pixels < d_num_locked_pixels )
-    num_pixels_to_copy = num_pixels;
+  if( !SDL_MUSTLOCK( &raw_surface ) &&
+      PixelFormatConverter::canConvert( raw_surface.format->format,
+					this->getFormat() ) )
+  {
+    for( unsigned i = 0; i < sections.size(); ++i )
+    {
+      this->copySection( raw_surface.format->format,
+			 raw_surface.pixels,
+			 raw_surface.pitch,
+			 raw_surface.format->palette,
+			 sections[i] );
+    }
+  }
+  else if( !SDL_MUSTLOCK( &raw_surface ) &&
+	   isPixelFormatSpecialized( raw_surface.format->format ) &&
+	   isPixelFormatSpecialized( this->getFormat() ) &&
+	   !SDL_ISPIXELFORMAT_INDEXED( this->getFormat() ) &&
+	   (!SDL_ISPIXELFORMAT_INDEXED( raw_surface.format->format ) ||
+	    raw_surface.format->palette != NULL) )
+  {
+    for( unsigned i = 0; i < sections.size(); ++i )
+      this->copySectionWithPixelViews( raw_surface, sections[i] );
+  }
   else
-    num_pixels_to_copy = d_num_locked_pixels;
+  {
+    Surface converted_surface( surface, this->getFormat() );
 
-  // Copy the pixels from the destination to the texture
-  memcpy( d_pixels, 
-	  pixels, 
-	  num_pixels_to_copy*SDL_BYTESPERPIXEL(this->getFormat()) );
+    for( unsigned i = 0; i < sections.size(); ++i )
+    {
+      this->copySection( converted_surface.getPixelFormat().format,
+			 converted_surface.getPixels(),
+			 converted_surface.getPitch(),
+			 NULL,
+			 sections[i] );
+    }
+  }
+}
+
+// Copy (and convert) a section of the pixels to the texture
+/*! \details The pixels must cover the section. The source and the texture
+ * pitches can differ. The section is checked by the lock.
+ */
+void StreamingTexture::copySection( const Uint32 format,
+				    const void* pixels,
+				    const int pitch,
+				    const SDL_Palette* palette,
+				    const SDL_Rect& section )
+{
+  // Make sure the pixels can be converted
+  testPrecondition( PixelFormatConverter::canConvert( format,
+						      this->getFormat() ) );
+  // Make sure the pixels are valid
+  testPrecondition( pixels != NULL );
   
-  this->unlock();
+  StreamingTextureLock section_lock( *this, section );
+
+  const Uint8* section_pixels = static_cast<const Uint8*>( pixels ) +
+    section.y*pitch + section.x*SDL_BYTESPERPIXEL( format );
+
+  PixelFormatConverter::convertRows( format,
+				     section_pixels,
+				     pitch,
+				     palette,
+				     this->getFormat(),
+				     section_lock.getPixels(),
+				     section_lock.getPitch(),
+				     section.w,
+				     section.h );
+}
+
+// Copy (and convert) a section of the pixels with pixel views
+/*! \details The surface and the texture formats must have compile-time
+ * traits (the texture format cannot be indexed). The section is checked by
+ * the lock.
+ */
+void StreamingTexture::copySectionWithPixelViews( const SDL_Surface& surface,
+						  const SDL_Rect& section )
+{
+  StreamingTextureLock section_lock( *this, section );
+
+  PixelViewCopier copier;
+  copier.source_pixels = static_cast<const Uint8*>( surface.pixels ) +
+    section.y*surface.pitch + section.x*surface.format->BytesPerPixel;
+  copier.source_pitch = surface.pitch;
+  copier.source_palette = surface.format->palette;
+  copier.destination_format = this->getFormat();
+  copier.destination_pixels = static_cast<Uint8*>( section_lock.getPixels() );
+  copier.destination_pitch = section_lock.getPitch();
+  copier.width = section.w;
+  copier.height = section.h;
+
+  dispatchPixelFormat( surface.format->format, copier );
 }
 
 // Lock the texture
@@ -111,9 +468,6 @@ void StreamingTexture::lock()
 				      &d_pixels,
 				      &d_pitch );
 
-  d_num_locked_pixels = d_pitch*this->getHeight()/
-    SDL_BYTESPERPIXEL(this->getFormat());
-
   TEST_FOR_EXCEPTION( return_value != 0,
 		      ExceptionType,
 		      "Error: The streaming texture could not be locked! "
@@ -122,6 +476,27 @@ void StreamingTexture::lock()
   d_is_locked = true;
 }
 
+// Lock a section of the texture
+/*! \details The pixel pointer will point to the first pixel of the section.
+ */
+void StreamingTexture::lockSection( const SDL_Rect& section )
+{
+  // Make sure the texture is unlocked
+  testPrecondition( !d_is_locked );
+
+  int return_value = SDL_LockTexture( this->getRawTexturePtr(),
+				      &section,
+				      &d_pixels,
+				      &d_pitch );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The streaming texture section could not be "
+		      "locked! SDL_Error: " << SDL_GetError() );
+
+  d_is_locked = true;
+}
+
 // Unlock the texture
 void StreamingTexture::unlock()
 {
@@ -9,28 +9,46 @@
 #ifndef GDEV_STREAMING_TEXTURE_HPP
 #define GDEV_STREAMING_TEXTURE_HPP
 
+// Std Lib Includes
+#include <vector>
+
 // GDev Includes
 #include "StreamingTexture.hpp"
 #include "Texture.hpp"
+#include "DirtyRegion.hpp"
+#include "StreamingTextureLock.hpp"
 
 namespace GDev{
 
-//! The streaming texture wrapper class
+/*! The streaming texture wrapper class
+ * \details The pixels of the texture can be updated by copying a surface
+ * (or the changed areas of it) or written directly with a
+ * GDev::StreamingTextureLock.
+ */
 class StreamingTexture : public Texture
 {
 
+  // The lock needs access to the lock and unlock methods
+  friend class StreamingTextureLock;
+
 public:
 
   //! Blank constructor 
   StreamingTexture( const std::shared_ptr<Renderer>& renderer,
 		    const int width,
 		    const int height,
-		    const Uint32 format = SDL_PIXELFORMAT_ARGB8888 );
+		    const Uint32 format = SDL_PIXELFORMAT_UNKNOWN );
 
   //! Surface constructor
   StreamingTexture( const std::shared_ptr<Renderer>& renderer,
 		    const Surface& surface );
 
+  //! Move constructor
+  StreamingTexture( StreamingTexture&& other_texture );
+
+  //! Move assignment operator
+  StreamingTexture& operator=( StreamingTexture&& other_texture );
+
   //! Destructor
   ~StreamingTexture()
   { /* ... */ }
@@ -43,11 +61,44 @@ public:
 
   //! Copy the surface to the texture
   void copy( const Surface& surface );
+
+  //! Copy the changed areas of the surface to the texture
+  void copy( const Surface& surface,
+	     const std::vector<SDL_Rect>& changed_areas );
+
+  //! Copy the changed region of the surface to the texture
+  void copy( const Surface& surface, const DirtyRegion& changed_region );
+
+  //! Copy the areas of the surface that differ from the previous surface
+  void copyChanges( const Surface& surface,
+		    const Surface& previous_surface );
+
+  //! Get the max number of sections that are locked by a partial copy
+  unsigned getMaxNumberOfCopySections() const;
+
+  //! Set the max number of sections that are locked by a partial copy
+  void setMaxNumberOfCopySections( const unsigned max_number_of_sections );
 	     
 private:
 
-  //! Copy the pixels to the texture
-  void copy( const void* pixels, const unsigned num_pixels );
+  // Copies a section of pixels with pixel views (defined in
+  // StreamingTexture.cpp)
+  struct PixelViewCopier;
+
+  //! Copy sections of the surface to the texture
+  void copySections( const Surface& surface,
+		     const std::vector<SDL_Rect>& sections );
+
+  //! Copy (and convert) a section of the pixels to the texture
+  void copySection( const Uint32 format,
+		    const void* pixels,
+		    const int pitch,
+		    const SDL_Palette* palette,
+		    const SDL_Rect& section );
+
+  //! Copy (and convert) a section of the pixels with pixel views
+  void copySectionWithPixelViews( const SDL_Surface& surface,
+				  const SDL_Rect& section );
 
   //! Lock the texture
   void lock();
@@ -61,6 +112,15 @@ private:
   //! Do not allow default construction
   StreamingTexture();
 
+  // The size of the tiles that are compared by copyChanges
+  static const int s_change_tile_size;
+
+  // The default max number of sections that are locked by a partial copy
+  static const unsigned s_default_max_number_of_copy_sections;
+
+  // The max number of sections that are locked by a partial copy
+  unsigned d_max_number_of_copy_sections;
+
   // Records if the texture is locked
   bool d_is_locked;
 
@@ -69,9 +129,6 @@ private:
 
   // The pixel pitch
   int d_pitch;
-
-  // The number of pixels
-  unsigned d_num_locked_pixels;
 };
 
 } // end GDev namespace
@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   StreamingTextureLock.cpp
+//! \author Alex Robinson
+//! \brief  The streaming texture lock class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "StreamingTextureLock.hpp"
+#include "StreamingTexture.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Constructor (lock the entire texture)
+StreamingTextureLock::StreamingTextureLock( StreamingTexture& texture )
+  : d_texture( texture ),
+    d_section()
+{
+  // Make sure the texture is unlocked
+  testPrecondition( !texture.isLocked() );
+
+  d_section.x = 0;
+  d_section.y = 0;
+  d_section.w = texture.getWidth();
+  d_section.h = texture.getHeight();
+
+  d_texture.lock();
+}
+
+// Constructor (lock a section of the texture)
+StreamingTextureLock::StreamingTextureLock( StreamingTexture& texture,
+					    const SDL_Rect& section )
+  : d_texture( texture ),
+    d_section( section )
+{
+  // Make sure the texture is unlocked
+  testPrecondition( !texture.isLocked() );
+  // Make sure the section is valid
+  testPrecondition( section.x >= 0 );
+  testPrecondition( section.y >= 0 );
+  testPrecondition( section.w > 0 );
+  testPrecondition( section.h > 0 );
+  testPrecondition( section.x + section.w <= texture.getWidth() );
+  testPrecondition( section.y + section.h <= texture.getHeight() );
+
+  d_texture.lockSection( d_section );
+}
+
+// Destructor (unlock the texture)
+StreamingTextureLock::~StreamingTextureLock()
+{
+  d_texture.unlock();
+}
+
+// Get the locked section of the texture
+const SDL_Rect& StreamingTextureLock::getSection() const
+{
+  return d_section;
+}
+
+// Get the width of the locked section
+int StreamingTextureLock::getWidth() const
+{
+  return d_section.w;
+}
+
+// Get the height of the locked section
+int StreamingTextureLock::getHeight() const
+{
+  return d_section.h;
+}
+
+// Get the length of a row of locked pixels in bytes (pitch)
+/*! \details The pitch can be larger than the width of the section times
+ * the number of bytes per pixel.
+ */
+int StreamingTextureLock::getPitch() const
+{
+  return d_texture.d_pitch;
+}
+
+// Get the format of the locked pixels
+Uint32 StreamingTextureLock::getFormat() const
+{
+  return d_texture.getFormat();
+}
+
+// Get the locked pixels
+/*! \details The pointer points to the first pixel of the locked section.
+ */
+void* StreamingTextureLock::getPixels()
+{
+  return d_texture.d_pixels;
+}
+
+// Get a row of locked pixels (the pixel size is checked)
+void* StreamingTextureLock::getRowPointer( const int y,
+					   const unsigned pixel_size )
+{
+  // Make sure the row is valid
+  testPrecondition( y >= 0 );
+  testPrecondition( y < d_section.h );
+  // Make sure the pixel size is valid
+  testPrecondition( pixel_size == SDL_BYTESPERPIXEL( d_texture.getFormat() ) );
+
+  return static_cast<Uint8*>( d_texture.d_pixels ) + y*d_texture.d_pitch;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end StreamingTextureLock.cpp
+//---------------------------------------------------------------------------//
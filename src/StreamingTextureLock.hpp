@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   StreamingTextureLock.hpp
+//! \author Alex Robinson
+//! \brief  The streaming texture lock class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_STREAMING_TEXTURE_LOCK_HPP
+#define GDEV_STREAMING_TEXTURE_LOCK_HPP
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+namespace GDev{
+
+class StreamingTexture;
+
+/*! The streaming texture lock class
+ * \details The lock gives write access to the pixels of a streaming
+ * texture (or a section of it) without an intermediate surface. The texture
+ * is locked when the lock is constructed and unlocked when the lock is
+ * destroyed (also when an exception is thrown). The locked pixels are
+ * exposed as a pitch-aware 2D view: rows and pixels can be accessed with
+ * the pixel type that matches the texture format (e.g. Uint32 for
+ * ARGB8888). The locked memory is write-only - it will not contain the
+ * current texture pixels with most renderers, so every pixel of the
+ * section should be written.
+ */
+class StreamingTextureLock : private boost::noncopyable
+{
+
+public:
+
+  //! Constructor (lock the entire texture)
+  StreamingTextureLock( StreamingTexture& texture );
+
+  //! Constructor (lock a section of the texture)
+  StreamingTextureLock( StreamingTexture& texture, const SDL_Rect& section );
+
+  //! Destructor (unlock the texture)
+  ~StreamingTextureLock();
+
+  //! Get the locked section of the texture
+  const SDL_Rect& getSection() const;
+
+  //! Get the width of the locked section
+  int getWidth() const;
+
+  //! Get the height of the locked section
+  int getHeight() const;
+
+  //! Get the length of a row of locked pixels in bytes (pitch)
+  int getPitch() const;
+
+  //! Get the format of the locked pixels
+  Uint32 getFormat() const;
+
+  //! Get the locked pixels
+  void* getPixels();
+
+  //! Get a row of locked pixels
+  template<typename PixelType>
+  PixelType* getRow( const int y );
+
+  //! Get a locked pixel
+  template<typename PixelType>
+  PixelType& getPixel( const int x, const int y );
+
+private:
+
+  // Get a row of locked pixels (the pixel size is checked)
+  void* getRowPointer( const int y, const unsigned pixel_size );
+
+  // The locked texture
+  StreamingTexture& d_texture;
+
+  // The locked section
+  SDL_Rect d_section;
+};
+
+// Get a row of locked pixels
+/*! \details The size of the pixel type must be the number of bytes per
+ * pixel of the texture format.
+ */
+template<typename PixelType>
+inline PixelType* StreamingTextureLock::getRow( const int y )
+{
+  return static_cast<PixelType*>(
+			    this->getRowPointer( y, sizeof(PixelType) ) );
+}
+
+// Get a locked pixel
+/*! \details The pixel is not bounds checked (only the row is).
+ */
+template<typename PixelType>
+inline PixelType& StreamingTextureLock::getPixel( const int x, const int y )
+{
+  return this->getRow<PixelType>( y )[x];
+}
+
+} // end GDev namespace
+
+#endif // end GDEV_STREAMING_TEXTURE_LOCK_HPP
+
+//---------------------------------------------------------------------------//
+// end StreamingTextureLock.hpp
+//---------------------------------------------------------------------------//
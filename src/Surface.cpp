@@ -6,11 +6,19 @@
 //!
 //---------------------------------------------------------------------------//
 
+// Std Lib Includes
+#include <vector>
+#include <algorithm>
+
 // SDL Includes
 #include <SDL2/SDL_image.h>
 
 // GDev Includes
 #include "Surface.hpp"
+#include "SurfaceBlitter.hpp"
+#include "PixelFormatConverter.hpp"
+#include "SurfacePixelPool.hpp"
+#include "PixelView.hpp"
 #include "ExceptionTestMacros.hpp"
 #include "DBCMacros.hpp"
 
@@ -21,22 +29,31 @@ Surface::Surface( const int width,
 		  const int height,
 		  const Uint32 pixel_format )
   : d_surface( NULL ),
-    d_owns_surface( true )
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
   // Make sure the dimensions are valid
   testPrecondition( width > 0 );
   testPrecondition( height > 0 );
 
-  this->initializeRGBSurface( width, height, pixel_format );
+  this->initializeRGBSurface( width, height, pixel_format, true );
 }
 
 // Shape constructor
+/*! \details The surface is filled one row span at a time (see 
+ * Shape::getRowSpans), which avoids testing every pixel of the shape.
+ */
 Surface::Surface( const Shape& area,
 		  const SDL_Color& inside_color,
 		  const SDL_Color& edge_color,
 		  const SDL_Color& outside_color )
   : d_surface( NULL ),
-    d_owns_surface( true )
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
   // Make sure the dimensions are valid
   testPrecondition( area.getBoundingBoxWidth() > 0 );
@@ -44,7 +61,8 @@ Surface::Surface( const Shape& area,
 
   this->initializeRGBSurface( area.getBoundingBoxWidth(), 
 			      area.getBoundingBoxHeight(), 
-			      SDL_PIXELFORMAT_ARGB8888 );
+			      SDL_PIXELFORMAT_ARGB8888,
+			      true );
 
   // Create the pixel types
   Uint32 in_pixel = SDL_MapRGBA( &this->getPixelFormat(),
@@ -69,21 +87,36 @@ Surface::Surface( const Shape& area,
     // Get the surface pixels
     this->lock();
     
-    Uint32* pixels = (Uint32*)this->getPixels();
+    PixelView<SDL_PIXELFORMAT_ARGB8888> pixels( *this );
+
+    std::vector<ShapeSpan> spans;
     
-    for( int i = 0; i < this->getNumberOfPixels(); ++i )
+    // Fill each row one span at a time
+    for( int row = 0; row < pixels.getHeight(); ++row )
     {
-      int row = i/this->getWidth();
-      int pixel_x_pos = i - row*this->getWidth() + 
-	area.getBoundingBoxXPosition();
-      int pixel_y_pos = row + area.getBoundingBoxYPosition();
-      
-      if( area.isPointOn( pixel_x_pos, pixel_y_pos ) )
-      	pixels[i] = edge_pixel;
-      else if( area.isPointIn( pixel_x_pos, pixel_y_pos ) )
-	pixels[i] = in_pixel;
-      else
-	pixels[i] = out_pixel;
+      area.getRowSpans( row + area.getBoundingBoxYPosition(), spans );
+
+      for( unsigned i = 0; i < spans.size(); ++i )
+      {
+	Uint32 span_pixel;
+
+	switch( spans[i].coverage )
+	{
+	case ON_SHAPE_EDGE:
+	  span_pixel = edge_pixel;
+	  break;
+	case INSIDE_SHAPE:
+	  span_pixel = in_pixel;
+	  break;
+	default:
+	  span_pixel = out_pixel;
+	}
+	
+	pixels.fillRow( row,
+			spans[i].x_position - area.getBoundingBoxXPosition(),
+			spans[i].length,
+			span_pixel );
+      }
     }
 
     this->unlock();
@@ -99,7 +132,10 @@ Surface::Surface( const Shape& area,
  */
 Surface::Surface( const std::string& image_name )
   : d_surface( NULL ),
-    d_owns_surface( true )
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
   // Make sure the image name is valid
   testPrecondition( image_name.size() > 0 );
@@ -122,7 +158,10 @@ Surface::Surface( const std::string& message,
 		  const SDL_Color& text_color,
 		  const SDL_Color* background_color )
   : d_surface( NULL ),
-    d_owns_surface( true )
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
   // Make sure the message is valid
   testPrecondition( message.size() > 0 );
@@ -157,12 +196,32 @@ Surface::Surface( const std::string& message,
 Surface::Surface( const Surface& other_surface,
 		  const Uint32 pixel_format )
   : d_surface( NULL ),
-    d_owns_surface( true )
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
-  d_surface = SDL_ConvertSurfaceFormat( 
-		  const_cast<SDL_Surface*>( other_surface.getRawSurfacePtr() ),
-		  pixel_format,
-		  0 );
+  const SDL_Surface& other_raw_surface = *other_surface.getRawSurfacePtr();
+  
+  // Use the pixel format converter for the common image formats
+  if( PixelFormatConverter::canConvert( other_raw_surface, pixel_format ) )
+  {
+    this->initializeRGBSurface( other_raw_surface.w,
+				other_raw_surface.h,
+				pixel_format,
+				false );
+
+    PixelFormatConverter::convert( other_raw_surface, *d_surface );
+
+    this->copyConversionSettings( other_raw_surface );
+  }
+  else
+  {
+    d_surface = SDL_ConvertSurfaceFormat( 
+			      const_cast<SDL_Surface*>( &other_raw_surface ),
+			      pixel_format,
+			      0 );
+  }
 
   TEST_FOR_EXCEPTION( d_surface == NULL,
 		      ExceptionType,
@@ -170,15 +229,141 @@ Surface::Surface( const Surface& other_surface,
 		      "requested format! SDL_Error: " << SDL_GetError() );
 }
 
+// Sub-surface constructor (will share the parent surface pixels)
+/*! \details The sub-surface is a view of an area of the parent surface: no
+ * pixels are copied (the rows of the sub-surface start in the rows of the 
+ * parent and have the parent pitch). Writing to the sub-surface pixels
+ * writes to the parent surface pixels. The sub-surface keeps the parent
+ * alive. The color key, the palette, the modulation and the blend mode of
+ * the parent are copied. The sub-surface can be used like any other 
+ * surface (blits, locks, exports, texture creation). The parent cannot be
+ * RLE accelerated (it must not require locking).
+ */
+Surface::Surface( const std::shared_ptr<Surface>& parent_surface,
+		  const SDL_Rect& area )
+  : d_surface( NULL ),
+    d_pixels( NULL ),
+    d_owns_surface( true ),
+    d_parent_surface( parent_surface ),
+    d_number_of_sub_surfaces( 0u )
+{
+  // Make sure the parent surface is valid
+  testPrecondition( parent_surface );
+  testPrecondition( !parent_surface->mustLock() );
+  testPrecondition( parent_surface->getPixelFormat().BitsPerPixel >= 8 );
+  // Make sure the area is valid
+  testPrecondition( area.x >= 0 );
+  testPrecondition( area.y >= 0 );
+  testPrecondition( area.w > 0 );
+  testPrecondition( area.h > 0 );
+  testPrecondition( area.x + area.w <= parent_surface->getWidth() );
+  testPrecondition( area.y + area.h <= parent_surface->getHeight() );
+
+  SDL_Surface* parent_raw_surface = parent_surface->getRawSurfacePtr();
+
+  const SDL_PixelFormat& format = *parent_raw_surface->format;
+  
+  Uint8* pixels = static_cast<Uint8*>( parent_raw_surface->pixels ) +
+    area.y*parent_raw_surface->pitch + area.x*format.BytesPerPixel;
+
+  d_surface = SDL_CreateRGBSurfaceFrom( pixels,
+					area.w,
+					area.h,
+					format.BitsPerPixel,
+					parent_raw_surface->pitch,
+					format.Rmask,
+					format.Gmask,
+					format.Bmask,
+					format.Amask );
+
+  TEST_FOR_EXCEPTION( d_surface == NULL,
+		      ExceptionType,
+		      "Error: The sub-surface could not be created! "
+		      "SDL_Error: " << SDL_GetError() );
+
+  if( format.palette != NULL )
+    SDL_SetSurfacePalette( d_surface, format.palette );
+
+  Uint32 color_key;
+
+  if( SDL_GetColorKey( parent_raw_surface, &color_key ) == 0 )
+    SDL_SetColorKey( d_surface, SDL_TRUE, color_key );
+
+  SDL_BlendMode blend_mode;
+
+  SDL_GetSurfaceBlendMode( parent_raw_surface, &blend_mode );
+  SDL_SetSurfaceBlendMode( d_surface, blend_mode );
+
+  this->copyConversionSettings( *parent_raw_surface );
+
+  // The clip rectangle of the parent does not apply to the sub-surface
+  SDL_SetClipRect( d_surface, NULL );
+
+  ++d_parent_surface->d_number_of_sub_surfaces;
+}
+
 // Existing surface constructor (will not take ownership)
 Surface::Surface( SDL_Surface* existing_surface )
   : d_surface( existing_surface ),
-    d_owns_surface( false )
+    d_pixels( NULL ),
+    d_owns_surface( false ),
+    d_parent_surface(),
+    d_number_of_sub_surfaces( 0u )
 {
   // Make sure the existing surface is valid
   testPrecondition( existing_surface != NULL );
 }
 
+// Move constructor
+/*! \details The surface, the pooled pixels, the ownership flag and the
+ * parent surface (of a sub-surface) are transferred. The other surface will
+ * be empty (it can only be destroyed or assigned to). A surface that has
+ * live sub-surfaces cannot be moved (the sub-surfaces refer to it).
+ */
+Surface::Surface( Surface&& other_surface )
+  : d_surface( other_surface.d_surface ),
+    d_pixels( other_surface.d_pixels ),
+    d_owns_surface( other_surface.d_owns_surface ),
+    d_parent_surface( std::move( other_surface.d_parent_surface ) ),
+    d_number_of_sub_surfaces( 0u )
+{
+  // Make sure the other surface has no sub-surfaces
+  testPrecondition( other_surface.d_number_of_sub_surfaces == 0u );
+
+  other_surface.d_surface = NULL;
+  other_surface.d_pixels = NULL;
+  other_surface.d_owns_surface = false;
+}
+
+// Move assignment operator
+/*! \details The surface that is currently wrapped will be freed (if it is
+ * owned) before the other surface is transferred. Neither surface can have
+ * live sub-surfaces (the pixels of this surface would be freed while the
+ * sub-surfaces still use them).
+ */
+Surface& Surface::operator=( Surface&& other_surface )
+{
+  // Make sure the surfaces have no sub-surfaces
+  testPrecondition( d_number_of_sub_surfaces == 0u );
+  testPrecondition( other_surface.d_number_of_sub_surfaces == 0u );
+
+  if( this != &other_surface )
+  {
+    this->free();
+
+    d_surface = other_surface.d_surface;
+    d_pixels = other_surface.d_pixels;
+    d_owns_surface = other_surface.d_owns_surface;
+    d_parent_surface = std::move( other_surface.d_parent_surface );
+
+    other_surface.d_surface = NULL;
+    other_surface.d_pixels = NULL;
+    other_surface.d_owns_surface = false;
+  }
+
+  return *this;
+}
+
 // Destructor
 Surface::~Surface()
 {
@@ -191,6 +376,24 @@ bool Surface::isLocallyOwned() const
   return d_owns_surface;
 }
 
+// Check if the surface is a sub-surface (a view of a parent surface)
+bool Surface::isSubSurface() const
+{
+  return d_parent_surface.get() != NULL;
+}
+
+// Get the number of live sub-surfaces (views of this surface)
+unsigned Surface::getNumberOfSubSurfaces() const
+{
+  return d_number_of_sub_surfaces;
+}
+
+// Get the parent surface of a sub-surface (NULL if not a sub-surface)
+std::shared_ptr<const Surface> Surface::getParentSurface() const
+{
+  return d_parent_surface;
+}
+
 // Get the width of the surface
 int Surface::getWidth() const
 {
@@ -437,18 +640,74 @@ const void* Surface::getPixels() const
 }
 
 // Get the number of surface pixels
+/*! \details The row padding (see getPitch) is not counted.
+ */
 unsigned Surface::getNumberOfPixels() const
 {
-  return this->getPitch()*this->getHeight()/
-    this->getPixelFormat().BytesPerPixel;
+  return this->getWidth()*this->getHeight();
 }
 
 // Perform a scaled surface copy to the destination surface
+/*! \details Scaled blits between surfaces with the same 32 bit pixel format
+ * are done with the GDev surface scaler, which supports the nearest,
+ * bilinear and box filters (see SurfaceScaler). All other scaled blits are
+ * done by SDL, which only supports the nearest filter. The destination
+ * rectangle will be set to the clipped rectangle that was blitted. Unscaled
+ * blits are forwarded to blitSurface.
+ */
 void Surface::blitScaled( Surface& destination_surface,
 			  SDL_Rect* destination_rectangle,
-			  const SDL_Rect* source_rectangle ) const
+			  const SDL_Rect* source_rectangle,
+			  const SurfaceScaler::Filter filter ) const
 			  
 {
+  const int source_width = source_rectangle ? source_rectangle->w :
+    this->getWidth();
+  const int source_height = source_rectangle ? source_rectangle->h :
+    this->getHeight();
+  const int destination_width = destination_rectangle ?
+    destination_rectangle->w : destination_surface.getWidth();
+  const int destination_height = destination_rectangle ?
+    destination_rectangle->h : destination_surface.getHeight();
+
+  if( source_width == destination_width &&
+      source_height == destination_height )
+  {
+    this->blitSurface( destination_surface,
+		       destination_rectangle,
+		       source_rectangle );
+
+    return;
+  }
+  
+  if( SurfaceScaler::canBlitScaled( *d_surface,
+				    *destination_surface.d_surface ) )
+  {
+    SDL_Rect clipped_source_rectangle, clipped_destination_rectangle;
+
+    bool visible = SurfaceScaler::clipRectangles(
+					      *d_surface,
+					      source_rectangle,
+					      *destination_surface.d_surface,
+					      destination_rectangle,
+					      clipped_source_rectangle,
+					      clipped_destination_rectangle );
+
+    if( visible )
+    {
+      SurfaceScaler::blitScaled( *d_surface,
+				 clipped_source_rectangle,
+				 *destination_surface.d_surface,
+				 clipped_destination_rectangle,
+				 filter );
+    }
+
+    if( destination_rectangle )
+      *destination_rectangle = clipped_destination_rectangle;
+
+    return;
+  }
+  
   int return_value = SDL_BlitScaled( const_cast<SDL_Surface*>( d_surface ),
 				     source_rectangle,
 				     destination_surface.d_surface,
@@ -461,11 +720,40 @@ void Surface::blitScaled( Surface& destination_surface,
 }
   
 // Perform a fast surface copy to the destination surface
+/*! \details Blits between ARGB8888 surfaces are done with the GDev
+ * surface blitter (SIMD kernels). All other blits are done by SDL. The
+ * destination rectangle will be set to the clipped rectangle that was
+ * blitted in both cases.
+ */
 void Surface::blitSurface( Surface& destination_surface,
 			   SDL_Rect* destination_rectangle,
 			   const SDL_Rect* source_rectangle ) const
 			   
 {
+  if( SurfaceBlitter::canBlit( *d_surface, *destination_surface.d_surface ) )
+  {
+    SDL_Rect full_destination_rectangle = {0, 0, 0, 0};
+
+    if( destination_rectangle == NULL )
+      destination_rectangle = &full_destination_rectangle;
+
+    SDL_Rect clipped_source_rectangle;
+
+    if( SurfaceBlitter::clipRectangles( *d_surface,
+					source_rectangle,
+					*destination_surface.d_surface,
+					*destination_rectangle,
+					clipped_source_rectangle ) )
+    {
+      SurfaceBlitter::blit( *d_surface,
+			    clipped_source_rectangle,
+			    *destination_surface.d_surface,
+			    *destination_rectangle );
+    }
+
+    return;
+  }
+  
   int return_value = SDL_BlitSurface( const_cast<SDL_Surface*>( d_surface ),
 				      source_rectangle,
 				      destination_surface.d_surface,
@@ -493,9 +781,14 @@ void Surface::exportToBMP( const std::string bmp_file_name ) const
 }
 
 // Initialize an RGB surface
+/*! \details The pixels are allocated from the surface pixel pool: every
+ * row starts on an aligned boundary. The pixels will only be cleared if 
+ * requested (recycled pixels are not cleared by the pool).
+ */
 void Surface::initializeRGBSurface( const int width,
 				    const int height,
-				    const Uint32 pixel_format )
+				    const Uint32 pixel_format,
+				    const bool clear_pixels )
 {
   // Make sure the dimensions are valid
   testPrecondition( width > 0 );
@@ -518,14 +811,29 @@ void Surface::initializeRGBSurface( const int width,
 		      " could not be used to create a blank surface! "
 		      "SDL_Error: " << SDL_GetError() );
 
-  d_surface = SDL_CreateRGBSurface( 0, 
-				    width,
-				    height,
-				    bits_per_pixel,
-				    rmask,
-				    gmask,
-				    bmask,
-				    amask );
+  const int pitch = SurfacePixelPool::getAlignedPitch( width, bits_per_pixel );
+
+  d_pixels = SurfacePixelPool::allocate( (size_t)pitch*height );
+
+  if( clear_pixels )
+    std::fill_n( (Uint8*)d_pixels, (size_t)pitch*height, 0 );
+
+  d_surface = SDL_CreateRGBSurfaceFrom( d_pixels,
+					width,
+					height,
+					bits_per_pixel,
+					pitch,
+					rmask,
+					gmask,
+					bmask,
+					amask );
+
+  if( d_surface == NULL )
+  {
+    SurfacePixelPool::deallocate( d_pixels );
+
+    d_pixels = NULL;
+  }
 
   TEST_FOR_EXCEPTION( d_surface == NULL,
 		      ExceptionType,
@@ -533,14 +841,52 @@ void Surface::initializeRGBSurface( const int width,
 		      "SDL_Error: " << SDL_GetError() );
 }
 
+// Copy the settings of a surface that has been converted
+/*! \details The settings are copied the same way that SDL_ConvertSurface
+ * copies them: the color and alpha modulation and the clip rectangle are
+ * copied. Blending is enabled if the new surface has an alpha channel
+ * (done when it is created) or if the alpha is modulated.
+ */
+void Surface::copyConversionSettings( const SDL_Surface& other_surface )
+{
+  SDL_Surface* other_raw_surface = const_cast<SDL_Surface*>( &other_surface );
+  
+  Uint8 red_mod, green_mod, blue_mod, alpha_mod;
+
+  SDL_GetSurfaceColorMod( other_raw_surface, &red_mod, &green_mod, &blue_mod );
+  SDL_GetSurfaceAlphaMod( other_raw_surface, &alpha_mod );
+
+  SDL_SetSurfaceColorMod( d_surface, red_mod, green_mod, blue_mod );
+  SDL_SetSurfaceAlphaMod( d_surface, alpha_mod );
+
+  if( alpha_mod != 255 )
+    SDL_SetSurfaceBlendMode( d_surface, SDL_BLENDMODE_BLEND );
+
+  SDL_SetClipRect( d_surface, &other_surface.clip_rect );
+}
+
 // Free the surface
+/*! \details Pixels from the surface pixel pool are returned to the pool
+ * (SDL does not free them).
+ */
 void Surface::free()
 {
   
   if( d_owns_surface )
     SDL_FreeSurface( d_surface );
 
+  SurfacePixelPool::deallocate( d_pixels );
+  
   d_surface = NULL;
+  d_pixels = NULL;
+
+  // The parent can only be released after the sub-surface has been freed
+  if( d_parent_surface )
+  {
+    --d_parent_surface->d_number_of_sub_surfaces;
+
+    d_parent_surface.reset();
+  }
 }
 
 } // end GDev namespace
@@ -12,6 +12,7 @@
 // Std Lib Includes
 #include <string>
 #include <stdexcept>
+#include <memory>
 
 // Boost Includes
 #include <boost/core/noncopyable.hpp>
@@ -23,6 +24,7 @@
 // GDev Includes
 #include "Font.hpp"
 #include "Shape.hpp"
+#include "SurfaceScaler.hpp"
 
 namespace GDev{
 
@@ -39,8 +41,11 @@ public:
 };
 
 /*! The surface wrapper class
- * \details The wrapper class does not allow copy construction or assignment.
- * If multiple "copies" are needed, use a smart pointer class.
+ * \details The wrapper class does not allow copy construction or assignment
+ * but surfaces can be moved (the ownership of the SDL surface is
+ * transferred). If multiple "copies" are needed, use a smart pointer class.
+ * The pixels of blank, shape and converted surfaces come from the surface
+ * pixel pool (every row is 64 byte aligned).
  */
 class Surface : private boost::noncopyable
 {
@@ -72,15 +77,34 @@ public:
   Surface( const Surface& other_surface,
 	   const Uint32 pixel_format );
 
+  //! Sub-surface constructor (will share the parent surface pixels)
+  Surface( const std::shared_ptr<Surface>& parent_surface,
+	   const SDL_Rect& area );
+
   //! Existing surface constructor (will not take ownership)
   Surface( SDL_Surface* existing_surface );
 
+  //! Move constructor
+  Surface( Surface&& other_surface );
+
+  //! Move assignment operator
+  Surface& operator=( Surface&& other_surface );
+
   //! Destructor
   ~Surface();
 
   //! Check if the surface has local ownership
   bool isLocallyOwned() const;
 
+  //! Check if the surface is a sub-surface (a view of a parent surface)
+  bool isSubSurface() const;
+
+  //! Get the number of live sub-surfaces (views of this surface)
+  unsigned getNumberOfSubSurfaces() const;
+
+  //! Get the parent surface of a sub-surface (NULL if not a sub-surface)
+  std::shared_ptr<const Surface> getParentSurface() const;
+
   //! Get the width of the surface
   int getWidth() const;
 
@@ -159,7 +183,9 @@ public:
   //! Perform a scaled surface copy to the destination surface
   void blitScaled( Surface& destination_surface,
 		   SDL_Rect* destination_rectangle = NULL,
-		   const SDL_Rect* source_rectangle = NULL ) const; 
+		   const SDL_Rect* source_rectangle = NULL,
+		   const SurfaceScaler::Filter filter =
+		   SurfaceScaler::NEAREST_FILTER ) const; 
 		   
   
   //! Perform a fast surface copy to the destination surface
@@ -175,7 +201,11 @@ private:
   // Initialize an RGB surface
   void initializeRGBSurface( const int width,
 			     const int height,
-			     const Uint32 pixel_format );
+			     const Uint32 pixel_format,
+			     const bool clear_pixels );
+
+  // Copy the settings of a surface that has been converted
+  void copyConversionSettings( const SDL_Surface& other_surface );
 
   // Free the surface
   void free();
@@ -186,8 +216,17 @@ private:
   // The SDL surface
   SDL_Surface* d_surface;
 
+  // The pixels from the surface pixel pool (NULL if SDL owns the pixels)
+  void* d_pixels;
+
   // Flag that indicates if the wrapper owns the surface
-  bool d_owns_surface;		    
+  bool d_owns_surface;
+
+  // The parent surface of a sub-surface (shares its pixels)
+  std::shared_ptr<Surface> d_parent_surface;
+
+  // The number of live sub-surfaces
+  unsigned d_number_of_sub_surfaces;
 };
 
 } // end GDev namespace
@@ -0,0 +1,753 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfaceBlitter.cpp
+//! \author Alex Robinson
+//! \brief  The surface blitter class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstring>
+#include <algorithm>
+
+// GDev Includes
+#include "SurfaceBlitter.hpp"
+#include "DBCMacros.hpp"
+
+// The SIMD kernels are only available with gcc compatible x86 compilers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GDEV_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace GDev{
+
+// Initialize static member data
+SurfaceBlitter::Kernel SurfaceBlitter::s_kernel =
+  SurfaceBlitter::getBestSupportedKernel();
+
+// Default constructor (opaque copy)
+SurfaceBlitter::Parameters::Parameters()
+  : blend_mode( SDL_BLENDMODE_NONE ),
+    red_mod( 255 ),
+    green_mod( 255 ),
+    blue_mod( 255 ),
+    alpha_mod( 255 ),
+    use_color_key( false ),
+    color_key( 0 )
+{ /* ... */ }
+
+// Check if the blit is an opaque copy
+/*! \details An opaque copy does not blend, modulate or color key the source
+ * pixels.
+ */
+bool SurfaceBlitter::Parameters::isOpaqueCopy() const
+{
+  return blend_mode == SDL_BLENDMODE_NONE &&
+    !use_color_key &&
+    red_mod == 255 &&
+    green_mod == 255 &&
+    blue_mod == 255 &&
+    alpha_mod == 255;
+}
+
+// Check if a kernel is supported by the CPU
+bool SurfaceBlitter::isKernelSupported( const Kernel kernel )
+{
+  switch( kernel )
+  {
+  case SCALAR_KERNEL:
+    return true;
+#ifdef GDEV_X86_SIMD_KERNELS
+  case SSE2_KERNEL:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "sse2" );
+  case AVX2_KERNEL:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" );
+#endif
+  default:
+    return false;
+  }
+}
+
+// Get the best kernel that is supported by the CPU
+SurfaceBlitter::Kernel SurfaceBlitter::getBestSupportedKernel()
+{
+  if( SurfaceBlitter::isKernelSupported( AVX2_KERNEL ) )
+    return AVX2_KERNEL;
+  else if( SurfaceBlitter::isKernelSupported( SSE2_KERNEL ) )
+    return SSE2_KERNEL;
+  else
+    return SCALAR_KERNEL;
+}
+
+// Get the kernel that is used for blits
+SurfaceBlitter::Kernel SurfaceBlitter::getKernel()
+{
+  return s_kernel;
+}
+
+// Set the kernel that is used for blits
+/*! \details This is mostly useful for testing and benchmarking the kernels.
+ */
+void SurfaceBlitter::setKernel( const Kernel kernel )
+{
+  // Make sure the kernel is supported
+  testPrecondition( SurfaceBlitter::isKernelSupported( kernel ) );
+
+  s_kernel = kernel;
+}
+
+// Get the name of a kernel
+const char* SurfaceBlitter::getKernelName( const Kernel kernel )
+{
+  switch( kernel )
+  {
+  case SCALAR_KERNEL: return "scalar";
+  case SSE2_KERNEL: return "sse2";
+  case AVX2_KERNEL: return "avx2";
+  default: return "unknown";
+  }
+}
+
+// Check if a blit between the surfaces can be done
+bool SurfaceBlitter::canBlit( const SDL_Surface& source_surface,
+			      const SDL_Surface& destination_surface )
+{
+  if( &source_surface == &destination_surface )
+    return false;
+
+  if( source_surface.format->format != SDL_PIXELFORMAT_ARGB8888 ||
+      destination_surface.format->format != SDL_PIXELFORMAT_ARGB8888 )
+    return false;
+
+  // RLE accelerated surfaces must be locked to access the pixels
+  if( SDL_MUSTLOCK( &source_surface ) || SDL_MUSTLOCK( &destination_surface ) )
+    return false;
+
+  SDL_BlendMode blend_mode;
+
+  SDL_GetSurfaceBlendMode( const_cast<SDL_Surface*>( &source_surface ),
+			   &blend_mode );
+
+  switch( blend_mode )
+  {
+  case SDL_BLENDMODE_NONE:
+  case SDL_BLENDMODE_BLEND:
+  case SDL_BLENDMODE_ADD:
+  case SDL_BLENDMODE_MOD:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Get the blit parameters of a source surface
+SurfaceBlitter::Parameters
+SurfaceBlitter::getParameters( const SDL_Surface& source_surface )
+{
+  SDL_Surface* surface = const_cast<SDL_Surface*>( &source_surface );
+
+  Parameters parameters;
+
+  SDL_GetSurfaceBlendMode( surface, &parameters.blend_mode );
+
+  SDL_GetSurfaceColorMod( surface,
+			  &parameters.red_mod,
+			  &parameters.green_mod,
+			  &parameters.blue_mod );
+
+  SDL_GetSurfaceAlphaMod( surface, &parameters.alpha_mod );
+
+  // SDL_GetColorKey will fail if the color key is not set
+  parameters.use_color_key =
+    (SDL_GetColorKey( surface, &parameters.color_key ) == 0);
+
+  parameters.color_key &= 0x00FFFFFF;
+
+  return parameters;
+}
+
+// Clip the blit rectangles (same rules as SDL_BlitSurface)
+/*! \details The source rectangle is clipped to the source surface and the
+ * destination rectangle is clipped to the clip rectangle of the destination
+ * surface. The width and height of the destination rectangle are ignored
+ * and set to the size of the clipped blit (zero if nothing will be
+ * blitted). A NULL source rectangle refers to the entire source surface.
+ */
+bool SurfaceBlitter::clipRectangles( const SDL_Surface& source_surface,
+				     const SDL_Rect* source_rectangle,
+				     const SDL_Surface& destination_surface,
+				     SDL_Rect& destination_rectangle,
+				     SDL_Rect& clipped_source_rectangle )
+{
+  int source_x = 0, source_y = 0;
+  int width = source_surface.w, height = source_surface.h;
+
+  // Clip the source rectangle to the source surface
+  if( source_rectangle )
+  {
+    source_x = source_rectangle->x;
+    width = source_rectangle->w;
+
+    if( source_x < 0 )
+    {
+      width += source_x;
+      destination_rectangle.x -= source_x;
+      source_x = 0;
+    }
+
+    if( width > source_surface.w - source_x )
+      width = source_surface.w - source_x;
+
+    source_y = source_rectangle->y;
+    height = source_rectangle->h;
+
+    if( source_y < 0 )
+    {
+      height += source_y;
+      destination_rectangle.y -= source_y;
+      source_y = 0;
+    }
+
+    if( height > source_surface.h - source_y )
+      height = source_surface.h - source_y;
+  }
+
+  // Clip the destination rectangle to the destination clip rectangle
+  const SDL_Rect& clip = destination_surface.clip_rect;
+
+  int delta = clip.x - destination_rectangle.x;
+
+  if( delta > 0 )
+  {
+    width -= delta;
+    destination_rectangle.x += delta;
+    source_x += delta;
+  }
+
+  delta = destination_rectangle.x + width - clip.x - clip.w;
+
+  if( delta > 0 )
+    width -= delta;
+
+  delta = clip.y - destination_rectangle.y;
+
+  if( delta > 0 )
+  {
+    height -= delta;
+    destination_rectangle.y += delta;
+    source_y += delta;
+  }
+
+  delta = destination_rectangle.y + height - clip.y - clip.h;
+
+  if( delta > 0 )
+    height -= delta;
+
+  if( width > 0 && height > 0 )
+  {
+    clipped_source_rectangle.x = source_x;
+    clipped_source_rectangle.y = source_y;
+    clipped_source_rectangle.w = width;
+    clipped_source_rectangle.h = height;
+
+    destination_rectangle.w = width;
+    destination_rectangle.h = height;
+
+    return true;
+  }
+  else
+  {
+    destination_rectangle.w = 0;
+    destination_rectangle.h = 0;
+
+    return false;
+  }
+}
+
+// Blit a clipped source rectangle to a clipped destination rectangle
+void SurfaceBlitter::blit( const SDL_Surface& source_surface,
+			   const SDL_Rect& source_rectangle,
+			   SDL_Surface& destination_surface,
+			   const SDL_Rect& destination_rectangle )
+{
+  // Make sure the surfaces can be blitted
+  testPrecondition( SurfaceBlitter::canBlit( source_surface,
+					     destination_surface ) );
+  // Make sure the rectangles are valid
+  testPrecondition( source_rectangle.w == destination_rectangle.w );
+  testPrecondition( source_rectangle.h == destination_rectangle.h );
+  testPrecondition( source_rectangle.x >= 0 );
+  testPrecondition( source_rectangle.y >= 0 );
+  testPrecondition( source_rectangle.x + source_rectangle.w <=
+		    source_surface.w );
+  testPrecondition( source_rectangle.y + source_rectangle.h <=
+		    source_surface.h );
+  testPrecondition( destination_rectangle.x >= 0 );
+  testPrecondition( destination_rectangle.y >= 0 );
+  testPrecondition( destination_rectangle.x + destination_rectangle.w <=
+		    destination_surface.w );
+  testPrecondition( destination_rectangle.y + destination_rectangle.h <=
+		    destination_surface.h );
+
+  const Parameters parameters =
+    SurfaceBlitter::getParameters( source_surface );
+
+  const Uint8* source_pixels =
+    static_cast<const Uint8*>( source_surface.pixels ) +
+    source_rectangle.y*source_surface.pitch + source_rectangle.x*4;
+
+  Uint8* destination_pixels =
+    static_cast<Uint8*>( destination_surface.pixels ) +
+    destination_rectangle.y*destination_surface.pitch +
+    destination_rectangle.x*4;
+
+  for( int row = 0; row < source_rectangle.h; ++row )
+  {
+    SurfaceBlitter::blitRow(
+		       reinterpret_cast<const Uint32*>( source_pixels ),
+		       reinterpret_cast<Uint32*>( destination_pixels ),
+		       source_rectangle.w,
+		       parameters );
+
+    source_pixels += source_surface.pitch;
+    destination_pixels += destination_surface.pitch;
+  }
+}
+
+// Blit a row of ARGB8888 pixels
+/*! \details Opaque copies (no blending, modulation or color key) are done
+ * with memcpy. All other blits are done with the selected kernel.
+ */
+void SurfaceBlitter::blitRow( const Uint32* source_row,
+			      Uint32* destination_row,
+			      const int width,
+			      const Parameters& parameters )
+{
+  if( parameters.isOpaqueCopy() )
+  {
+    memcpy( destination_row, source_row, width*sizeof(Uint32) );
+
+    return;
+  }
+
+  switch( s_kernel )
+  {
+  case AVX2_KERNEL:
+    SurfaceBlitter::blitRowAVX2( source_row,
+				 destination_row,
+				 width,
+				 parameters );
+    break;
+  case SSE2_KERNEL:
+    SurfaceBlitter::blitRowSSE2( source_row,
+				 destination_row,
+				 width,
+				 parameters );
+    break;
+  default:
+    SurfaceBlitter::blitRowScalar( source_row,
+				   destination_row,
+				   width,
+				   parameters );
+  }
+}
+
+// Blit a row of pixels with the scalar kernel
+/*! \details The blend equations are the ones used by SDL's reference
+ * blitter (SDL_Blit_Slow). All divisions by 255 are truncated.
+ */
+void SurfaceBlitter::blitRowScalar( const Uint32* source_row,
+				    Uint32* destination_row,
+				    const int width,
+				    const Parameters& parameters )
+{
+  for( int i = 0; i < width; ++i )
+  {
+    const Uint32 source_pixel = source_row[i];
+
+    if( parameters.use_color_key &&
+	(source_pixel & 0x00FFFFFF) == parameters.color_key )
+      continue;
+
+    Uint32 source_a = source_pixel >> 24;
+    Uint32 source_r = (source_pixel >> 16) & 0xFF;
+    Uint32 source_g = (source_pixel >> 8) & 0xFF;
+    Uint32 source_b = source_pixel & 0xFF;
+
+    // Apply the color and alpha modulation
+    source_r = source_r*parameters.red_mod/255;
+    source_g = source_g*parameters.green_mod/255;
+    source_b = source_b*parameters.blue_mod/255;
+    source_a = source_a*parameters.alpha_mod/255;
+
+    // Premultiply the source color by the source alpha
+    if( parameters.blend_mode == SDL_BLENDMODE_BLEND ||
+	parameters.blend_mode == SDL_BLENDMODE_ADD )
+    {
+      source_r = source_r*source_a/255;
+      source_g = source_g*source_a/255;
+      source_b = source_b*source_a/255;
+    }
+
+    const Uint32 destination_pixel = destination_row[i];
+
+    Uint32 destination_a = destination_pixel >> 24;
+    Uint32 destination_r = (destination_pixel >> 16) & 0xFF;
+    Uint32 destination_g = (destination_pixel >> 8) & 0xFF;
+    Uint32 destination_b = destination_pixel & 0xFF;
+
+    switch( parameters.blend_mode )
+    {
+    case SDL_BLENDMODE_BLEND:
+      destination_r = source_r + (255 - source_a)*destination_r/255;
+      destination_g = source_g + (255 - source_a)*destination_g/255;
+      destination_b = source_b + (255 - source_a)*destination_b/255;
+      destination_a = source_a + (255 - source_a)*destination_a/255;
+      break;
+    case SDL_BLENDMODE_ADD:
+      destination_r = std::min( source_r + destination_r, 255u );
+      destination_g = std::min( source_g + destination_g, 255u );
+      destination_b = std::min( source_b + destination_b, 255u );
+      break;
+    case SDL_BLENDMODE_MOD:
+      destination_r = source_r*destination_r/255;
+      destination_g = source_g*destination_g/255;
+      destination_b = source_b*destination_b/255;
+      break;
+    default:
+      destination_r = source_r;
+      destination_g = source_g;
+      destination_b = source_b;
+      destination_a = source_a;
+    }
+
+    destination_row[i] = (destination_a << 24) | (destination_r << 16) |
+      (destination_g << 8) | destination_b;
+  }
+}
+
+#ifdef GDEV_X86_SIMD_KERNELS
+
+// Blit a row of pixels with the SSE2 kernel
+/*! \details Four pixels are processed at a time. The channels are widened
+ * to 16 bits so that the products of two channels can be stored. The
+ * truncated division by 255 is done exactly with (t + (t >> 8)) >> 8, where
+ * t = x + 1. The remaining pixels are blitted with the scalar kernel.
+ */
+__attribute__((target("sse2")))
+void SurfaceBlitter::blitRowSSE2( const Uint32* source_row,
+				  Uint32* destination_row,
+				  const int width,
+				  const Parameters& parameters )
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16( 1 );
+  const __m128i max_channel = _mm_set1_epi16( 255 );
+
+  // The 16 bit channel lanes are ordered b, g, r, a
+  const __m128i modulation = _mm_set1_epi64x(
+				     (long long)parameters.blue_mod |
+				     (long long)parameters.green_mod << 16 |
+				     (long long)parameters.red_mod << 32 |
+				     (long long)parameters.alpha_mod << 48 );
+  const __m128i alpha_lanes = _mm_set1_epi64x( 0x00FF000000000000LL );
+  const __m128i color_lanes = _mm_set1_epi64x( 0x0000FFFFFFFFFFFFLL );
+
+  const __m128i alpha_mask = _mm_set1_epi32( 0xFF000000 );
+  const __m128i color_mask = _mm_set1_epi32( 0x00FFFFFF );
+  const __m128i color_key = _mm_set1_epi32( parameters.color_key );
+
+  const bool modulate = parameters.red_mod != 255 ||
+    parameters.green_mod != 255 ||
+    parameters.blue_mod != 255 ||
+    parameters.alpha_mod != 255;
+
+  const bool premultiply = parameters.blend_mode == SDL_BLENDMODE_BLEND ||
+    parameters.blend_mode == SDL_BLENDMODE_ADD;
+
+#define GDEV_DIV255_SSE2( x ) \
+  _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, one ),		\
+				 _mm_srli_epi16( _mm_add_epi16( x, one ), 8 ) ), 8 )
+
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i source =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( source_row + i ) );
+    const __m128i destination =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( destination_row+i ));
+
+    __m128i source_lo = _mm_unpacklo_epi8( source, zero );
+    __m128i source_hi = _mm_unpackhi_epi8( source, zero );
+
+    // Apply the color and alpha modulation
+    if( modulate )
+    {
+      source_lo = GDEV_DIV255_SSE2( _mm_mullo_epi16( source_lo, modulation ) );
+      source_hi = GDEV_DIV255_SSE2( _mm_mullo_epi16( source_hi, modulation ) );
+    }
+
+    // Broadcast the source alpha to every lane
+    const __m128i alpha_lo = _mm_shufflehi_epi16(
+			  _mm_shufflelo_epi16( source_lo, 0xFF ), 0xFF );
+    const __m128i alpha_hi = _mm_shufflehi_epi16(
+			  _mm_shufflelo_epi16( source_hi, 0xFF ), 0xFF );
+
+    // Premultiply the source color by the source alpha
+    if( premultiply )
+    {
+      source_lo = GDEV_DIV255_SSE2( _mm_mullo_epi16(
+	     source_lo,
+	     _mm_or_si128( _mm_and_si128( alpha_lo, color_lanes ), alpha_lanes ) ) );
+      source_hi = GDEV_DIV255_SSE2( _mm_mullo_epi16(
+	     source_hi,
+	     _mm_or_si128( _mm_and_si128( alpha_hi, color_lanes ), alpha_lanes ) ) );
+    }
+
+    __m128i result;
+
+    switch( parameters.blend_mode )
+    {
+    case SDL_BLENDMODE_BLEND:
+    {
+      const __m128i destination_lo = _mm_unpacklo_epi8( destination, zero );
+      const __m128i destination_hi = _mm_unpackhi_epi8( destination, zero );
+
+      const __m128i blend_lo = _mm_add_epi16( source_lo, GDEV_DIV255_SSE2(
+		        _mm_mullo_epi16( destination_lo,
+				  _mm_sub_epi16( max_channel, alpha_lo ) ) ) );
+      const __m128i blend_hi = _mm_add_epi16( source_hi, GDEV_DIV255_SSE2(
+		        _mm_mullo_epi16( destination_hi,
+				  _mm_sub_epi16( max_channel, alpha_hi ) ) ) );
+
+      result = _mm_packus_epi16( blend_lo, blend_hi );
+      break;
+    }
+    case SDL_BLENDMODE_ADD:
+      result = _mm_adds_epu8( _mm_packus_epi16( source_lo, source_hi ),
+			      destination );
+      result = _mm_or_si128( _mm_and_si128( result, color_mask ),
+			     _mm_and_si128( destination, alpha_mask ) );
+      break;
+    case SDL_BLENDMODE_MOD:
+    {
+      const __m128i destination_lo = _mm_unpacklo_epi8( destination, zero );
+      const __m128i destination_hi = _mm_unpackhi_epi8( destination, zero );
+
+      result = _mm_packus_epi16(
+	 GDEV_DIV255_SSE2( _mm_mullo_epi16( source_lo, destination_lo ) ),
+	 GDEV_DIV255_SSE2( _mm_mullo_epi16( source_hi, destination_hi ) ) );
+      result = _mm_or_si128( _mm_and_si128( result, color_mask ),
+			     _mm_and_si128( destination, alpha_mask ) );
+      break;
+    }
+    default:
+      result = _mm_packus_epi16( source_lo, source_hi );
+    }
+
+    // Keep the destination pixels where the source matches the color key
+    if( parameters.use_color_key )
+    {
+      const __m128i keyed =
+	_mm_cmpeq_epi32( _mm_and_si128( source, color_mask ), color_key );
+
+      result = _mm_or_si128( _mm_and_si128( keyed, destination ),
+			     _mm_andnot_si128( keyed, result ) );
+    }
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( destination_row + i ),
+		      result );
+  }
+
+#undef GDEV_DIV255_SSE2
+
+  SurfaceBlitter::blitRowScalar( source_row + i,
+				 destination_row + i,
+				 width - i,
+				 parameters );
+}
+
+// Blit a row of pixels with the AVX2 kernel
+/*! \details Eight pixels are processed at a time. This is the 256 bit
+ * version of the SSE2 kernel (the unpack and pack instructions work on each
+ * 128 bit half independently, so the pixel order is preserved).
+ */
+__attribute__((target("avx2")))
+void SurfaceBlitter::blitRowAVX2( const Uint32* source_row,
+				  Uint32* destination_row,
+				  const int width,
+				  const Parameters& parameters )
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi16( 1 );
+  const __m256i max_channel = _mm256_set1_epi16( 255 );
+
+  // The 16 bit channel lanes are ordered b, g, r, a
+  const __m256i modulation = _mm256_set1_epi64x(
+				     (long long)parameters.blue_mod |
+				     (long long)parameters.green_mod << 16 |
+				     (long long)parameters.red_mod << 32 |
+				     (long long)parameters.alpha_mod << 48 );
+  const __m256i alpha_lanes = _mm256_set1_epi64x( 0x00FF000000000000LL );
+  const __m256i color_lanes = _mm256_set1_epi64x( 0x0000FFFFFFFFFFFFLL );
+
+  const __m256i alpha_mask = _mm256_set1_epi32( 0xFF000000 );
+  const __m256i color_mask = _mm256_set1_epi32( 0x00FFFFFF );
+  const __m256i color_key = _mm256_set1_epi32( parameters.color_key );
+
+  const bool modulate = parameters.red_mod != 255 ||
+    parameters.green_mod != 255 ||
+    parameters.blue_mod != 255 ||
+    parameters.alpha_mod != 255;
+
+  const bool premultiply = parameters.blend_mode == SDL_BLENDMODE_BLEND ||
+    parameters.blend_mode == SDL_BLENDMODE_ADD;
+
+#define GDEV_DIV255_AVX2( x ) \
+  _mm256_srli_epi16( _mm256_add_epi16( _mm256_add_epi16( x, one ),	\
+			     _mm256_srli_epi16( _mm256_add_epi16( x, one ), 8 ) ), 8 )
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i source = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>( source_row + i ) );
+    const __m256i destination = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>( destination_row + i ) );
+
+    __m256i source_lo = _mm256_unpacklo_epi8( source, zero );
+    __m256i source_hi = _mm256_unpackhi_epi8( source, zero );
+
+    // Apply the color and alpha modulation
+    if( modulate )
+    {
+      source_lo =
+	GDEV_DIV255_AVX2( _mm256_mullo_epi16( source_lo, modulation ) );
+      source_hi =
+	GDEV_DIV255_AVX2( _mm256_mullo_epi16( source_hi, modulation ) );
+    }
+
+    // Broadcast the source alpha to every lane
+    const __m256i alpha_lo = _mm256_shufflehi_epi16(
+			  _mm256_shufflelo_epi16( source_lo, 0xFF ), 0xFF );
+    const __m256i alpha_hi = _mm256_shufflehi_epi16(
+			  _mm256_shufflelo_epi16( source_hi, 0xFF ), 0xFF );
+
+    // Premultiply the source color by the source alpha
+    if( premultiply )
+    {
+      source_lo = GDEV_DIV255_AVX2( _mm256_mullo_epi16(
+	  source_lo,
+	  _mm256_or_si256( _mm256_and_si256( alpha_lo, color_lanes ),
+			   alpha_lanes ) ) );
+      source_hi = GDEV_DIV255_AVX2( _mm256_mullo_epi16(
+	  source_hi,
+	  _mm256_or_si256( _mm256_and_si256( alpha_hi, color_lanes ),
+			   alpha_lanes ) ) );
+    }
+
+    __m256i result;
+
+    switch( parameters.blend_mode )
+    {
+    case SDL_BLENDMODE_BLEND:
+    {
+      const __m256i destination_lo =
+	_mm256_unpacklo_epi8( destination, zero );
+      const __m256i destination_hi =
+	_mm256_unpackhi_epi8( destination, zero );
+
+      const __m256i blend_lo = _mm256_add_epi16( source_lo, GDEV_DIV255_AVX2(
+		    _mm256_mullo_epi16( destination_lo,
+			       _mm256_sub_epi16( max_channel, alpha_lo ) ) ) );
+      const __m256i blend_hi = _mm256_add_epi16( source_hi, GDEV_DIV255_AVX2(
+		    _mm256_mullo_epi16( destination_hi,
+			       _mm256_sub_epi16( max_channel, alpha_hi ) ) ) );
+
+      result = _mm256_packus_epi16( blend_lo, blend_hi );
+      break;
+    }
+    case SDL_BLENDMODE_ADD:
+      result = _mm256_adds_epu8( _mm256_packus_epi16( source_lo, source_hi ),
+				 destination );
+      result = _mm256_or_si256( _mm256_and_si256( result, color_mask ),
+				_mm256_and_si256( destination, alpha_mask ) );
+      break;
+    case SDL_BLENDMODE_MOD:
+    {
+      const __m256i destination_lo =
+	_mm256_unpacklo_epi8( destination, zero );
+      const __m256i destination_hi =
+	_mm256_unpackhi_epi8( destination, zero );
+
+      result = _mm256_packus_epi16(
+	 GDEV_DIV255_AVX2( _mm256_mullo_epi16( source_lo, destination_lo ) ),
+	 GDEV_DIV255_AVX2( _mm256_mullo_epi16( source_hi, destination_hi ) ) );
+      result = _mm256_or_si256( _mm256_and_si256( result, color_mask ),
+				_mm256_and_si256( destination, alpha_mask ) );
+      break;
+    }
+    default:
+      result = _mm256_packus_epi16( source_lo, source_hi );
+    }
+
+    // Keep the destination pixels where the source matches the color key
+    if( parameters.use_color_key )
+    {
+      const __m256i keyed = _mm256_cmpeq_epi32(
+			 _mm256_and_si256( source, color_mask ), color_key );
+
+      result = _mm256_or_si256( _mm256_and_si256( keyed, destination ),
+				_mm256_andnot_si256( keyed, result ) );
+    }
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( destination_row + i ),
+			 result );
+  }
+
+#undef GDEV_DIV255_AVX2
+
+  SurfaceBlitter::blitRowScalar( source_row + i,
+				 destination_row + i,
+				 width - i,
+				 parameters );
+}
+
+#else // GDEV_X86_SIMD_KERNELS
+
+// Blit a row of pixels with the SSE2 kernel (not available)
+void SurfaceBlitter::blitRowSSE2( const Uint32* source_row,
+				  Uint32* destination_row,
+				  const int width,
+				  const Parameters& parameters )
+{
+  SurfaceBlitter::blitRowScalar( source_row,
+				 destination_row,
+				 width,
+				 parameters );
+}
+
+// Blit a row of pixels with the AVX2 kernel (not available)
+void SurfaceBlitter::blitRowAVX2( const Uint32* source_row,
+				  Uint32* destination_row,
+				  const int width,
+				  const Parameters& parameters )
+{
+  SurfaceBlitter::blitRowScalar( source_row,
+				 destination_row,
+				 width,
+				 parameters );
+}
+
+#endif // end GDEV_X86_SIMD_KERNELS
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end SurfaceBlitter.cpp
+//---------------------------------------------------------------------------//
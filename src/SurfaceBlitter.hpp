@@ -0,0 +1,135 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfaceBlitter.hpp
+//! \author Alex Robinson
+//! \brief  The surface blitter class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SURFACE_BLITTER_HPP
+#define GDEV_SURFACE_BLITTER_HPP
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "SimdKernel.hpp"
+
+namespace GDev{
+
+/*! The surface blitter class
+ * \details The surface blitter performs unscaled blits between ARGB8888
+ * surfaces without going through the generic SDL blitters. The blend modes
+ * (none, blend, add and mod), the color and alpha modulation and the color
+ * key of the source surface are all supported. The results are identical to
+ * the ones produced by SDL's reference (slow) blitter. A scalar, an SSE2 and
+ * an AVX2 kernel are available. The best kernel that is supported by the
+ * CPU is selected at start up. Surfaces with other pixel formats (or
+ * surfaces that must be locked) cannot be blitted by this class - use
+ * SDL_BlitSurface instead (see Surface::blitSurface).
+ */
+class SurfaceBlitter
+{
+
+public:
+
+  //! The kernel type
+  typedef SimdKernel Kernel;
+
+  //! The blit parameters (taken from the source surface)
+  struct Parameters
+  {
+    //! Default constructor (opaque copy)
+    Parameters();
+
+    //! Check if the blit is an opaque copy
+    bool isOpaqueCopy() const;
+
+    //! The blend mode
+    SDL_BlendMode blend_mode;
+
+    //! The color modulation
+    Uint8 red_mod, green_mod, blue_mod;
+
+    //! The alpha modulation
+    Uint8 alpha_mod;
+
+    //! Flag that indicates if the color key is used
+    bool use_color_key;
+
+    //! The color key (only the rgb bits are compared)
+    Uint32 color_key;
+  };
+
+  //! Check if a kernel is supported by the CPU
+  static bool isKernelSupported( const Kernel kernel );
+
+  //! Get the best kernel that is supported by the CPU
+  static Kernel getBestSupportedKernel();
+
+  //! Get the kernel that is used for blits
+  static Kernel getKernel();
+
+  //! Set the kernel that is used for blits
+  static void setKernel( const Kernel kernel );
+
+  //! Get the name of a kernel
+  static const char* getKernelName( const Kernel kernel );
+
+  //! Check if a blit between the surfaces can be done
+  static bool canBlit( const SDL_Surface& source_surface,
+		       const SDL_Surface& destination_surface );
+
+  //! Get the blit parameters of a source surface
+  static Parameters getParameters( const SDL_Surface& source_surface );
+
+  //! Clip the blit rectangles (same rules as SDL_BlitSurface)
+  static bool clipRectangles( const SDL_Surface& source_surface,
+			      const SDL_Rect* source_rectangle,
+			      const SDL_Surface& destination_surface,
+			      SDL_Rect& destination_rectangle,
+			      SDL_Rect& clipped_source_rectangle );
+
+  //! Blit a clipped source rectangle to a clipped destination rectangle
+  static void blit( const SDL_Surface& source_surface,
+		    const SDL_Rect& source_rectangle,
+		    SDL_Surface& destination_surface,
+		    const SDL_Rect& destination_rectangle );
+
+  //! Blit a row of ARGB8888 pixels
+  static void blitRow( const Uint32* source_row,
+		       Uint32* destination_row,
+		       const int width,
+		       const Parameters& parameters );
+
+private:
+
+  // Blit a row of pixels with the scalar kernel
+  static void blitRowScalar( const Uint32* source_row,
+			     Uint32* destination_row,
+			     const int width,
+			     const Parameters& parameters );
+
+  // Blit a row of pixels with the SSE2 kernel
+  static void blitRowSSE2( const Uint32* source_row,
+			   Uint32* destination_row,
+			   const int width,
+			   const Parameters& parameters );
+
+  // Blit a row of pixels with the AVX2 kernel
+  static void blitRowAVX2( const Uint32* source_row,
+			   Uint32* destination_row,
+			   const int width,
+			   const Parameters& parameters );
+
+  // The kernel that is used for blits
+  static Kernel s_kernel;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SURFACE_BLITTER_HPP
+
+//---------------------------------------------------------------------------//
+// end SurfaceBlitter.hpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,319 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfacePixelPool.cpp
+//! \author Alex Robinson
+//! \brief  The surface pixel pool class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <cstdlib>
+#include <new>
+
+// GDev Includes
+#include "SurfacePixelPool.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const size_t SurfacePixelPool::s_alignment = 64;
+
+const size_t SurfacePixelPool::s_min_size_class = 4096;
+
+// Get the alignment of the buffers (and surface rows) in bytes
+size_t SurfacePixelPool::getAlignment()
+{
+  return s_alignment;
+}
+
+// Get the length of an aligned row of pixels in bytes (pitch)
+int SurfacePixelPool::getAlignedPitch( const int width,
+				       const int bits_per_pixel )
+{
+  // Make sure the width is valid
+  testPrecondition( width > 0 );
+  // Make sure the bits per pixel are valid
+  testPrecondition( bits_per_pixel > 0 );
+
+  const int row_size = (width*bits_per_pixel + 7)/8;
+
+  return (row_size + (int)s_alignment - 1) & ~((int)s_alignment - 1);
+}
+
+// Allocate a buffer
+/*! \details The buffer will start on an aligned boundary. A buffer from the
+ * free list of the size class will be reused if there is one (the contents
+ * of a reused buffer are undefined). A std::bad_alloc exception will be
+ * thrown if memory cannot be allocated.
+ */
+void* SurfacePixelPool::allocate( const size_t size )
+{
+  // Make sure the size is valid
+  testPrecondition( size > 0 );
+
+  const size_t size_class = SurfacePixelPool::getSizeClass( size );
+
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  {
+    std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+    ++pool.number_of_allocations;
+    pool.number_of_bytes_in_use += size_class;
+
+    std::map<size_t,std::vector<void*> >::iterator free_list =
+      pool.free_buffers.find( size_class );
+
+    if( free_list != pool.free_buffers.end() && !free_list->second.empty() )
+    {
+      void* buffer = free_list->second.back();
+
+      free_list->second.pop_back();
+
+      ++pool.number_of_recycled_allocations;
+      pool.number_of_free_bytes -= size_class;
+      --pool.number_of_free_buffers;
+
+      return buffer;
+    }
+  }
+
+  // The system allocator is called without holding the pool lock
+  try{
+    return SurfacePixelPool::allocateNewBuffer( size_class );
+  }
+  catch( const std::bad_alloc& )
+  {
+    std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+    --pool.number_of_allocations;
+    pool.number_of_bytes_in_use -= size_class;
+
+    throw;
+  }
+}
+
+// Return a buffer to the pool
+/*! \details The buffer will be kept in the free list of its size class
+ * unless the free lists are full (the buffer will be freed). Null buffers
+ * are ignored.
+ */
+void SurfacePixelPool::deallocate( void* buffer )
+{
+  if( buffer == NULL )
+    return;
+
+  const size_t size_class = SurfacePixelPool::getHeader( buffer ).size;
+
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  {
+    std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+    pool.number_of_bytes_in_use -= size_class;
+
+    if( pool.number_of_free_bytes + size_class <=
+	pool.max_number_of_free_bytes )
+    {
+      pool.free_buffers[size_class].push_back( buffer );
+
+      pool.number_of_free_bytes += size_class;
+      ++pool.number_of_free_buffers;
+
+      return;
+    }
+  }
+
+  SurfacePixelPool::freeBuffer( buffer );
+}
+
+// Get the max number of bytes that are kept in the free lists
+size_t SurfacePixelPool::getMaxNumberOfFreeBytes()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.max_number_of_free_bytes;
+}
+
+// Set the max number of bytes that are kept in the free lists
+/*! \details The free lists will not be trimmed (see releaseFreeBuffers).
+ * A max of zero disables the recycling of buffers.
+ */
+void SurfacePixelPool::setMaxNumberOfFreeBytes(
+					     const size_t max_number_of_bytes )
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  pool.max_number_of_free_bytes = max_number_of_bytes;
+}
+
+// Release the buffers in the free lists
+void SurfacePixelPool::releaseFreeBuffers()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::map<size_t,std::vector<void*> > free_buffers;
+
+  {
+    std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+    free_buffers.swap( pool.free_buffers );
+
+    pool.number_of_free_bytes = 0;
+    pool.number_of_free_buffers = 0;
+  }
+
+  std::map<size_t,std::vector<void*> >::iterator free_list =
+    free_buffers.begin();
+
+  while( free_list != free_buffers.end() )
+  {
+    for( unsigned i = 0; i < free_list->second.size(); ++i )
+      SurfacePixelPool::freeBuffer( free_list->second[i] );
+
+    ++free_list;
+  }
+}
+
+// Get the number of allocations
+unsigned long SurfacePixelPool::getNumberOfAllocations()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.number_of_allocations;
+}
+
+// Get the number of allocations that were served from the free lists
+unsigned long SurfacePixelPool::getNumberOfRecycledAllocations()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.number_of_recycled_allocations;
+}
+
+// Get the number of bytes in buffers that are in use
+/*! \details The size class of each buffer is counted (not the requested
+ * size).
+ */
+size_t SurfacePixelPool::getNumberOfBytesInUse()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.number_of_bytes_in_use;
+}
+
+// Get the number of bytes in the free lists
+size_t SurfacePixelPool::getNumberOfFreeBytes()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.number_of_free_bytes;
+}
+
+// Get the number of buffers in the free lists
+unsigned SurfacePixelPool::getNumberOfFreeBuffers()
+{
+  PoolData& pool = SurfacePixelPool::getPoolData();
+
+  std::lock_guard<std::mutex> pool_lock( pool.mutex );
+
+  return pool.number_of_free_buffers;
+}
+
+// Get the pool data
+/*! \details The pool data is never destroyed because surfaces that are
+ * owned by static objects can be freed after the static objects of this
+ * file have been destroyed. By default 64 MB are kept in the free lists.
+ */
+SurfacePixelPool::PoolData& SurfacePixelPool::getPoolData()
+{
+  static PoolData* pool_data = NULL;
+  static std::once_flag pool_data_flag;
+
+  std::call_once( pool_data_flag, [](){
+      pool_data = new PoolData;
+
+      pool_data->max_number_of_free_bytes = 64*1024*1024;
+      pool_data->number_of_allocations = 0ul;
+      pool_data->number_of_recycled_allocations = 0ul;
+      pool_data->number_of_bytes_in_use = 0;
+      pool_data->number_of_free_bytes = 0;
+      pool_data->number_of_free_buffers = 0u; } );
+
+  return *pool_data;
+}
+
+// Get the size class of a request
+/*! \details Sizes in (2^k, 2^(k+1)] are rounded up to a multiple of 2^(k-2)
+ * so that no more than a quarter of a buffer is wasted.
+ */
+size_t SurfacePixelPool::getSizeClass( const size_t size )
+{
+  if( size <= s_min_size_class )
+    return s_min_size_class;
+
+  size_t power_of_two = s_min_size_class;
+
+  while( power_of_two*2 < size )
+    power_of_two *= 2;
+
+  const size_t step = power_of_two/4;
+
+  return ((size + step - 1)/step)*step;
+}
+
+// Get the header of a buffer
+SurfacePixelPool::BufferHeader& SurfacePixelPool::getHeader( void* buffer )
+{
+  return *(reinterpret_cast<BufferHeader*>( buffer ) - 1);
+}
+
+// Allocate a new buffer from the system allocator
+/*! \details The header is stored right in front of the aligned buffer.
+ */
+void* SurfacePixelPool::allocateNewBuffer( const size_t size )
+{
+  void* raw_memory =
+    std::malloc( size + sizeof(BufferHeader) + s_alignment - 1 );
+
+  if( raw_memory == NULL )
+    throw std::bad_alloc();
+
+  const size_t address = reinterpret_cast<size_t>( raw_memory ) +
+    sizeof(BufferHeader);
+
+  void* buffer = reinterpret_cast<void*>(
+			     (address + s_alignment - 1) & ~(s_alignment - 1) );
+
+  BufferHeader& header = SurfacePixelPool::getHeader( buffer );
+
+  header.raw_memory = raw_memory;
+  header.size = size;
+
+  return buffer;
+}
+
+// Free a buffer with the system allocator
+void SurfacePixelPool::freeBuffer( void* buffer )
+{
+  std::free( SurfacePixelPool::getHeader( buffer ).raw_memory );
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end SurfacePixelPool.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,142 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfacePixelPool.hpp
+//! \author Alex Robinson
+//! \brief  The surface pixel pool class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SURFACE_PIXEL_POOL_HPP
+#define GDEV_SURFACE_PIXEL_POOL_HPP
+
+// Std Lib Includes
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <mutex>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+namespace GDev{
+
+/*! The surface pixel pool class
+ * \details The pool hands out pixel buffers for the surfaces that GDev
+ * creates. Every buffer starts on a 64 byte boundary and surface rows are
+ * padded to a multiple of 64 bytes (see getAlignedPitch) so every row is
+ * aligned for the SIMD kernels. Requests are rounded up to a size class
+ * (four classes per power of two) and freed buffers are kept in a free list
+ * for their size class so that surfaces that are created every frame
+ * (e.g. shape surfaces) do not go through the system allocator. The pool is
+ * thread safe.
+ */
+class SurfacePixelPool
+{
+
+public:
+
+  //! Get the alignment of the buffers (and surface rows) in bytes
+  static size_t getAlignment();
+
+  //! Get the length of an aligned row of pixels in bytes (pitch)
+  static int getAlignedPitch( const int width, const int bits_per_pixel );
+
+  //! Allocate a buffer
+  static void* allocate( const size_t size );
+
+  //! Return a buffer to the pool
+  static void deallocate( void* buffer );
+
+  //! Get the max number of bytes that are kept in the free lists
+  static size_t getMaxNumberOfFreeBytes();
+
+  //! Set the max number of bytes that are kept in the free lists
+  static void setMaxNumberOfFreeBytes( const size_t max_number_of_bytes );
+
+  //! Release the buffers in the free lists
+  static void releaseFreeBuffers();
+
+  //! Get the number of allocations
+  static unsigned long getNumberOfAllocations();
+
+  //! Get the number of allocations that were served from the free lists
+  static unsigned long getNumberOfRecycledAllocations();
+
+  //! Get the number of bytes in buffers that are in use
+  static size_t getNumberOfBytesInUse();
+
+  //! Get the number of bytes in the free lists
+  static size_t getNumberOfFreeBytes();
+
+  //! Get the number of buffers in the free lists
+  static unsigned getNumberOfFreeBuffers();
+
+private:
+
+  // The buffer header (stored in front of the buffer)
+  struct BufferHeader
+  {
+    // The memory returned by the system allocator
+    void* raw_memory;
+
+    // The size class of the buffer
+    size_t size;
+  };
+
+  // The pool data
+  struct PoolData
+  {
+    // The pool mutex
+    std::mutex mutex;
+
+    // The free lists (indexed by size class)
+    std::map<size_t,std::vector<void*> > free_buffers;
+
+    // The max number of bytes that are kept in the free lists
+    size_t max_number_of_free_bytes;
+
+    // The number of allocations
+    unsigned long number_of_allocations;
+
+    // The number of allocations that were served from the free lists
+    unsigned long number_of_recycled_allocations;
+
+    // The number of bytes in buffers that are in use
+    size_t number_of_bytes_in_use;
+
+    // The number of bytes in the free lists
+    size_t number_of_free_bytes;
+
+    // The number of buffers in the free lists
+    unsigned number_of_free_buffers;
+  };
+
+  // Get the pool data
+  static PoolData& getPoolData();
+
+  // Get the size class of a request
+  static size_t getSizeClass( const size_t size );
+
+  // Get the header of a buffer
+  static BufferHeader& getHeader( void* buffer );
+
+  // Allocate a new buffer from the system allocator
+  static void* allocateNewBuffer( const size_t size );
+
+  // Free a buffer with the system allocator
+  static void freeBuffer( void* buffer );
+
+  // The buffer alignment
+  static const size_t s_alignment;
+
+  // The smallest size class
+  static const size_t s_min_size_class;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SURFACE_PIXEL_POOL_HPP
+
+//---------------------------------------------------------------------------//
+// end SurfacePixelPool.hpp
+//---------------------------------------------------------------------------//
@@ -35,6 +35,14 @@ void SurfaceRenderer::resetViewport()
   this->setViewport( viewport );
 }
 
+// Check if areas of the drawing can be presented
+/*! \details The surface is the drawing, so it is never discarded.
+ */
+bool SurfaceRenderer::isPartialPresentSupported() const
+{
+  return true;
+}
+
 } // end GDev namespace
 
 //---------------------------------------------------------------------------//
@@ -45,6 +45,9 @@ public:
   //! Reset the viewport to the entire target
   void resetViewport();
 
+  //! Check if areas of the drawing can be presented
+  bool isPartialPresentSupported() const;
+
 private:
 
   // Do not allow default construction
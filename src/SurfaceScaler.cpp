@@ -0,0 +1,945 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfaceScaler.cpp
+//! \author Alex Robinson
+//! \brief  The surface scaler class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// GDev Includes
+#include "SurfaceScaler.hpp"
+#include "DBCMacros.hpp"
+
+// The SIMD kernels are only available with gcc compatible x86 compilers
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GDEV_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace GDev{
+
+// Initialize static member data
+SurfaceScaler::Kernel SurfaceScaler::s_kernel =
+  SurfaceBlitter::getBestSupportedKernel();
+
+// Get the kernel that is used for scaled blits
+SurfaceScaler::Kernel SurfaceScaler::getKernel()
+{
+  return s_kernel;
+}
+
+// Set the kernel that is used for scaled blits
+/*! \details This is mostly useful for testing and benchmarking the kernels.
+ */
+void SurfaceScaler::setKernel( const Kernel kernel )
+{
+  // Make sure the kernel is supported
+  testPrecondition( SurfaceBlitter::isKernelSupported( kernel ) );
+
+  s_kernel = kernel;
+}
+
+// Get the name of a filter
+const char* SurfaceScaler::getFilterName( const Filter filter )
+{
+  switch( filter )
+  {
+  case NEAREST_FILTER: return "nearest";
+  case BILINEAR_FILTER: return "bilinear";
+  case BOX_FILTER: return "box";
+  default: return "unknown";
+  }
+}
+
+// Check if a scaled blit between the surfaces can be done
+/*! \details Both surfaces must have the same 32 bit pixel format. Blending,
+ * modulation and color keys are only supported for ARGB8888 surfaces.
+ */
+bool SurfaceScaler::canBlitScaled( const SDL_Surface& source_surface,
+				   const SDL_Surface& destination_surface )
+{
+  if( &source_surface == &destination_surface )
+    return false;
+
+  if( source_surface.format->format != destination_surface.format->format ||
+      source_surface.format->BytesPerPixel != 4 )
+    return false;
+
+  if( SDL_MUSTLOCK( &source_surface ) || SDL_MUSTLOCK( &destination_surface ) )
+    return false;
+
+  if( source_surface.format->format == SDL_PIXELFORMAT_ARGB8888 )
+    return SurfaceBlitter::canBlit( source_surface, destination_surface );
+  else
+    return SurfaceBlitter::getParameters( source_surface ).isOpaqueCopy();
+}
+
+// Clip the scaled blit rectangles (same rules as SDL_BlitScaled)
+/*! \details The source rectangle is clipped to the source surface and the
+ * destination rectangle is clipped to the clip rectangle of the destination
+ * surface. The opposite rectangle is clipped proportionally. A NULL
+ * rectangle refers to the entire surface. False will be returned if
+ * nothing will be blitted.
+ */
+bool SurfaceScaler::clipRectangles( const SDL_Surface& source_surface,
+				    const SDL_Rect* source_rectangle,
+				    const SDL_Surface& destination_surface,
+				    const SDL_Rect* destination_rectangle,
+				    SDL_Rect& clipped_source_rectangle,
+				    SDL_Rect& clipped_destination_rectangle )
+{
+  const int source_w = source_rectangle ? source_rectangle->w :
+    source_surface.w;
+  const int source_h = source_rectangle ? source_rectangle->h :
+    source_surface.h;
+  const int destination_w = destination_rectangle ? destination_rectangle->w:
+    destination_surface.w;
+  const int destination_h = destination_rectangle ? destination_rectangle->h:
+    destination_surface.h;
+
+  clipped_destination_rectangle.w = 0;
+  clipped_destination_rectangle.h = 0;
+
+  if( source_w <= 0 || source_h <= 0 )
+    return false;
+
+  const double scaling_w = (double)destination_w/source_w;
+  const double scaling_h = (double)destination_h/source_h;
+
+  double source_x0 = source_rectangle ? source_rectangle->x : 0;
+  double source_y0 = source_rectangle ? source_rectangle->y : 0;
+  double source_x1 = source_x0 + source_w - 1;
+  double source_y1 = source_y0 + source_h - 1;
+
+  double destination_x0 = destination_rectangle ? destination_rectangle->x :0;
+  double destination_y0 = destination_rectangle ? destination_rectangle->y :0;
+  double destination_x1 = destination_x0 + destination_w - 1;
+  double destination_y1 = destination_y0 + destination_h - 1;
+
+  // Clip the source rectangle to the source surface
+  if( source_x0 < 0 )
+  {
+    destination_x0 -= source_x0*scaling_w;
+    source_x0 = 0;
+  }
+
+  if( source_x1 >= source_surface.w )
+  {
+    destination_x1 -= (source_x1 - source_surface.w + 1)*scaling_w;
+    source_x1 = source_surface.w - 1;
+  }
+
+  if( source_y0 < 0 )
+  {
+    destination_y0 -= source_y0*scaling_h;
+    source_y0 = 0;
+  }
+
+  if( source_y1 >= source_surface.h )
+  {
+    destination_y1 -= (source_y1 - source_surface.h + 1)*scaling_h;
+    source_y1 = source_surface.h - 1;
+  }
+
+  // Clip the destination rectangle to the clip rectangle (in clip space)
+  const SDL_Rect& clip = destination_surface.clip_rect;
+
+  destination_x0 -= clip.x;
+  destination_x1 -= clip.x;
+  destination_y0 -= clip.y;
+  destination_y1 -= clip.y;
+
+  if( destination_x0 < 0 )
+  {
+    source_x0 -= destination_x0/scaling_w;
+    destination_x0 = 0;
+  }
+
+  if( destination_x1 >= clip.w )
+  {
+    source_x1 -= (destination_x1 - clip.w + 1)/scaling_w;
+    destination_x1 = clip.w - 1;
+  }
+
+  if( destination_y0 < 0 )
+  {
+    source_y0 -= destination_y0/scaling_h;
+    destination_y0 = 0;
+  }
+
+  if( destination_y1 >= clip.h )
+  {
+    source_y1 -= (destination_y1 - clip.h + 1)/scaling_h;
+    destination_y1 = clip.h - 1;
+  }
+
+  destination_x0 += clip.x;
+  destination_x1 += clip.x;
+  destination_y0 += clip.y;
+  destination_y1 += clip.y;
+
+  clipped_source_rectangle.x = (int)std::floor( source_x0 + 0.5 );
+  clipped_source_rectangle.y = (int)std::floor( source_y0 + 0.5 );
+  clipped_source_rectangle.w = (int)std::floor( source_x1 - source_x0 + 1.5 );
+  clipped_source_rectangle.h = (int)std::floor( source_y1 - source_y0 + 1.5 );
+
+  clipped_destination_rectangle.x = (int)std::floor( destination_x0 + 0.5 );
+  clipped_destination_rectangle.y = (int)std::floor( destination_y0 + 0.5 );
+  clipped_destination_rectangle.w =
+    std::max( (int)std::floor( destination_x1 - destination_x0 + 1.5 ), 0 );
+  clipped_destination_rectangle.h =
+    std::max( (int)std::floor( destination_y1 - destination_y0 + 1.5 ), 0 );
+
+  // Rounding can push the rectangles past the surface edges by one pixel
+  clipped_source_rectangle.w = std::min( clipped_source_rectangle.w,
+				source_surface.w - clipped_source_rectangle.x );
+  clipped_source_rectangle.h = std::min( clipped_source_rectangle.h,
+				source_surface.h - clipped_source_rectangle.y );
+  clipped_destination_rectangle.w =
+    std::min( clipped_destination_rectangle.w,
+	      clip.x + clip.w - clipped_destination_rectangle.x );
+  clipped_destination_rectangle.h =
+    std::min( clipped_destination_rectangle.h,
+	      clip.y + clip.h - clipped_destination_rectangle.y );
+
+  return clipped_destination_rectangle.w > 0 &&
+    clipped_destination_rectangle.h > 0 &&
+    clipped_source_rectangle.w > 0 &&
+    clipped_source_rectangle.h > 0;
+}
+
+// Blit a clipped source rectangle to a clipped destination rectangle
+void SurfaceScaler::blitScaled( const SDL_Surface& source_surface,
+				const SDL_Rect& source_rectangle,
+				SDL_Surface& destination_surface,
+				const SDL_Rect& destination_rectangle,
+				const Filter filter )
+{
+  // Make sure the surfaces can be blitted
+  testPrecondition( SurfaceScaler::canBlitScaled( source_surface,
+						  destination_surface ) );
+  // Make sure the rectangles are valid
+  testPrecondition( source_rectangle.x >= 0 );
+  testPrecondition( source_rectangle.y >= 0 );
+  testPrecondition( source_rectangle.w > 0 );
+  testPrecondition( source_rectangle.h > 0 );
+  testPrecondition( source_rectangle.x + source_rectangle.w <=
+		    source_surface.w );
+  testPrecondition( source_rectangle.y + source_rectangle.h <=
+		    source_surface.h );
+  testPrecondition( destination_rectangle.x >= 0 );
+  testPrecondition( destination_rectangle.y >= 0 );
+  testPrecondition( destination_rectangle.w > 0 );
+  testPrecondition( destination_rectangle.h > 0 );
+  testPrecondition( destination_rectangle.x + destination_rectangle.w <=
+		    destination_surface.w );
+  testPrecondition( destination_rectangle.y + destination_rectangle.h <=
+		    destination_surface.h );
+
+  const SurfaceBlitter::Parameters parameters =
+    SurfaceBlitter::getParameters( source_surface );
+
+  // The color key must not be blended into the neighboring pixels
+  if( parameters.use_color_key || filter == NEAREST_FILTER )
+  {
+    SurfaceScaler::blitNearest( source_surface,
+				source_rectangle,
+				destination_surface,
+				destination_rectangle,
+				parameters );
+  }
+  else if( filter == BILINEAR_FILTER )
+  {
+    SurfaceScaler::blitBilinear( source_surface,
+				 source_rectangle,
+				 destination_surface,
+				 destination_rectangle,
+				 parameters );
+  }
+  else
+  {
+    SurfaceScaler::blitBox( source_surface,
+			    source_rectangle,
+			    destination_surface,
+			    destination_rectangle,
+			    parameters );
+  }
+}
+
+// Blit with the nearest filter
+/*! \details The pixel centers of the destination rectangle are mapped to
+ * the source rectangle.
+ */
+void SurfaceScaler::blitNearest( const SDL_Surface& source_surface,
+				 const SDL_Rect& source_rectangle,
+				 SDL_Surface& destination_surface,
+				 const SDL_Rect& destination_rectangle,
+				 const SurfaceBlitter::Parameters& parameters )
+{
+  const int width = destination_rectangle.w;
+  const int height = destination_rectangle.h;
+
+  // Compute the source column of each destination column
+  std::vector<int> source_columns( width );
+
+  const Uint64 x_step = ((Uint64)source_rectangle.w << 16)/width;
+  Uint64 x_position = x_step/2;
+
+  for( int i = 0; i < width; ++i )
+  {
+    source_columns[i] = std::min( (int)(x_position >> 16),
+				  source_rectangle.w - 1 );
+    x_position += x_step;
+  }
+
+  const Uint64 y_step = ((Uint64)source_rectangle.h << 16)/height;
+  Uint64 y_position = y_step/2;
+
+  std::vector<Uint32> scaled_row( width );
+
+  for( int j = 0; j < height; ++j )
+  {
+    const int source_y = source_rectangle.y +
+      std::min( (int)(y_position >> 16), source_rectangle.h - 1 );
+    y_position += y_step;
+
+    const Uint32* source_row = reinterpret_cast<const Uint32*>(
+	static_cast<const Uint8*>( source_surface.pixels ) +
+	source_y*source_surface.pitch ) + source_rectangle.x;
+
+    Uint32* destination_row = reinterpret_cast<Uint32*>(
+	static_cast<Uint8*>( destination_surface.pixels ) +
+	(destination_rectangle.y + j)*destination_surface.pitch ) +
+      destination_rectangle.x;
+
+    // Opaque copies can be sampled straight into the destination
+    if( parameters.isOpaqueCopy() )
+    {
+      SurfaceScaler::nearestRow( source_row,
+				 &source_columns[0],
+				 destination_row,
+				 width );
+    }
+    else
+    {
+      SurfaceScaler::nearestRow( source_row,
+				 &source_columns[0],
+				 &scaled_row[0],
+				 width );
+
+      SurfaceBlitter::blitRow( &scaled_row[0],
+			       destination_row,
+			       width,
+			       parameters );
+    }
+  }
+}
+
+// Blit with the bilinear filter
+/*! \details The pixel centers of the destination rectangle are mapped to
+ * the source rectangle. Each destination row is computed in two passes: the
+ * two nearest source rows are interpolated first and then the two nearest
+ * columns of the interpolated row are interpolated. The samples are clamped
+ * to the edges of the source rectangle.
+ */
+void SurfaceScaler::blitBilinear( const SDL_Surface& source_surface,
+				  const SDL_Rect& source_rectangle,
+				  SDL_Surface& destination_surface,
+				  const SDL_Rect& destination_rectangle,
+				  const SurfaceBlitter::Parameters& parameters )
+{
+  const int width = destination_rectangle.w;
+  const int height = destination_rectangle.h;
+
+  // Compute the source columns and weights of each destination column
+  std::vector<int> first_columns( width ), second_columns( width );
+  std::vector<Uint32> column_weights( width );
+
+  for( int i = 0; i < width; ++i )
+  {
+    Sint64 center = ((2*(Sint64)i + 1)*source_rectangle.w << 16)/(2*width) -
+      0x8000;
+
+    if( center < 0 )
+      center = 0;
+
+    int column = (int)(center >> 16);
+    Uint32 weight = (center & 0xFFFF) >> 9;
+
+    if( column >= source_rectangle.w - 1 )
+    {
+      column = source_rectangle.w - 1;
+      weight = 0;
+    }
+
+    first_columns[i] = column;
+    second_columns[i] = std::min( column + 1, source_rectangle.w - 1 );
+    column_weights[i] = weight*0x01010101u;
+  }
+
+  std::vector<Uint32> row_weights( source_rectangle.w );
+  std::vector<Uint32> interpolated_row( source_rectangle.w );
+  std::vector<Uint32> first_samples( width ), second_samples( width );
+  std::vector<Uint32> scaled_row( width );
+
+  for( int j = 0; j < height; ++j )
+  {
+    Sint64 center = ((2*(Sint64)j + 1)*source_rectangle.h << 16)/(2*height) -
+      0x8000;
+
+    if( center < 0 )
+      center = 0;
+
+    int row = (int)(center >> 16);
+    Uint32 weight = (center & 0xFFFF) >> 9;
+
+    if( row >= source_rectangle.h - 1 )
+    {
+      row = source_rectangle.h - 1;
+      weight = 0;
+    }
+
+    const Uint32* first_source_row = reinterpret_cast<const Uint32*>(
+	static_cast<const Uint8*>( source_surface.pixels ) +
+	(source_rectangle.y + row)*source_surface.pitch ) + source_rectangle.x;
+
+    const Uint32* vertical_row = first_source_row;
+
+    // Interpolate the source rows
+    if( weight > 0 )
+    {
+      const Uint32* second_source_row = reinterpret_cast<const Uint32*>(
+	   reinterpret_cast<const Uint8*>( first_source_row ) +
+	   source_surface.pitch );
+
+      std::fill( row_weights.begin(), row_weights.end(), weight*0x01010101u );
+
+      SurfaceScaler::lerpRow( first_source_row,
+			      second_source_row,
+			      &row_weights[0],
+			      &interpolated_row[0],
+			      source_rectangle.w );
+
+      vertical_row = &interpolated_row[0];
+    }
+
+    // Interpolate the columns
+    SurfaceScaler::nearestRow( vertical_row,
+			       &first_columns[0],
+			       &first_samples[0],
+			       width );
+    SurfaceScaler::nearestRow( vertical_row,
+			       &second_columns[0],
+			       &second_samples[0],
+			       width );
+
+    Uint32* destination_row = reinterpret_cast<Uint32*>(
+	static_cast<Uint8*>( destination_surface.pixels ) +
+	(destination_rectangle.y + j)*destination_surface.pitch ) +
+      destination_rectangle.x;
+
+    if( parameters.isOpaqueCopy() )
+    {
+      SurfaceScaler::lerpRow( &first_samples[0],
+			      &second_samples[0],
+			      &column_weights[0],
+			      destination_row,
+			      width );
+    }
+    else
+    {
+      SurfaceScaler::lerpRow( &first_samples[0],
+			      &second_samples[0],
+			      &column_weights[0],
+			      &scaled_row[0],
+			      width );
+
+      SurfaceBlitter::blitRow( &scaled_row[0],
+			       destination_row,
+			       width,
+			       parameters );
+    }
+  }
+}
+
+// Blit with the box filter
+/*! \details Each destination pixel is the rounded average of the source
+ * pixels in its footprint. The footprint always contains at least one
+ * source pixel.
+ */
+void SurfaceScaler::blitBox( const SDL_Surface& source_surface,
+			     const SDL_Rect& source_rectangle,
+			     SDL_Surface& destination_surface,
+			     const SDL_Rect& destination_rectangle,
+			     const SurfaceBlitter::Parameters& parameters )
+{
+  const int width = destination_rectangle.w;
+  const int height = destination_rectangle.h;
+
+  // Compute the source column span of each destination column
+  std::vector<int> first_columns( width ), end_columns( width );
+
+  for( int i = 0; i < width; ++i )
+  {
+    first_columns[i] = (int)((Sint64)i*source_rectangle.w/width);
+    end_columns[i] = std::max( (int)((Sint64)(i+1)*source_rectangle.w/width),
+			       first_columns[i] + 1 );
+  }
+
+  std::vector<Uint32> channel_sums( 4*source_rectangle.w );
+  std::vector<Uint32> scaled_row( width );
+
+  for( int j = 0; j < height; ++j )
+  {
+    const int first_row = (int)((Sint64)j*source_rectangle.h/height);
+    const int end_row = std::max( (int)((Sint64)(j+1)*source_rectangle.h/height),
+				  first_row + 1 );
+
+    // Sum the channels of the source rows in the footprint
+    std::fill( channel_sums.begin(), channel_sums.end(), 0u );
+
+    for( int row = first_row; row < end_row; ++row )
+    {
+      const Uint32* source_row = reinterpret_cast<const Uint32*>(
+	  static_cast<const Uint8*>( source_surface.pixels ) +
+	  (source_rectangle.y + row)*source_surface.pitch ) +
+	source_rectangle.x;
+
+      SurfaceScaler::accumulateRow( source_row,
+				    &channel_sums[0],
+				    source_rectangle.w );
+    }
+
+    // Average the channel sums of the columns in the footprint
+    for( int i = 0; i < width; ++i )
+    {
+      const Uint64 count =
+	(Uint64)(end_columns[i] - first_columns[i])*(end_row - first_row);
+
+      Uint32 pixel = 0;
+
+      for( int channel = 0; channel < 4; ++channel )
+      {
+	Uint64 sum = 0;
+
+	for( int column = first_columns[i]; column < end_columns[i]; ++column )
+	  sum += channel_sums[4*column + channel];
+
+	pixel |= (Uint32)((sum + count/2)/count) << 8*channel;
+      }
+
+      scaled_row[i] = pixel;
+    }
+
+    Uint32* destination_row = reinterpret_cast<Uint32*>(
+	static_cast<Uint8*>( destination_surface.pixels ) +
+	(destination_rectangle.y + j)*destination_surface.pitch ) +
+      destination_rectangle.x;
+
+    SurfaceBlitter::blitRow( &scaled_row[0],
+			     destination_row,
+			     width,
+			     parameters );
+  }
+}
+
+// Sample a row with the nearest filter
+void SurfaceScaler::nearestRow( const Uint32* source_row,
+				const int* source_columns,
+				Uint32* scaled_row,
+				const int width )
+{
+  // There is no SSE2 gather instruction
+  if( s_kernel == AVX2_KERNEL )
+  {
+    SurfaceScaler::nearestRowAVX2( source_row,
+				   source_columns,
+				   scaled_row,
+				   width );
+  }
+  else
+  {
+    SurfaceScaler::nearestRowScalar( source_row,
+				     source_columns,
+				     scaled_row,
+				     width );
+  }
+}
+
+// Interpolate two rows (7 bit weights replicated in each byte)
+void SurfaceScaler::lerpRow( const Uint32* first_row,
+			     const Uint32* second_row,
+			     const Uint32* weights,
+			     Uint32* interpolated_row,
+			     const int width )
+{
+  switch( s_kernel )
+  {
+  case AVX2_KERNEL:
+    SurfaceScaler::lerpRowAVX2( first_row,
+				second_row,
+				weights,
+				interpolated_row,
+				width );
+    break;
+  case SSE2_KERNEL:
+    SurfaceScaler::lerpRowSSE2( first_row,
+				second_row,
+				weights,
+				interpolated_row,
+				width );
+    break;
+  default:
+    SurfaceScaler::lerpRowScalar( first_row,
+				  second_row,
+				  weights,
+				  interpolated_row,
+				  width );
+  }
+}
+
+// Add the channels of a row to the channel sums
+void SurfaceScaler::accumulateRow( const Uint32* source_row,
+				   Uint32* channel_sums,
+				   const int width )
+{
+  switch( s_kernel )
+  {
+  case AVX2_KERNEL:
+    SurfaceScaler::accumulateRowAVX2( source_row, channel_sums, width );
+    break;
+  case SSE2_KERNEL:
+    SurfaceScaler::accumulateRowSSE2( source_row, channel_sums, width );
+    break;
+  default:
+    SurfaceScaler::accumulateRowScalar( source_row, channel_sums, width );
+  }
+}
+
+// Sample a row with the nearest filter (scalar kernel)
+void SurfaceScaler::nearestRowScalar( const Uint32* source_row,
+				      const int* source_columns,
+				      Uint32* scaled_row,
+				      const int width )
+{
+  for( int i = 0; i < width; ++i )
+    scaled_row[i] = source_row[source_columns[i]];
+}
+
+// Interpolate two rows (scalar kernel)
+/*! \details Each channel is interpolated with (a*(128-w) + b*w + 64) >> 7.
+ */
+void SurfaceScaler::lerpRowScalar( const Uint32* first_row,
+				   const Uint32* second_row,
+				   const Uint32* weights,
+				   Uint32* interpolated_row,
+				   const int width )
+{
+  for( int i = 0; i < width; ++i )
+  {
+    const Uint32 weight = weights[i] & 0xFF;
+
+    Uint32 pixel = 0;
+
+    for( int shift = 0; shift < 32; shift += 8 )
+    {
+      const Uint32 first = (first_row[i] >> shift) & 0xFF;
+      const Uint32 second = (second_row[i] >> shift) & 0xFF;
+
+      pixel |= ((first*(128 - weight) + second*weight + 64) >> 7) << shift;
+    }
+
+    interpolated_row[i] = pixel;
+  }
+}
+
+// Add the channels of a row to the channel sums (scalar kernel)
+void SurfaceScaler::accumulateRowScalar( const Uint32* source_row,
+					 Uint32* channel_sums,
+					 const int width )
+{
+  for( int i = 0; i < width; ++i )
+  {
+    channel_sums[4*i] += source_row[i] & 0xFF;
+    channel_sums[4*i+1] += (source_row[i] >> 8) & 0xFF;
+    channel_sums[4*i+2] += (source_row[i] >> 16) & 0xFF;
+    channel_sums[4*i+3] += source_row[i] >> 24;
+  }
+}
+
+#ifdef GDEV_X86_SIMD_KERNELS
+
+// Sample a row with the nearest filter (AVX2 kernel)
+/*! \details Eight pixels are gathered at a time.
+ */
+__attribute__((target("avx2")))
+void SurfaceScaler::nearestRowAVX2( const Uint32* source_row,
+				    const int* source_columns,
+				    Uint32* scaled_row,
+				    const int width )
+{
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i columns = _mm256_loadu_si256(
+		      reinterpret_cast<const __m256i*>( source_columns + i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( scaled_row + i ),
+			 _mm256_i32gather_epi32(
+			       reinterpret_cast<const int*>( source_row ),
+			       columns,
+			       4 ) );
+  }
+
+  SurfaceScaler::nearestRowScalar( source_row,
+				   source_columns + i,
+				   scaled_row + i,
+				   width - i );
+}
+
+// Interpolate two rows (SSE2 kernel)
+/*! \details Four pixels are interpolated at a time with 16 bit channels.
+ */
+__attribute__((target("sse2")))
+void SurfaceScaler::lerpRowSSE2( const Uint32* first_row,
+				 const Uint32* second_row,
+				 const Uint32* weights,
+				 Uint32* interpolated_row,
+				 const int width )
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max_weight = _mm_set1_epi16( 128 );
+  const __m128i rounding = _mm_set1_epi16( 64 );
+
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i first =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( first_row + i ) );
+    const __m128i second =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( second_row + i ) );
+    const __m128i weight =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( weights + i ) );
+
+    const __m128i weight_lo = _mm_unpacklo_epi8( weight, zero );
+    const __m128i weight_hi = _mm_unpackhi_epi8( weight, zero );
+
+    const __m128i result_lo = _mm_srli_epi16( _mm_add_epi16(
+	 _mm_add_epi16(
+	  _mm_mullo_epi16( _mm_unpacklo_epi8( first, zero ),
+			   _mm_sub_epi16( max_weight, weight_lo ) ),
+	  _mm_mullo_epi16( _mm_unpacklo_epi8( second, zero ), weight_lo ) ),
+	 rounding ), 7 );
+    const __m128i result_hi = _mm_srli_epi16( _mm_add_epi16(
+	 _mm_add_epi16(
+	  _mm_mullo_epi16( _mm_unpackhi_epi8( first, zero ),
+			   _mm_sub_epi16( max_weight, weight_hi ) ),
+	  _mm_mullo_epi16( _mm_unpackhi_epi8( second, zero ), weight_hi ) ),
+	 rounding ), 7 );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( interpolated_row + i ),
+		      _mm_packus_epi16( result_lo, result_hi ) );
+  }
+
+  SurfaceScaler::lerpRowScalar( first_row + i,
+				second_row + i,
+				weights + i,
+				interpolated_row + i,
+				width - i );
+}
+
+// Interpolate two rows (AVX2 kernel)
+/*! \details Eight pixels are interpolated at a time with 16 bit channels.
+ */
+__attribute__((target("avx2")))
+void SurfaceScaler::lerpRowAVX2( const Uint32* first_row,
+				 const Uint32* second_row,
+				 const Uint32* weights,
+				 Uint32* interpolated_row,
+				 const int width )
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max_weight = _mm256_set1_epi16( 128 );
+  const __m256i rounding = _mm256_set1_epi16( 64 );
+
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    const __m256i first = _mm256_loadu_si256(
+			  reinterpret_cast<const __m256i*>( first_row + i ) );
+    const __m256i second = _mm256_loadu_si256(
+			  reinterpret_cast<const __m256i*>( second_row + i ) );
+    const __m256i weight = _mm256_loadu_si256(
+			  reinterpret_cast<const __m256i*>( weights + i ) );
+
+    const __m256i weight_lo = _mm256_unpacklo_epi8( weight, zero );
+    const __m256i weight_hi = _mm256_unpackhi_epi8( weight, zero );
+
+    const __m256i result_lo = _mm256_srli_epi16( _mm256_add_epi16(
+	 _mm256_add_epi16(
+	  _mm256_mullo_epi16( _mm256_unpacklo_epi8( first, zero ),
+			      _mm256_sub_epi16( max_weight, weight_lo ) ),
+	  _mm256_mullo_epi16( _mm256_unpacklo_epi8( second, zero ),
+			      weight_lo ) ),
+	 rounding ), 7 );
+    const __m256i result_hi = _mm256_srli_epi16( _mm256_add_epi16(
+	 _mm256_add_epi16(
+	  _mm256_mullo_epi16( _mm256_unpackhi_epi8( first, zero ),
+			      _mm256_sub_epi16( max_weight, weight_hi ) ),
+	  _mm256_mullo_epi16( _mm256_unpackhi_epi8( second, zero ),
+			      weight_hi ) ),
+	 rounding ), 7 );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( interpolated_row + i ),
+			 _mm256_packus_epi16( result_lo, result_hi ) );
+  }
+
+  SurfaceScaler::lerpRowScalar( first_row + i,
+				second_row + i,
+				weights + i,
+				interpolated_row + i,
+				width - i );
+}
+
+// Add the channels of a row to the channel sums (SSE2 kernel)
+/*! \details The channels of four pixels are widened to 32 bits and added
+ * to the sums at a time.
+ */
+__attribute__((target("sse2")))
+void SurfaceScaler::accumulateRowSSE2( const Uint32* source_row,
+				       Uint32* channel_sums,
+				       const int width )
+{
+  const __m128i zero = _mm_setzero_si128();
+
+  int i = 0;
+
+  for( ; i + 4 <= width; i += 4 )
+  {
+    const __m128i pixels =
+      _mm_loadu_si128( reinterpret_cast<const __m128i*>( source_row + i ) );
+
+    const __m128i pixels_lo = _mm_unpacklo_epi8( pixels, zero );
+    const __m128i pixels_hi = _mm_unpackhi_epi8( pixels, zero );
+
+    __m128i* sums = reinterpret_cast<__m128i*>( channel_sums + 4*i );
+
+    _mm_storeu_si128( sums, _mm_add_epi32( _mm_loadu_si128( sums ),
+				     _mm_unpacklo_epi16( pixels_lo, zero ) ) );
+    _mm_storeu_si128( sums+1, _mm_add_epi32( _mm_loadu_si128( sums+1 ),
+				     _mm_unpackhi_epi16( pixels_lo, zero ) ) );
+    _mm_storeu_si128( sums+2, _mm_add_epi32( _mm_loadu_si128( sums+2 ),
+				     _mm_unpacklo_epi16( pixels_hi, zero ) ) );
+    _mm_storeu_si128( sums+3, _mm_add_epi32( _mm_loadu_si128( sums+3 ),
+				     _mm_unpackhi_epi16( pixels_hi, zero ) ) );
+  }
+
+  SurfaceScaler::accumulateRowScalar( source_row + i,
+				      channel_sums + 4*i,
+				      width - i );
+}
+
+// Add the channels of a row to the channel sums (AVX2 kernel)
+/*! \details The channels of two pixels are widened to 32 bits and added to
+ * the sums at a time (eight pixels per iteration).
+ */
+__attribute__((target("avx2")))
+void SurfaceScaler::accumulateRowAVX2( const Uint32* source_row,
+				       Uint32* channel_sums,
+				       const int width )
+{
+  int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    for( int pair = 0; pair < 4; ++pair )
+    {
+      __m256i* sums =
+	reinterpret_cast<__m256i*>( channel_sums + 4*(i + 2*pair) );
+
+      const __m256i channels = _mm256_cvtepu8_epi32( _mm_loadl_epi64(
+	   reinterpret_cast<const __m128i*>( source_row + i + 2*pair ) ) );
+
+      _mm256_storeu_si256( sums, _mm256_add_epi32( _mm256_loadu_si256( sums ),
+						   channels ) );
+    }
+  }
+
+  SurfaceScaler::accumulateRowScalar( source_row + i,
+				      channel_sums + 4*i,
+				      width - i );
+}
+
+#else // GDEV_X86_SIMD_KERNELS
+
+// Sample a row with the nearest filter (AVX2 kernel - not available)
+void SurfaceScaler::nearestRowAVX2( const Uint32* source_row,
+				    const int* source_columns,
+				    Uint32* scaled_row,
+				    const int width )
+{
+  SurfaceScaler::nearestRowScalar( source_row,
+				   source_columns,
+				   scaled_row,
+				   width );
+}
+
+// Interpolate two rows (SSE2 kernel - not available)
+void SurfaceScaler::lerpRowSSE2( const Uint32* first_row,
+				 const Uint32* second_row,
+				 const Uint32* weights,
+				 Uint32* interpolated_row,
+				 const int width )
+{
+  SurfaceScaler::lerpRowScalar( first_row,
+				second_row,
+				weights,
+				interpolated_row,
+				width );
+}
+
+// Interpolate two rows (AVX2 kernel - not available)
+void SurfaceScaler::lerpRowAVX2( const Uint32* first_row,
+				 const Uint32* second_row,
+				 const Uint32* weights,
+				 Uint32* interpolated_row,
+				 const int width )
+{
+  SurfaceScaler::lerpRowScalar( first_row,
+				second_row,
+				weights,
+				interpolated_row,
+				width );
+}
+
+// Add the channels of a row to the channel sums (SSE2 kernel - not avail.)
+void SurfaceScaler::accumulateRowSSE2( const Uint32* source_row,
+				       Uint32* channel_sums,
+				       const int width )
+{
+  SurfaceScaler::accumulateRowScalar( source_row, channel_sums, width );
+}
+
+// Add the channels of a row to the channel sums (AVX2 kernel - not avail.)
+void SurfaceScaler::accumulateRowAVX2( const Uint32* source_row,
+				       Uint32* channel_sums,
+				       const int width )
+{
+  SurfaceScaler::accumulateRowScalar( source_row, channel_sums, width );
+}
+
+#endif // end GDEV_X86_SIMD_KERNELS
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end SurfaceScaler.cpp
+//---------------------------------------------------------------------------//
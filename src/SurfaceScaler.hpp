@@ -0,0 +1,177 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   SurfaceScaler.hpp
+//! \author Alex Robinson
+//! \brief  The surface scaler class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_SURFACE_SCALER_HPP
+#define GDEV_SURFACE_SCALER_HPP
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "SimdKernel.hpp"
+#include "SurfaceBlitter.hpp"
+
+namespace GDev{
+
+/*! The surface scaler class
+ * \details The surface scaler performs scaled blits between surfaces that
+ * have the same 32 bit pixel format. The source rectangle is resampled with
+ * a nearest, a bilinear or a box filter. The sample positions are stepped
+ * with 16.16 fixed point numbers. The bilinear weights have 7 bits of
+ * precision and the box filter averages every source pixel that falls in
+ * the footprint of a destination pixel (it is meant for downsampling - when
+ * upsampling it behaves like the nearest filter). Each scaled row is passed
+ * to the surface blitter, so the blend mode, the modulation and the color
+ * key of ARGB8888 source surfaces are honored. Color keyed surfaces are
+ * always scaled with the nearest filter so that the color key is not
+ * blended into the neighboring pixels. The SIMD kernels are selected like
+ * the surface blitter kernels.
+ */
+class SurfaceScaler
+{
+
+public:
+
+  //! The scale filters
+  enum Filter{
+    NEAREST_FILTER = 0,
+    BILINEAR_FILTER,
+    BOX_FILTER
+  };
+
+  //! The kernel type
+  typedef SimdKernel Kernel;
+
+  //! Get the kernel that is used for scaled blits
+  static Kernel getKernel();
+
+  //! Set the kernel that is used for scaled blits
+  static void setKernel( const Kernel kernel );
+
+  //! Get the name of a filter
+  static const char* getFilterName( const Filter filter );
+
+  //! Check if a scaled blit between the surfaces can be done
+  static bool canBlitScaled( const SDL_Surface& source_surface,
+			     const SDL_Surface& destination_surface );
+
+  //! Clip the scaled blit rectangles (same rules as SDL_BlitScaled)
+  static bool clipRectangles( const SDL_Surface& source_surface,
+			      const SDL_Rect* source_rectangle,
+			      const SDL_Surface& destination_surface,
+			      const SDL_Rect* destination_rectangle,
+			      SDL_Rect& clipped_source_rectangle,
+			      SDL_Rect& clipped_destination_rectangle );
+
+  //! Blit a clipped source rectangle to a clipped destination rectangle
+  static void blitScaled( const SDL_Surface& source_surface,
+			  const SDL_Rect& source_rectangle,
+			  SDL_Surface& destination_surface,
+			  const SDL_Rect& destination_rectangle,
+			  const Filter filter );
+
+private:
+
+  // Blit with the nearest filter
+  static void blitNearest( const SDL_Surface& source_surface,
+			   const SDL_Rect& source_rectangle,
+			   SDL_Surface& destination_surface,
+			   const SDL_Rect& destination_rectangle,
+			   const SurfaceBlitter::Parameters& parameters );
+
+  // Blit with the bilinear filter
+  static void blitBilinear( const SDL_Surface& source_surface,
+			    const SDL_Rect& source_rectangle,
+			    SDL_Surface& destination_surface,
+			    const SDL_Rect& destination_rectangle,
+			    const SurfaceBlitter::Parameters& parameters );
+
+  // Blit with the box filter
+  static void blitBox( const SDL_Surface& source_surface,
+		       const SDL_Rect& source_rectangle,
+		       SDL_Surface& destination_surface,
+		       const SDL_Rect& destination_rectangle,
+		       const SurfaceBlitter::Parameters& parameters );
+
+  // Sample a row with the nearest filter
+  static void nearestRow( const Uint32* source_row,
+			  const int* source_columns,
+			  Uint32* scaled_row,
+			  const int width );
+
+  // Interpolate two rows (7 bit weights replicated in each byte)
+  static void lerpRow( const Uint32* first_row,
+		       const Uint32* second_row,
+		       const Uint32* weights,
+		       Uint32* interpolated_row,
+		       const int width );
+
+  // Add the channels of a row to the channel sums
+  static void accumulateRow( const Uint32* source_row,
+			     Uint32* channel_sums,
+			     const int width );
+
+  // Sample a row with the nearest filter (scalar kernel)
+  static void nearestRowScalar( const Uint32* source_row,
+				const int* source_columns,
+				Uint32* scaled_row,
+				const int width );
+
+  // Sample a row with the nearest filter (AVX2 kernel)
+  static void nearestRowAVX2( const Uint32* source_row,
+			      const int* source_columns,
+			      Uint32* scaled_row,
+			      const int width );
+
+  // Interpolate two rows (scalar kernel)
+  static void lerpRowScalar( const Uint32* first_row,
+			     const Uint32* second_row,
+			     const Uint32* weights,
+			     Uint32* interpolated_row,
+			     const int width );
+
+  // Interpolate two rows (SSE2 kernel)
+  static void lerpRowSSE2( const Uint32* first_row,
+			   const Uint32* second_row,
+			   const Uint32* weights,
+			   Uint32* interpolated_row,
+			   const int width );
+
+  // Interpolate two rows (AVX2 kernel)
+  static void lerpRowAVX2( const Uint32* first_row,
+			   const Uint32* second_row,
+			   const Uint32* weights,
+			   Uint32* interpolated_row,
+			   const int width );
+
+  // Add the channels of a row to the channel sums (scalar kernel)
+  static void accumulateRowScalar( const Uint32* source_row,
+				   Uint32* channel_sums,
+				   const int width );
+
+  // Add the channels of a row to the channel sums (SSE2 kernel)
+  static void accumulateRowSSE2( const Uint32* source_row,
+				 Uint32* channel_sums,
+				 const int width );
+
+  // Add the channels of a row to the channel sums (AVX2 kernel)
+  static void accumulateRowAVX2( const Uint32* source_row,
+				 Uint32* channel_sums,
+				 const int width );
+
+  // The kernel that is used for scaled blits
+  static Kernel s_kernel;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_SURFACE_SCALER_HPP
+
+//---------------------------------------------------------------------------//
+// end SurfaceScaler.hpp
+//---------------------------------------------------------------------------//
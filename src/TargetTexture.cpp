@@ -9,13 +9,15 @@
 // GDev Includes
 #include "TargetTexture.hpp"
 #include "ExceptionTestMacros.hpp"
+#include "ExceptionCatchMacros.hpp"
 #include "DBCMacros.hpp"
 
 namespace GDev{
 
 // Basic blank constructor
 /*! \details The size of the texture will be the size of the rendering
- * target.
+ * target. If the format is unknown the native texture format of the 
+ * renderer will be used.
  */ 
 TargetTexture::TargetTexture( const std::shared_ptr<Renderer>& renderer,
 			      const Uint32 format )
@@ -31,6 +33,9 @@ TargetTexture::TargetTexture( const std::shared_ptr<Renderer>& renderer,
 }
 
 // Blank constructor
+/*! \details If the format is unknown the native texture format of the 
+ * renderer will be used.
+ */
 TargetTexture::TargetTexture( const std::shared_ptr<Renderer>& renderer,
 			      const int width,
 			      const int height,
@@ -42,6 +47,39 @@ TargetTexture::TargetTexture( const std::shared_ptr<Renderer>& renderer,
   testPrecondition( renderer->isNonDefaultTargetSupported() );
 }
 
+// Move constructor
+/*! \details If the other texture is the rendering target this texture will
+ * be the rendering target (the SDL texture is transferred).
+ */
+TargetTexture::TargetTexture( TargetTexture&& other_texture )
+  : Texture( std::move( other_texture ) )
+{ /* ... */ }
+
+// Move assignment operator
+/*! \details If the current texture is the rendering target the default
+ * target will be restored when it is destroyed. The renderer is notified
+ * so that its saved states will not refer to the destroyed texture.
+ */
+TargetTexture& TargetTexture::operator=( TargetTexture&& other_texture )
+{
+  if( this != &other_texture && this->getRawTexturePtr() != NULL )
+    this->getRenderer().releaseTarget( this->getRawTexturePtr() );
+
+  Texture::operator=( std::move( other_texture ) );
+
+  return *this;
+}
+
+// Destructor
+/*! \details If the texture is the rendering target the default target will
+ * be restored (see the move assignment operator).
+ */
+TargetTexture::~TargetTexture()
+{
+  if( this->getRawTexturePtr() != NULL )
+    this->getRenderer().releaseTarget( this->getRawTexturePtr() );
+}
+
 // Get the access pattern
 SDL_TextureAccess TargetTexture::getAccessPattern() const
 {
@@ -51,24 +89,26 @@ SDL_TextureAccess TargetTexture::getAccessPattern() const
 // Check if this is the rendering target
 bool TargetTexture::isRenderTarget() const
 {
-  return this->getRawTexturePtr() == SDL_GetRenderTarget( 
-	const_cast<SDL_Renderer*>( this->getRenderer().getRawRendererPtr() ) );
+  return this->getRenderer().isCurrentTarget( this->getRawTexturePtr() );
 }
 
 // Set as the current rendering target
+/*! \details Changing the rendering target also resets the viewport, clip
+ * rectangle and scale of the renderer (these are restored when the default
+ * target is set again).
+ */
 void TargetTexture::setAsRenderTarget()
 {
   // Make sure this is not the rendering target
   testPrecondition( !this->isRenderTarget() );
   
-  int return_value = 
-    SDL_SetRenderTarget( this->getRenderer().getRawRendererPtr(),
-			 this->getRawTexturePtr() );
-  
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The texture could not be set as the rendering "
-		      "target! SDL_Error: " << SDL_GetError() );
+  try{
+    this->getRenderer().setCurrentTarget( this->getRawTexturePtr() );
+  }
+  EXCEPTION_CATCH_RETHROW_AS( Renderer::ExceptionType,
+			      ExceptionType,
+			      "Error: The texture could not be set as the "
+			      "rendering target!" );
 }
   
 // Unset as the current rendering target
@@ -77,14 +117,13 @@ void TargetTexture::unsetAsRenderTarget()
   // Make sure this is the rendering target
   testPrecondition( this->isRenderTarget() );
   
-  int return_value = 
-    SDL_SetRenderTarget( this->getRenderer().getRawRendererPtr(), NULL );
-
-  TEST_FOR_EXCEPTION( return_value != 0,
-		      ExceptionType,
-		      "Error: The default rendering target could not be set "
-		      "as the rendering target! SDL_Error: " 
-		      << SDL_GetError() );
+  try{
+    this->getRenderer().setCurrentTarget( NULL );
+  }
+  EXCEPTION_CATCH_RETHROW_AS( Renderer::ExceptionType,
+			      ExceptionType,
+			      "Error: The default rendering target could not be "
+			      "set as the rendering target!" );
 }
 
 } // end GDev namespace
@@ -22,17 +22,22 @@ public:
   
   //! Basic blank constructor
   TargetTexture( const std::shared_ptr<Renderer>& renderer,
-		 const Uint32 format = SDL_PIXELFORMAT_ARGB8888 );
+		 const Uint32 format = SDL_PIXELFORMAT_UNKNOWN );
 
   //! Blank constructor
   TargetTexture( const std::shared_ptr<Renderer>& renderer,
 		 const int width,
 		 const int height,
-		 const Uint32 format = SDL_PIXELFORMAT_ARGB8888 );
+		 const Uint32 format = SDL_PIXELFORMAT_UNKNOWN );
+
+  //! Move constructor
+  TargetTexture( TargetTexture&& other_texture );
+
+  //! Move assignment operator
+  TargetTexture& operator=( TargetTexture&& other_texture );
 
   //! Destructor
-  ~TargetTexture()
-  { /* ... */ }
+  ~TargetTexture();
 
   //! Get the access pattern
   SDL_TextureAccess getAccessPattern() const;
@@ -0,0 +1,121 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextTextureCache.cpp
+//! \author Alex Robinson
+//! \brief  The text texture cache class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "TextTextureCache.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// The default memory budget (bytes)
+const size_t TextTextureCache::s_default_memory_budget = 8*1024*1024;
+
+// Constructor
+TextTextureCacheKey::TextTextureCacheKey( const Renderer& renderer,
+					  const std::string& message,
+					  const Font& font,
+					  const SDL_Color& text_color,
+					  const SDL_Color* background_color )
+  : renderer( &renderer ),
+    message( message ),
+    font_filename( font.getFontFilename() ),
+    font_size( font.getFontSize() ),
+    text_color( (text_color.r << 24) | (text_color.g << 16) |
+		(text_color.b << 8) | text_color.a ),
+    has_background_color( background_color != NULL ),
+    background_color( 0 )
+{
+  if( background_color != NULL )
+  {
+    this->background_color = (background_color->r << 24) |
+      (background_color->g << 16) | (background_color->b << 8) |
+      background_color->a;
+  }
+}
+
+// Less than operator
+bool TextTextureCacheKey::operator<( 
+				 const TextTextureCacheKey& other_key ) const
+{
+  if( renderer != other_key.renderer )
+    return renderer < other_key.renderer;
+  else if( font_size != other_key.font_size )
+    return font_size < other_key.font_size;
+  else if( font_filename != other_key.font_filename )
+    return font_filename < other_key.font_filename;
+  else if( text_color != other_key.text_color )
+    return text_color < other_key.text_color;
+  else if( has_background_color != other_key.has_background_color )
+    return has_background_color < other_key.has_background_color;
+  else if( background_color != other_key.background_color )
+    return background_color < other_key.background_color;
+  else
+    return message < other_key.message;
+}
+
+// Constructor
+TextTextureCache::TextTextureCache( const size_t memory_budget )
+  : TextureCache<TextTextureCacheKey,StaticTexture>( memory_budget )
+{ /* ... */ }
+
+// Get the texture for a message (created if it has not been cached)
+/*! \details A found texture becomes the most recently used texture. The
+ * cached textures are shared, so their state (e.g. color modulation) should
+ * not be changed. Textures that are larger than the memory budget will not
+ * be cached.
+ */
+std::shared_ptr<StaticTexture> TextTextureCache::getTexture(
+			      const std::shared_ptr<Renderer>& renderer,
+			      const std::string& message,
+			      const Font& font,
+			      const SDL_Color& text_color,
+			      const SDL_Color* background_color )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+  // Make sure the message is valid
+  testPrecondition( message.size() > 0 );
+
+  Key key( *renderer, message, font, text_color, background_color );
+
+  std::shared_ptr<StaticTexture> texture = this->find( key );
+
+  if( !texture )
+  {
+    texture.reset( new StaticTexture( renderer,
+				      message,
+				      font,
+				      text_color,
+				      background_color ) );
+
+    this->insert( key, texture );
+  }
+
+  return texture;
+}
+
+// Remove the textures of a font (filename and size) from the cache
+/*! \details The textures of other fonts that were loaded from the same file
+ * with the same size will also be removed. Fonts do not need to be removed
+ * before they are destroyed.
+ */
+void TextTextureCache::removeFont( const Font& font )
+{
+  const std::string& font_filename = font.getFontFilename();
+  const unsigned font_size = font.getFontSize();
+
+  this->removeIf( [&]( const Key& key ){
+      return key.font_size == font_size &&
+	key.font_filename == font_filename; } );
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end TextTextureCache.cpp
+//---------------------------------------------------------------------------//
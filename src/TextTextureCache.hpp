@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextTextureCache.hpp
+//! \author Alex Robinson
+//! \brief  The text texture cache class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_TEXT_TEXTURE_CACHE_HPP
+#define GDEV_TEXT_TEXTURE_CACHE_HPP
+
+// Std Lib Includes
+#include <string>
+#include <memory>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Renderer.hpp"
+#include "Font.hpp"
+#include "StaticTexture.hpp"
+#include "TextureCache.hpp"
+
+namespace GDev{
+
+/*! The text texture cache key
+ * \details Fonts are identified by their filename and size (not their
+ * address), so a moved or destroyed font never leaves a stale key behind
+ * and fonts loaded from the same file with the same size share textures.
+ */
+struct TextTextureCacheKey
+{
+  //! Constructor
+  TextTextureCacheKey( const Renderer& renderer,
+		       const std::string& message,
+		       const Font& font,
+		       const SDL_Color& text_color,
+		       const SDL_Color* background_color );
+
+  //! Less than operator
+  bool operator<( const TextTextureCacheKey& other_key ) const;
+
+  //! The renderer
+  const Renderer* renderer;
+
+  //! The message
+  std::string message;
+
+  //! The font filename
+  std::string font_filename;
+
+  //! The font size
+  unsigned font_size;
+
+  //! The packed text color (RGBA)
+  Uint32 text_color;
+
+  //! Records if there is a background color
+  bool has_background_color;
+
+  //! The packed background color (RGBA)
+  Uint32 background_color;
+};
+
+/*! The text texture cache class
+ * \details The cache stores the static textures created for text messages
+ * (see the StaticTexture text constructor). The textures are identified by
+ * the renderer, the message, the font (filename and size), the text color
+ * and the background color. When the memory used by the cached textures
+ * exceeds the memory budget the least recently used textures will be
+ * evicted.
+ */
+class TextTextureCache : public TextureCache<TextTextureCacheKey,StaticTexture>
+{
+
+public:
+
+  //! Constructor
+  TextTextureCache( const size_t memory_budget = s_default_memory_budget );
+
+  //! Destructor
+  ~TextTextureCache()
+  { /* ... */ }
+
+  //! Get the texture for a message (created if it has not been cached)
+  std::shared_ptr<StaticTexture> getTexture(
+			      const std::shared_ptr<Renderer>& renderer,
+			      const std::string& message,
+			      const Font& font,
+			      const SDL_Color& text_color,
+			      const SDL_Color* background_color = NULL );
+
+  //! Remove the textures of a font (filename and size) from the cache
+  void removeFont( const Font& font );
+
+private:
+
+  // The default memory budget (bytes)
+  static const size_t s_default_memory_budget;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_TEXT_TEXTURE_CACHE_HPP
+
+//---------------------------------------------------------------------------//
+// end TextTextureCache.hpp
+//---------------------------------------------------------------------------//
@@ -6,8 +6,12 @@
 //!
 //---------------------------------------------------------------------------//
 
+// Std Lib Includes
+#include <vector>
+
 // GDev Includes
 #include "Texture.hpp"
+#include "PixelFormatConverter.hpp"
 #include "ExceptionTestMacros.hpp"
 #include "DBCMacros.hpp"
 
@@ -19,11 +23,13 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
 		  const Uint32 format,
 		  const unsigned width,
 		  const unsigned height )
-  : d_texture( SDL_CreateTexture( renderer->getRawRendererPtr(),
-				  format,
-				  access,
-				  width,
-				  height ) ),
+  : d_texture( SDL_CreateTexture( 
+		      renderer->getRawRendererPtr(),
+		      format == SDL_PIXELFORMAT_UNKNOWN ?
+		      renderer->getNativeTextureFormat() : format,
+		      access,
+		      width,
+		      height ) ),
     d_width( width ),
     d_height( height ),
     d_format(),
@@ -32,7 +38,8 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
   // Make sure the renderer is valid
   testPrecondition( renderer );
   // Make sure the format is valid
-  testPrecondition( renderer->isValidTextureFormat( format ) );
+  testPrecondition( format == SDL_PIXELFORMAT_UNKNOWN ||
+		    renderer->isValidTextureFormat( format ) );
   // Make sure the access pattern is valid
   testPrecondition( access != SDL_TEXTUREACCESS_STATIC );
   // Make sure the texture size is valid
@@ -70,8 +77,7 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
   try{
     Surface shape_surface( area, inside_color, edge_color, outside_color );
     
-    d_texture = SDL_CreateTextureFromSurface(renderer->getRawRendererPtr(),
-					     shape_surface.getRawSurfacePtr());
+    d_texture = Texture::createTextureFromSurface( *renderer, shape_surface );
   }
   EXCEPTION_CATCH_RETHROW( ExceptionType,
 			   "Error: The texture could not be created!" );
@@ -89,9 +95,7 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
 // Surface constructor
 Texture::Texture( const std::shared_ptr<Renderer>& renderer,
 		  const Surface& surface )
-  : d_texture( SDL_CreateTextureFromSurface( 
-		    renderer->getRawRendererPtr(),
-		    const_cast<SDL_Surface*>( surface.getRawSurfacePtr() ) ) ),
+  : d_texture( Texture::createTextureFromSurface( *renderer, surface ) ),
     d_width( surface.getWidth() ),
     d_height( surface.getHeight() ),
     d_format(),
@@ -126,8 +130,7 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
   Surface tmp_surface( image_name );
 
   // Create the texture from the surface
-  d_texture = SDL_CreateTextureFromSurface( renderer->getRawRendererPtr(),
-					    tmp_surface.getRawSurfacePtr() );
+  d_texture = Texture::createTextureFromSurface( *renderer, tmp_surface );
 
   d_width = tmp_surface.getWidth();
   d_height = tmp_surface.getHeight();
@@ -160,8 +163,7 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
   Surface tmp_surface( message, font, text_color, background_color );
 
   // Create the texture from the surface
-  d_texture = SDL_CreateTextureFromSurface( renderer->getRawRendererPtr(),
-					    tmp_surface.getRawSurfacePtr() );
+  d_texture = Texture::createTextureFromSurface( *renderer, tmp_surface );
 
   d_width = tmp_surface.getWidth();
   d_height = tmp_surface.getHeight();
@@ -175,6 +177,50 @@ Texture::Texture( const std::shared_ptr<Renderer>& renderer,
   this->loadTextureFormat();
 }
 
+// Move constructor
+/*! \details The SDL texture and the renderer link are transferred. The 
+ * other texture will be empty (it can only be destroyed or assigned to).
+ */
+Texture::Texture( Texture&& other_texture )
+  : RenderableObject(),
+    d_texture( other_texture.d_texture ),
+    d_width( other_texture.d_width ),
+    d_height( other_texture.d_height ),
+    d_format( other_texture.d_format ),
+    d_renderer( std::move( other_texture.d_renderer ) )
+{
+  other_texture.d_texture = NULL;
+  other_texture.d_width = 0;
+  other_texture.d_height = 0;
+  other_texture.d_format = SDL_PIXELFORMAT_UNKNOWN;
+}
+
+// Move assignment operator
+/*! \details The current texture will be destroyed before the other texture
+ * is transferred. The renderer link is transferred with the texture (the
+ * textures do not need to use the same renderer).
+ */
+Texture& Texture::operator=( Texture&& other_texture )
+{
+  if( this != &other_texture )
+  {
+    this->free();
+
+    d_texture = other_texture.d_texture;
+    d_width = other_texture.d_width;
+    d_height = other_texture.d_height;
+    d_format = other_texture.d_format;
+    d_renderer = std::move( other_texture.d_renderer );
+
+    other_texture.d_texture = NULL;
+    other_texture.d_width = 0;
+    other_texture.d_height = 0;
+    other_texture.d_format = SDL_PIXELFORMAT_UNKNOWN;
+  }
+
+  return *this;
+}
+
 // Destructor
 Texture::~Texture()
 {
@@ -298,9 +344,56 @@ SDL_Texture* Texture::getRawTexturePtr()
   return d_texture;
 }
 
+// Update a section of the texture with the surface pixels
+/*! \details The surface will be copied to the texture section that starts 
+ * at the desired point. It will be converted to the texture format first if 
+ * necessary. This should not be used with a locked streaming texture.
+ */
+void Texture::update( const Surface& surface,
+		      const int x_position,
+		      const int y_position )
+{
+  // Make sure the section is valid
+  testPrecondition( x_position >= 0 );
+  testPrecondition( y_position >= 0 );
+  testPrecondition( x_position + surface.getWidth() <= d_width );
+  testPrecondition( y_position + surface.getHeight() <= d_height );
+
+  SDL_Rect section = {x_position,
+		      y_position,
+		      surface.getWidth(),
+		      surface.getHeight()};
+
+  int return_value;
+
+  if( surface.getPixelFormatValue() == d_format )
+  {
+    return_value = SDL_UpdateTexture( d_texture,
+				      &section,
+				      surface.getPixels(),
+				      surface.getPitch() );
+  }
+  else
+  {
+    Surface converted_surface( surface, d_format );
+
+    return_value = SDL_UpdateTexture( d_texture,
+				      &section,
+				      converted_surface.getPixels(),
+				      converted_surface.getPitch() );
+  }
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The texture could not be updated! "
+		      "SDL_Error: " << SDL_GetError() );
+}
+
 // Render the texture with default parameters
 void Texture::render() const
 {
+  d_renderer->recordDrawCall();
+
   int return_value = 
     SDL_RenderCopy( const_cast<SDL_Renderer*>(d_renderer->getRawRendererPtr()),
 		    const_cast<SDL_Texture*>(d_texture),
@@ -355,6 +448,8 @@ void Texture::render( const SDL_Rect* target_clip,
 		      const SDL_Point* rotation_center,
 		      const SDL_RendererFlip flip ) const
 {
+  d_renderer->recordDrawCall();
+
   int return_value = SDL_RenderCopyEx(
 		    const_cast<SDL_Renderer*>(d_renderer->getRawRendererPtr()),
 		    const_cast<SDL_Texture*>(d_texture),
@@ -382,10 +477,155 @@ Renderer& Texture::getRenderer()
   return *d_renderer;
 }
   
+// Create a texture from a surface in the native format of the renderer
+/*! \details The surface is converted to the native texture format of the
+ * renderer once (with the GDev::PixelFormatConverter) so that SDL can
+ * upload it without converting it again. The color key of indexed surfaces
+ * is converted to a transparent palette entry. The color key of ARGB8888,
+ * RGB888 and RGB24 surfaces is folded into the alpha channel when the
+ * native format is ARGB8888. Other color keyed surfaces and surfaces that
+ * the converter does not support are passed to SDL as they are (this is
+ * counted as a slow texture conversion by the renderer). NULL will be
+ * returned if the texture could not be created.
+ */
+SDL_Texture* Texture::createTextureFromSurface( Renderer& renderer,
+						const Surface& surface )
+{
+  SDL_Surface* raw_surface = 
+    const_cast<SDL_Surface*>( surface.getRawSurfacePtr() );
+
+  Uint32 color_key;
+  
+  const bool color_keyed = (SDL_GetColorKey( raw_surface, &color_key ) == 0);
+  
+  const Uint32 native_format = renderer.getNativeTextureFormat( 
+				raw_surface->format->Amask != 0 || color_keyed );
+
+  if( raw_surface->format->format == native_format && !color_keyed )
+  {
+    return SDL_CreateTextureFromSurface( renderer.getRawRendererPtr(),
+					 raw_surface );
+  }
+  else if( PixelFormatConverter::canConvert( *raw_surface, native_format ) )
+  {
+    Surface native_surface( surface, native_format );
+
+    // Keep the blend mode of the surface (it is copied to the texture)
+    native_surface.setBlendMode( surface.getBlendMode() );
+
+    return SDL_CreateTextureFromSurface( renderer.getRawRendererPtr(),
+					 native_surface.getRawSurfacePtr() );
+  }
+  // Convert the color key of indexed surfaces (e.g. solid text) to a 
+  // transparent palette entry
+  else if( color_keyed && 
+	   raw_surface->format->format == SDL_PIXELFORMAT_INDEX8 &&
+	   raw_surface->format->palette != NULL &&
+	   raw_surface->format->palette->ncolors > 0 &&
+	   !SDL_MUSTLOCK( raw_surface ) &&
+	   PixelFormatConverter::canConvert( SDL_PIXELFORMAT_INDEX8, 
+					     native_format ) &&
+	   SDL_ISPIXELFORMAT_ALPHA( native_format ) )
+  {
+    const SDL_Palette& palette = *raw_surface->format->palette;
+    
+    std::vector<SDL_Color> keyed_colors( palette.colors, 
+					 palette.colors + palette.ncolors );
+
+    if( color_key < keyed_colors.size() )
+      keyed_colors[color_key].a = 0;
+    
+    SDL_Palette keyed_palette = palette;
+    keyed_palette.colors = &keyed_colors[0];
+    
+    Surface native_surface( surface.getWidth(), 
+			    surface.getHeight(), 
+			    native_format );
+
+    PixelFormatConverter::convertRows( SDL_PIXELFORMAT_INDEX8,
+				       raw_surface->pixels,
+				       raw_surface->pitch,
+				       &keyed_palette,
+				       native_format,
+				       native_surface.getRawSurfacePtr()->pixels,
+				       native_surface.getPitch(),
+				       surface.getWidth(),
+				       surface.getHeight() );
+
+    Uint8 red_mod, green_mod, blue_mod;
+    surface.getColorMod( red_mod, green_mod, blue_mod );
+
+    native_surface.setColorMod( red_mod, green_mod, blue_mod );
+    native_surface.setAlphaMod( surface.getAlphaMod() );
+    native_surface.setBlendMode( SDL_BLENDMODE_BLEND );
+
+    return SDL_CreateTextureFromSurface( renderer.getRawRendererPtr(),
+					 native_surface.getRawSurfacePtr() );
+  }
+  // Fold the color key of 24 and 32 bit surfaces into the alpha channel
+  // (the color key of these formats has the RGB layout of ARGB8888)
+  else if( color_keyed &&
+	   (raw_surface->format->format == SDL_PIXELFORMAT_ARGB8888 ||
+	    raw_surface->format->format == SDL_PIXELFORMAT_RGB888 ||
+	    raw_surface->format->format == SDL_PIXELFORMAT_RGB24) &&
+	   !SDL_MUSTLOCK( raw_surface ) &&
+	   native_format == SDL_PIXELFORMAT_ARGB8888 )
+  {
+    Surface native_surface( surface.getWidth(),
+			    surface.getHeight(),
+			    native_format );
+
+    SDL_Surface* raw_native_surface = native_surface.getRawSurfacePtr();
+
+    PixelFormatConverter::convertRows( raw_surface->format->format,
+				       raw_surface->pixels,
+				       raw_surface->pitch,
+				       NULL,
+				       native_format,
+				       raw_native_surface->pixels,
+				       raw_native_surface->pitch,
+				       surface.getWidth(),
+				       surface.getHeight() );
+
+    const Uint32 key_color = color_key & 0x00FFFFFF;
+
+    for( int y = 0; y < surface.getHeight(); ++y )
+    {
+      Uint32* row = reinterpret_cast<Uint32*>(
+	       static_cast<Uint8*>( raw_native_surface->pixels ) +
+	       y*raw_native_surface->pitch );
+
+      for( int x = 0; x < surface.getWidth(); ++x )
+      {
+	if( (row[x] & 0x00FFFFFF) == key_color )
+	  row[x] = key_color;
+      }
+    }
+
+    Uint8 red_mod, green_mod, blue_mod;
+    surface.getColorMod( red_mod, green_mod, blue_mod );
+
+    native_surface.setColorMod( red_mod, green_mod, blue_mod );
+    native_surface.setAlphaMod( surface.getAlphaMod() );
+    native_surface.setBlendMode( SDL_BLENDMODE_BLEND );
+
+    return SDL_CreateTextureFromSurface( renderer.getRawRendererPtr(),
+					 raw_native_surface );
+  }
+  else
+  {
+    ++renderer.d_slow_texture_conversions;
+    
+    return SDL_CreateTextureFromSurface( renderer.getRawRendererPtr(),
+					 raw_surface );
+  }
+}
+
 // Free texture
 void Texture::free()
 {
-  SDL_DestroyTexture( d_texture );
+  if( d_texture != NULL )
+    SDL_DestroyTexture( d_texture );
   
   d_texture = NULL;
 
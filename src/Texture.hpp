@@ -44,11 +44,16 @@ public:
 };
 
 /*! The texture wrapper base class
- * \details The wrapper class does not allow copy construction or assignment.
- * If multiple "copies" are needed, use a smart pointer class.
+ * \details The wrapper class does not allow copy construction or assignment
+ * but the derived textures can be moved (the SDL texture and the renderer
+ * link are transferred). If multiple "copies" are needed, use a smart 
+ * pointer class.
  */
 class Texture : public RenderableObject, private boost::noncopyable
 {
+
+  // The registry replaces the renderer link of the textures it owns
+  friend class TextureRegistry;
   
 public:
 
@@ -94,6 +99,11 @@ public:
   //! Get the raw texture pointer (potentially dangerous)
   SDL_Texture* getRawTexturePtr();
 
+  //! Update a section of the texture with the surface pixels
+  void update( const Surface& surface,
+	       const int x_position = 0,
+	       const int y_position = 0 );
+
   //! Render the texture
   void render() const;
 
@@ -143,6 +153,12 @@ protected:
 	   const SDL_Color& text_color,
 	   const SDL_Color* background_color );
 
+  //! Move constructor
+  Texture( Texture&& other_texture );
+
+  //! Move assignment operator
+  Texture& operator=( Texture&& other_texture );
+
   //! Get the renderer
   const Renderer& getRenderer() const;
 
@@ -151,6 +167,10 @@ protected:
 
 private:
 
+  // Create a texture from a surface in the native format of the renderer
+  static SDL_Texture* createTextureFromSurface( Renderer& renderer,
+						const Surface& surface );
+
   // Free the texture
   void free();
 
@@ -0,0 +1,305 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureAtlas.cpp
+//! \author Alex Robinson
+//! \brief  The texture atlas class definition
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <algorithm>
+
+// GDev Includes
+#include "TextureAtlas.hpp"
+#include "TargetTexture.hpp"
+#include "StreamingTexture.hpp"
+#include "ExceptionTestMacros.hpp"
+#include "ExceptionCatchMacros.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const int TextureAtlas::s_default_page_size = 1024;
+
+// Constructor
+/*! \details The page size will be reduced to the max texture size of the
+ * renderer if necessary. If the format is unknown the native texture format
+ * of the renderer (with alpha) will be used so that the pages can be
+ * updated without conversions.
+ */
+TextureAtlas::TextureAtlas( const std::shared_ptr<Renderer>& renderer,
+			    const int page_width,
+			    const int page_height,
+			    const unsigned padding,
+			    const Uint32 format )
+  : d_renderer( renderer ),
+    d_page_width( page_width ),
+    d_page_height( page_height ),
+    d_padding( padding ),
+    d_format( format ),
+    d_pages(),
+    d_image_regions(),
+    d_number_of_regions( 0 ),
+    d_used_area( 0 )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+
+  if( d_format == SDL_PIXELFORMAT_UNKNOWN )
+    d_format = renderer->getNativeTextureFormat( true );
+
+  // Make sure the format is valid
+  testPrecondition( renderer->isValidTextureFormat( d_format ) );
+  // Make sure the page size is valid
+  testPrecondition( page_width > 0 );
+  testPrecondition( page_height > 0 );
+
+  d_page_width = std::min( d_page_width, renderer->getMaxTextureWidth() );
+  d_page_height = std::min( d_page_height, renderer->getMaxTextureHeight() );
+}
+
+// Get the page width
+int TextureAtlas::getPageWidth() const
+{
+  return d_page_width;
+}
+
+// Get the page height
+int TextureAtlas::getPageHeight() const
+{
+  return d_page_height;
+}
+
+// Get the padding between regions
+unsigned TextureAtlas::getPadding() const
+{
+  return d_padding;
+}
+
+// Get the page format
+Uint32 TextureAtlas::getFormat() const
+{
+  return d_format;
+}
+
+// Insert a surface
+/*! \details The surface will be placed in the first page that it fits in.
+ * If it does not fit in any page a new page will be created. The surface
+ * pixels are copied, so the surface can be freed after it is inserted.
+ */
+TextureRegion TextureAtlas::insert( const Surface& surface )
+{
+  const int max_width = d_renderer->getMaxTextureWidth();
+  const int max_height = d_renderer->getMaxTextureHeight();
+
+  // Make sure the surface fits in a texture
+  TEST_FOR_EXCEPTION( surface.getWidth() > max_width ||
+		      surface.getHeight() > max_height,
+		      ExceptionType,
+		      "Error: The surface (" << surface.getWidth() << "x"
+		      << surface.getHeight() << ") is larger than the max "
+		      "texture size (" << max_width << "x" << max_height
+		      << ")!" );
+
+  // Only pad the surface if the padded surface still fits in a texture
+  int insert_width = surface.getWidth() + d_padding;
+  int insert_height = surface.getHeight() + d_padding;
+
+  if( insert_width > max_width )
+    insert_width = surface.getWidth();
+
+  if( insert_height > max_height )
+    insert_height = surface.getHeight();
+
+  SDL_Rect placement;
+
+  unsigned page = 0;
+
+  while( page < d_pages.size() )
+  {
+    if( d_pages[page].packer.insert( insert_width, insert_height, placement ) )
+      break;
+
+    ++page;
+  }
+
+  // Create a new page
+  if( page == d_pages.size() )
+  {
+    this->createPage( std::max( d_page_width, insert_width ),
+		      std::max( d_page_height, insert_height ) );
+
+    d_pages.back().packer.insert( insert_width, insert_height, placement );
+  }
+
+  this->copySurfaceToPage( surface, d_pages[page], placement );
+
+  ++d_number_of_regions;
+  d_used_area += (unsigned long)surface.getWidth()*surface.getHeight();
+
+  placement.w = surface.getWidth();
+  placement.h = surface.getHeight();
+
+  return TextureRegion( d_pages[page].texture, placement );
+}
+
+// Insert an image (only loaded the first time it is inserted)
+TextureRegion TextureAtlas::insert( const std::string& image_name )
+{
+  std::map<std::string,TextureRegion>::const_iterator image_region =
+    d_image_regions.find( image_name );
+
+  if( image_region != d_image_regions.end() )
+    return image_region->second;
+  else
+  {
+    Surface image_surface( image_name );
+
+    TextureRegion region = this->insert( image_surface );
+
+    d_image_regions[image_name] = region;
+
+    return region;
+  }
+}
+
+// Check if an image has been inserted
+bool TextureAtlas::contains( const std::string& image_name ) const
+{
+  return d_image_regions.find( image_name ) != d_image_regions.end();
+}
+
+// Get the number of pages
+unsigned TextureAtlas::getNumberOfPages() const
+{
+  return d_pages.size();
+}
+
+// Get a page texture
+const std::shared_ptr<Texture>&
+TextureAtlas::getPage( const unsigned page ) const
+{
+  // Make sure the page is valid
+  testPrecondition( page < d_pages.size() );
+
+  return d_pages[page].texture;
+}
+
+// Get the fraction of a page that is used
+/*! \details The padding around the regions is counted as used.
+ */
+double TextureAtlas::getPageOccupancy( const unsigned page ) const
+{
+  // Make sure the page is valid
+  testPrecondition( page < d_pages.size() );
+
+  return d_pages[page].packer.getOccupancy();
+}
+
+// Get the number of regions
+unsigned TextureAtlas::getNumberOfRegions() const
+{
+  return d_number_of_regions;
+}
+
+// Get the area used by the regions (pixels, excluding padding)
+unsigned long TextureAtlas::getUsedArea() const
+{
+  return d_used_area;
+}
+
+// Get the total area of the pages (pixels)
+unsigned long TextureAtlas::getTotalArea() const
+{
+  unsigned long total_area = 0;
+
+  for( unsigned i = 0; i < d_pages.size(); ++i )
+  {
+    total_area += (unsigned long)d_pages[i].packer.getWidth()*
+      d_pages[i].packer.getHeight();
+  }
+
+  return total_area;
+}
+
+// Get the fraction of the total area that is used
+double TextureAtlas::getOccupancy() const
+{
+  unsigned long total_area = this->getTotalArea();
+
+  if( total_area > 0 )
+    return (double)d_used_area/total_area;
+  else
+    return 0.0;
+}
+
+// Create a new page
+/*! \details Target textures are used for the pages when the renderer
+ * supports them. Otherwise streaming textures are used. The page is cleared
+ * to transparent black.
+ */
+void TextureAtlas::createPage( const int width, const int height )
+{
+  std::shared_ptr<Texture> page_texture;
+
+  try{
+    if( d_renderer->isNonDefaultTargetSupported() )
+    {
+      page_texture.reset(
+		     new TargetTexture( d_renderer, width, height, d_format ) );
+    }
+    else
+    {
+      page_texture.reset(
+		  new StreamingTexture( d_renderer, width, height, d_format ) );
+    }
+
+    page_texture->setBlendMode( SDL_BLENDMODE_BLEND );
+
+    // Clear the page (blank surfaces are zero initialized)
+    Surface blank_surface( width, height, d_format );
+
+    page_texture->update( blank_surface );
+  }
+  EXCEPTION_CATCH_RETHROW_AS( std::runtime_error,
+			      ExceptionType,
+			      "Error: The texture atlas page could not be "
+			      "created!" );
+
+  d_pages.push_back( Page( page_texture, width, height ) );
+}
+
+// Copy a surface to a page
+/*! \details Color keyed surfaces are blitted to a blank surface first so
+ * that the color key becomes transparent.
+ */
+void TextureAtlas::copySurfaceToPage( const Surface& surface,
+				      Page& page,
+				      const SDL_Rect& placement )
+{
+  try{
+    if( surface.isColorKeySet() )
+    {
+      Surface keyed_surface( surface.getWidth(),
+			     surface.getHeight(),
+			     d_format );
+
+      surface.blitSurface( keyed_surface );
+
+      page.texture->update( keyed_surface, placement.x, placement.y );
+    }
+    else
+      page.texture->update( surface, placement.x, placement.y );
+  }
+  EXCEPTION_CATCH_RETHROW_AS( std::runtime_error,
+			      ExceptionType,
+			      "Error: The surface could not be copied to the "
+			      "texture atlas page!" );
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end TextureAtlas.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,182 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureAtlas.hpp
+//! \author Alex Robinson
+//! \brief  The texture atlas class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_TEXTURE_ATLAS_HPP
+#define GDEV_TEXTURE_ATLAS_HPP
+
+// Std Lib Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Renderer.hpp"
+#include "Surface.hpp"
+#include "Texture.hpp"
+#include "TextureRegion.hpp"
+#include "RectanglePacker.hpp"
+
+namespace GDev{
+
+//! The texture atlas exception class
+class TextureAtlasException : public std::runtime_error
+{
+public:
+  TextureAtlasException( const std::string& message )
+    : std::runtime_error( message )
+  { /* ... */ }
+
+  ~TextureAtlasException() throw()
+  { /* ... */ }
+};
+
+/*! The texture atlas class
+ * \details Surfaces (or images) that are inserted into the atlas are packed
+ * into one or more page textures. A texture region that refers to the
+ * packed surface is returned. Regions in the same page can be rendered
+ * without changing the texture (see SpriteBatch). The page size will never
+ * exceed the max texture size of the renderer. Surfaces that do not fit in
+ * a page of the default page size are given their own page. The regions are
+ * separated by transparent padding to prevent filtered sampling from
+ * bleeding into neighboring regions.
+ */
+class TextureAtlas : private boost::noncopyable
+{
+
+public:
+
+  //! The exception class
+  typedef TextureAtlasException ExceptionType;
+
+  //! Constructor
+  TextureAtlas( const std::shared_ptr<Renderer>& renderer,
+		const int page_width = s_default_page_size,
+		const int page_height = s_default_page_size,
+		const unsigned padding = 1u,
+		const Uint32 format = SDL_PIXELFORMAT_UNKNOWN );
+
+  //! Destructor
+  ~TextureAtlas()
+  { /* ... */ }
+
+  //! Get the page width
+  int getPageWidth() const;
+
+  //! Get the page height
+  int getPageHeight() const;
+
+  //! Get the padding between regions
+  unsigned getPadding() const;
+
+  //! Get the page format
+  Uint32 getFormat() const;
+
+  //! Insert a surface
+  TextureRegion insert( const Surface& surface );
+
+  //! Insert an image (only loaded the first time it is inserted)
+  TextureRegion insert( const std::string& image_name );
+
+  //! Check if an image has been inserted
+  bool contains( const std::string& image_name ) const;
+
+  //! Get the number of pages
+  unsigned getNumberOfPages() const;
+
+  //! Get a page texture
+  const std::shared_ptr<Texture>& getPage( const unsigned page ) const;
+
+  //! Get the fraction of a page that is used
+  double getPageOccupancy( const unsigned page ) const;
+
+  //! Get the number of regions
+  unsigned getNumberOfRegions() const;
+
+  //! Get the area used by the regions (pixels, excluding padding)
+  unsigned long getUsedArea() const;
+
+  //! Get the total area of the pages (pixels)
+  unsigned long getTotalArea() const;
+
+  //! Get the fraction of the total area that is used
+  double getOccupancy() const;
+
+private:
+
+  // The atlas page
+  struct Page
+  {
+    // Constructor
+    Page( const std::shared_ptr<Texture>& page_texture,
+	  const int width,
+	  const int height )
+      : texture( page_texture ),
+	packer( width, height )
+    { /* ... */ }
+
+    // The page texture
+    std::shared_ptr<Texture> texture;
+
+    // The page packer
+    RectanglePacker packer;
+  };
+
+  // Create a new page
+  void createPage( const int width, const int height );
+
+  // Copy a surface to a page
+  void copySurfaceToPage( const Surface& surface,
+			  Page& page,
+			  const SDL_Rect& placement );
+
+  // The default page size
+  static const int s_default_page_size;
+
+  // The renderer
+  std::shared_ptr<Renderer> d_renderer;
+
+  // The page width
+  int d_page_width;
+
+  // The page height
+  int d_page_height;
+
+  // The padding between regions
+  unsigned d_padding;
+
+  // The page format
+  Uint32 d_format;
+
+  // The pages
+  std::vector<Page> d_pages;
+
+  // The regions of the inserted images
+  std::map<std::string,TextureRegion> d_image_regions;
+
+  // The number of regions
+  unsigned d_number_of_regions;
+
+  // The area used by the regions
+  unsigned long d_used_area;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_TEXTURE_ATLAS_HPP
+
+//---------------------------------------------------------------------------//
+// end TextureAtlas.hpp
+//---------------------------------------------------------------------------//
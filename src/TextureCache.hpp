@@ -0,0 +1,323 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureCache.hpp
+//! \author Alex Robinson
+//! \brief  The texture cache class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_TEXTURE_CACHE_HPP
+#define GDEV_TEXTURE_CACHE_HPP
+
+// Std Lib Includes
+#include <list>
+#include <map>
+#include <memory>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+/*! The texture cache class
+ * \details The cache stores shared textures with a memory budget. When the
+ * memory used by the cached textures exceeds the memory budget the least
+ * recently used textures will be evicted. The key type must be less than
+ * comparable and the texture type must provide the width, height and format
+ * of the texture (see GDev::Texture).
+ */
+template<typename KeyType, typename TextureType>
+class TextureCache : private boost::noncopyable
+{
+
+public:
+
+  //! The cache key type
+  typedef KeyType Key;
+
+  //! Constructor
+  TextureCache( const size_t memory_budget );
+
+  //! Destructor
+  ~TextureCache()
+  { /* ... */ }
+
+  //! Get the memory budget (bytes)
+  size_t getMemoryBudget() const;
+
+  //! Set the memory budget (bytes)
+  void setMemoryBudget( const size_t memory_budget );
+
+  //! Get the memory used by the cached textures (bytes)
+  size_t getMemoryUsage() const;
+
+  //! Get the number of cached textures
+  unsigned getNumberOfTextures() const;
+
+  //! Get the number of cache hits
+  unsigned long getNumberOfHits() const;
+
+  //! Get the number of cache misses
+  unsigned long getNumberOfMisses() const;
+
+  //! Get the fraction of lookups that were hits
+  double getHitRate() const;
+
+  //! Reset the hit and miss counters
+  void resetCounters();
+
+  //! Find a cached texture (NULL if it has not been cached)
+  std::shared_ptr<TextureType> find( const Key& key );
+
+  //! Add a texture to the cache
+  void insert( const Key& key, const std::shared_ptr<TextureType>& texture );
+
+  //! Remove the textures with keys that satisfy the predicate
+  template<typename Predicate>
+  void removeIf( Predicate predicate );
+
+  //! Remove all textures from the cache
+  void clear();
+
+private:
+
+  // The cache entry
+  struct Entry
+  {
+    // The key of the entry
+    Key key;
+
+    // The cached texture
+    std::shared_ptr<TextureType> texture;
+
+    // The memory used by the texture (bytes)
+    size_t memory;
+  };
+
+  // The entry list type
+  typedef std::list<Entry> EntryList;
+
+  // The entry lookup table type
+  typedef std::map<Key,typename EntryList::iterator> EntryLookup;
+
+  // Evict the least recently used textures until the budget is respected
+  void evict( const size_t memory_budget );
+
+  // The memory budget
+  size_t d_memory_budget;
+
+  // The memory used by the cached textures
+  size_t d_memory_usage;
+
+  // The number of cache hits
+  unsigned long d_hits;
+
+  // The number of cache misses
+  unsigned long d_misses;
+
+  // The cache entries (most recently used first)
+  EntryList d_entries;
+
+  // The cache entry lookup table
+  EntryLookup d_entry_lookup;
+};
+
+// Constructor
+template<typename KeyType, typename TextureType>
+inline TextureCache<KeyType,TextureType>::TextureCache( 
+					       const size_t memory_budget )
+  : d_memory_budget( memory_budget ),
+    d_memory_usage( 0 ),
+    d_hits( 0 ),
+    d_misses( 0 ),
+    d_entries(),
+    d_entry_lookup()
+{ /* ... */ }
+
+// Get the memory budget (bytes)
+template<typename KeyType, typename TextureType>
+inline size_t TextureCache<KeyType,TextureType>::getMemoryBudget() const
+{
+  return d_memory_budget;
+}
+
+// Set the memory budget (bytes)
+/*! \details Cached textures will be evicted if the new budget is smaller
+ * than the memory that is currently used.
+ */
+template<typename KeyType, typename TextureType>
+inline void TextureCache<KeyType,TextureType>::setMemoryBudget( 
+					       const size_t memory_budget )
+{
+  d_memory_budget = memory_budget;
+
+  this->evict( d_memory_budget );
+}
+
+// Get the memory used by the cached textures (bytes)
+template<typename KeyType, typename TextureType>
+inline size_t TextureCache<KeyType,TextureType>::getMemoryUsage() const
+{
+  return d_memory_usage;
+}
+
+// Get the number of cached textures
+template<typename KeyType, typename TextureType>
+inline unsigned TextureCache<KeyType,TextureType>::getNumberOfTextures() const
+{
+  return d_entries.size();
+}
+
+// Get the number of cache hits
+template<typename KeyType, typename TextureType>
+inline unsigned long 
+TextureCache<KeyType,TextureType>::getNumberOfHits() const
+{
+  return d_hits;
+}
+
+// Get the number of cache misses
+template<typename KeyType, typename TextureType>
+inline unsigned long 
+TextureCache<KeyType,TextureType>::getNumberOfMisses() const
+{
+  return d_misses;
+}
+
+// Get the fraction of lookups that were hits
+template<typename KeyType, typename TextureType>
+inline double TextureCache<KeyType,TextureType>::getHitRate() const
+{
+  if( d_hits + d_misses > 0 )
+    return (double)d_hits/(d_hits + d_misses);
+  else
+    return 0.0;
+}
+
+// Reset the hit and miss counters
+template<typename KeyType, typename TextureType>
+inline void TextureCache<KeyType,TextureType>::resetCounters()
+{
+  d_hits = 0;
+  d_misses = 0;
+}
+
+// Find a cached texture (NULL if it has not been cached)
+/*! \details A found texture becomes the most recently used texture.
+ */
+template<typename KeyType, typename TextureType>
+inline std::shared_ptr<TextureType> 
+TextureCache<KeyType,TextureType>::find( const Key& key )
+{
+  typename EntryLookup::iterator lookup_it = d_entry_lookup.find( key );
+
+  if( lookup_it != d_entry_lookup.end() )
+  {
+    ++d_hits;
+
+    // Move the entry to the front of the list
+    d_entries.splice( d_entries.begin(), d_entries, lookup_it->second );
+
+    return lookup_it->second->texture;
+  }
+  else
+  {
+    ++d_misses;
+    
+    return std::shared_ptr<TextureType>();
+  }
+}
+
+// Add a texture to the cache
+/*! \details Textures that are larger than the memory budget will not be
+ * cached.
+ */
+template<typename KeyType, typename TextureType>
+inline void TextureCache<KeyType,TextureType>::insert( 
+			       const Key& key,
+			       const std::shared_ptr<TextureType>& texture )
+{
+  // Make sure the texture is valid
+  testPrecondition( texture );
+  // Make sure the texture has not been cached already
+  testPrecondition( d_entry_lookup.find( key ) == d_entry_lookup.end() );
+
+  size_t memory = (size_t)texture->getWidth()*texture->getHeight()*
+    SDL_BYTESPERPIXEL( texture->getFormat() );
+
+  if( memory <= d_memory_budget )
+  {
+    // Make room for the new texture
+    this->evict( d_memory_budget - memory );
+    
+    Entry entry = {key, texture, memory};
+
+    d_entries.push_front( entry );
+    
+    d_entry_lookup.insert( std::make_pair( key, d_entries.begin() ) );
+
+    d_memory_usage += memory;
+  }
+}
+
+// Remove the textures with keys that satisfy the predicate
+template<typename KeyType, typename TextureType>
+template<typename Predicate>
+inline void TextureCache<KeyType,TextureType>::removeIf( 
+						  Predicate predicate )
+{
+  typename EntryList::iterator entry = d_entries.begin();
+
+  while( entry != d_entries.end() )
+  {
+    if( predicate( entry->key ) )
+    {
+      d_memory_usage -= entry->memory;
+
+      d_entry_lookup.erase( entry->key );
+
+      entry = d_entries.erase( entry );
+    }
+    else
+      ++entry;
+  }
+}
+
+// Remove all textures from the cache
+template<typename KeyType, typename TextureType>
+inline void TextureCache<KeyType,TextureType>::clear()
+{
+  d_entry_lookup.clear();
+  d_entries.clear();
+
+  d_memory_usage = 0;
+}
+
+// Evict the least recently used textures until the budget is respected
+template<typename KeyType, typename TextureType>
+inline void TextureCache<KeyType,TextureType>::evict( 
+					       const size_t memory_budget )
+{
+  while( d_memory_usage > memory_budget )
+  {
+    d_memory_usage -= d_entries.back().memory;
+
+    d_entry_lookup.erase( d_entries.back().key );
+
+    d_entries.pop_back();
+  }
+}
+
+} // end GDev namespace
+
+#endif // end GDEV_TEXTURE_CACHE_HPP
+
+//---------------------------------------------------------------------------//
+// end TextureCache.hpp
+//---------------------------------------------------------------------------//
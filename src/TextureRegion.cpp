@@ -0,0 +1,150 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureRegion.cpp
+//! \author Alex Robinson
+//! \brief  The texture region class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "TextureRegion.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Default constructor (empty region)
+TextureRegion::TextureRegion()
+  : d_texture(),
+    d_clip()
+{
+  d_clip.x = 0;
+  d_clip.y = 0;
+  d_clip.w = 0;
+  d_clip.h = 0;
+}
+
+// Constructor
+TextureRegion::TextureRegion( const std::shared_ptr<Texture>& texture,
+			      const SDL_Rect& clip )
+  : d_texture( texture ),
+    d_clip( clip )
+{
+  // Make sure the texture is valid
+  testPrecondition( texture );
+  // Make sure the clip is valid
+  testPrecondition( clip.x >= 0 );
+  testPrecondition( clip.y >= 0 );
+  testPrecondition( clip.w > 0 );
+  testPrecondition( clip.h > 0 );
+  testPrecondition( clip.x + clip.w <= texture->getWidth() );
+  testPrecondition( clip.y + clip.h <= texture->getHeight() );
+}
+
+// Check if the region is empty
+bool TextureRegion::isEmpty() const
+{
+  return !d_texture;
+}
+
+// Get the width of the region
+int TextureRegion::getWidth() const
+{
+  return d_clip.w;
+}
+
+// Get the height of the region
+int TextureRegion::getHeight() const
+{
+  return d_clip.h;
+}
+
+// Get the clip of the region in the texture
+const SDL_Rect& TextureRegion::getClip() const
+{
+  return d_clip;
+}
+
+// Get the texture
+const std::shared_ptr<Texture>& TextureRegion::getTexture() const
+{
+  return d_texture;
+}
+
+// Convert a clip of the region to a clip of the texture
+/*! \details If the region clip is NULL the clip of the entire region will
+ * be returned.
+ */
+SDL_Rect TextureRegion::convertClip( const SDL_Rect* region_clip ) const
+{
+  if( region_clip == NULL )
+    return d_clip;
+  else
+  {
+    // Make sure the region clip is valid
+    testPrecondition( region_clip->x >= 0 );
+    testPrecondition( region_clip->y >= 0 );
+    testPrecondition( region_clip->x + region_clip->w <= d_clip.w );
+    testPrecondition( region_clip->y + region_clip->h <= d_clip.h );
+
+    SDL_Rect texture_clip = {d_clip.x + region_clip->x,
+			     d_clip.y + region_clip->y,
+			     region_clip->w,
+			     region_clip->h};
+
+    return texture_clip;
+  }
+}
+
+// Render the whole region clip at the desired point
+/*! \details The region clip is relative to the region. The rotation center
+ * is the point on the target around which the target clip will be rotated.
+ * The default is the center of the target.
+ */
+void TextureRegion::render( const int target_x_position,
+			    const int target_y_position,
+			    const SDL_Rect* region_clip,
+			    const double rotation_angle,
+			    const SDL_Point* rotation_center,
+			    const SDL_RendererFlip flip ) const
+{
+  // Make sure the region is not empty
+  testPrecondition( !this->isEmpty() );
+
+  SDL_Rect texture_clip = this->convertClip( region_clip );
+
+  d_texture->render( target_x_position,
+		     target_y_position,
+		     &texture_clip,
+		     rotation_angle,
+		     rotation_center,
+		     flip );
+}
+
+// Render the region
+/*! \details The region clip is relative to the region. The rotation center
+ * is the point on the target around which the target clip will be rotated.
+ * The default is the center of the target.
+ */
+void TextureRegion::render( const SDL_Rect* target_clip,
+			    const SDL_Rect* region_clip,
+			    const double rotation_angle,
+			    const SDL_Point* rotation_center,
+			    const SDL_RendererFlip flip ) const
+{
+  // Make sure the region is not empty
+  testPrecondition( !this->isEmpty() );
+
+  SDL_Rect texture_clip = this->convertClip( region_clip );
+
+  d_texture->render( target_clip,
+		     &texture_clip,
+		     rotation_angle,
+		     rotation_center,
+		     flip );
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end TextureRegion.cpp
+//---------------------------------------------------------------------------//
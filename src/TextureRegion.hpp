@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureRegion.hpp
+//! \author Alex Robinson
+//! \brief  The texture region class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_TEXTURE_REGION_HPP
+#define GDEV_TEXTURE_REGION_HPP
+
+// Std Lib Includes
+#include <memory>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+// GDev Includes
+#include "Texture.hpp"
+
+namespace GDev{
+
+/*! The texture region class
+ * \details A texture region is a lightweight handle to a rectangular region
+ * of a texture (e.g. an image in a texture atlas or a sprite in a sprite
+ * sheet). It can be copied freely. The region renders like a texture whose
+ * size is the size of the region. The texture will be kept alive as long as
+ * a region that refers to it exists.
+ */
+class TextureRegion
+{
+
+public:
+
+  //! Default constructor (empty region)
+  TextureRegion();
+
+  //! Constructor
+  TextureRegion( const std::shared_ptr<Texture>& texture,
+		 const SDL_Rect& clip );
+
+  //! Destructor
+  ~TextureRegion()
+  { /* ... */ }
+
+  //! Check if the region is empty
+  bool isEmpty() const;
+
+  //! Get the width of the region
+  int getWidth() const;
+
+  //! Get the height of the region
+  int getHeight() const;
+
+  //! Get the clip of the region in the texture
+  const SDL_Rect& getClip() const;
+
+  //! Get the texture
+  const std::shared_ptr<Texture>& getTexture() const;
+
+  //! Convert a clip of the region to a clip of the texture
+  SDL_Rect convertClip( const SDL_Rect* region_clip ) const;
+
+  //! Render the whole region clip at the desired point
+  void render( const int target_x_position,
+	       const int target_y_position,
+	       const SDL_Rect* region_clip = NULL,
+	       const double rotation_angle = 0.0,
+	       const SDL_Point* rotation_center = NULL,
+	       const SDL_RendererFlip flip = SDL_FLIP_NONE ) const;
+
+  //! Render the region
+  void render( const SDL_Rect* target_clip,
+	       const SDL_Rect* region_clip = NULL,
+	       const double rotation_angle = 0.0,
+	       const SDL_Point* rotation_center = NULL,
+	       const SDL_RendererFlip flip = SDL_FLIP_NONE ) const;
+
+private:
+
+  // The texture
+  std::shared_ptr<Texture> d_texture;
+
+  // The clip of the region in the texture
+  SDL_Rect d_clip;
+};
+
+} // end GDev namespace
+
+#endif // end GDEV_TEXTURE_REGION_HPP
+
+//---------------------------------------------------------------------------//
+// end TextureRegion.hpp
+//---------------------------------------------------------------------------//
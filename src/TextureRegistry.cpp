@@ -0,0 +1,227 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureRegistry.cpp
+//! \author Alex Robinson
+//! \brief  The texture registry class definition
+//!
+//---------------------------------------------------------------------------//
+
+// GDev Includes
+#include "TextureRegistry.hpp"
+#include "StaticTexture.hpp"
+#include "Surface.hpp"
+#include "ExceptionTestMacros.hpp"
+#include "DBCMacros.hpp"
+
+namespace GDev{
+
+// Initialize static member data
+const unsigned TextureRegistry::s_slot_index_bits = 20;
+
+// Constructor
+/*! \details The renderer will usually create the registry with a pointer
+ * that does not own it (the registered textures keep a copy of it).
+ */
+TextureRegistry::TextureRegistry( const std::shared_ptr<Renderer>& renderer )
+  : d_renderer( renderer ),
+    d_slots(),
+    d_free_slots(),
+    d_number_of_textures( 0u )
+{
+  // Make sure the renderer is valid
+  testPrecondition( renderer );
+}
+
+// Destructor
+TextureRegistry::~TextureRegistry()
+{ /* ... */ }
+
+// Add a texture (the registry takes ownership)
+/*! \details The texture must have been created with the registry renderer.
+ * The texture will refer to the renderer with the pointer of the registry
+ * (it will no longer keep the renderer alive). A free slot will be reused
+ * if there is one. The returned handle will be valid until the texture is
+ * removed.
+ */
+TextureHandle TextureRegistry::add( std::unique_ptr<Texture> texture )
+{
+  // Make sure the texture is valid
+  testPrecondition( texture.get() != NULL );
+  testPrecondition( texture->d_renderer.get() == d_renderer.get() );
+
+  unsigned slot_index;
+
+  if( d_free_slots.size() > 0 )
+  {
+    slot_index = d_free_slots.back();
+
+    d_free_slots.pop_back();
+  }
+  else
+  {
+    TEST_FOR_EXCEPTION( d_slots.size() >=
+			TextureRegistry::getMaxNumberOfTextures(),
+			Texture::ExceptionType,
+			"Error: The texture registry is full!" );
+
+    slot_index = d_slots.size();
+
+    d_slots.resize( d_slots.size() + 1 );
+    d_slots.back().generation = 1u;
+  }
+
+  texture->d_renderer = d_renderer;
+
+  d_slots[slot_index].texture = std::move( texture );
+
+  ++d_number_of_textures;
+
+  return TextureRegistry::createHandle( slot_index,
+					d_slots[slot_index].generation );
+}
+
+// Create a static texture from a surface
+TextureHandle TextureRegistry::create( const Surface& surface )
+{
+  return this->add( std::unique_ptr<Texture>(
+				     new StaticTexture( d_renderer, surface ) ) );
+}
+
+// Create a static texture from an image
+TextureHandle TextureRegistry::create( const std::string& image_name )
+{
+  return this->add( std::unique_ptr<Texture>(
+				  new StaticTexture( d_renderer, image_name ) ) );
+}
+
+// Check if a handle refers to a registered texture
+bool TextureRegistry::isValid( const TextureHandle handle ) const
+{
+  const unsigned slot_index = TextureRegistry::getSlotIndex( handle );
+
+  return slot_index < d_slots.size() &&
+    d_slots[slot_index].generation ==
+    TextureRegistry::getGeneration( handle ) &&
+    d_slots[slot_index].texture;
+}
+
+// Get a registered texture
+/*! \details The handle is only checked when design-by-contract checks are
+ * enabled (use find to check stale handles in all builds).
+ */
+const Texture& TextureRegistry::get( const TextureHandle handle ) const
+{
+  // Make sure the handle is valid
+  testPrecondition( this->isValid( handle ) );
+
+  return *d_slots[TextureRegistry::getSlotIndex( handle )].texture;
+}
+
+// Get a registered texture
+/*! \details The handle is only checked when design-by-contract checks are
+ * enabled (use find to check stale handles in all builds).
+ */
+Texture& TextureRegistry::get( const TextureHandle handle )
+{
+  // Make sure the handle is valid
+  testPrecondition( this->isValid( handle ) );
+
+  return *d_slots[TextureRegistry::getSlotIndex( handle )].texture;
+}
+
+// Find a registered texture (NULL if the handle is stale)
+const Texture* TextureRegistry::find( const TextureHandle handle ) const
+{
+  if( this->isValid( handle ) )
+    return d_slots[TextureRegistry::getSlotIndex( handle )].texture.get();
+  else
+    return NULL;
+}
+
+// Find a registered texture (NULL if the handle is stale)
+Texture* TextureRegistry::find( const TextureHandle handle )
+{
+  if( this->isValid( handle ) )
+    return d_slots[TextureRegistry::getSlotIndex( handle )].texture.get();
+  else
+    return NULL;
+}
+
+// Remove a texture
+/*! \details The texture will be destroyed and every handle to it will
+ * become stale. Stale handles are ignored.
+ */
+void TextureRegistry::remove( const TextureHandle handle )
+{
+  if( !this->isValid( handle ) )
+    return;
+
+  const unsigned slot_index = TextureRegistry::getSlotIndex( handle );
+
+  Slot& slot = d_slots[slot_index];
+
+  slot.texture.reset();
+
+  // Generation zero is skipped so that the null handle is never valid
+  slot.generation = (slot.generation + 1) &
+    ((1u << (32 - s_slot_index_bits)) - 1);
+
+  if( slot.generation == 0u )
+    slot.generation = 1u;
+
+  d_free_slots.push_back( slot_index );
+
+  --d_number_of_textures;
+}
+
+// Remove all textures
+/*! \details Every handle will become stale.
+ */
+void TextureRegistry::clear()
+{
+  for( unsigned i = 0; i < d_slots.size(); ++i )
+  {
+    if( d_slots[i].texture )
+    {
+      this->remove( TextureRegistry::createHandle( i,
+						   d_slots[i].generation ) );
+    }
+  }
+}
+
+// Get the number of registered textures
+unsigned TextureRegistry::getNumberOfTextures() const
+{
+  return d_number_of_textures;
+}
+
+// Get the max number of textures that can be registered
+unsigned TextureRegistry::getMaxNumberOfTextures()
+{
+  return 1u << s_slot_index_bits;
+}
+
+// Get the slot index of a handle
+unsigned TextureRegistry::getSlotIndex( const TextureHandle handle )
+{
+  return handle & ((1u << s_slot_index_bits) - 1);
+}
+
+// Get the generation of a handle
+unsigned TextureRegistry::getGeneration( const TextureHandle handle )
+{
+  return handle >> s_slot_index_bits;
+}
+
+// Create a handle
+TextureHandle TextureRegistry::createHandle( const unsigned slot_index,
+					     const unsigned generation )
+{
+  return (generation << s_slot_index_bits) | slot_index;
+}
+
+} // end GDev namespace
+
+//---------------------------------------------------------------------------//
+// end TextureRegistry.cpp
+//---------------------------------------------------------------------------//
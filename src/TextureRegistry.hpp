@@ -0,0 +1,160 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   TextureRegistry.hpp
+//! \author Alex Robinson
+//! \brief  The texture registry class declaration
+//!
+//---------------------------------------------------------------------------//
+
+#ifndef GDEV_TEXTURE_REGISTRY_HPP
+#define GDEV_TEXTURE_REGISTRY_HPP
+
+// Std Lib Includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+// Boost Includes
+#include <boost/core/noncopyable.hpp>
+
+// SDL Includes
+#include <SDL2/SDL.h>
+
+namespace GDev{
+
+// Forward declare the renderer, texture and surface classes
+class Renderer;
+class Texture;
+class Surface;
+
+//! The texture handle (generation in the high bits, slot in the low bits)
+typedef Uint32 TextureHandle;
+
+//! The null texture handle (never valid)
+const TextureHandle NULL_TEXTURE_HANDLE = 0;
+
+/*! The texture registry class
+ * \details The registry is owned by a renderer and stores textures that
+ * are referred to with 32 bit generational handles instead of shared
+ * pointers. The registry owns its textures: the slots are stored in a dense
+ * array and a handle is resolved with an index and a generation check. When
+ * a texture is removed the generation of its slot is incremented so that
+ * stale handles are detected (find returns NULL; get checks the handle when
+ * design-by-contract checks are enabled). The registered textures refer to
+ * the renderer without owning it (the registry is cleared before the
+ * renderer is destroyed).
+ */
+class TextureRegistry : private boost::noncopyable
+{
+
+public:
+
+  //! Constructor (the renderer pointer must not own the renderer)
+  TextureRegistry( const std::shared_ptr<Renderer>& renderer );
+
+  //! Destructor
+  ~TextureRegistry();
+
+  //! Add a texture (the registry takes ownership)
+  TextureHandle add( std::unique_ptr<Texture> texture );
+
+  //! Add a texture (the texture is moved into the registry)
+  template<typename TextureType>
+  typename std::enable_if<std::is_base_of<Texture,TextureType>::value &&
+			  !std::is_reference<TextureType>::value,
+			  TextureHandle>::type
+  add( TextureType&& texture );
+
+  //! Create a static texture from a surface
+  TextureHandle create( const Surface& surface );
+
+  //! Create a static texture from an image
+  TextureHandle create( const std::string& image_name );
+
+  //! Check if a handle refers to a registered texture
+  bool isValid( const TextureHandle handle ) const;
+
+  //! Get a registered texture
+  const Texture& get( const TextureHandle handle ) const;
+
+  //! Get a registered texture
+  Texture& get( const TextureHandle handle );
+
+  //! Find a registered texture (NULL if the handle is stale)
+  const Texture* find( const TextureHandle handle ) const;
+
+  //! Find a registered texture (NULL if the handle is stale)
+  Texture* find( const TextureHandle handle );
+
+  //! Remove a texture
+  void remove( const TextureHandle handle );
+
+  //! Remove all textures
+  void clear();
+
+  //! Get the number of registered textures
+  unsigned getNumberOfTextures() const;
+
+  //! Get the max number of textures that can be registered
+  static unsigned getMaxNumberOfTextures();
+
+  //! Get the slot index of a handle
+  static unsigned getSlotIndex( const TextureHandle handle );
+
+  //! Get the generation of a handle
+  static unsigned getGeneration( const TextureHandle handle );
+
+private:
+
+  // The texture slot
+  struct Slot
+  {
+    // The texture (NULL if the slot is free)
+    std::unique_ptr<Texture> texture;
+
+    // The generation of the slot
+    unsigned generation;
+  };
+
+  // Create a handle
+  static TextureHandle createHandle( const unsigned slot_index,
+				     const unsigned generation );
+
+  // The number of bits used for the slot index
+  static const unsigned s_slot_index_bits;
+
+  // The renderer (not owned)
+  std::shared_ptr<Renderer> d_renderer;
+
+  // The slots
+  std::vector<Slot> d_slots;
+
+  // The free slot indices
+  std::vector<unsigned> d_free_slots;
+
+  // The number of registered textures
+  unsigned d_number_of_textures;
+};
+
+// Add a texture (the texture is moved into the registry)
+/*! \details Only rvalues are accepted (use std::move).
+ */
+template<typename TextureType>
+inline typename std::enable_if<std::is_base_of<Texture,TextureType>::value &&
+			       !std::is_reference<TextureType>::value,
+			       TextureHandle>::type
+TextureRegistry::add( TextureType&& texture )
+{
+  return this->add( std::unique_ptr<Texture>( 
+				new TextureType( std::move( texture ) ) ) );
+}
+
+} // end GDev namespace
+
+#endif // end GDEV_TEXTURE_REGISTRY_HPP
+
+//---------------------------------------------------------------------------//
+// end TextureRegistry.hpp
+//---------------------------------------------------------------------------//
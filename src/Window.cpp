@@ -43,6 +43,38 @@ Window::Window( const std::string& window_title,
   //			     new Surface( SDL_GetWindowSurface( d_window ) ) );
 }
 
+// Move constructor
+/*! \details The other window will be empty (it can only be destroyed or
+ * assigned to).
+ */
+Window::Window( Window&& other_window )
+  : d_window( other_window.d_window ),
+    d_window_surface_wrapper( 
+			 std::move( other_window.d_window_surface_wrapper ) )
+{
+  other_window.d_window = NULL;
+}
+
+// Move assignment operator
+/*! \details The current window will be destroyed before the other window
+ * is transferred.
+ */
+Window& Window::operator=( Window&& other_window )
+{
+  if( this != &other_window )
+  {
+    this->free();
+
+    d_window = other_window.d_window;
+    d_window_surface_wrapper = 
+      std::move( other_window.d_window_surface_wrapper );
+
+    other_window.d_window = NULL;
+  }
+
+  return *this;
+}
+
 // Destructor
 Window::~Window()
 {
@@ -285,35 +317,45 @@ bool Window::isMouseConfinedToWindow() const
 }
 
 // Update the screen (copy window surface to screen)
-//void Window::updateWindowSurface()
-//{
-//  int return_value = SDL_UpdateWindowSurface( d_window );
-//
-//  TEST_FOR_EXCEPTION( return_value != 0,
-//		      ExceptionType,
-//		      "Error: The window surface could not be updated! "
-//		      "SDL_Error: " << SDL_GetError() );
-//}
+/*! \details This should only be used when the window is drawn with a 
+ * software renderer (the window surface is the rendering target).
+ */
+void Window::updateWindowSurface()
+{
+  int return_value = SDL_UpdateWindowSurface( d_window );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The window surface could not be updated! "
+		      "SDL_Error: " << SDL_GetError() );
+}
 
 // Update the screen (copy areas of the window surface to the screen)
-//void Window::updateWindowSurface( const std::vector<SDL_Rect>& update_areas )
-//{
-//  int return_value = SDL_UpdateWindowSurfaceRects( d_window,
-//						   &update_areas[0],
-//						   update_areas.size() );
-//
-//  TEST_FOR_EXCEPTION( return_value != 0,
-//		      ExceptionType,
-//		      "Error: The window surface areas could not be updated! "
-//		      "SDL_Error: " << SDL_GetError() );
-//}
+/*! \details This should only be used when the window is drawn with a 
+ * software renderer (the window surface is the rendering target).
+ */
+void Window::updateWindowSurface( const std::vector<SDL_Rect>& update_areas )
+{
+  // Make sure there is at least one area
+  testPrecondition( update_areas.size() > 0 );
+  
+  int return_value = SDL_UpdateWindowSurfaceRects( d_window,
+						   &update_areas[0],
+						   update_areas.size() );
+
+  TEST_FOR_EXCEPTION( return_value != 0,
+		      ExceptionType,
+		      "Error: The window surface areas could not be updated! "
+		      "SDL_Error: " << SDL_GetError() );
+}
 
 // Free the window
 void Window::free()
 {
   d_window_surface_wrapper.reset();
   
-  SDL_DestroyWindow( d_window );
+  if( d_window != NULL )
+    SDL_DestroyWindow( d_window );
 
   d_window = NULL;
 }
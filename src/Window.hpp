@@ -39,8 +39,9 @@ public:
 };
 
 /*! The window wrapper class
- * \details The wrapper class does not allow copy construction or assignment.
- * If multiple "copies" are needed, use a smart pointer class. Note: The
+ * \details The wrapper class does not allow copy construction or assignment
+ * but windows can be moved (the SDL window is transferred). If multiple 
+ * "copies" are needed, use a smart pointer class. Note: The
  * window surface cannot be returned because window rendering will not
  * work after SDL_GetWindowSurface is called!
  */
@@ -60,6 +61,12 @@ public:
 	  const int height,
 	  const Uint32 window_flags = SDL_WINDOW_SHOWN );
 
+  //! Move constructor
+  Window( Window&& other_window );
+
+  //! Move assignment operator
+  Window& operator=( Window&& other_window );
+
   //! Destructor
   ~Window();
 
@@ -160,10 +167,10 @@ public:
   bool isMouseConfinedToWindow() const;
 
   //! Update the window surface (copy window surface to screen)
-  //void updateWindowSurface();
+  void updateWindowSurface();
 
   //! Update the screen (copy areas of the window surface to the screen)
-  //void updateWindowSurface( const std::vector<SDL_Rect>& update_areas );
+  void updateWindowSurface( const std::vector<SDL_Rect>& update_areas );
 
 private:
  
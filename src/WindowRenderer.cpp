@@ -9,6 +9,7 @@
 // GDev Includes
 #include "WindowRenderer.hpp"
 #include "ExceptionTestMacros.hpp"
+#include "ExceptionCatchMacros.hpp"
 #include "DBCMacros.hpp"
 
 namespace GDev{
@@ -32,6 +33,36 @@ void WindowRenderer::resetViewport()
   this->setViewport( viewport );
 }
 
+// Check if areas of the drawing can be presented
+/*! \details Only the software renderer draws to the window surface
+ * directly. Accelerated renderers may discard the drawing once it has been
+ * presented, so the entire drawing must always be presented.
+ */
+bool WindowRenderer::isPartialPresentSupported() const
+{
+  return this->getSupportedFlags() & SDL_RENDERER_SOFTWARE;
+}
+
+// Present areas of the drawing
+/*! \details The areas of the window surface will be copied to the screen
+ * when the software renderer is used. 
+ */
+void WindowRenderer::presentAreas( const std::vector<SDL_Rect>& areas )
+{
+  if( this->isPartialPresentSupported() )
+  {
+    try{
+      d_window->updateWindowSurface( areas );
+    }
+    EXCEPTION_CATCH_RETHROW_AS( Window::ExceptionType,
+				ExceptionType,
+				"Error: The window areas could not be "
+				"presented!" );
+  }
+  else
+    this->present();
+}
+
 } // end GDev namespace
 
 //---------------------------------------------------------------------------//
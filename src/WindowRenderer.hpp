@@ -28,7 +28,8 @@ namespace GDev{
  * \details The wrapper class does not allow copy construction or assignment.
  * If multiple "copies" are needed, use a smart pointer class. This class
  * will store a copy of the window pointer to prevent the window from being
- * closed until the renderer is deleted.
+ * closed until the renderer is deleted. Unlike the window, the renderer
+ * cannot be moved: textures and caches refer to their renderer by address.
  */
 class WindowRenderer : public Renderer, private boost::noncopyable
 {
@@ -47,6 +48,14 @@ public:
   //! Reset the viewport to the entire target
   void resetViewport();
 
+  //! Check if areas of the drawing can be presented
+  bool isPartialPresentSupported() const;
+
+protected:
+
+  //! Present areas of the drawing
+  void presentAreas( const std::vector<SDL_Rect>& areas );
+
 private:
 
   // Do not allow default construction
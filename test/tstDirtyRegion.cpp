@@ -0,0 +1,227 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstDirtyRegion.cpp
+//! \author Alex Robinson
+//! \brief  The dirty region class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "DirtyRegion.hpp"
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the dirty region can be constructed
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  BOOST_CHECK_EQUAL( region.getWidth(), 800 );
+  BOOST_CHECK_EQUAL( region.getHeight(), 600 );
+  BOOST_CHECK_EQUAL( region.getFullFrameThreshold(), 0.5 );
+  BOOST_CHECK( region.isEmpty() );
+  BOOST_CHECK( !region.isFullFrame() );
+  BOOST_CHECK_EQUAL( region.getArea(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that areas can be invalidated
+BOOST_AUTO_TEST_CASE( invalidate )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  SDL_Rect area = {10, 10, 100, 50};
+
+  region.invalidate( area );
+
+  BOOST_CHECK( !region.isEmpty() );
+  BOOST_CHECK( !region.isFullFrame() );
+  BOOST_REQUIRE_EQUAL( region.getRectangles().size(), 1 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].x, 10 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].y, 10 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].w, 100 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].h, 50 );
+  BOOST_CHECK_EQUAL( region.getArea(), 5000 );
+
+  // Areas outside of the target are ignored
+  SDL_Rect outside_area = {900, 10, 100, 50};
+
+  region.invalidate( outside_area );
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 1 );
+
+  // Areas are clipped to the target
+  SDL_Rect partial_area = {750, 580, 100, 50};
+
+  region.invalidate( partial_area );
+
+  BOOST_REQUIRE_EQUAL( region.getRectangles().size(), 2 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[1].w, 50 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[1].h, 20 );
+
+  region.clear();
+
+  BOOST_CHECK( region.isEmpty() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that invalidated areas are merged
+BOOST_AUTO_TEST_CASE( invalidate_merge )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  // Adjacent areas are merged
+  SDL_Rect left_area = {0, 0, 10, 10};
+  SDL_Rect right_area = {10, 0, 10, 10};
+
+  region.invalidate( left_area );
+  region.invalidate( right_area );
+
+  BOOST_REQUIRE_EQUAL( region.getRectangles().size(), 1 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].w, 20 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].h, 10 );
+
+  // Contained areas are merged
+  SDL_Rect inner_area = {5, 2, 5, 5};
+
+  region.invalidate( inner_area );
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 1 );
+  BOOST_CHECK_EQUAL( region.getArea(), 200 );
+
+  // Distant areas are not merged
+  SDL_Rect distant_area = {400, 400, 10, 10};
+
+  region.invalidate( distant_area );
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 2 );
+
+  // An area that joins two areas is merged with both
+  SDL_Rect first_area = {100, 100, 10, 10};
+  SDL_Rect second_area = {120, 100, 10, 10};
+  SDL_Rect joining_area = {110, 100, 10, 10};
+
+  region.invalidate( first_area );
+  region.invalidate( second_area );
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 4 );
+
+  region.invalidate( joining_area );
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 3 );
+  BOOST_CHECK_EQUAL( region.getArea(), 200+100+300 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the max number of rectangles is respected
+BOOST_AUTO_TEST_CASE( invalidate_max_rectangles )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  region.setMaxNumberOfRectangles( 4 );
+
+  BOOST_CHECK_EQUAL( region.getMaxNumberOfRectangles(), 4 );
+
+  for( int i = 0; i < 10; ++i )
+  {
+    SDL_Rect area = {i*50, i*50, 5, 5};
+
+    region.invalidate( area );
+  }
+
+  BOOST_CHECK_EQUAL( region.getRectangles().size(), 4 );
+
+  // Every invalidated area must still be covered
+  for( int i = 0; i < 10; ++i )
+  {
+    SDL_Rect area = {i*50, i*50, 5, 5};
+
+    BOOST_CHECK( region.intersects( area ) );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the entire target is invalidated above the threshold
+BOOST_AUTO_TEST_CASE( invalidate_full_frame )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  region.setFullFrameThreshold( 0.25 );
+
+  BOOST_CHECK_EQUAL( region.getFullFrameThreshold(), 0.25 );
+
+  SDL_Rect area = {0, 0, 400, 300};
+
+  region.invalidate( area );
+
+  BOOST_CHECK( !region.isFullFrame() );
+
+  SDL_Rect small_area = {600, 500, 10, 10};
+
+  region.invalidate( small_area );
+
+  BOOST_CHECK( region.isFullFrame() );
+  BOOST_REQUIRE_EQUAL( region.getRectangles().size(), 1 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].w, 800 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].h, 600 );
+  BOOST_CHECK_EQUAL( region.getArea(), 800*600 );
+
+  region.clear();
+
+  BOOST_CHECK( !region.isFullFrame() );
+
+  region.invalidateAll();
+
+  BOOST_CHECK( region.isFullFrame() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that resizing the target invalidates the entire target
+BOOST_AUTO_TEST_CASE( setSize )
+{
+  GDev::DirtyRegion region;
+
+  region.setSize( 800, 600 );
+
+  BOOST_CHECK( region.isFullFrame() );
+
+  region.clear();
+  region.setSize( 800, 600 );
+
+  BOOST_CHECK( region.isEmpty() );
+
+  region.setSize( 640, 480 );
+
+  BOOST_CHECK( region.isFullFrame() );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].w, 640 );
+  BOOST_CHECK_EQUAL( region.getRectangles()[0].h, 480 );
+}
+
+//---------------------------------------------------------------------------//
+// Check if an area intersects the region
+BOOST_AUTO_TEST_CASE( intersects )
+{
+  GDev::DirtyRegion region( 800, 600 );
+
+  SDL_Rect area = {10, 10, 100, 50};
+
+  region.invalidate( area );
+
+  SDL_Rect overlapping_area = {100, 50, 20, 20};
+  SDL_Rect separate_area = {110, 10, 20, 20};
+
+  BOOST_CHECK( region.intersects( overlapping_area ) );
+  BOOST_CHECK( !region.intersects( separate_area ) );
+}
+
+//---------------------------------------------------------------------------//
+// end tstDirtyRegion.cpp
+//---------------------------------------------------------------------------//
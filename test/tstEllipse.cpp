@@ -10,6 +10,8 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
+#include <cmath>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -17,7 +19,37 @@
 
 // GDev Includes
 #include "Ellipse.hpp"
+#include "SurfaceBlitter.hpp"
 
+//---------------------------------------------------------------------------//
+// Testing functions.
+//---------------------------------------------------------------------------//
+// Check if a point is within rounding error of one of the ellipse boundaries
+bool isPointNearBoundary( const GDev::Shape& shape, const int x, const int y )
+{
+  GDev::ShapeGeometry geometry;
+  shape.getGeometry( geometry );
+
+  const double x_offset = x - shape.getCenterXPosition();
+  const double y_offset = y - shape.getCenterYPosition();
+
+  double x_term = x_offset/geometry[0];
+  double y_term = y_offset/geometry[1];
+
+  bool near_boundary = 
+    std::fabs( x_term*x_term + y_term*y_term - 1.0 ) < 1e-12;
+
+  if( geometry[2] > 0 )
+  {
+    x_term = x_offset/(geometry[0] - geometry[2]);
+    y_term = y_offset/(geometry[1] - geometry[2]);
+
+    near_boundary = near_boundary ||
+      std::fabs( x_term*x_term + y_term*y_term - 1.0 ) < 1e-12;
+  }
+
+  return near_boundary;
+}
 
 //---------------------------------------------------------------------------//
 // Tests.
@@ -191,6 +223,252 @@ BOOST_AUTO_TEST_CASE( isPointOn )
   BOOST_CHECK( !shape->isPointOn( 100, 101 ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the boundary points agree with the ellipse equation
+BOOST_AUTO_TEST_CASE( isPointIn_isPointOn_boundary )
+{
+  // The x and y terms of this point sum to one after rounding
+  GDev::Ellipse ellipse( 0, 0, 13, 78 );
+
+  BOOST_CHECK( !ellipse.isPointIn( 5, 72 ) );
+  BOOST_CHECK( !ellipse.isPointIn( -5, -72 ) );
+  BOOST_CHECK( ellipse.isPointIn( 5, 71 ) );
+
+  for( int x_axis_size = 1; x_axis_size <= 40; ++x_axis_size )
+  {
+    for( int y_axis_size = 1; y_axis_size <= 80; ++y_axis_size )
+    {
+      const unsigned edge_thickness = (x_axis_size + y_axis_size)%5;
+      
+      GDev::Ellipse ellipse( 0, 0, x_axis_size, y_axis_size, edge_thickness );
+
+      for( int y = -y_axis_size; y <= y_axis_size; ++y )
+      {
+	for( int x = -x_axis_size; x <= x_axis_size; ++x )
+	{
+	  double x_term = (double)x/x_axis_size;
+	  x_term *= x_term;
+
+	  double y_term = (double)y/y_axis_size;
+	  y_term *= y_term;
+
+	  const bool is_in = !(x_term + y_term - 1.0 > 0.0);
+
+	  x_term = (double)x/(x_axis_size - edge_thickness);
+	  x_term *= x_term;
+
+	  y_term = (double)y/(y_axis_size - edge_thickness);
+	  y_term *= y_term;
+
+	  const bool is_on = edge_thickness > 0u && is_in &&
+	    !(x_term + y_term - 1.0 < 0.0);
+
+	  BOOST_REQUIRE_EQUAL( ellipse.isPointIn( x, y ), is_in );
+	  BOOST_REQUIRE_EQUAL( ellipse.isPointOn( x, y ), is_on );
+	}
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the row spans agree with isPointOn and isPointIn
+BOOST_AUTO_TEST_CASE( getRowSpans )
+{
+  std::vector<std::shared_ptr<GDev::Shape> > shapes;
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 100, 50, 100, 50 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 100, 50, 100, 50, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 0, 0, 7, 3, 1 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( -20, 30, 10, 5, 5 ) ) );
+
+  std::vector<GDev::ShapeSpan> spans;
+
+  for( unsigned i = 0; i < shapes.size(); ++i )
+  {
+    const GDev::Shape& shape = *shapes[i];
+    
+    for( int y = shape.getBoundingBoxYPosition(); 
+	 y < shape.getBoundingBoxYPosition()+shape.getBoundingBoxHeight(); 
+	 ++y )
+    {
+      shape.getRowSpans( y, spans );
+
+      int x = shape.getBoundingBoxXPosition();
+
+      for( unsigned j = 0; j < spans.size(); ++j )
+      {
+	BOOST_REQUIRE_EQUAL( spans[j].x_position, x );
+	BOOST_REQUIRE( spans[j].length > 0 );
+
+	if( j > 0 )
+	  BOOST_CHECK( spans[j].coverage != spans[j-1].coverage );
+
+	for( int k = 0; k < spans[j].length; ++k, ++x )
+	{
+	  GDev::ShapeCoverage coverage;
+
+	  if( shape.isPointOn( x, y ) )
+	    coverage = GDev::ON_SHAPE_EDGE;
+	  else if( shape.isPointIn( x, y ) )
+	    coverage = GDev::INSIDE_SHAPE;
+	  else
+	    coverage = GDev::OUTSIDE_SHAPE;
+
+	  BOOST_REQUIRE_EQUAL( spans[j].coverage, coverage );
+	}
+      }
+
+      BOOST_CHECK_EQUAL( x, shape.getBoundingBoxXPosition() + 
+			 shape.getBoundingBoxWidth() );
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the batched point queries agree with isPointIn and isPointOn
+// (except within rounding error of the boundaries) and that every kernel
+// returns identical results
+BOOST_AUTO_TEST_CASE( arePointsIn_arePointsOn )
+{
+  std::vector<std::shared_ptr<GDev::Shape> > shapes;
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 100, 50, 100, 50 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 100, 50, 100, 50, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 0, 0, 7, 3, 1 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( -20, 30, 10, 5, 5 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 5, 5, 3, 4, 7 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 0, 0, 4, 6, 4 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Ellipse( 0, 0, 13, 78, 3 ) ) );
+
+  std::vector<GDev::Shape::Kernel> kernels;
+  kernels.push_back( GDev::SCALAR_KERNEL );
+  kernels.push_back( GDev::SSE2_KERNEL );
+  kernels.push_back( GDev::AVX2_KERNEL );
+
+  const GDev::Shape::Kernel default_kernel = GDev::Shape::getKernel();
+
+  for( unsigned i = 0; i < shapes.size(); ++i )
+  {
+    const GDev::Shape& shape = *shapes[i];
+
+    // Test every point in (and around) the bounding box
+    std::vector<int> x_positions, y_positions;
+
+    for( int y = shape.getBoundingBoxYPosition() - 2;
+	 y <= shape.getBoundingBoxYPosition()+shape.getBoundingBoxHeight()+2;
+	 ++y )
+    {
+      for( int x = shape.getBoundingBoxXPosition() - 2;
+	   x <= shape.getBoundingBoxXPosition()+shape.getBoundingBoxWidth()+2;
+	   ++x )
+      {
+	x_positions.push_back( x );
+	y_positions.push_back( y );
+      }
+    }
+
+    // Use a number of points that is not a multiple of the kernel widths
+    x_positions.push_back( shape.getCenterXPosition() );
+    y_positions.push_back( shape.getCenterYPosition() );
+    
+    const unsigned number_of_points = x_positions.size();
+
+    std::vector<Uint32> in_mask( 
+	      GDev::Shape::getNumberOfMaskWords( number_of_points ), 0xFFFFFFFF );
+    std::vector<Uint32> on_mask( in_mask );
+
+    // The scalar kernel results
+    GDev::Shape::setKernel( GDev::SCALAR_KERNEL );
+
+    std::vector<Uint32> scalar_in_mask( in_mask );
+    std::vector<Uint32> scalar_on_mask( on_mask );
+
+    shape.arePointsIn( x_positions.data(), 
+		       y_positions.data(), 
+		       number_of_points, 
+		       scalar_in_mask.data() );
+    shape.arePointsOn( x_positions.data(), 
+		       y_positions.data(), 
+		       number_of_points, 
+		       scalar_on_mask.data() );
+
+    for( unsigned k = 0; k < number_of_points; ++k )
+    {
+      if( !isPointNearBoundary( shape, x_positions[k], y_positions[k] ) )
+      {
+	BOOST_REQUIRE_EQUAL( 
+		    GDev::Shape::isMaskBitSet( scalar_in_mask.data(), k ),
+		    shape.isPointIn( x_positions[k], y_positions[k] ) );
+	BOOST_REQUIRE_EQUAL( 
+		    GDev::Shape::isMaskBitSet( scalar_on_mask.data(), k ),
+		    shape.isPointOn( x_positions[k], y_positions[k] ) );
+      }
+    }
+
+    for( unsigned j = 0; j < kernels.size(); ++j )
+    {
+      if( !GDev::SurfaceBlitter::isKernelSupported( kernels[j] ) )
+	continue;
+
+      GDev::Shape::setKernel( kernels[j] );
+
+      shape.arePointsIn( x_positions.data(), 
+			 y_positions.data(), 
+			 number_of_points, 
+			 in_mask.data() );
+      shape.arePointsOn( x_positions.data(), 
+			 y_positions.data(), 
+			 number_of_points, 
+			 on_mask.data() );
+
+      // The bits past the last point are cleared too
+      BOOST_REQUIRE( in_mask == scalar_in_mask );
+      BOOST_REQUIRE( on_mask == scalar_on_mask );
+    }
+
+    if( number_of_points%32u != 0u )
+    {
+      BOOST_CHECK_EQUAL( in_mask.back() >> (number_of_points%32u), 0u );
+      BOOST_CHECK_EQUAL( on_mask.back() >> (number_of_points%32u), 0u );
+    }
+  }
+
+  GDev::Shape::setKernel( default_kernel );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the batched point queries can differ from isPointIn within
+// rounding error of the boundary
+BOOST_AUTO_TEST_CASE( arePointsIn_boundary )
+{
+  GDev::Ellipse ellipse( 0, 0, 13, 78 );
+
+  const int x_positions[2] = {5, 5};
+  const int y_positions[2] = {72, 73};
+
+  Uint32 mask;
+
+  ellipse.arePointsIn( x_positions, y_positions, 2u, &mask );
+
+  // The reciprocal axis squares give exactly one for the first point
+  BOOST_CHECK( GDev::Shape::isMaskBitSet( &mask, 0u ) );
+  BOOST_CHECK( !ellipse.isPointIn( 5, 72 ) );
+  BOOST_CHECK( isPointNearBoundary( ellipse, 5, 72 ) );
+
+  BOOST_CHECK( !GDev::Shape::isMaskBitSet( &mask, 1u ) );
+  BOOST_CHECK( !ellipse.isPointIn( 5, 73 ) );
+}
+
 //---------------------------------------------------------------------------//
 // end tstEllipse.cpp
 //---------------------------------------------------------------------------//
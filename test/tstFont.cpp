@@ -9,6 +9,9 @@
 // Std Lib Includes
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <utility>
+#include <vector>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -17,6 +20,8 @@
 
 // GDev Includes
 #include "Font.hpp"
+#include "SpriteBatch.hpp"
+#include "SurfaceRenderer.hpp"
 #include "GlobalSDLSession.hpp"
 
 //---------------------------------------------------------------------------//
@@ -58,6 +63,41 @@ struct CommandLineArgsFixture
 
 BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
 
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+
+// Get the columns of an ARGB surface that have a pixel with a set channel
+/*! \details The columns are relative to the left most column that was found
+ * so that text rendered at different positions can be compared.
+ */
+std::vector<int> getInkColumns( const SDL_Surface* surface,
+				const Uint32 channel_mask )
+{
+  std::vector<int> columns;
+
+  for( int x = 0; x < surface->w; ++x )
+  {
+    for( int y = 0; y < surface->h; ++y )
+    {
+      const Uint32* row = (const Uint32*)
+	((const Uint8*)surface->pixels + y*surface->pitch);
+
+      if( row[x] & channel_mask )
+      {
+	columns.push_back( x );
+
+	break;
+      }
+    }
+  }
+
+  for( unsigned i = columns.size(); i > 0; --i )
+    columns[i-1] -= columns.front();
+
+  return columns;
+}
+
 BOOST_FIXTURE_TEST_SUITE( Font, CommandLineArgsFixture )
 
 //---------------------------------------------------------------------------//
@@ -69,6 +109,15 @@ BOOST_AUTO_TEST_CASE( constructor )
   BOOST_CHECK_NO_THROW( GDev::Font dummy_font( test_font_filename, 28 ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the font filename can be returned
+BOOST_AUTO_TEST_CASE( getFontFilename )
+{
+  GDev::Font font( test_font_filename, 28 );
+
+  BOOST_CHECK_EQUAL( font.getFontFilename(), test_font_filename );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the font size can be constructed
 BOOST_AUTO_TEST_CASE( getFontSize )
@@ -82,6 +131,31 @@ BOOST_AUTO_TEST_CASE( getFontSize )
   BOOST_CHECK_EQUAL( font_2.getFontSize(), 48 );
 }
 
+//---------------------------------------------------------------------------//
+// Check that a font can be moved
+BOOST_AUTO_TEST_CASE( move )
+{
+  GDev::Font font( test_font_filename, 28 );
+
+  const TTF_Font* raw_font = font.getRawFontPtr();
+
+  GDev::Font moved_font( std::move( font ) );
+
+  BOOST_CHECK_EQUAL( moved_font.getRawFontPtr(), raw_font );
+  BOOST_CHECK_EQUAL( moved_font.getFontSize(), 28 );
+  BOOST_CHECK_EQUAL( moved_font.getFontFilename(), test_font_filename );
+  BOOST_CHECK( font.getRawFontPtr() == NULL );
+  BOOST_CHECK( font.getFontFilename().empty() );
+
+  GDev::Font other_font( test_font_filename, 48 );
+
+  other_font = std::move( moved_font );
+
+  BOOST_CHECK_EQUAL( other_font.getRawFontPtr(), raw_font );
+  BOOST_CHECK_EQUAL( other_font.getFontSize(), 28 );
+  BOOST_CHECK( moved_font.getRawFontPtr() == NULL );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the raw pointer can be returned
 BOOST_AUTO_TEST_CASE( getRawFontPtr )
@@ -95,6 +169,125 @@ BOOST_AUTO_TEST_CASE( getRawFontPtr )
   BOOST_CHECK( font.getRawFontPtr() );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the size of text can be returned
+BOOST_AUTO_TEST_CASE( getTextSize )
+{
+  GDev::Font font( test_font_filename, 20 );
+
+  int width, height;
+
+  font.getTextSize( "", width, height );
+
+  BOOST_CHECK_EQUAL( width, 0 );
+  BOOST_CHECK_EQUAL( height, 0 );
+
+  font.getTextSize( "Score: 100", width, height );
+
+  int expected_width, expected_height;
+
+  TTF_SizeText( font.getRawFontPtr(), "Score: 100",
+		&expected_width, &expected_height );
+
+  BOOST_CHECK_EQUAL( width, expected_width );
+  BOOST_CHECK_EQUAL( height, font.getHeight() );
+
+  font.getTextSize( "Score\n100", width, height );
+
+  BOOST_CHECK_EQUAL( height, font.getHeight() + font.getLineSkip() );
+
+  // Kerned pairs and glyphs with negative bearings
+  font.getTextSize( "AVATAR Wojtek", width, height );
+
+  TTF_SizeText( font.getRawFontPtr(), "AVATAR Wojtek",
+		&expected_width, &expected_height );
+
+  BOOST_CHECK_EQUAL( width, expected_width );
+}
+
+//---------------------------------------------------------------------------//
+// Check that text can be rendered with the glyph atlas
+BOOST_AUTO_TEST_CASE( renderText )
+{
+  std::shared_ptr<GDev::Surface> surface(
+		    new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  std::shared_ptr<GDev::Renderer> renderer(
+				       new GDev::SurfaceRenderer( surface ) );
+
+  GDev::Font font( test_font_filename, 20 );
+
+  SDL_Color red = {0xFF,0,0,0xFF};
+
+  BOOST_CHECK_EQUAL( font.getNumberOfCachedGlyphs( renderer ), 0u );
+
+  font.renderText( renderer, "abca", 0, 0, red );
+
+  BOOST_CHECK_EQUAL( font.getNumberOfCachedGlyphs( renderer ), 3u );
+
+  font.renderText( renderer, "cab", 0, 30, red );
+
+  BOOST_CHECK_EQUAL( font.getNumberOfCachedGlyphs( renderer ), 3u );
+
+  // Text with the same color is rendered in one sprite group
+  GDev::SpriteBatch batch;
+
+  font.addText( batch, renderer, 0, "100", 0, 60, red );
+  font.addText( batch, renderer, 0, "200", 50, 60, red );
+
+  BOOST_CHECK_EQUAL( batch.getNumberOfSprites(), 6u );
+
+  batch.render();
+
+  BOOST_CHECK_EQUAL( batch.getNumberOfSubmittedGroups(), 1u );
+
+  font.releaseGlyphAtlas( renderer );
+
+  BOOST_CHECK_EQUAL( font.getNumberOfCachedGlyphs( renderer ), 0u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the glyphs are placed where SDL_ttf places them
+BOOST_AUTO_TEST_CASE( renderText_glyph_positions )
+{
+  std::shared_ptr<GDev::Surface> surface(
+		    new GDev::Surface( 400, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  std::shared_ptr<GDev::Renderer> renderer(
+				       new GDev::SurfaceRenderer( surface ) );
+
+  GDev::Font font( test_font_filename, 40 );
+
+  SDL_Color transparent = {0,0,0,0};
+  SDL_Color red = {0xFF,0,0,0xFF};
+
+  const char* texts[3] = {"AVATAR", "Wojtek", "Score: 100"};
+
+  for( unsigned i = 0; i < 3; ++i )
+  {
+    renderer->setDrawColor( transparent );
+    renderer->clear();
+
+    font.renderText( renderer, texts[i], 20, 0, red );
+
+    std::unique_ptr<SDL_Surface,void (*)(SDL_Surface*)> expected_surface(
+	      TTF_RenderText_Blended( font.getRawFontPtr(), texts[i], red ),
+	      SDL_FreeSurface );
+
+    BOOST_REQUIRE( expected_surface );
+
+    std::vector<int> columns =
+      getInkColumns( surface->getRawSurfacePtr(), 0xFF000000 );
+
+    std::vector<int> expected_columns =
+      getInkColumns( expected_surface.get(), 0xFF000000 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( columns.begin(), columns.end(),
+				   expected_columns.begin(),
+				   expected_columns.end() );
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,296 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstMultiBufferedStreamingTexture.cpp
+//! \author Alex Robinson
+//! \brief  The multi-buffered streaming texture class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "MultiBufferedStreamingTexture.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface
+std::shared_ptr<GDev::Surface> test_surface;
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    test_surface.reset( new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+// Fill a staging buffer with a color
+void fillBuffer( GDev::MultiBufferedStreamingTexture& texture,
+		 const int buffer,
+		 const Uint32 color )
+{
+  Uint8* pixels = static_cast<Uint8*>( texture.getBufferPixels( buffer ) );
+
+  for( int y = 0; y < texture.getHeight(); ++y )
+  {
+    Uint32* row = reinterpret_cast<Uint32*>( pixels +
+					     y*texture.getBufferPitch() );
+
+    for( int x = 0; x < texture.getWidth(); ++x )
+      row[x] = color;
+  }
+}
+
+// Render a texture and get a pixel of the test surface
+Uint32 renderAndGetPixel( const GDev::MultiBufferedStreamingTexture& texture,
+			  const int x,
+			  const int y )
+{
+  texture.render( 0, 0 );
+
+  const Uint8* pixels = static_cast<const Uint8*>( test_surface->getPixels() );
+
+  return reinterpret_cast<const Uint32*>( pixels +
+					  y*test_surface->getPitch() )[x];
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the staging buffers can be acquired and released
+BOOST_AUTO_TEST_CASE( acquireBuffer )
+{
+  GDev::MultiBufferedStreamingTexture texture( test_surface_renderer, 8, 4 );
+
+  BOOST_CHECK_EQUAL( texture.getNumberOfBuffers(), 3 );
+  BOOST_CHECK( texture.getBufferPitch() >= 8*4 );
+
+  const int first_buffer = texture.acquireBuffer();
+  const int second_buffer = texture.acquireBuffer();
+  const int third_buffer = texture.acquireBuffer();
+
+  BOOST_CHECK( first_buffer >= 0 );
+  BOOST_CHECK( second_buffer >= 0 );
+  BOOST_CHECK( third_buffer >= 0 );
+  BOOST_CHECK( first_buffer != second_buffer );
+  BOOST_CHECK( second_buffer != third_buffer );
+
+  // Every buffer is being written
+  BOOST_CHECK_EQUAL( texture.acquireBuffer(), -1 );
+
+  texture.releaseBuffer( second_buffer );
+
+  BOOST_CHECK_EQUAL( texture.acquireBuffer(), second_buffer );
+
+  // The published buffer will be recycled
+  texture.publishBuffer( first_buffer );
+
+  BOOST_CHECK_EQUAL( texture.acquireBuffer(), first_buffer );
+  BOOST_CHECK_EQUAL( texture.getNumberOfDroppedBuffers(), 1 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the buffer pitch is computed from the resolved texture format
+BOOST_AUTO_TEST_CASE( getBufferPitch_native_format )
+{
+  GDev::MultiBufferedStreamingTexture texture( test_surface_renderer,
+					       9, 4,
+					       3,
+					       SDL_PIXELFORMAT_UNKNOWN );
+
+  BOOST_CHECK( texture.getFormat() != SDL_PIXELFORMAT_UNKNOWN );
+  BOOST_CHECK_EQUAL( texture.getBufferPitch(),
+		     (9*SDL_BYTESPERPIXEL( texture.getFormat() ) + 3) & ~3 );
+
+  const int buffer = texture.acquireBuffer();
+
+  BOOST_REQUIRE( buffer >= 0 );
+
+  fillBuffer( texture, buffer, 0xFF00FF00 );
+  texture.publishBuffer( buffer );
+
+  BOOST_CHECK( texture.update() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the newest published buffer is uploaded
+BOOST_AUTO_TEST_CASE( update )
+{
+  GDev::MultiBufferedStreamingTexture texture( test_surface_renderer, 8, 4 );
+  texture.setBlendMode( SDL_BLENDMODE_NONE );
+
+  BOOST_CHECK( !texture.update() );
+
+  const int old_buffer = texture.acquireBuffer();
+  fillBuffer( texture, old_buffer, 0xFFFF0000 );
+  texture.publishBuffer( old_buffer );
+
+  const int new_buffer = texture.acquireBuffer();
+  fillBuffer( texture, new_buffer, 0xFF00FF00 );
+  texture.publishBuffer( new_buffer );
+
+  BOOST_CHECK( texture.update() );
+  BOOST_CHECK_EQUAL( texture.getNumberOfDroppedBuffers(), 1 );
+  BOOST_CHECK_EQUAL( renderAndGetPixel( texture, 7, 3 ), 0xFF00FF00 );
+
+  // Nothing new has been published
+  BOOST_CHECK( !texture.update() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a producer thread can fill the buffers while the render
+// thread uploads them
+BOOST_AUTO_TEST_CASE( update_threaded )
+{
+  GDev::MultiBufferedStreamingTexture texture( test_surface_renderer, 64, 64 );
+  texture.setBlendMode( SDL_BLENDMODE_NONE );
+
+  std::atomic<bool> done( false );
+
+  std::thread producer( [&](){
+      for( Uint32 frame = 1; frame <= 500; ++frame )
+      {
+	const int buffer = texture.acquireBuffer();
+
+	if( buffer >= 0 )
+	{
+	  fillBuffer( texture, buffer, 0xFF000000 | frame );
+	  texture.publishBuffer( buffer );
+	}
+      }
+
+      done = true; } );
+
+  unsigned number_of_updates = 0;
+
+  while( !done )
+  {
+    if( texture.update() )
+    {
+      ++number_of_updates;
+
+      // Every uploaded frame must be complete
+      BOOST_REQUIRE_EQUAL( renderAndGetPixel( texture, 0, 0 ),
+			   renderAndGetPixel( texture, 63, 63 ) );
+    }
+  }
+
+  producer.join();
+
+  // The last frame is always uploaded
+  if( texture.update() )
+    ++number_of_updates;
+
+  BOOST_CHECK( number_of_updates > 0 );
+  BOOST_CHECK_EQUAL( renderAndGetPixel( texture, 10, 10 ), 0xFF0001F4 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the uploaded frames never go backwards when several producer
+// threads publish buffers
+BOOST_AUTO_TEST_CASE( update_multiple_producers )
+{
+  GDev::MultiBufferedStreamingTexture texture( test_surface_renderer,
+					       64, 64, 4 );
+  texture.setBlendMode( SDL_BLENDMODE_NONE );
+
+  const unsigned number_of_producers = 4;
+
+  std::atomic<unsigned long> number_of_publications( 0ul );
+  std::atomic<unsigned> number_of_done_producers( 0u );
+
+  std::vector<std::thread> producers;
+
+  for( unsigned p = 0; p < number_of_producers; ++p )
+  {
+    producers.push_back( std::thread( [&,p](){
+	  for( Uint32 frame = 1; frame <= 250; ++frame )
+	  {
+	    const int buffer = texture.acquireBuffer();
+
+	    if( buffer >= 0 )
+	    {
+	      fillBuffer( texture, buffer, 0xFF000000 | (p << 16) | frame );
+	      texture.publishBuffer( buffer );
+
+	      ++number_of_publications;
+	    }
+	  }
+
+	  ++number_of_done_producers; } ) );
+  }
+
+  unsigned long number_of_updates = 0;
+  unsigned long uploaded_publication = 0;
+
+  while( number_of_done_producers < number_of_producers )
+  {
+    if( texture.update() )
+    {
+      ++number_of_updates;
+
+      // The uploaded publication must always be newer
+      BOOST_REQUIRE( texture.getUploadedPublication() >
+		     uploaded_publication );
+
+      uploaded_publication = texture.getUploadedPublication();
+
+      // Every uploaded frame must be complete
+      BOOST_REQUIRE_EQUAL( renderAndGetPixel( texture, 0, 0 ),
+			   renderAndGetPixel( texture, 63, 63 ) );
+    }
+  }
+
+  for( unsigned p = 0; p < number_of_producers; ++p )
+    producers[p].join();
+
+  if( texture.update() )
+    ++number_of_updates;
+
+  // The newest publication is always uploaded
+  BOOST_CHECK_EQUAL( texture.getUploadedPublication(),
+		     number_of_publications.load() );
+
+  // Every published buffer is either uploaded or dropped
+  BOOST_CHECK_EQUAL( number_of_updates +
+		     texture.getNumberOfDroppedBuffers(),
+		     number_of_publications.load() );
+
+  // Nothing new has been published
+  BOOST_CHECK( !texture.update() );
+}
+
+//---------------------------------------------------------------------------//
+// end tstMultiBufferedStreamingTexture.cpp
+//---------------------------------------------------------------------------//
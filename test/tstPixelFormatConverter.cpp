@@ -0,0 +1,328 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstPixelFormatConverter.cpp
+//! \author Alex Robinson
+//! \brief  The pixel format converter class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "PixelFormatConverter.hpp"
+#include "SurfaceBlitter.hpp"
+#include "Surface.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+// Get the kernels that are supported by the CPU
+std::vector<GDev::PixelFormatConverter::Kernel> getSupportedKernels()
+{
+  std::vector<GDev::PixelFormatConverter::Kernel> kernels;
+
+  kernels.push_back( GDev::SCALAR_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::SSE2_KERNEL ) )
+    kernels.push_back( GDev::SSE2_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::AVX2_KERNEL ) )
+    kernels.push_back( GDev::AVX2_KERNEL );
+
+  return kernels;
+}
+
+// Get a pixel of a 32 bit surface
+Uint32 getPixel( const GDev::Surface& surface, const int x, const int y )
+{
+  const Uint8* row = static_cast<const Uint8*>( surface.getPixels() ) +
+    y*surface.getPitch();
+
+  return reinterpret_cast<const Uint32*>( row )[x];
+}
+
+// Set a pixel of a 32 bit surface
+void setPixel( GDev::Surface& surface,
+	       const int x,
+	       const int y,
+	       const Uint32 pixel )
+{
+  Uint8* row = static_cast<Uint8*>( surface.getRawSurfacePtr()->pixels ) +
+    y*surface.getPitch();
+
+  reinterpret_cast<Uint32*>( row )[x] = pixel;
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the supported conversions can be identified
+BOOST_AUTO_TEST_CASE( canConvert )
+{
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_RGB24,
+					       SDL_PIXELFORMAT_ARGB8888 ) );
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_ARGB8888,
+					       SDL_PIXELFORMAT_RGB24 ) );
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_ABGR8888,
+					       SDL_PIXELFORMAT_ARGB8888 ) );
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_ARGB8888,
+					       SDL_PIXELFORMAT_RGBA8888 ) );
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_INDEX8,
+					       SDL_PIXELFORMAT_ARGB8888 ) );
+  BOOST_CHECK( GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_RGB565,
+					       SDL_PIXELFORMAT_RGB565 ) );
+
+  BOOST_CHECK( !GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_ARGB8888,
+					       SDL_PIXELFORMAT_INDEX8 ) );
+  BOOST_CHECK( !GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_INDEX8,
+					       SDL_PIXELFORMAT_INDEX8 ) );
+  BOOST_CHECK( !GDev::PixelFormatConverter::canConvert(
+					       SDL_PIXELFORMAT_RGB565,
+					       SDL_PIXELFORMAT_ARGB8888 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that rows of pixels can be converted
+BOOST_AUTO_TEST_CASE( convertRows )
+{
+  const Uint32 argb_pixels[2] = {0x80102030, 0xFFA0B0C0};
+  Uint32 pixels[2];
+
+  GDev::PixelFormatConverter::convertRows( SDL_PIXELFORMAT_ARGB8888,
+					   argb_pixels,
+					   8,
+					   NULL,
+					   SDL_PIXELFORMAT_ABGR8888,
+					   pixels,
+					   8,
+					   2,
+					   1 );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0x80302010 );
+  BOOST_CHECK_EQUAL( pixels[1], 0xFFC0B0A0 );
+
+  GDev::PixelFormatConverter::convertRows( SDL_PIXELFORMAT_ARGB8888,
+					   argb_pixels,
+					   8,
+					   NULL,
+					   SDL_PIXELFORMAT_RGBA8888,
+					   pixels,
+					   8,
+					   2,
+					   1 );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0x10203080 );
+  BOOST_CHECK_EQUAL( pixels[1], 0xA0B0C0FF );
+
+  Uint8 rgb24_pixels[6];
+
+  GDev::PixelFormatConverter::convertRows( SDL_PIXELFORMAT_ARGB8888,
+					   argb_pixels,
+					   8,
+					   NULL,
+					   SDL_PIXELFORMAT_RGB24,
+					   rgb24_pixels,
+					   6,
+					   2,
+					   1 );
+
+  BOOST_CHECK_EQUAL( (int)rgb24_pixels[0], 0x10 );
+  BOOST_CHECK_EQUAL( (int)rgb24_pixels[1], 0x20 );
+  BOOST_CHECK_EQUAL( (int)rgb24_pixels[2], 0x30 );
+  BOOST_CHECK_EQUAL( (int)rgb24_pixels[5], 0xC0 );
+
+  // Converting back to ARGB8888 makes the pixels opaque
+  GDev::PixelFormatConverter::convertRows( SDL_PIXELFORMAT_RGB24,
+					   rgb24_pixels,
+					   6,
+					   NULL,
+					   SDL_PIXELFORMAT_ARGB8888,
+					   pixels,
+					   8,
+					   2,
+					   1 );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0xFF102030 );
+  BOOST_CHECK_EQUAL( pixels[1], 0xFFA0B0C0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that indexed pixels can be converted with a palette
+BOOST_AUTO_TEST_CASE( convertRows_indexed )
+{
+  SDL_Color colors[2] = {{0x10, 0x20, 0x30, 0xFF}, {0xA0, 0xB0, 0xC0, 0x80}};
+
+  SDL_Palette palette;
+  palette.ncolors = 2;
+  palette.colors = colors;
+
+  const Uint8 indexed_pixels[3] = {1, 0, 7};
+  Uint32 pixels[3];
+
+  GDev::PixelFormatConverter::convertRows( SDL_PIXELFORMAT_INDEX8,
+					   indexed_pixels,
+					   3,
+					   &palette,
+					   SDL_PIXELFORMAT_ARGB8888,
+					   pixels,
+					   12,
+					   3,
+					   1 );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0x80A0B0C0 );
+  BOOST_CHECK_EQUAL( pixels[1], 0xFF102030 );
+  BOOST_CHECK_EQUAL( pixels[2], 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the simd kernels and the threads produce the same results as
+// the scalar kernel
+BOOST_AUTO_TEST_CASE( convertRows_kernels_agree )
+{
+  std::vector<GDev::PixelFormatConverter::Kernel> kernels =
+    getSupportedKernels();
+
+  const Uint32 conversions[9][2] =
+    {{SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888},
+     {SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888},
+     {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888},
+     {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888},
+     {SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888},
+     {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24},
+     {SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_ARGB8888},
+     {SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888},
+     {SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB888}};
+
+  srand( 1 );
+
+  SDL_Color colors[256];
+
+  for( unsigned i = 0; i < 256; ++i )
+  {
+    colors[i].r = rand()%256;
+    colors[i].g = rand()%256;
+    colors[i].b = rand()%256;
+    colors[i].a = rand()%256;
+  }
+
+  SDL_Palette palette;
+  palette.ncolors = 200;
+  palette.colors = colors;
+
+  const unsigned number_of_threads =
+    GDev::PixelFormatConverter::getNumberOfThreads();
+
+  for( unsigned trial = 0; trial < 90; ++trial )
+  {
+    const Uint32 source_format = conversions[trial%9][0];
+    const Uint32 destination_format = conversions[trial%9][1];
+
+    // Make some of the conversions large enough to be split into bands
+    const int width = (trial%5 == 0 ? 100 : 1) + rand()%100;
+    const int height = (trial%5 == 0 ? 4000 : 1 + rand()%10);
+
+    const int source_pitch = width*SDL_BYTESPERPIXEL( source_format ) + 5;
+    const int destination_pitch =
+      width*SDL_BYTESPERPIXEL( destination_format ) + 3;
+
+    std::vector<Uint8> source_pixels( source_pitch*height );
+
+    for( unsigned i = 0; i < source_pixels.size(); ++i )
+      source_pixels[i] = rand()%256;
+
+    std::vector<Uint8> reference_pixels( destination_pitch*height, 0 );
+
+    GDev::PixelFormatConverter::setKernel(
+					 GDev::SCALAR_KERNEL );
+    GDev::PixelFormatConverter::setNumberOfThreads( 1 );
+
+    GDev::PixelFormatConverter::convertRows( source_format,
+					     &source_pixels[0],
+					     source_pitch,
+					     &palette,
+					     destination_format,
+					     &reference_pixels[0],
+					     destination_pitch,
+					     width,
+					     height );
+
+    GDev::PixelFormatConverter::setNumberOfThreads( 4 );
+
+    for( unsigned k = 0; k < kernels.size(); ++k )
+    {
+      std::vector<Uint8> kernel_pixels( destination_pitch*height, 0 );
+
+      GDev::PixelFormatConverter::setKernel( kernels[k] );
+
+      GDev::PixelFormatConverter::convertRows( source_format,
+					       &source_pixels[0],
+					       source_pitch,
+					       &palette,
+					       destination_format,
+					       &kernel_pixels[0],
+					       destination_pitch,
+					       width,
+					       height );
+
+      // Only the converted bytes of each row are compared
+      for( int y = 0; y < height; ++y )
+      {
+	for( int x = 0; 
+	     x < width*(int)SDL_BYTESPERPIXEL( destination_format );
+	     ++x )
+	{
+	  BOOST_REQUIRE_EQUAL( (int)kernel_pixels[y*destination_pitch+x],
+			       (int)reference_pixels[y*destination_pitch+x] );
+	}
+      }
+    }
+  }
+
+  GDev::PixelFormatConverter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+  GDev::PixelFormatConverter::setNumberOfThreads( number_of_threads );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a surface can be converted
+BOOST_AUTO_TEST_CASE( surface_conversion )
+{
+  GDev::Surface source_surface( 3, 2, SDL_PIXELFORMAT_ABGR8888 );
+
+  setPixel( source_surface, 0, 0, 0xFF302010 );
+  setPixel( source_surface, 2, 1, 0x80C0B0A0 );
+
+  source_surface.setAlphaMod( 0x40 );
+
+  GDev::Surface converted_surface( source_surface, SDL_PIXELFORMAT_ARGB8888 );
+
+  BOOST_CHECK_EQUAL( converted_surface.getWidth(), 3 );
+  BOOST_CHECK_EQUAL( converted_surface.getHeight(), 2 );
+  BOOST_CHECK_EQUAL( converted_surface.getPixelFormat().format,
+		     SDL_PIXELFORMAT_ARGB8888 );
+  BOOST_CHECK_EQUAL( getPixel( converted_surface, 0, 0 ), 0xFF102030 );
+  BOOST_CHECK_EQUAL( getPixel( converted_surface, 2, 1 ), 0x80A0B0C0 );
+  BOOST_CHECK_EQUAL( (int)converted_surface.getAlphaMod(), 0x40 );
+  BOOST_CHECK_EQUAL( converted_surface.getBlendMode(), SDL_BLENDMODE_BLEND );
+}
+
+//---------------------------------------------------------------------------//
+// end tstPixelFormatConverter.cpp
+//---------------------------------------------------------------------------//
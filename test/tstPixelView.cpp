@@ -0,0 +1,299 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstPixelView.cpp
+//! \author Alex Robinson
+//! \brief  The pixel format traits and pixel view unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+#include <functional>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "PixelView.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Structs.
+//---------------------------------------------------------------------------//
+// Records the bytes per pixel of a dispatched format
+struct BytesPerPixelFunction
+{
+  int bytes_per_pixel;
+
+  template<Uint32 Format>
+  void operator()( GDev::PixelFormatTag<Format> )
+  { bytes_per_pixel = GDev::PixelFormatTraits<Format>::bytes_per_pixel; }
+};
+
+// Stores the bytes per pixel of a dispatched format (can be a temporary)
+struct StoreBytesPerPixelFunction
+{
+  StoreBytesPerPixelFunction( int* bytes_per_pixel )
+    : bytes_per_pixel( bytes_per_pixel )
+  { /* ... */ }
+
+  int* bytes_per_pixel;
+
+  template<Uint32 Format>
+  void operator()( GDev::PixelFormatTag<Format> ) const
+  { *bytes_per_pixel = GDev::PixelFormatTraits<Format>::bytes_per_pixel; }
+};
+
+// Sums the ARGB values of the pixels of a dispatched format
+struct SumARGBFunction
+{
+  Uint8* pixels;
+  int width;
+  int height;
+  int pitch;
+  Uint32 sum;
+
+  template<Uint32 Format>
+  void operator()( GDev::PixelFormatTag<Format> )
+  {
+    GDev::PixelView<Format> view( pixels, width, height, pitch );
+
+    sum = 0;
+
+    for( int y = 0; y < view.getHeight(); ++y )
+    {
+      for( int x = 0; x < view.getWidth(); ++x )
+	sum += view.getARGB( x, y );
+    }
+  }
+};
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the format traits can convert pixels to and from ARGB8888
+BOOST_AUTO_TEST_CASE( traits_toARGB_fromARGB )
+{
+  typedef GDev::PixelFormatTraits<SDL_PIXELFORMAT_ARGB8888> ARGBTraits;
+  typedef GDev::PixelFormatTraits<SDL_PIXELFORMAT_ABGR8888> ABGRTraits;
+  typedef GDev::PixelFormatTraits<SDL_PIXELFORMAT_RGB24> RGB24Traits;
+  typedef GDev::PixelFormatTraits<SDL_PIXELFORMAT_RGB565> RGB565Traits;
+
+  BOOST_CHECK_EQUAL( ARGBTraits::bytes_per_pixel, 4 );
+  BOOST_CHECK_EQUAL( ABGRTraits::bytes_per_pixel, 4 );
+  BOOST_CHECK_EQUAL( RGB24Traits::bytes_per_pixel, 3 );
+  BOOST_CHECK_EQUAL( RGB565Traits::bytes_per_pixel, 2 );
+
+  BOOST_CHECK_EQUAL( ARGBTraits::fromARGB( 0x80112233 ), 0x80112233 );
+  BOOST_CHECK_EQUAL( ABGRTraits::fromARGB( 0x80112233 ), 0x80332211 );
+  BOOST_CHECK_EQUAL( ABGRTraits::toARGB( 0x80332211, NULL ), 0x80112233 );
+  BOOST_CHECK_EQUAL( RGB24Traits::fromARGB( 0x80112233 ), 0x112233 );
+  BOOST_CHECK_EQUAL( RGB24Traits::toARGB( 0x112233, NULL ), 0xFF112233 );
+  BOOST_CHECK_EQUAL( RGB565Traits::fromARGB( 0xFFFF0000 ), 0xF800 );
+  BOOST_CHECK_EQUAL( RGB565Traits::toARGB( 0xF800, NULL ), 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( RGB565Traits::toARGB( 0x07E0, NULL ), 0xFF00FF00 );
+  BOOST_CHECK_EQUAL( RGB565Traits::toARGB( 0x001F, NULL ), 0xFF0000FF );
+}
+
+//---------------------------------------------------------------------------//
+// Check that RGB24 pixels are stored as R, G, B bytes
+BOOST_AUTO_TEST_CASE( pixel_ref_rgb24 )
+{
+  Uint8 pixels[6] = {0, 0, 0, 0, 0, 0};
+
+  GDev::PixelView<SDL_PIXELFORMAT_RGB24> view( pixels, 2, 1, 6 );
+
+  view( 1, 0 ).setARGB( 0xFF112233 );
+
+  BOOST_CHECK_EQUAL( pixels[3], 0x11 );
+  BOOST_CHECK_EQUAL( pixels[4], 0x22 );
+  BOOST_CHECK_EQUAL( pixels[5], 0x33 );
+  BOOST_CHECK_EQUAL( view( 1, 0 ).getValue(), 0x112233 );
+
+  view( 0, 0 ) = view( 1, 0 );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0x11 );
+  BOOST_CHECK_EQUAL( view.getARGB( 0, 0 ), 0xFF112233 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that indexed pixels can be converted with the palette
+BOOST_AUTO_TEST_CASE( pixel_ref_index8 )
+{
+  SDL_Color colors[2];
+  colors[0].r = 0; colors[0].g = 0; colors[0].b = 0; colors[0].a = 255;
+  colors[1].r = 10; colors[1].g = 20; colors[1].b = 30; colors[1].a = 40;
+
+  SDL_Palette palette;
+  palette.ncolors = 2;
+  palette.colors = colors;
+
+  Uint8 pixels[4] = {0, 1, 1, 0};
+
+  GDev::ConstPixelView<SDL_PIXELFORMAT_INDEX8>
+    view( pixels, 2, 2, 2, &palette );
+
+  BOOST_CHECK_EQUAL( view( 1, 0 ).getValue(), 1 );
+  BOOST_CHECK_EQUAL( view.getARGB( 0, 0 ), 0xFF000000 );
+  BOOST_CHECK_EQUAL( view.getARGB( 0, 1 ), 0x280A141E );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the view respects the pitch
+BOOST_AUTO_TEST_CASE( fill_pitch )
+{
+  // 3 pixels per row with one pixel of padding
+  std::vector<Uint32> pixels( 4*2, 0xDEADBEEF );
+
+  GDev::PixelView<SDL_PIXELFORMAT_ARGB8888>
+    view( (Uint8*)pixels.data(), 3, 2, 16 );
+
+  BOOST_CHECK_EQUAL( view.getWidth(), 3 );
+  BOOST_CHECK_EQUAL( view.getHeight(), 2 );
+  BOOST_CHECK_EQUAL( view.getPitch(), 16 );
+
+  view.fill( 0xFF000000 );
+  view.fillRow( 1, 1, 2, 0xFFFFFFFF );
+
+  BOOST_CHECK_EQUAL( pixels[0], 0xFF000000 );
+  BOOST_CHECK_EQUAL( pixels[2], 0xFF000000 );
+  BOOST_CHECK_EQUAL( pixels[3], 0xDEADBEEF );
+  BOOST_CHECK_EQUAL( pixels[4], 0xFF000000 );
+  BOOST_CHECK_EQUAL( pixels[5], 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( pixels[6], 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( pixels[7], 0xDEADBEEF );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the pixels of a row can be iterated over
+BOOST_AUTO_TEST_CASE( row_iterator )
+{
+  Uint16 pixels[4] = {0x0001, 0x0002, 0x0003, 0x0004};
+
+  GDev::PixelView<SDL_PIXELFORMAT_RGB565> view( (Uint8*)pixels, 2, 2, 4 );
+
+  BOOST_CHECK_EQUAL( view.rowEnd( 1 ) - view.rowBegin( 1 ), 2 );
+
+  Uint32 sum = 0;
+
+  for( GDev::PixelView<SDL_PIXELFORMAT_RGB565>::Iterator pixel =
+	 view.rowBegin( 1 );
+       pixel != view.rowEnd( 1 );
+       ++pixel )
+    sum += (*pixel).getValue();
+
+  BOOST_CHECK_EQUAL( sum, 7 );
+
+  int number_of_pixels = 0;
+
+  view.forEachPixel( [&number_of_pixels](
+		       GDev::PixelRef<SDL_PIXELFORMAT_RGB565> pixel ){
+		       pixel = 0x0010;
+		       ++number_of_pixels; } );
+
+  BOOST_CHECK_EQUAL( number_of_pixels, 4 );
+  BOOST_CHECK_EQUAL( pixels[0], 0x0010 );
+  BOOST_CHECK_EQUAL( pixels[3], 0x0010 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the rows of a view can be iterated over
+BOOST_AUTO_TEST_CASE( rows_iterator )
+{
+  // 2 pixels per row with one pixel of padding
+  Uint32 pixels[9] = {1, 2, 0xDEADBEEF,
+		      3, 4, 0xDEADBEEF,
+		      5, 6, 0xDEADBEEF};
+
+  GDev::PixelView<SDL_PIXELFORMAT_ARGB8888> view( (Uint8*)pixels, 2, 3, 12 );
+
+  int number_of_rows = 0;
+  Uint32 sum = 0;
+
+  for( GDev::PixelView<SDL_PIXELFORMAT_ARGB8888>::RowIterator row =
+	 view.rowsBegin();
+       row != view.rowsEnd();
+       ++row )
+  {
+    BOOST_CHECK_EQUAL( (*row).getWidth(), 2 );
+
+    for( GDev::PixelRef<SDL_PIXELFORMAT_ARGB8888> pixel : *row )
+      sum += pixel.getValue();
+
+    ++number_of_rows;
+  }
+
+  BOOST_CHECK_EQUAL( number_of_rows, 3 );
+  BOOST_CHECK_EQUAL( sum, 21 );
+
+  GDev::PixelRow<SDL_PIXELFORMAT_ARGB8888> row = view.getRow( 1 );
+
+  BOOST_CHECK_EQUAL( row[1].getValue(), 4 );
+
+  row[0] = 7;
+
+  BOOST_CHECK_EQUAL( pixels[3], 7 );
+  BOOST_CHECK_EQUAL( pixels[5], 0xDEADBEEF );
+}
+
+//---------------------------------------------------------------------------//
+// Check that runtime formats can be dispatched
+BOOST_AUTO_TEST_CASE( dispatch_runtime_format )
+{
+  BytesPerPixelFunction function;
+
+  BOOST_CHECK( GDev::dispatchPixelFormat( SDL_PIXELFORMAT_RGB24,
+					  std::ref( function ) ) );
+  BOOST_CHECK_EQUAL( function.bytes_per_pixel, 3 );
+
+  BOOST_CHECK( GDev::dispatchPixelFormat( SDL_PIXELFORMAT_INDEX8,
+					  std::ref( function ) ) );
+  BOOST_CHECK_EQUAL( function.bytes_per_pixel, 1 );
+
+  BOOST_CHECK( !GDev::dispatchPixelFormat( SDL_PIXELFORMAT_RGB888,
+					   std::ref( function ) ) );
+  BOOST_CHECK( GDev::isPixelFormatSpecialized( SDL_PIXELFORMAT_ABGR8888 ) );
+  BOOST_CHECK( !GDev::isPixelFormatSpecialized( SDL_PIXELFORMAT_RGB888 ) );
+
+  // The same kernel must give the same result for every format
+  Uint32 argb_pixels[2] = {0xFF112233, 0xFF445566};
+  Uint32 abgr_pixels[2] = {0xFF332211, 0xFF665544};
+  Uint8 rgb24_pixels[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+
+  SumARGBFunction sum_function;
+  sum_function.width = 2;
+  sum_function.height = 1;
+
+  sum_function.pixels = (Uint8*)argb_pixels;
+  sum_function.pitch = 8;
+  GDev::dispatchPixelFormat( SDL_PIXELFORMAT_ARGB8888,
+			     std::ref( sum_function ) );
+
+  const Uint32 argb_sum = sum_function.sum;
+
+  sum_function.pixels = (Uint8*)abgr_pixels;
+  GDev::dispatchPixelFormat( SDL_PIXELFORMAT_ABGR8888,
+			     std::ref( sum_function ) );
+
+  BOOST_CHECK_EQUAL( sum_function.sum, argb_sum );
+
+  sum_function.pixels = rgb24_pixels;
+  sum_function.pitch = 6;
+  GDev::dispatchPixelFormat( SDL_PIXELFORMAT_RGB24,
+			     std::ref( sum_function ) );
+
+  BOOST_CHECK_EQUAL( sum_function.sum, argb_sum );
+
+  // Temporary functions can be dispatched
+  int bytes_per_pixel = 0;
+
+  BOOST_CHECK( GDev::dispatchPixelFormat(
+			 SDL_PIXELFORMAT_RGB565,
+			 StoreBytesPerPixelFunction( &bytes_per_pixel ) ) );
+  BOOST_CHECK_EQUAL( bytes_per_pixel, 2 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstPixelView.cpp
+//---------------------------------------------------------------------------//
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -17,6 +18,7 @@
 
 // GDev Includes
 #include "Rectangle.hpp"
+#include "SurfaceBlitter.hpp"
 
 //---------------------------------------------------------------------------//
 // Tests.
@@ -306,6 +308,156 @@ BOOST_AUTO_TEST_CASE( isPointOn )
   BOOST_CHECK( !shape->isPointOn( 201, 101 ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the row spans agree with isPointOn and isPointIn
+BOOST_AUTO_TEST_CASE( getRowSpans )
+{
+  std::vector<std::shared_ptr<GDev::Shape> > shapes;
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 0, 0, 200, 100 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 0, 0, 200, 100, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 10, 20, 5, 7, 3 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( -10, -20, 30, 40, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 10, -3, 20, 8, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 0, 0, 20, 3, 5 ) ) );
+
+  std::vector<GDev::ShapeSpan> spans;
+
+  for( unsigned i = 0; i < shapes.size(); ++i )
+  {
+    const GDev::Shape& shape = *shapes[i];
+    
+    for( int y = shape.getBoundingBoxYPosition(); 
+	 y < shape.getBoundingBoxYPosition()+shape.getBoundingBoxHeight(); 
+	 ++y )
+    {
+      shape.getRowSpans( y, spans );
+
+      int x = shape.getBoundingBoxXPosition();
+
+      for( unsigned j = 0; j < spans.size(); ++j )
+      {
+	BOOST_REQUIRE_EQUAL( spans[j].x_position, x );
+	BOOST_REQUIRE( spans[j].length > 0 );
+
+	if( j > 0 )
+	  BOOST_CHECK( spans[j].coverage != spans[j-1].coverage );
+
+	for( int k = 0; k < spans[j].length; ++k, ++x )
+	{
+	  GDev::ShapeCoverage coverage;
+
+	  if( shape.isPointOn( x, y ) )
+	    coverage = GDev::ON_SHAPE_EDGE;
+	  else if( shape.isPointIn( x, y ) )
+	    coverage = GDev::INSIDE_SHAPE;
+	  else
+	    coverage = GDev::OUTSIDE_SHAPE;
+
+	  BOOST_REQUIRE_EQUAL( spans[j].coverage, coverage );
+	}
+      }
+
+      BOOST_CHECK_EQUAL( x, shape.getBoundingBoxXPosition() + 
+			 shape.getBoundingBoxWidth() );
+    }
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that the batched point queries agree with isPointIn and isPointOn
+BOOST_AUTO_TEST_CASE( arePointsIn_arePointsOn )
+{
+  std::vector<std::shared_ptr<GDev::Shape> > shapes;
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 0, 0, 200, 100 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 0, 0, 200, 100, 2 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( 10, 20, 5, 7, 3 ) ) );
+  shapes.push_back( std::shared_ptr<GDev::Shape>( 
+			  new GDev::Rectangle( -10, -20, 30, 40, 2 ) ) );
+
+  std::vector<GDev::Shape::Kernel> kernels;
+  kernels.push_back( GDev::SCALAR_KERNEL );
+  kernels.push_back( GDev::SSE2_KERNEL );
+  kernels.push_back( GDev::AVX2_KERNEL );
+
+  const GDev::Shape::Kernel default_kernel = GDev::Shape::getKernel();
+
+  for( unsigned i = 0; i < shapes.size(); ++i )
+  {
+    const GDev::Shape& shape = *shapes[i];
+
+    // Test every point in (and around) the bounding box
+    std::vector<int> x_positions, y_positions;
+
+    for( int y = shape.getBoundingBoxYPosition() - 2;
+	 y <= shape.getBoundingBoxYPosition()+shape.getBoundingBoxHeight()+2;
+	 ++y )
+    {
+      for( int x = shape.getBoundingBoxXPosition() - 2;
+	   x <= shape.getBoundingBoxXPosition()+shape.getBoundingBoxWidth()+2;
+	   ++x )
+      {
+	x_positions.push_back( x );
+	y_positions.push_back( y );
+      }
+    }
+
+    // Use a number of points that is not a multiple of the kernel widths
+    x_positions.push_back( shape.getCenterXPosition() );
+    y_positions.push_back( shape.getCenterYPosition() );
+    
+    const unsigned number_of_points = x_positions.size();
+
+    std::vector<Uint32> in_mask( 
+	      GDev::Shape::getNumberOfMaskWords( number_of_points ), 0xFFFFFFFF );
+    std::vector<Uint32> on_mask( in_mask );
+
+    for( unsigned j = 0; j < kernels.size(); ++j )
+    {
+      if( !GDev::SurfaceBlitter::isKernelSupported( kernels[j] ) )
+	continue;
+
+      GDev::Shape::setKernel( kernels[j] );
+
+      shape.arePointsIn( x_positions.data(), 
+			 y_positions.data(), 
+			 number_of_points, 
+			 in_mask.data() );
+      shape.arePointsOn( x_positions.data(), 
+			 y_positions.data(), 
+			 number_of_points, 
+			 on_mask.data() );
+
+      for( unsigned k = 0; k < number_of_points; ++k )
+      {
+	BOOST_REQUIRE_EQUAL( 
+		    GDev::Shape::isMaskBitSet( in_mask.data(), k ),
+		    shape.isPointIn( x_positions[k], y_positions[k] ) );
+	BOOST_REQUIRE_EQUAL( 
+		    GDev::Shape::isMaskBitSet( on_mask.data(), k ),
+		    shape.isPointOn( x_positions[k], y_positions[k] ) );
+      }
+
+      // The bits past the last point must be cleared
+      if( number_of_points%32u != 0u )
+      {
+	BOOST_CHECK_EQUAL( in_mask.back() >> (number_of_points%32u), 0u );
+	BOOST_CHECK_EQUAL( on_mask.back() >> (number_of_points%32u), 0u );
+      }
+    }
+  }
+
+  GDev::Shape::setKernel( default_kernel );
+}
+
 //---------------------------------------------------------------------------//
 // end tstRectangle.cpp
 //---------------------------------------------------------------------------//
@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstRectanglePacker.cpp
+//! \author Alex Robinson
+//! \brief  The rectangle packer class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "RectanglePacker.hpp"
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the packer can be constructed
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  GDev::RectanglePacker packer( 256, 128 );
+
+  BOOST_CHECK_EQUAL( packer.getWidth(), 256 );
+  BOOST_CHECK_EQUAL( packer.getHeight(), 128 );
+  BOOST_CHECK_EQUAL( packer.getNumberOfRectangles(), 0u );
+  BOOST_CHECK_EQUAL( packer.getUsedArea(), 0ul );
+  BOOST_CHECK_EQUAL( packer.getOccupancy(), 0.0 );
+  BOOST_CHECK_EQUAL( packer.getNumberOfFreeRectangles(), 1u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that rectangles can be inserted
+BOOST_AUTO_TEST_CASE( insert )
+{
+  GDev::RectanglePacker packer( 128, 128 );
+
+  SDL_Rect placement;
+
+  BOOST_CHECK( packer.insert( 64, 32, placement ) );
+  BOOST_CHECK_EQUAL( placement.x, 0 );
+  BOOST_CHECK_EQUAL( placement.y, 0 );
+  BOOST_CHECK_EQUAL( placement.w, 64 );
+  BOOST_CHECK_EQUAL( placement.h, 32 );
+
+  // Rectangles that are too large do not fit
+  BOOST_CHECK( !packer.insert( 129, 10, placement ) );
+  BOOST_CHECK( !packer.insert( 128, 97, placement ) );
+
+  BOOST_CHECK( packer.insert( 128, 96, placement ) );
+  BOOST_CHECK( packer.insert( 64, 32, placement ) );
+
+  // The bin is full
+  BOOST_CHECK( !packer.insert( 1, 1, placement ) );
+
+  BOOST_CHECK_EQUAL( packer.getNumberOfRectangles(), 3u );
+  BOOST_CHECK_EQUAL( packer.getUsedArea(), 128ul*128ul );
+  BOOST_CHECK_EQUAL( packer.getOccupancy(), 1.0 );
+  BOOST_CHECK_EQUAL( packer.getNumberOfFreeRectangles(), 0u );
+
+  packer.clear();
+
+  BOOST_CHECK_EQUAL( packer.getNumberOfRectangles(), 0u );
+  BOOST_CHECK( packer.insert( 128, 128, placement ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the placed rectangles do not overlap
+BOOST_AUTO_TEST_CASE( insert_no_overlap )
+{
+  GDev::RectanglePacker packer( 512, 512 );
+
+  std::vector<SDL_Rect> placements;
+
+  SDL_Rect placement;
+
+  for( int i = 0; i < 2000; ++i )
+  {
+    const int width = 4 + (i*37)%29;
+    const int height = 4 + (i*53)%31;
+
+    if( packer.insert( width, height, placement ) )
+    {
+      BOOST_CHECK_EQUAL( placement.w, width );
+      BOOST_CHECK_EQUAL( placement.h, height );
+
+      placements.push_back( placement );
+    }
+  }
+
+  BOOST_CHECK_EQUAL( packer.getNumberOfRectangles(), placements.size() );
+
+  for( unsigned i = 0; i < placements.size(); ++i )
+  {
+    BOOST_CHECK( placements[i].x >= 0 );
+    BOOST_CHECK( placements[i].y >= 0 );
+    BOOST_CHECK( placements[i].x + placements[i].w <= 512 );
+    BOOST_CHECK( placements[i].y + placements[i].h <= 512 );
+
+    for( unsigned j = i+1; j < placements.size(); ++j )
+      BOOST_CHECK( !SDL_HasIntersection( &placements[i], &placements[j] ) );
+  }
+
+  // The bin should be packed tightly once it is full
+  BOOST_CHECK( packer.getOccupancy() > 0.9 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstRectanglePacker.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,228 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSpriteBatch.cpp
+//! \author Alex Robinson
+//! \brief  The sprite batch class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "SpriteBatch.hpp"
+#include "StaticTexture.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+#include "Rectangle.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface
+std::shared_ptr<GDev::Surface> test_surface;
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    test_surface.reset( new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+
+// Create a solid color texture
+std::shared_ptr<GDev::Texture> createSolidTexture( const SDL_Color& color )
+{
+  GDev::Rectangle area( 0, 0, 20, 20 );
+
+  return std::shared_ptr<GDev::Texture>(
+	  new GDev::StaticTexture( test_surface_renderer, area, color, color, color ) );
+}
+
+// Get the color of a test surface pixel (ARGB)
+Uint32 getTestSurfacePixel( const int x_position, const int y_position )
+{
+  const Uint8* pixels = (const Uint8*)test_surface->getPixels();
+
+  return *((const Uint32*)(pixels + y_position*test_surface->getPitch()) +
+	   x_position);
+}
+
+// Clear the test surface
+void clearTestSurface()
+{
+  SDL_Color black = {0,0,0,0xFF};
+  test_surface_renderer->setDrawColor( black );
+  test_surface_renderer->clear();
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that sprites can be added to the batch
+BOOST_AUTO_TEST_CASE( add )
+{
+  SDL_Color red = {0xFF,0,0,0xFF};
+
+  std::shared_ptr<GDev::Texture> texture = createSolidTexture( red );
+
+  GDev::SpriteBatch batch;
+
+  BOOST_CHECK( batch.isEmpty() );
+  BOOST_CHECK_EQUAL( batch.getNumberOfSprites(), 0u );
+
+  SDL_Rect texture_clip = {0,0,10,10};
+
+  batch.add( texture, 0, 10, 10 );
+  batch.add( texture, 0, 30, 10, &texture_clip );
+  batch.add( texture, 1, &texture_clip, NULL, 45.0 );
+
+  BOOST_CHECK( !batch.isEmpty() );
+  BOOST_CHECK_EQUAL( batch.getNumberOfSprites(), 3u );
+
+  batch.clear();
+
+  BOOST_CHECK( batch.isEmpty() );
+  BOOST_CHECK_EQUAL( batch.getNumberOfSprites(), 0u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that sprites are grouped by layer, texture and texture state
+BOOST_AUTO_TEST_CASE( render_groups )
+{
+  SDL_Color red = {0xFF,0,0,0xFF};
+  SDL_Color blue = {0,0,0xFF,0xFF};
+
+  std::shared_ptr<GDev::Texture> red_texture = createSolidTexture( red );
+  std::shared_ptr<GDev::Texture> blue_texture = createSolidTexture( blue );
+
+  clearTestSurface();
+
+  GDev::SpriteBatch batch;
+
+  // Interleave the textures in one layer
+  for( int i = 0; i < 100; ++i )
+  {
+    batch.add( red_texture, 0, (i%10)*20, (i/10)*10 );
+    batch.add( blue_texture, 0, (i%10)*20, (i/10)*10 + 5 );
+  }
+
+  batch.render();
+
+  BOOST_CHECK( batch.isEmpty() );
+  BOOST_CHECK_EQUAL( batch.getNumberOfSubmittedGroups(), 2u );
+
+  // Add sprites to a second layer and change the alpha of some sprites
+  for( int i = 0; i < 100; ++i )
+  {
+    batch.add( red_texture, 0, (i%10)*20, (i/10)*10 );
+    batch.add( blue_texture, 1, (i%10)*20, (i/10)*10 );
+  }
+
+  red_texture->setAlphaMod( 0x80 );
+
+  for( int i = 0; i < 10; ++i )
+    batch.add( red_texture, 0, i*20, 0 );
+
+  red_texture->setAlphaMod( 0xFF );
+
+  batch.render();
+
+  BOOST_CHECK_EQUAL( batch.getNumberOfSubmittedGroups(), 3u );
+
+  // Check that the original texture state was restored
+  BOOST_CHECK_EQUAL( red_texture->getAlphaMod(), 0xFF );
+
+  // Rendering an empty batch submits nothing
+  batch.render();
+
+  BOOST_CHECK_EQUAL( batch.getNumberOfSubmittedGroups(), 0u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the layers are rendered in order
+BOOST_AUTO_TEST_CASE( render_layers )
+{
+  SDL_Color red = {0xFF,0,0,0xFF};
+  SDL_Color blue = {0,0,0xFF,0xFF};
+
+  std::shared_ptr<GDev::Texture> red_texture = createSolidTexture( red );
+  std::shared_ptr<GDev::Texture> blue_texture = createSolidTexture( blue );
+
+  clearTestSurface();
+
+  GDev::SpriteBatch batch;
+
+  // The red sprite is added last but is in the lower layer
+  batch.add( blue_texture, 1, 0, 0 );
+  batch.add( red_texture, 0, 10, 0 );
+
+  // Sprites in the same layer with the same texture keep their order
+  batch.add( red_texture, 2, 50, 0 );
+  batch.add( red_texture, 2, 60, 0 );
+
+  batch.render();
+
+  test_surface_renderer->present();
+
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 5, 5 ), 0xFF0000FF );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 15, 5 ), 0xFF0000FF );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 25, 5 ), 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 65, 5 ), 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 85, 5 ), 0xFF000000 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the recorded texture state is used
+BOOST_AUTO_TEST_CASE( render_texture_state )
+{
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+  std::shared_ptr<GDev::Texture> texture = createSolidTexture( white );
+
+  clearTestSurface();
+
+  GDev::SpriteBatch batch;
+
+  texture->setColorMod( 0, 0xFF, 0 );
+  batch.add( texture, 0, 0, 0 );
+
+  texture->setColorMod( 0xFF, 0xFF, 0xFF );
+  batch.add( texture, 0, 20, 0 );
+
+  batch.render();
+
+  test_surface_renderer->present();
+
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 5, 5 ), 0xFF00FF00 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 25, 5 ), 0xFFFFFFFF );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSpriteBatch.cpp
+//---------------------------------------------------------------------------//
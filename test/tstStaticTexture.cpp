@@ -10,6 +10,8 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
+#include <utility>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -384,6 +386,118 @@ BOOST_AUTO_TEST_CASE( getFormat_windrend )
   BOOST_CHECK( format != SDL_PIXELFORMAT_UNKNOWN );
 }
 
+//---------------------------------------------------------------------------//
+// Check that surfaces are converted to the native format without the slow
+// conversion path
+BOOST_AUTO_TEST_CASE( getFormat_native_surfrend )
+{
+  test_surface_renderer->resetSlowTextureConversionCounter();
+  
+  GDev::Surface argb_surface( 16, 16, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface abgr_surface( 16, 16, SDL_PIXELFORMAT_ABGR8888 );
+  GDev::Surface rgb_surface( 16, 16, SDL_PIXELFORMAT_RGB24 );
+
+  GDev::StaticTexture argb_texture( test_surface_renderer, argb_surface );
+  GDev::StaticTexture abgr_texture( test_surface_renderer, abgr_surface );
+  GDev::StaticTexture rgb_texture( test_surface_renderer, rgb_surface );
+
+  BOOST_CHECK_EQUAL( argb_texture.getFormat(), 
+		     test_surface_renderer->getNativeTextureFormat() );
+  BOOST_CHECK_EQUAL( abgr_texture.getFormat(), 
+		     test_surface_renderer->getNativeTextureFormat() );
+  BOOST_CHECK_EQUAL( rgb_texture.getFormat(), 
+		     test_surface_renderer->getNativeTextureFormat( false ) );
+  BOOST_CHECK_EQUAL( 
+	       test_surface_renderer->getNumberOfSlowTextureConversions(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the color key of 24 and 32 bit surfaces is folded into the
+// alpha channel without the slow conversion path
+BOOST_AUTO_TEST_CASE( color_key_native_surfrend )
+{
+  test_surface_renderer->resetSlowTextureConversionCounter();
+
+  // A magenta (color key) pixel followed by a red pixel
+  GDev::Surface rgb_surface( 2, 1, SDL_PIXELFORMAT_RGB24 );
+
+  Uint8* rgb_pixels = (Uint8*)rgb_surface.getRawSurfacePtr()->pixels;
+  rgb_pixels[0] = 0xFF; rgb_pixels[1] = 0x00; rgb_pixels[2] = 0xFF;
+  rgb_pixels[3] = 0xFF; rgb_pixels[4] = 0x00; rgb_pixels[5] = 0x00;
+
+  rgb_surface.setColorKey(
+		  SDL_MapRGB( &rgb_surface.getPixelFormat(), 0xFF, 0, 0xFF ) );
+
+  GDev::Surface argb_surface( 2, 1, SDL_PIXELFORMAT_ARGB8888 );
+
+  Uint32* argb_pixels = (Uint32*)argb_surface.getRawSurfacePtr()->pixels;
+  argb_pixels[0] = 0xFFFF00FF;
+  argb_pixels[1] = 0xFFFF0000;
+
+  argb_surface.setColorKey( 0xFFFF00FF );
+
+  GDev::StaticTexture rgb_texture( test_surface_renderer, rgb_surface );
+  GDev::StaticTexture argb_texture( test_surface_renderer, argb_surface );
+
+  if( test_surface_renderer->getNativeTextureFormat() ==
+      SDL_PIXELFORMAT_ARGB8888 )
+  {
+    BOOST_CHECK_EQUAL(
+	       test_surface_renderer->getNumberOfSlowTextureConversions(), 0 );
+  }
+
+  SDL_Color black = {0,0,0,0xFF};
+  test_surface_renderer->setDrawColor( black );
+  test_surface_renderer->clear();
+
+  rgb_texture.render( 0, 0 );
+  argb_texture.render( 0, 1 );
+
+  const Uint8* pixels = (const Uint8*)test_surface->getPixels();
+  const Uint32* first_row = (const Uint32*)pixels;
+  const Uint32* second_row =
+    (const Uint32*)(pixels + test_surface->getPitch());
+
+  BOOST_CHECK_EQUAL( first_row[0], 0xFF000000 );
+  BOOST_CHECK_EQUAL( first_row[1], 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( second_row[0], 0xFF000000 );
+  BOOST_CHECK_EQUAL( second_row[1], 0xFFFF0000 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a texture can be moved
+BOOST_AUTO_TEST_CASE( move_surfrend )
+{
+  GDev::StaticTexture texture( test_surface_renderer, test_image_filename );
+
+  const SDL_Texture* raw_texture = texture.getRawTexturePtr();
+
+  GDev::StaticTexture moved_texture( std::move( texture ) );
+
+  BOOST_CHECK_EQUAL( moved_texture.getRawTexturePtr(), raw_texture );
+  BOOST_CHECK_EQUAL( moved_texture.getWidth(), 800 );
+  BOOST_CHECK( texture.getRawTexturePtr() == NULL );
+  BOOST_CHECK_EQUAL( texture.getWidth(), 0 );
+  
+  BOOST_CHECK_NO_THROW( moved_texture.render( 0, 0 ) );
+
+  // Textures can be stored in a vector
+  GDev::Surface surface( 16, 16, SDL_PIXELFORMAT_ARGB8888 );
+  
+  std::vector<GDev::StaticTexture> textures;
+
+  for( unsigned i = 0; i < 100; ++i )
+    textures.push_back( GDev::StaticTexture( test_surface_renderer, surface ) );
+
+  textures[0] = std::move( moved_texture );
+
+  BOOST_CHECK_EQUAL( textures[0].getRawTexturePtr(), raw_texture );
+  BOOST_CHECK_EQUAL( textures[99].getWidth(), 16 );
+
+  for( unsigned i = 0; i < textures.size(); ++i )
+    BOOST_CHECK_NO_THROW( textures[i].render( 0, 0 ) );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the access pattern can be returned
 BOOST_AUTO_TEST_CASE( getAccessPattern_surfrend )
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -188,6 +189,28 @@ BOOST_AUTO_TEST_CASE( copy_surfrend )
   BOOST_CHECK_NO_THROW( texture.copy( image_surface ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the streaming texture can be moved
+BOOST_AUTO_TEST_CASE( move_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 16, 8 );
+
+  const SDL_Texture* raw_texture = texture.getRawTexturePtr();
+
+  GDev::StreamingTexture moved_texture( std::move( texture ) );
+
+  BOOST_CHECK_EQUAL( moved_texture.getRawTexturePtr(), raw_texture );
+  BOOST_CHECK( !moved_texture.isLocked() );
+  BOOST_CHECK( texture.getRawTexturePtr() == NULL );
+
+  GDev::Surface image_surface( test_image_filename );
+
+  texture = GDev::StreamingTexture( test_surface_renderer, image_surface );
+
+  BOOST_CHECK_EQUAL( texture.getWidth(), image_surface.getWidth() );
+  BOOST_CHECK_NO_THROW( texture.copy( image_surface ) );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the surface can be copied to the streaming texture
 BOOST_AUTO_TEST_CASE( copy_windrend )
@@ -201,6 +224,209 @@ BOOST_AUTO_TEST_CASE( copy_windrend )
   BOOST_CHECK_NO_THROW( texture.copy( image_surface ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that a surface with a different format and pitch can be copied to
+// the streaming texture
+BOOST_AUTO_TEST_CASE( copy_convert_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 5, 3 );
+
+  GDev::Surface abgr_surface( 7, 2, SDL_PIXELFORMAT_ABGR8888 );
+
+  SDL_FillRect( abgr_surface.getRawSurfacePtr(), NULL, 0xFF302010 );
+
+  BOOST_CHECK_NO_THROW( texture.copy( abgr_surface ) );
+
+  // The software renderer keeps the pixels of a streaming texture
+  void* pixels;
+  int pitch;
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+
+  const Uint32* first_row = static_cast<const Uint32*>( pixels );
+  const Uint32* second_row = reinterpret_cast<const Uint32*>(
+				      static_cast<const Uint8*>( pixels ) + pitch );
+
+  BOOST_CHECK_EQUAL( first_row[0], 0xFF102030 );
+  BOOST_CHECK_EQUAL( first_row[4], 0xFF102030 );
+  BOOST_CHECK_EQUAL( second_row[4], 0xFF102030 );
+
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a surface with a format that the pixel format converter does
+// not support can be copied to the streaming texture
+BOOST_AUTO_TEST_CASE( copy_convert_pixel_view_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 5, 3,
+				  SDL_PIXELFORMAT_ARGB8888 );
+
+  GDev::Surface rgb565_surface( 7, 2, SDL_PIXELFORMAT_RGB565 );
+
+  SDL_FillRect( rgb565_surface.getRawSurfacePtr(), NULL, 0xF800 );
+
+  BOOST_CHECK_NO_THROW( texture.copy( rgb565_surface ) );
+
+  // The software renderer keeps the pixels of a streaming texture
+  void* pixels;
+  int pitch;
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+
+  const Uint32* first_row = static_cast<const Uint32*>( pixels );
+  const Uint32* second_row = reinterpret_cast<const Uint32*>(
+				      static_cast<const Uint8*>( pixels ) + pitch );
+
+  BOOST_CHECK_EQUAL( first_row[0], 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( first_row[4], 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( second_row[4], 0xFFFF0000 );
+
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the changed areas of a surface are copied to the
+// streaming texture
+BOOST_AUTO_TEST_CASE( copy_changed_areas_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 64, 64 );
+
+  GDev::Surface surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_FillRect( surface.getRawSurfacePtr(), NULL, 0xFF000000 );
+
+  texture.copy( surface );
+
+  SDL_FillRect( surface.getRawSurfacePtr(), NULL, 0xFFFFFFFF );
+
+  std::vector<SDL_Rect> changed_areas( 2 );
+  changed_areas[0].x = 2;
+  changed_areas[0].y = 3;
+  changed_areas[0].w = 4;
+  changed_areas[0].h = 5;
+  changed_areas[1].x = 60;
+  changed_areas[1].y = 60;
+  changed_areas[1].w = 10;
+  changed_areas[1].h = 10;
+
+  BOOST_CHECK_NO_THROW( texture.copy( surface, changed_areas ) );
+
+  // The software renderer keeps the pixels of a streaming texture
+  void* pixels;
+  int pitch;
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+
+  const Uint8* bytes = static_cast<const Uint8*>( pixels );
+  
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+3*pitch )[2],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+7*pitch )[5],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+63*pitch )[63],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+2*pitch )[2],
+		     0xFF000000 );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+30*pitch )[30],
+		     0xFF000000 );
+
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the max number of copy sections can be set per texture
+BOOST_AUTO_TEST_CASE( get_setMaxNumberOfCopySections_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 64, 64 );
+  GDev::StreamingTexture other_texture( test_surface_renderer, 64, 64 );
+
+  BOOST_CHECK_EQUAL( texture.getMaxNumberOfCopySections(), 8u );
+
+  texture.setMaxNumberOfCopySections( 1u );
+
+  BOOST_CHECK_EQUAL( texture.getMaxNumberOfCopySections(), 1u );
+  BOOST_CHECK_EQUAL( other_texture.getMaxNumberOfCopySections(), 8u );
+
+  // The changed areas are merged into a single section
+  GDev::Surface surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_FillRect( surface.getRawSurfacePtr(), NULL, 0xFFFFFFFF );
+
+  std::vector<SDL_Rect> changed_areas( 2 );
+  changed_areas[0].x = 0;
+  changed_areas[0].y = 0;
+  changed_areas[0].w = 4;
+  changed_areas[0].h = 4;
+  changed_areas[1].x = 60;
+  changed_areas[1].y = 60;
+  changed_areas[1].w = 4;
+  changed_areas[1].h = 4;
+
+  BOOST_CHECK_NO_THROW( texture.copy( surface, changed_areas ) );
+
+  void* pixels;
+  int pitch;
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+
+  const Uint8* bytes = static_cast<const Uint8*>( pixels );
+
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+30*pitch )[30],
+		     0xFFFFFFFF );
+
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+
+  // The setting moves with the texture
+  GDev::StreamingTexture moved_texture( std::move( texture ) );
+
+  BOOST_CHECK_EQUAL( moved_texture.getMaxNumberOfCopySections(), 1u );
+
+  other_texture = std::move( moved_texture );
+
+  BOOST_CHECK_EQUAL( other_texture.getMaxNumberOfCopySections(), 1u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the areas of a surface that differ from the previous
+// surface are copied to the streaming texture
+BOOST_AUTO_TEST_CASE( copyChanges_surfrend )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 100, 100 );
+
+  GDev::Surface previous_surface( 100, 100, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface surface( 100, 100, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_FillRect( previous_surface.getRawSurfacePtr(), NULL, 0xFF000000 );
+  SDL_FillRect( surface.getRawSurfacePtr(), NULL, 0xFF000000 );
+
+  texture.copy( previous_surface );
+
+  // Change one pixel of the surface and one pixel of the texture
+  SDL_Rect changed_pixel = {70, 40, 1, 1};
+  SDL_FillRect( surface.getRawSurfacePtr(), &changed_pixel, 0xFFFFFFFF );
+
+  void* pixels;
+  int pitch;
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+  static_cast<Uint32*>( pixels )[0] = 0xFF0000FF;
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+
+  BOOST_CHECK_NO_THROW( texture.copyChanges( surface, previous_surface ) );
+
+  SDL_LockTexture( texture.getRawTexturePtr(), NULL, &pixels, &pitch );
+
+  const Uint8* bytes = static_cast<const Uint8*>( pixels );
+
+  // The changed tile was copied but the unchanged tiles were not
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( bytes+40*pitch )[70],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( static_cast<const Uint32*>( pixels )[0], 0xFF0000FF );
+
+  SDL_UnlockTexture( texture.getRawTexturePtr() );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the texture can be rendered
 BOOST_AUTO_TEST_CASE( render_basic_surfrend )
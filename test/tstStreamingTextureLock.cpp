@@ -0,0 +1,146 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstStreamingTextureLock.cpp
+//! \author Alex Robinson
+//! \brief  The streaming texture lock class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "StreamingTextureLock.hpp"
+#include "StreamingTexture.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface
+std::shared_ptr<GDev::Surface> test_surface;
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    test_surface.reset( new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the lock locks and unlocks the texture
+BOOST_AUTO_TEST_CASE( constructor_destructor )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 16, 8 );
+
+  {
+    GDev::StreamingTextureLock lock( texture );
+
+    BOOST_CHECK( texture.isLocked() );
+    BOOST_CHECK_EQUAL( lock.getWidth(), 16 );
+    BOOST_CHECK_EQUAL( lock.getHeight(), 8 );
+    BOOST_CHECK( lock.getPitch() >= 16*4 );
+    BOOST_CHECK_EQUAL( lock.getFormat(), SDL_PIXELFORMAT_ARGB8888 );
+  }
+
+  BOOST_CHECK( !texture.isLocked() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the texture is unlocked when an exception is thrown
+BOOST_AUTO_TEST_CASE( destructor_exception )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 16, 8 );
+
+  try{
+    GDev::StreamingTextureLock lock( texture );
+
+    throw std::runtime_error( "test" );
+  }
+  catch( const std::runtime_error& )
+  { /* ... */ }
+
+  BOOST_CHECK( !texture.isLocked() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that pixels can be written through the lock
+BOOST_AUTO_TEST_CASE( getPixel )
+{
+  GDev::StreamingTexture texture( test_surface_renderer, 16, 8 );
+
+  {
+    GDev::StreamingTextureLock lock( texture );
+
+    for( int y = 0; y < lock.getHeight(); ++y )
+    {
+      Uint32* row = lock.getRow<Uint32>( y );
+
+      for( int x = 0; x < lock.getWidth(); ++x )
+	row[x] = 0xFF000000 | (y << 8) | x;
+    }
+  }
+
+  // Write a section
+  {
+    SDL_Rect section = {4, 2, 3, 3};
+
+    GDev::StreamingTextureLock lock( texture, section );
+
+    BOOST_CHECK_EQUAL( lock.getWidth(), 3 );
+    BOOST_CHECK_EQUAL( lock.getHeight(), 3 );
+
+    for( int y = 0; y < lock.getHeight(); ++y )
+    {
+      for( int x = 0; x < lock.getWidth(); ++x )
+	lock.getPixel<Uint32>( x, y ) = 0xFFFFFFFF;
+    }
+  }
+
+  // Render the texture to check the pixels
+  texture.setBlendMode( SDL_BLENDMODE_NONE );
+
+  BOOST_CHECK_NO_THROW( texture.render( 0, 0 ) );
+
+  const Uint8* pixels = static_cast<const Uint8*>( test_surface->getPixels() );
+  const int pitch = test_surface->getPitch();
+
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( pixels + pitch )[3],
+		     0xFF000103 );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( pixels + 2*pitch )[4],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( pixels + 4*pitch )[6],
+		     0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( reinterpret_cast<const Uint32*>( pixels + 5*pitch )[7],
+		     0xFF000507 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstStreamingTextureLock.cpp
+//---------------------------------------------------------------------------//
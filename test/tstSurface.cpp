@@ -9,6 +9,9 @@
 // Std Lib Includes
 #include <iostream>
 #include <string>
+#include <vector>
+#include <utility>
+#include <memory>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -17,8 +20,11 @@
 
 // GDev Includes
 #include "Surface.hpp"
+#include "SurfacePixelPool.hpp"
 #include "Ellipse.hpp"
 #include "Rectangle.hpp"
+#include "SurfaceRenderer.hpp"
+#include "StaticTexture.hpp"
 #include "GlobalSDLSession.hpp"
 
 //---------------------------------------------------------------------------//
@@ -173,6 +179,267 @@ BOOST_AUTO_TEST_CASE( getPitch )
   BOOST_CHECK_EQUAL( pitch, 3200 );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the rows of created surfaces are aligned
+BOOST_AUTO_TEST_CASE( getPitch_aligned )
+{
+  GDev::Surface surface( 101, 20, SDL_PIXELFORMAT_ARGB8888 );
+
+  BOOST_CHECK_EQUAL( surface.getPitch() % 64, 0 );
+  BOOST_CHECK_EQUAL( reinterpret_cast<size_t>( surface.getPixels() ) % 64, 0 );
+
+  GDev::Surface converted_surface( surface, SDL_PIXELFORMAT_RGB24 );
+
+  BOOST_CHECK_EQUAL( converted_surface.getPitch() % 64, 0 );
+  BOOST_CHECK_EQUAL( 
+	   reinterpret_cast<size_t>( converted_surface.getPixels() ) % 64, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the pixels of freed surfaces are recycled
+BOOST_AUTO_TEST_CASE( pixels_recycled )
+{
+  const void* pixels;
+  
+  {
+    GDev::Surface surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+    pixels = surface.getPixels();
+  }
+
+  const unsigned long number_of_recycled_allocations = 
+    GDev::SurfacePixelPool::getNumberOfRecycledAllocations();
+
+  GDev::Surface surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+  BOOST_CHECK_EQUAL( surface.getPixels(), pixels );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfRecycledAllocations(),
+		     number_of_recycled_allocations + 1 );
+
+  // Blank surfaces are always cleared
+  BOOST_CHECK_EQUAL( static_cast<const Uint32*>( surface.getPixels() )[0], 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a surface can be moved
+BOOST_AUTO_TEST_CASE( move )
+{
+  GDev::Surface surface( test_image_filename );
+
+  const SDL_Surface* raw_surface = surface.getRawSurfacePtr();
+
+  GDev::Surface moved_surface( std::move( surface ) );
+
+  BOOST_CHECK_EQUAL( moved_surface.getRawSurfacePtr(), raw_surface );
+  BOOST_CHECK( moved_surface.isLocallyOwned() );
+  BOOST_CHECK( surface.getRawSurfacePtr() == NULL );
+  BOOST_CHECK( !surface.isLocallyOwned() );
+
+  GDev::Surface blank_surface( 10, 10, SDL_PIXELFORMAT_ARGB8888 );
+
+  blank_surface = std::move( moved_surface );
+
+  BOOST_CHECK_EQUAL( blank_surface.getRawSurfacePtr(), raw_surface );
+  BOOST_CHECK_EQUAL( blank_surface.getWidth(), 800 );
+  BOOST_CHECK( moved_surface.getRawSurfacePtr() == NULL );
+
+  // Surfaces can be stored in a vector
+  std::vector<GDev::Surface> surfaces;
+
+  for( int i = 1; i <= 10; ++i )
+    surfaces.push_back( GDev::Surface( i, i, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  for( int i = 1; i <= 10; ++i )
+    BOOST_CHECK_EQUAL( surfaces[i-1].getWidth(), i );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a sub-surface shares the pixels of the parent surface
+BOOST_AUTO_TEST_CASE( constructor_sub_surface )
+{
+  std::shared_ptr<GDev::Surface> sheet( 
+		     new GDev::Surface( 64, 32, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  SDL_Rect frame_area = {16, 8, 16, 16};
+
+  GDev::Surface frame( sheet, frame_area );
+
+  BOOST_CHECK( frame.isSubSurface() );
+  BOOST_CHECK( !sheet->isSubSurface() );
+  BOOST_CHECK_EQUAL( frame.getParentSurface().get(), sheet.get() );
+  BOOST_CHECK_EQUAL( frame.getWidth(), 16 );
+  BOOST_CHECK_EQUAL( frame.getHeight(), 16 );
+  BOOST_CHECK_EQUAL( frame.getPitch(), sheet->getPitch() );
+  BOOST_CHECK_EQUAL( frame.getPixelFormatValue(), SDL_PIXELFORMAT_ARGB8888 );
+  BOOST_CHECK_EQUAL( frame.getClipRectangle().w, 16 );
+
+  // Writing to the frame writes to the sheet
+  Uint32* frame_pixels = 
+    static_cast<Uint32*>( frame.getRawSurfacePtr()->pixels );
+
+  frame_pixels[frame.getPitch()/4 + 1] = 0xFF123456;
+
+  const Uint32* sheet_pixels = 
+    static_cast<const Uint32*>( sheet->getPixels() );
+
+  BOOST_CHECK_EQUAL( sheet_pixels[9*sheet->getPitch()/4 + 17], 0xFF123456 );
+
+  // The frame can be blitted
+  GDev::Surface frame_copy( 16, 16, SDL_PIXELFORMAT_ARGB8888 );
+  frame.setBlendMode( SDL_BLENDMODE_NONE );
+
+  BOOST_CHECK_NO_THROW( frame.blitSurface( frame_copy ) );
+  BOOST_CHECK_EQUAL( static_cast<const Uint32*>( frame_copy.getPixels() )[
+					    frame_copy.getPitch()/4 + 1 ],
+		     0xFF123456 );
+
+  // The frame keeps the sheet alive
+  GDev::Surface* raw_sheet = sheet.get();
+  
+  sheet.reset();
+
+  BOOST_CHECK_EQUAL( frame.getParentSurface().get(), raw_sheet );
+  BOOST_CHECK_EQUAL( frame_pixels[frame.getPitch()/4 + 1], 0xFF123456 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the number of sub-surface pixels only includes the view
+BOOST_AUTO_TEST_CASE( getNumberOfPixels_sub_surface )
+{
+  std::shared_ptr<GDev::Surface> sheet( 
+		   new GDev::Surface( 4096, 64, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  SDL_Rect frame_area = {32, 16, 32, 32};
+
+  GDev::Surface frame( sheet, frame_area );
+
+  BOOST_CHECK_EQUAL( frame.getPitch(), sheet->getPitch() );
+  BOOST_CHECK_EQUAL( frame.getNumberOfPixels(), 32*32 );
+  BOOST_CHECK_EQUAL( sheet->getNumberOfPixels(), 4096*64 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a sub-surface can be locked, exported and used for a texture
+BOOST_AUTO_TEST_CASE( sub_surface_lock_export_texture )
+{
+  std::shared_ptr<GDev::Surface> sheet(
+		     new GDev::Surface( 64, 32, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  SDL_Rect frame_area = {16, 8, 16, 16};
+
+  GDev::Surface frame( sheet, frame_area );
+
+  static_cast<Uint32*>( frame.getRawSurfacePtr()->pixels )[0] = 0xFF123456;
+
+  // Lock and unlock
+  BOOST_CHECK( !frame.isLocked() );
+
+  BOOST_CHECK_NO_THROW( frame.lock() );
+
+  BOOST_CHECK( frame.isLocked() );
+  BOOST_CHECK_EQUAL( static_cast<const Uint32*>( frame.getPixels() )[0],
+		     0xFF123456 );
+
+  frame.unlock();
+
+  BOOST_CHECK( !frame.isLocked() );
+
+  // Export (only the frame pixels are exported)
+  BOOST_CHECK_NO_THROW( frame.exportToBMP( "test_sub_surface.bmp" ) );
+
+  GDev::Surface exported_frame( "test_sub_surface.bmp" );
+
+  BOOST_CHECK_EQUAL( exported_frame.getWidth(), 16 );
+  BOOST_CHECK_EQUAL( exported_frame.getHeight(), 16 );
+
+  // Texture creation
+  std::shared_ptr<GDev::Surface> target(
+		     new GDev::Surface( 32, 32, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  std::shared_ptr<GDev::Renderer> renderer(
+				      new GDev::SurfaceRenderer( target ) );
+
+  frame.setBlendMode( SDL_BLENDMODE_NONE );
+
+  GDev::StaticTexture texture( renderer, frame );
+
+  BOOST_CHECK_EQUAL( texture.getWidth(), 16 );
+  BOOST_CHECK_EQUAL( texture.getHeight(), 16 );
+
+  texture.render( 0, 0 );
+
+  BOOST_CHECK_EQUAL( static_cast<const Uint32*>( target->getPixels() )[0],
+		     0xFF123456 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the sub-surfaces of a surface are counted
+BOOST_AUTO_TEST_CASE( getNumberOfSubSurfaces )
+{
+  std::shared_ptr<GDev::Surface> sheet(
+		     new GDev::Surface( 64, 32, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 0u );
+
+  SDL_Rect frame_area = {0, 0, 16, 16};
+
+  {
+    GDev::Surface frame( sheet, frame_area );
+
+    BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 1u );
+
+    // Moving a sub-surface does not change the count
+    GDev::Surface moved_frame( std::move( frame ) );
+
+    BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 1u );
+
+    GDev::Surface other_frame( sheet, frame_area );
+
+    BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 2u );
+
+    other_frame = std::move( moved_frame );
+
+    BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 1u );
+  }
+
+  BOOST_CHECK_EQUAL( sheet->getNumberOfSubSurfaces(), 0u );
+
+  // A surface without sub-surfaces can be assigned to
+  *sheet = GDev::Surface( 8, 8, SDL_PIXELFORMAT_ARGB8888 );
+
+  BOOST_CHECK_EQUAL( sheet->getWidth(), 8 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that a sprite sheet can be sliced without copying pixels
+BOOST_AUTO_TEST_CASE( constructor_sub_surface_slice )
+{
+  std::shared_ptr<GDev::Surface> sheet( 
+		   new GDev::Surface( 1024, 1024, SDL_PIXELFORMAT_ARGB8888 ) );
+
+  const unsigned long number_of_allocations = 
+    GDev::SurfacePixelPool::getNumberOfAllocations();
+  
+  std::vector<GDev::Surface> frames;
+  frames.reserve( 32*32 );
+
+  for( int y = 0; y < 32; ++y )
+  {
+    for( int x = 0; x < 32; ++x )
+    {
+      SDL_Rect frame_area = {x*32, y*32, 32, 32};
+      
+      frames.push_back( GDev::Surface( sheet, frame_area ) );
+    }
+  }
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfAllocations(),
+		     number_of_allocations );
+  BOOST_CHECK_EQUAL( frames.back().getPixels(), 
+		     static_cast<const Uint8*>( sheet->getPixels() ) +
+		     31*32*sheet->getPitch() + 31*32*4 );
+}
+
 //---------------------------------------------------------------------------//
 // Check that pixel format can be returned
 BOOST_AUTO_TEST_CASE( getPixelFormat )
@@ -210,6 +477,12 @@ BOOST_AUTO_TEST_CASE( getNumberOfPixels )
   GDev::Surface formatted_surface( surface, SDL_PIXELFORMAT_ARGB8888 );
 
   BOOST_CHECK_EQUAL( formatted_surface.getNumberOfPixels(), 480000 ); 
+
+  // The padded rows of the pooled pixels are not counted
+  GDev::Surface padded_surface( 17, 5, SDL_PIXELFORMAT_ARGB8888 );
+
+  BOOST_CHECK( padded_surface.getPitch() > 17*4 );
+  BOOST_CHECK_EQUAL( padded_surface.getNumberOfPixels(), 17*5 );
 }
 
 //---------------------------------------------------------------------------//
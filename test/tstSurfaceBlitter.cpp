@@ -0,0 +1,370 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSurfaceBlitter.cpp
+//! \author Alex Robinson
+//! \brief  The surface blitter class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "SurfaceBlitter.hpp"
+#include "Surface.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+// Get the kernels that are supported by the CPU
+std::vector<GDev::SimdKernel> getSupportedKernels()
+{
+  std::vector<GDev::SimdKernel> kernels;
+
+  kernels.push_back( GDev::SCALAR_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::SSE2_KERNEL ) )
+    kernels.push_back( GDev::SSE2_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::AVX2_KERNEL ) )
+    kernels.push_back( GDev::AVX2_KERNEL );
+
+  return kernels;
+}
+
+// Blit a row of identical pixels (long enough to use the simd loop + tail)
+Uint32 blitPixel( const Uint32 source_pixel,
+		  const Uint32 destination_pixel,
+		  const GDev::SurfaceBlitter::Parameters& parameters )
+{
+  std::vector<Uint32> source_row( 19, source_pixel );
+  std::vector<Uint32> destination_row( 19, destination_pixel );
+
+  GDev::SurfaceBlitter::blitRow( &source_row[0],
+				 &destination_row[0],
+				 destination_row.size(),
+				 parameters );
+
+  for( unsigned i = 1; i < destination_row.size(); ++i )
+    BOOST_CHECK_EQUAL( destination_row[i], destination_row[0] );
+
+  return destination_row[0];
+}
+
+// Get a pixel of an ARGB8888 surface
+Uint32 getPixel( const GDev::Surface& surface, const int x, const int y )
+{
+  const Uint8* row = static_cast<const Uint8*>( surface.getPixels() ) +
+    y*surface.getPitch();
+
+  return reinterpret_cast<const Uint32*>( row )[x];
+}
+
+// Fill an ARGB8888 surface
+void fillSurface( GDev::Surface& surface, const Uint32 pixel )
+{
+  SDL_FillRect( surface.getRawSurfacePtr(), NULL, pixel );
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the kernel can be selected
+BOOST_AUTO_TEST_CASE( get_setKernel )
+{
+  BOOST_CHECK( GDev::SurfaceBlitter::isKernelSupported(
+				     GDev::SCALAR_KERNEL ) );
+  BOOST_CHECK_EQUAL( GDev::SurfaceBlitter::getKernel(),
+		     GDev::SurfaceBlitter::getBestSupportedKernel() );
+
+  std::cout << "best kernel: "
+	    << GDev::SurfaceBlitter::getKernelName(
+			     GDev::SurfaceBlitter::getBestSupportedKernel() )
+	    << std::endl;
+
+  GDev::SurfaceBlitter::setKernel( GDev::SCALAR_KERNEL );
+
+  BOOST_CHECK_EQUAL( GDev::SurfaceBlitter::getKernel(),
+		     GDev::SCALAR_KERNEL );
+
+  GDev::SurfaceBlitter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that every kernel implements the blend equations
+BOOST_AUTO_TEST_CASE( blitRow_blend_modes )
+{
+  std::vector<GDev::SimdKernel> kernels = getSupportedKernels();
+
+  for( unsigned k = 0; k < kernels.size(); ++k )
+  {
+    GDev::SurfaceBlitter::setKernel( kernels[k] );
+
+    GDev::SurfaceBlitter::Parameters parameters;
+
+    // No blending (with modulation so that the copy is not a memcpy)
+    parameters.alpha_mod = 0x80;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0xFF204060, 0xFF0000FF, parameters ),
+		       0x80204060 );
+
+    parameters.alpha_mod = 0xFF;
+
+    // Blend
+    parameters.blend_mode = SDL_BLENDMODE_BLEND;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0x80FF0000, 0xFF0000FF, parameters ),
+		       0xFF80007F );
+    BOOST_CHECK_EQUAL( blitPixel( 0xFF102030, 0x80FFFFFF, parameters ),
+		       0xFF102030 );
+    BOOST_CHECK_EQUAL( blitPixel( 0x00102030, 0x80FFFFFF, parameters ),
+		       0x80FFFFFF );
+
+    // Add (the destination alpha is not changed)
+    parameters.blend_mode = SDL_BLENDMODE_ADD;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0xFFF01020, 0x40201000, parameters ),
+		       0x40FF2020 );
+    BOOST_CHECK_EQUAL( blitPixel( 0x80FF0000, 0xFF000000, parameters ),
+		       0xFF800000 );
+
+    // Mod (the destination alpha is not changed)
+    parameters.blend_mode = SDL_BLENDMODE_MOD;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0x00FF8000, 0x40FFFFFF, parameters ),
+		       0x40FF8000 );
+
+    // Color modulation
+    parameters.blend_mode = SDL_BLENDMODE_BLEND;
+    parameters.red_mod = 0x80;
+    parameters.green_mod = 0;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0xFFFFFFFF, 0xFF000000, parameters ),
+		       0xFF8000FF );
+
+    // Color key
+    parameters.red_mod = 0xFF;
+    parameters.green_mod = 0xFF;
+    parameters.use_color_key = true;
+    parameters.color_key = 0x00FF00FF;
+
+    BOOST_CHECK_EQUAL( blitPixel( 0xFFFF00FF, 0xFF123456, parameters ),
+		       0xFF123456 );
+    BOOST_CHECK_EQUAL( blitPixel( 0x80FF00FF, 0xFF123456, parameters ),
+		       0xFF123456 );
+    BOOST_CHECK_EQUAL( blitPixel( 0xFFFF00FE, 0xFF123456, parameters ),
+		       0xFFFF00FE );
+  }
+
+  GDev::SurfaceBlitter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the simd kernels produce the same results as the scalar kernel
+BOOST_AUTO_TEST_CASE( blitRow_kernels_agree )
+{
+  std::vector<GDev::SimdKernel> kernels = getSupportedKernels();
+
+  const SDL_BlendMode blend_modes[4] = {SDL_BLENDMODE_NONE,
+					SDL_BLENDMODE_BLEND,
+					SDL_BLENDMODE_ADD,
+					SDL_BLENDMODE_MOD};
+
+  srand( 1 );
+
+  for( unsigned trial = 0; trial < 400; ++trial )
+  {
+    GDev::SurfaceBlitter::Parameters parameters;
+    parameters.blend_mode = blend_modes[trial%4];
+    parameters.red_mod = rand()%256;
+    parameters.green_mod = rand()%256;
+    parameters.blue_mod = rand()%256;
+    parameters.alpha_mod = rand()%256;
+    parameters.use_color_key = (trial%3 == 0);
+    parameters.color_key = 0x00123456;
+
+    const int width = rand()%40;
+
+    std::vector<Uint32> source_row( width ), destination_row( width );
+
+    for( int i = 0; i < width; ++i )
+    {
+      source_row[i] = ((Uint32)(rand()%0x10000) << 16) | rand()%0x10000;
+      destination_row[i] = ((Uint32)(rand()%0x10000) << 16) | rand()%0x10000;
+
+      if( i%5 == 0 )
+	source_row[i] = (source_row[i] & 0xFF000000) | parameters.color_key;
+    }
+
+    std::vector<Uint32> reference_row( destination_row );
+
+    GDev::SurfaceBlitter::setKernel( GDev::SCALAR_KERNEL );
+    GDev::SurfaceBlitter::blitRow( &source_row[0],
+				   &reference_row[0],
+				   width,
+				   parameters );
+
+    for( unsigned k = 1; k < kernels.size(); ++k )
+    {
+      std::vector<Uint32> kernel_row( destination_row );
+
+      GDev::SurfaceBlitter::setKernel( kernels[k] );
+      GDev::SurfaceBlitter::blitRow( &source_row[0],
+				     &kernel_row[0],
+				     width,
+				     parameters );
+
+      BOOST_CHECK( kernel_row == reference_row );
+    }
+  }
+
+  GDev::SurfaceBlitter::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the blit rectangles are clipped like SDL_BlitSurface
+BOOST_AUTO_TEST_CASE( clipRectangles )
+{
+  GDev::Surface source_surface( 20, 10, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 30, 30, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_Rect clipped_source_rect;
+
+  // Entire source surface
+  SDL_Rect dest_rect = {5, 5, 0, 0};
+
+  BOOST_CHECK( GDev::SurfaceBlitter::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       NULL,
+				       *destination_surface.getRawSurfacePtr(),
+				       dest_rect,
+				       clipped_source_rect ) );
+  BOOST_CHECK_EQUAL( clipped_source_rect.x, 0 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.y, 0 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.w, 20 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.h, 10 );
+  BOOST_CHECK_EQUAL( dest_rect.w, 20 );
+  BOOST_CHECK_EQUAL( dest_rect.h, 10 );
+
+  // Source rectangle partially outside of the source surface
+  SDL_Rect source_rect = {-2, 4, 10, 10};
+  dest_rect.x = 0;
+  dest_rect.y = 0;
+
+  BOOST_CHECK( GDev::SurfaceBlitter::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       &source_rect,
+				       *destination_surface.getRawSurfacePtr(),
+				       dest_rect,
+				       clipped_source_rect ) );
+  BOOST_CHECK_EQUAL( clipped_source_rect.x, 0 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.y, 4 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.w, 8 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.h, 6 );
+  BOOST_CHECK_EQUAL( dest_rect.x, 2 );
+  BOOST_CHECK_EQUAL( dest_rect.y, 0 );
+
+  // Destination rectangle partially outside of the clip rectangle
+  SDL_Rect clip_rect = {10, 10, 10, 10};
+  destination_surface.setClipRectangle( clip_rect );
+
+  dest_rect.x = 5;
+  dest_rect.y = 15;
+
+  BOOST_CHECK( GDev::SurfaceBlitter::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       NULL,
+				       *destination_surface.getRawSurfacePtr(),
+				       dest_rect,
+				       clipped_source_rect ) );
+  BOOST_CHECK_EQUAL( clipped_source_rect.x, 5 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.y, 0 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.w, 10 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.h, 5 );
+  BOOST_CHECK_EQUAL( dest_rect.x, 10 );
+  BOOST_CHECK_EQUAL( dest_rect.y, 15 );
+  BOOST_CHECK_EQUAL( dest_rect.w, 10 );
+  BOOST_CHECK_EQUAL( dest_rect.h, 5 );
+
+  // Destination rectangle outside of the clip rectangle
+  dest_rect.x = 25;
+  dest_rect.y = 0;
+
+  BOOST_CHECK( !GDev::SurfaceBlitter::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       NULL,
+				       *destination_surface.getRawSurfacePtr(),
+				       dest_rect,
+				       clipped_source_rect ) );
+  BOOST_CHECK_EQUAL( dest_rect.w, 0 );
+  BOOST_CHECK_EQUAL( dest_rect.h, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only ARGB8888 surfaces can be blitted
+BOOST_AUTO_TEST_CASE( canBlit )
+{
+  GDev::Surface argb_surface( 8, 8, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface other_argb_surface( 8, 8, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface rgba_surface( 8, 8, SDL_PIXELFORMAT_RGBA8888 );
+
+  BOOST_CHECK( GDev::SurfaceBlitter::canBlit(
+				     *argb_surface.getRawSurfacePtr(),
+				     *other_argb_surface.getRawSurfacePtr() ) );
+  BOOST_CHECK( !GDev::SurfaceBlitter::canBlit(
+				     *argb_surface.getRawSurfacePtr(),
+				     *argb_surface.getRawSurfacePtr() ) );
+  BOOST_CHECK( !GDev::SurfaceBlitter::canBlit(
+				     *argb_surface.getRawSurfacePtr(),
+				     *rgba_surface.getRawSurfacePtr() ) );
+  BOOST_CHECK( !GDev::SurfaceBlitter::canBlit(
+				     *rgba_surface.getRawSurfacePtr(),
+				     *argb_surface.getRawSurfacePtr() ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that Surface::blitSurface uses the surface settings
+BOOST_AUTO_TEST_CASE( surface_blitSurface )
+{
+  GDev::Surface source_surface( 4, 4, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 8, 8, SDL_PIXELFORMAT_ARGB8888 );
+
+  fillSurface( source_surface, 0x80FF0000 );
+  fillSurface( destination_surface, 0xFF0000FF );
+
+  source_surface.setBlendMode( SDL_BLENDMODE_BLEND );
+
+  SDL_Rect dest_rect = {6, 2, 0, 0};
+
+  source_surface.blitSurface( destination_surface, &dest_rect );
+
+  BOOST_CHECK_EQUAL( dest_rect.w, 2 );
+  BOOST_CHECK_EQUAL( dest_rect.h, 4 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 5, 2 ), 0xFF0000FF );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 6, 2 ), 0xFF80007F );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 7, 5 ), 0xFF80007F );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 7, 6 ), 0xFF0000FF );
+
+  // Color key
+  source_surface.setBlendMode( SDL_BLENDMODE_NONE );
+  source_surface.setColorKey( 0x00FF0000 );
+
+  source_surface.blitSurface( destination_surface );
+
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 0 ), 0xFF0000FF );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSurfaceBlitter.cpp
+//---------------------------------------------------------------------------//
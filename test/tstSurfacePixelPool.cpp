@@ -0,0 +1,143 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSurfacePixelPool.cpp
+//! \author Alex Robinson
+//! \brief  The surface pixel pool class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "SurfacePixelPool.hpp"
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the aligned pitch can be returned
+BOOST_AUTO_TEST_CASE( getAlignedPitch )
+{
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignment(), 64 );
+  
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 1, 32 ), 64 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 16, 32 ), 64 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 17, 32 ), 128 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 100, 24 ), 320 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 64, 8 ), 64 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getAlignedPitch( 513, 1 ), 128 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that aligned buffers can be allocated
+BOOST_AUTO_TEST_CASE( allocate )
+{
+  const unsigned long number_of_allocations =
+    GDev::SurfacePixelPool::getNumberOfAllocations();
+  const size_t number_of_bytes_in_use = 
+    GDev::SurfacePixelPool::getNumberOfBytesInUse();
+  
+  std::vector<void*> buffers;
+  
+  for( size_t size = 1; size < 1000000; size = size*3 + 1 )
+  {
+    void* buffer = GDev::SurfacePixelPool::allocate( size );
+
+    BOOST_REQUIRE( buffer != NULL );
+    BOOST_CHECK_EQUAL( reinterpret_cast<size_t>( buffer ) % 64, 0 );
+
+    // The entire buffer must be writable
+    std::memset( buffer, 0xFF, size );
+
+    buffers.push_back( buffer );
+  }
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfAllocations(),
+		     number_of_allocations + buffers.size() );
+  BOOST_CHECK( GDev::SurfacePixelPool::getNumberOfBytesInUse() >
+	       number_of_bytes_in_use );
+
+  for( unsigned i = 0; i < buffers.size(); ++i )
+    GDev::SurfacePixelPool::deallocate( buffers[i] );
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfBytesInUse(),
+		     number_of_bytes_in_use );
+}
+
+//---------------------------------------------------------------------------//
+// Check that freed buffers are recycled
+BOOST_AUTO_TEST_CASE( deallocate )
+{
+  GDev::SurfacePixelPool::releaseFreeBuffers();
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 0 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBytes(), 0 );
+  
+  const unsigned long number_of_recycled_allocations = 
+    GDev::SurfacePixelPool::getNumberOfRecycledAllocations();
+
+  void* buffer = GDev::SurfacePixelPool::allocate( 200*100*4 );
+
+  GDev::SurfacePixelPool::deallocate( buffer );
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 1 );
+  BOOST_CHECK( GDev::SurfacePixelPool::getNumberOfFreeBytes() >= 200*100*4 );
+  
+  // A request in the same size class gets the same buffer
+  void* recycled_buffer = GDev::SurfacePixelPool::allocate( 200*100*4 - 10 );
+
+  BOOST_CHECK_EQUAL( recycled_buffer, buffer );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfRecycledAllocations(),
+		     number_of_recycled_allocations + 1 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 0 );
+
+  GDev::SurfacePixelPool::deallocate( recycled_buffer );
+
+  // A request in a larger size class gets a new buffer
+  void* larger_buffer = GDev::SurfacePixelPool::allocate( 400*100*4 );
+
+  BOOST_CHECK( larger_buffer != buffer );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 1 );
+
+  GDev::SurfacePixelPool::deallocate( larger_buffer );
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 2 );
+
+  GDev::SurfacePixelPool::releaseFreeBuffers();
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 0 );
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBytes(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the max number of free bytes can be set
+BOOST_AUTO_TEST_CASE( get_setMaxNumberOfFreeBytes )
+{
+  const size_t default_max_number_of_free_bytes = 
+    GDev::SurfacePixelPool::getMaxNumberOfFreeBytes();
+
+  BOOST_CHECK( default_max_number_of_free_bytes > 0 );
+
+  GDev::SurfacePixelPool::releaseFreeBuffers();
+  GDev::SurfacePixelPool::setMaxNumberOfFreeBytes( 0 );
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getMaxNumberOfFreeBytes(), 0 );
+  
+  GDev::SurfacePixelPool::deallocate( 
+				    GDev::SurfacePixelPool::allocate( 100 ) );
+
+  BOOST_CHECK_EQUAL( GDev::SurfacePixelPool::getNumberOfFreeBuffers(), 0 );
+
+  GDev::SurfacePixelPool::setMaxNumberOfFreeBytes( 
+					    default_max_number_of_free_bytes );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSurfacePixelPool.cpp
+//---------------------------------------------------------------------------//
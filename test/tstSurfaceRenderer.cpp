@@ -10,6 +10,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <cstring>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -47,6 +48,22 @@ struct SurfaceFixture
   const std::shared_ptr<GDev::Surface> test_surface;
 };
 
+// A rectangle that must be drawn with a texture
+class TextureRectangle : public GDev::Rectangle
+{
+public:
+  TextureRectangle( const int x_position,
+		    const int y_position,
+		    const int width,
+		    const int height,
+		    const unsigned edge_thickness = 0u )
+    : GDev::Rectangle( x_position, y_position, width, height, edge_thickness )
+  { /* ... */ }
+
+  bool hasRectangularCoverage() const
+  { return false; }
+};
+
 BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
 
 BOOST_FIXTURE_TEST_SUITE( SurfaceRenderer, SurfaceFixture );
@@ -109,6 +126,18 @@ BOOST_AUTO_TEST_CASE( isValidTextureFormat )
   BOOST_CHECK( renderer.isValidTextureFormat( SDL_PIXELFORMAT_BGRA8888 ) );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the native texture format can be returned
+BOOST_AUTO_TEST_CASE( getNativeTextureFormat )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  BOOST_CHECK_EQUAL( renderer.getNativeTextureFormat(), 
+		     SDL_PIXELFORMAT_ARGB8888 );
+  BOOST_CHECK_EQUAL( renderer.getNativeTextureFormat( false ),
+		     SDL_PIXELFORMAT_RGB888 );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the max texture width can be returned
 BOOST_AUTO_TEST_CASE( getMaxTextureWidth )
@@ -183,6 +212,69 @@ BOOST_AUTO_TEST_CASE( get_setLogicalSize )
   BOOST_CHECK_EQUAL( logical_height, 600 );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the scale and viewport are reloaded when the logical size is set
+BOOST_AUTO_TEST_CASE( setLogicalSize_state )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  renderer.setLogicalSize( 400, 300 );
+
+  float x_scale, y_scale, sdl_x_scale, sdl_y_scale;
+
+  renderer.getScale( x_scale, y_scale );
+  SDL_RenderGetScale( renderer.getRawRendererPtr(), 
+		      &sdl_x_scale, 
+		      &sdl_y_scale );
+  
+  BOOST_CHECK_EQUAL( x_scale, 2.0f );
+  BOOST_CHECK_EQUAL( y_scale, 2.0f );
+  BOOST_CHECK_EQUAL( x_scale, sdl_x_scale );
+  BOOST_CHECK_EQUAL( y_scale, sdl_y_scale );
+
+  SDL_Rect viewport, sdl_viewport;
+
+  renderer.getViewport( viewport );
+  SDL_RenderGetViewport( renderer.getRawRendererPtr(), &sdl_viewport );
+
+  BOOST_CHECK( SDL_RectEquals( &viewport, &sdl_viewport ) );
+  BOOST_CHECK_EQUAL( viewport.w, 400 );
+  BOOST_CHECK_EQUAL( viewport.h, 300 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the state can be reloaded after using the raw renderer pointer
+BOOST_AUTO_TEST_CASE( synchronizeState )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  SDL_Rect viewport = {10,20,100,200};
+  
+  SDL_RenderSetScale( renderer.getRawRendererPtr(), 2.0f, 2.0f );
+  SDL_RenderSetViewport( renderer.getRawRendererPtr(), &viewport );
+
+  renderer.synchronizeState();
+
+  float x_scale, y_scale;
+
+  renderer.getScale( x_scale, y_scale );
+
+  BOOST_CHECK_EQUAL( x_scale, 2.0f );
+  BOOST_CHECK_EQUAL( y_scale, 2.0f );
+
+  SDL_Rect read_viewport;
+
+  renderer.getViewport( read_viewport );
+  
+  BOOST_CHECK( SDL_RectEquals( &read_viewport, &viewport ) );
+
+  renderer.resetStateChangeCounters();
+
+  renderer.setViewport( viewport );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSkippedStateChanges(), 1 );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the scale factor can be returned
 BOOST_AUTO_TEST_CASE( get_setScale )
@@ -673,6 +765,341 @@ BOOST_AUTO_TEST_CASE( drawShapes )
   test_surface->exportToBMP( "test_shapes_surface.bmp" );
 }
 
+//---------------------------------------------------------------------------//
+// Check that rectangles are drawn like shape textures
+BOOST_AUTO_TEST_CASE( drawShape_geometry )
+{
+  std::shared_ptr<GDev::Surface> texture_surface( 
+		     new GDev::Surface( 400, 300, SDL_PIXELFORMAT_ARGB8888 ) );
+  std::shared_ptr<GDev::Surface> geometry_surface( 
+		     new GDev::Surface( 400, 300, SDL_PIXELFORMAT_ARGB8888 ) );
+  
+  GDev::SurfaceRenderer texture_renderer( texture_surface );
+  GDev::SurfaceRenderer geometry_renderer( geometry_surface );
+
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+  SDL_Color blue = {0,0,0xFF,0xFF};
+
+  texture_renderer.setDrawColor( white );
+  texture_renderer.clear();
+  texture_renderer.setDrawColor( blue );
+  
+  geometry_renderer.setDrawColor( white );
+  geometry_renderer.clear();
+  geometry_renderer.setDrawColor( blue );
+
+  texture_renderer.drawShape( TextureRectangle( 10, 10, 100, 50, 3 ), false );
+  texture_renderer.drawShape( TextureRectangle( 150, 40, 200, 60, 4 ), true );
+  texture_renderer.drawShape( TextureRectangle( 100, 220, 60, 50 ), false );
+  texture_renderer.present();
+
+  geometry_renderer.drawShape( GDev::Rectangle( 10, 10, 100, 50, 3 ), false );
+  geometry_renderer.drawShape( GDev::Rectangle( 150, 40, 200, 60, 4 ), true );
+  geometry_renderer.drawShape( GDev::Rectangle( 100, 220, 60, 50 ), false );
+  geometry_renderer.present();
+
+  const Uint8* texture_pixels = (const Uint8*)texture_surface->getPixels();
+  const Uint8* geometry_pixels = (const Uint8*)geometry_surface->getPixels();
+
+  for( int row = 0; row < texture_surface->getHeight(); ++row )
+  {
+    BOOST_REQUIRE( memcmp( texture_pixels+row*texture_surface->getPitch(),
+			   geometry_pixels+row*geometry_surface->getPitch(),
+			   texture_surface->getWidth()*4 ) == 0 );
+  }
+}
+
+//---------------------------------------------------------------------------//
+// Check that shape textures are cached
+BOOST_AUTO_TEST_CASE( getShapeTextureCache )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  GDev::ShapeTextureCache& cache = renderer.getShapeTextureCache();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0 );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+
+  // Rectangles are drawn without textures
+  renderer.drawShape( GDev::Rectangle( 100, 50, 100, 50, 2 ), false );
+  renderer.drawShape( GDev::Rectangle( 100, 50, 100, 50 ), true );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 0 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0 );
+
+  // Ellipses are drawn with cached textures
+  GDev::Ellipse ellipse( 100, 50, 100, 50, 2 );
+
+  SDL_Color blue = {0,0,0xFF,0xFF};
+
+  renderer.setDrawColor( blue );
+
+  renderer.drawShape( ellipse, true );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 0 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 1 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1 );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 200*100*4 );
+
+  // The same shape and color
+  renderer.drawShape( GDev::Ellipse( 100, 50, 100, 50, 2 ), true );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 1 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1 );
+
+  // The same shape and color at a different position
+  renderer.drawShape( GDev::Ellipse( 500, 400, 100, 50, 2 ), true );
+  renderer.present();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 2 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1 );
+
+  // The cached texture is copied to the moved bounding box
+  const Uint32* center_row = (const Uint32*)
+    ((const Uint8*)test_surface->getPixels() + 400*test_surface->getPitch());
+
+  BOOST_CHECK_EQUAL( center_row[500], 0xFF0000FF );
+  BOOST_CHECK_EQUAL( center_row[399], 0x00000000 );
+
+  // A different fill mode
+  renderer.drawShape( ellipse, false );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 2 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 2 );
+
+  // A different color
+  SDL_Color green = {0,0xFF,0,0xFF};
+
+  renderer.setDrawColor( green );
+  
+  renderer.drawShape( ellipse, false );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 3 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 3 );
+
+  // A different shape type with the same geometry parameters
+  renderer.drawShape( TextureRectangle( 100, 50, 100, 50, 2 ), false );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 4 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 4 );
+
+  // The least recently used textures will be evicted
+  cache.setMemoryBudget( 200*100*4 + 100*50*4 );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 2 );
+  BOOST_CHECK( cache.getMemoryUsage() <= cache.getMemoryBudget() );
+
+  renderer.drawShape( ellipse, false );
+  
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 3 );
+
+  // Textures larger than the budget will not be cached
+  cache.setMemoryBudget( 0 );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0 );
+  BOOST_CHECK_NO_THROW( renderer.drawShape( ellipse, false ) );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0 );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that redundant state changes are skipped
+BOOST_AUTO_TEST_CASE( skipRedundantStateChanges )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  SDL_Color red = {0xFF,0,0,0xFF};
+  SDL_Rect viewport = {200,150,400,300};
+  SDL_Rect clip_rect = {10,20,100,200};
+
+  renderer.resetStateChangeCounters();
+
+  renderer.setDrawColor( red );
+  renderer.setDrawBlendMode( SDL_BLENDMODE_BLEND );
+  renderer.setViewport( viewport );
+  renderer.setClipRectangle( clip_rect );
+  renderer.setScale( 2.0, 2.0 );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfStateChanges(), 5 );
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSkippedStateChanges(), 0 );
+
+  renderer.setDrawColor( red );
+  renderer.setDrawBlendMode( SDL_BLENDMODE_BLEND );
+  renderer.setScale( 2.0, 2.0 );
+  renderer.setCurrentTargetDefault();
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfStateChanges(), 5 );
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSkippedStateChanges(), 4 );
+
+  SDL_Color read_color;
+  renderer.getDrawColor( read_color );
+
+  BOOST_CHECK_EQUAL( read_color.r, 0xFF );
+  BOOST_CHECK_EQUAL( read_color.g, 0 );
+  BOOST_CHECK_EQUAL( read_color.b, 0 );
+  BOOST_CHECK_EQUAL( read_color.a, 0xFF );
+  BOOST_CHECK_EQUAL( renderer.getDrawBlendMode(), SDL_BLENDMODE_BLEND );
+
+  renderer.resetStateChangeCounters();
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfStateChanges(), 0 );
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSkippedStateChanges(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the draw calls are counted
+BOOST_AUTO_TEST_CASE( getNumberOfDrawCalls )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfDrawCalls(), 0 );
+
+  SDL_Rect rectangle = {10,10,20,20};
+
+  renderer.clear();
+  renderer.drawPoint( 5, 5 );
+  renderer.drawLine( 0, 0, 10, 10 );
+  renderer.drawRectangle( rectangle, true );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfDrawCalls(), 4 );
+
+  // Ellipses are drawn with a (cached) texture copy
+  GDev::Ellipse ellipse( 50, 50, 10, 10 );
+
+  renderer.drawShape( ellipse, true );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfDrawCalls(), 5 );
+
+  renderer.resetDrawCallCounter();
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfDrawCalls(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the renderer state can be saved and restored
+BOOST_AUTO_TEST_CASE( push_popState )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  SDL_Color red = {0xFF,0,0,0xFF};
+  SDL_Color blue = {0,0,0xFF,0x80};
+  SDL_Rect viewport = {200,150,400,300};
+  SDL_Rect clip_rect = {10,20,100,200};
+  
+  renderer.setDrawColor( red );
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSavedStates(), 0 );
+
+  renderer.pushState();
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSavedStates(), 1 );
+  
+  renderer.setDrawColor( blue );
+  renderer.setDrawBlendMode( SDL_BLENDMODE_ADD );
+  renderer.setViewport( viewport );
+  renderer.setClipRectangle( clip_rect );
+
+  renderer.resetStateChangeCounters();
+  
+  renderer.popState();
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSavedStates(), 0 );
+  
+  // Only the changed state is passed to SDL (color, blend, viewport, clip)
+  BOOST_CHECK_EQUAL( renderer.getNumberOfStateChanges(), 4 );
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSkippedStateChanges(), 2 );
+
+  SDL_Color read_color;
+  renderer.getDrawColor( read_color );
+  
+  BOOST_CHECK_EQUAL( read_color.r, 0xFF );
+  BOOST_CHECK_EQUAL( read_color.b, 0 );
+  BOOST_CHECK_EQUAL( renderer.getDrawBlendMode(), SDL_BLENDMODE_NONE );
+
+  SDL_Rect read_rect;
+  renderer.getViewport( read_rect );
+
+  BOOST_CHECK_EQUAL( read_rect.x, 0 );
+  BOOST_CHECK_EQUAL( read_rect.y, 0 );
+  BOOST_CHECK_EQUAL( read_rect.w, 800 );
+  BOOST_CHECK_EQUAL( read_rect.h, 600 );
+
+  renderer.getClipRectangle( read_rect );
+
+  BOOST_CHECK_EQUAL( read_rect.w, 0 );
+  BOOST_CHECK_EQUAL( read_rect.h, 0 );
+
+  // Check the state scope
+  {
+    GDev::RendererStateScope scope( renderer );
+
+    BOOST_CHECK_EQUAL( renderer.getNumberOfSavedStates(), 1 );
+
+    renderer.setDrawColor( blue );
+  }
+
+  BOOST_CHECK_EQUAL( renderer.getNumberOfSavedStates(), 0 );
+
+  renderer.getDrawColor( read_color );
+  
+  BOOST_CHECK_EQUAL( read_color.r, 0xFF );
+  BOOST_CHECK_EQUAL( read_color.b, 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that only the dirty region is cleared and presented
+BOOST_AUTO_TEST_CASE( presentDirtyRegion )
+{
+  GDev::SurfaceRenderer renderer( test_surface );
+
+  BOOST_CHECK( renderer.isPartialPresentSupported() );
+
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+  SDL_Color black = {0,0,0,0xFF};
+
+  // The first frame is always a full frame
+  SDL_Rect small_area = {0,0,10,10};
+  
+  renderer.invalidate( small_area );
+
+  BOOST_CHECK( renderer.getDirtyRegion().isFullFrame() );
+  BOOST_CHECK_EQUAL( renderer.getDirtyRegion().getWidth(), 800 );
+  BOOST_CHECK_EQUAL( renderer.getDirtyRegion().getHeight(), 600 );
+
+  renderer.setDrawColor( white );
+  renderer.clearDirtyRegion();
+  renderer.presentDirtyRegion();
+
+  BOOST_CHECK( renderer.getDirtyRegion().isEmpty() );
+
+  // Only the invalidated area is cleared
+  SDL_Rect area = {100,100,50,50};
+
+  renderer.invalidate( area );
+  
+  BOOST_CHECK( !renderer.getDirtyRegion().isFullFrame() );
+
+  renderer.setDrawColor( black );
+  renderer.clearDirtyRegion();
+  renderer.presentDirtyRegion();
+
+  BOOST_CHECK( renderer.getDirtyRegion().isEmpty() );
+
+  const Uint8* pixels = (const Uint8*)test_surface->getPixels();
+
+  BOOST_CHECK_EQUAL( *((const Uint32*)(pixels+120*test_surface->getPitch())+120),
+		     0xFF000000 );
+  BOOST_CHECK_EQUAL( *((const Uint32*)(pixels+50*test_surface->getPitch())+50),
+		     0xFFFFFFFF );
+
+  // Invalidating most of the target results in a full frame
+  SDL_Rect large_area = {0,0,700,500};
+
+  renderer.invalidate( large_area );
+
+  BOOST_CHECK( renderer.getDirtyRegion().isFullFrame() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 //---------------------------------------------------------------------------//
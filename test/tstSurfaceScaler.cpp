@@ -0,0 +1,263 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstSurfaceScaler.cpp
+//! \author Alex Robinson
+//! \brief  The surface scaler class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "SurfaceScaler.hpp"
+#include "Surface.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+// Get the kernels that are supported by the CPU
+std::vector<GDev::SurfaceScaler::Kernel> getSupportedKernels()
+{
+  std::vector<GDev::SurfaceScaler::Kernel> kernels;
+
+  kernels.push_back( GDev::SCALAR_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::SSE2_KERNEL ) )
+    kernels.push_back( GDev::SSE2_KERNEL );
+
+  if( GDev::SurfaceBlitter::isKernelSupported(
+				       GDev::AVX2_KERNEL ) )
+    kernels.push_back( GDev::AVX2_KERNEL );
+
+  return kernels;
+}
+
+// Get a pixel of a 32 bit surface
+Uint32 getPixel( const GDev::Surface& surface, const int x, const int y )
+{
+  const Uint8* row = static_cast<const Uint8*>( surface.getPixels() ) +
+    y*surface.getPitch();
+
+  return reinterpret_cast<const Uint32*>( row )[x];
+}
+
+// Set a pixel of a 32 bit surface
+void setPixel( GDev::Surface& surface,
+	       const int x,
+	       const int y,
+	       const Uint32 pixel )
+{
+  Uint8* row = static_cast<Uint8*>( surface.getRawSurfacePtr()->pixels ) +
+    y*surface.getPitch();
+
+  reinterpret_cast<Uint32*>( row )[x] = pixel;
+}
+
+// Create a 2x2 checker board surface
+void createCheckerBoard( GDev::Surface& surface )
+{
+  setPixel( surface, 0, 0, 0xFF000000 );
+  setPixel( surface, 1, 0, 0xFFFFFFFF );
+  setPixel( surface, 0, 1, 0xFFFFFFFF );
+  setPixel( surface, 1, 1, 0xFF000000 );
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the nearest filter replicates the source pixels
+BOOST_AUTO_TEST_CASE( blitScaled_nearest )
+{
+  GDev::Surface source_surface( 2, 2, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 4, 4, SDL_PIXELFORMAT_ARGB8888 );
+
+  createCheckerBoard( source_surface );
+
+  source_surface.blitScaled( destination_surface,
+			     NULL,
+			     NULL,
+			     GDev::SurfaceScaler::NEAREST_FILTER );
+
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 0 ), 0xFF000000 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 1, 1 ), 0xFF000000 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 2, 1 ), 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 1, 2 ), 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 3, 3 ), 0xFF000000 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the bilinear filter interpolates the source pixels
+BOOST_AUTO_TEST_CASE( blitScaled_bilinear )
+{
+  GDev::Surface source_surface( 2, 2, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 4, 4, SDL_PIXELFORMAT_ARGB8888 );
+
+  createCheckerBoard( source_surface );
+
+  source_surface.blitScaled( destination_surface,
+			     NULL,
+			     NULL,
+			     GDev::SurfaceScaler::BILINEAR_FILTER );
+
+  // The corners are clamped to the source pixels
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 0 ), 0xFF000000 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 3, 0 ), 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 3 ), 0xFFFFFFFF );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 3, 3 ), 0xFF000000 );
+
+  // The inner pixels are interpolated
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 1, 0 ), 0xFF404040 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 1, 1 ), 0xFF606060 );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 2, 1 ), 0xFF9F9F9F );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the box filter averages the source pixels
+BOOST_AUTO_TEST_CASE( blitScaled_box )
+{
+  GDev::Surface source_surface( 2, 2, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 1, 1, SDL_PIXELFORMAT_ARGB8888 );
+
+  createCheckerBoard( source_surface );
+
+  source_surface.blitScaled( destination_surface,
+			     NULL,
+			     NULL,
+			     GDev::SurfaceScaler::BOX_FILTER );
+
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 0 ), 0xFF808080 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the scaled blit uses the blend mode of the source surface
+BOOST_AUTO_TEST_CASE( blitScaled_blend )
+{
+  GDev::Surface source_surface( 2, 2, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 4, 4, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_FillRect( source_surface.getRawSurfacePtr(), NULL, 0x80FF0000 );
+  SDL_FillRect( destination_surface.getRawSurfacePtr(), NULL, 0xFF0000FF );
+
+  source_surface.setBlendMode( SDL_BLENDMODE_BLEND );
+
+  source_surface.blitScaled( destination_surface,
+			     NULL,
+			     NULL,
+			     GDev::SurfaceScaler::BILINEAR_FILTER );
+
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 0, 0 ), 0xFF80007F );
+  BOOST_CHECK_EQUAL( getPixel( destination_surface, 2, 3 ), 0xFF80007F );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the simd kernels produce the same results as the scalar kernel
+BOOST_AUTO_TEST_CASE( blitScaled_kernels_agree )
+{
+  std::vector<GDev::SurfaceScaler::Kernel> kernels = getSupportedKernels();
+
+  srand( 1 );
+
+  for( unsigned trial = 0; trial < 60; ++trial )
+  {
+    const int source_width = 1 + rand()%40;
+    const int source_height = 1 + rand()%40;
+
+    GDev::Surface source_surface( source_width,
+				  source_height,
+				  SDL_PIXELFORMAT_ARGB8888 );
+
+    for( int y = 0; y < source_height; ++y )
+    {
+      for( int x = 0; x < source_width; ++x )
+      {
+	setPixel( source_surface, x, y,
+		  ((Uint32)(rand()%0x10000) << 16) | rand()%0x10000 );
+      }
+    }
+
+    const GDev::SurfaceScaler::Filter filter =
+      (GDev::SurfaceScaler::Filter)(trial%3);
+
+    SDL_Rect destination_rect = {3, 1, 1 + rand()%60, 1 + rand()%60};
+
+    GDev::Surface reference_surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+    GDev::SurfaceScaler::setKernel( GDev::SCALAR_KERNEL );
+
+    SDL_Rect rect = destination_rect;
+    source_surface.blitScaled( reference_surface, &rect, NULL, filter );
+
+    for( unsigned k = 1; k < kernels.size(); ++k )
+    {
+      GDev::Surface kernel_surface( 64, 64, SDL_PIXELFORMAT_ARGB8888 );
+
+      GDev::SurfaceScaler::setKernel( kernels[k] );
+
+      rect = destination_rect;
+      source_surface.blitScaled( kernel_surface, &rect, NULL, filter );
+
+      for( int y = 0; y < 64; ++y )
+      {
+	for( int x = 0; x < 64; ++x )
+	{
+	  BOOST_REQUIRE_EQUAL( getPixel( kernel_surface, x, y ),
+			       getPixel( reference_surface, x, y ) );
+	}
+      }
+    }
+  }
+
+  GDev::SurfaceScaler::setKernel(
+			      GDev::SurfaceBlitter::getBestSupportedKernel() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the scaled blit rectangles are clipped like SDL_BlitScaled
+BOOST_AUTO_TEST_CASE( clipRectangles )
+{
+  GDev::Surface source_surface( 2, 2, SDL_PIXELFORMAT_ARGB8888 );
+  GDev::Surface destination_surface( 10, 10, SDL_PIXELFORMAT_ARGB8888 );
+
+  SDL_Rect source_rect = {0, 0, 2, 2};
+  SDL_Rect dest_rect = {-4, -4, 8, 8};
+  SDL_Rect clipped_source_rect, clipped_dest_rect;
+
+  BOOST_CHECK( GDev::SurfaceScaler::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       &source_rect,
+				       *destination_surface.getRawSurfacePtr(),
+				       &dest_rect,
+				       clipped_source_rect,
+				       clipped_dest_rect ) );
+  BOOST_CHECK_EQUAL( clipped_source_rect.x, 1 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.y, 1 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.w, 1 );
+  BOOST_CHECK_EQUAL( clipped_source_rect.h, 1 );
+  BOOST_CHECK_EQUAL( clipped_dest_rect.x, 0 );
+  BOOST_CHECK_EQUAL( clipped_dest_rect.y, 0 );
+  BOOST_CHECK_EQUAL( clipped_dest_rect.w, 4 );
+  BOOST_CHECK_EQUAL( clipped_dest_rect.h, 4 );
+
+  // Entirely clipped
+  dest_rect.x = 20;
+
+  BOOST_CHECK( !GDev::SurfaceScaler::clipRectangles(
+				       *source_surface.getRawSurfacePtr(),
+				       &source_rect,
+				       *destination_surface.getRawSurfacePtr(),
+				       &dest_rect,
+				       clipped_source_rect,
+				       clipped_dest_rect ) );
+}
+
+//---------------------------------------------------------------------------//
+// end tstSurfaceScaler.cpp
+//---------------------------------------------------------------------------//
@@ -71,6 +71,39 @@ private:
 
 BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
 
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+
+// Check that the stored renderer state matches the SDL renderer state
+void checkRendererStateInStep( GDev::Renderer& renderer )
+{
+  SDL_Renderer* raw_renderer = renderer.getRawRendererPtr();
+
+  BOOST_CHECK_EQUAL( renderer.isCurrentTargetDefault(),
+		     SDL_GetRenderTarget( raw_renderer ) == NULL );
+
+  float x_scale, y_scale, sdl_x_scale, sdl_y_scale;
+
+  renderer.getScale( x_scale, y_scale );
+  SDL_RenderGetScale( raw_renderer, &sdl_x_scale, &sdl_y_scale );
+
+  BOOST_CHECK_EQUAL( x_scale, sdl_x_scale );
+  BOOST_CHECK_EQUAL( y_scale, sdl_y_scale );
+
+  SDL_Rect rect, sdl_rect;
+
+  renderer.getViewport( rect );
+  SDL_RenderGetViewport( raw_renderer, &sdl_rect );
+
+  BOOST_CHECK( SDL_RectEquals( &rect, &sdl_rect ) );
+
+  renderer.getClipRectangle( rect );
+  SDL_RenderGetClipRect( raw_renderer, &sdl_rect );
+
+  BOOST_CHECK( SDL_RectEquals( &rect, &sdl_rect ) );
+}
+
 //---------------------------------------------------------------------------//
 // Tests.
 //---------------------------------------------------------------------------//
@@ -373,6 +406,104 @@ BOOST_AUTO_TEST_CASE( setAsRenderTarget_surface )
   BOOST_CHECK( test_surface_renderer->isCurrentTargetDefault() );
 }
 
+//---------------------------------------------------------------------------//
+// Check that the default target is set when the rendering target is
+// replaced by a move assignment or destroyed
+BOOST_AUTO_TEST_CASE( move_assignment_render_target_surface )
+{
+  GDev::TargetTexture texture( test_surface_renderer, 10, 10 );
+  GDev::TargetTexture other_texture( test_surface_renderer, 20, 20 );
+
+  texture.setAsRenderTarget();
+
+  test_surface_renderer->pushState();
+
+  texture = std::move( other_texture );
+
+  BOOST_CHECK( test_surface_renderer->isCurrentTargetDefault() );
+  BOOST_CHECK( !texture.isRenderTarget() );
+  BOOST_CHECK_EQUAL( texture.getWidth(), 20 );
+
+  // The saved state must not refer to the destroyed texture
+  test_surface_renderer->popState();
+
+  BOOST_CHECK( test_surface_renderer->isCurrentTargetDefault() );
+
+  {
+    GDev::TargetTexture temp_texture( test_surface_renderer, 10, 10 );
+
+    temp_texture.setAsRenderTarget();
+  }
+
+  BOOST_CHECK( test_surface_renderer->isCurrentTargetDefault() );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the stored renderer state stays in step with SDL when the
+// rendering target changes
+BOOST_AUTO_TEST_CASE( setAsRenderTarget_state_surface )
+{
+  GDev::TargetTexture texture( test_surface_renderer, 100, 50 );
+
+  SDL_Rect viewport = {20,10,300,200};
+  SDL_Rect clip_rect = {5,5,40,30};
+
+  test_surface_renderer->pushState();
+  
+  test_surface_renderer->setViewport( viewport );
+  test_surface_renderer->setClipRectangle( clip_rect );
+
+  checkRendererStateInStep( *test_surface_renderer );
+
+  texture.setAsRenderTarget();
+
+  checkRendererStateInStep( *test_surface_renderer );
+
+  SDL_Rect read_rect;
+  test_surface_renderer->getViewport( read_rect );
+
+  BOOST_CHECK_EQUAL( read_rect.w, 100 );
+  BOOST_CHECK_EQUAL( read_rect.h, 50 );
+
+  test_surface_renderer->setScale( 2.0, 2.0 );
+
+  checkRendererStateInStep( *test_surface_renderer );
+
+  test_surface_renderer->setViewport( clip_rect );
+  test_surface_renderer->setClipRectangle( clip_rect );
+
+  checkRendererStateInStep( *test_surface_renderer );
+
+  // The default target state is restored by SDL
+  texture.unsetAsRenderTarget();
+
+  checkRendererStateInStep( *test_surface_renderer );
+
+  test_surface_renderer->getViewport( read_rect );
+
+  BOOST_CHECK( SDL_RectEquals( &read_rect, &viewport ) );
+
+  // Destroying the current target sets the default target
+  {
+    GDev::TargetTexture temp_texture( test_surface_renderer, 10, 10 );
+
+    temp_texture.setAsRenderTarget();
+
+    checkRendererStateInStep( *test_surface_renderer );
+  }
+
+  checkRendererStateInStep( *test_surface_renderer );
+  BOOST_CHECK( test_surface_renderer->isCurrentTargetDefault() );
+
+  test_surface_renderer->popState();
+
+  test_surface_renderer->getClipRectangle( read_rect );
+
+  BOOST_CHECK( SDL_RectEmpty( &read_rect ) );
+
+  checkRendererStateInStep( *test_surface_renderer );
+}
+
 //---------------------------------------------------------------------------//
 // Check if the texture can be set as the rendering target
 BOOST_AUTO_TEST_CASE( setAsRenderTarget_window )
@@ -0,0 +1,238 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstTextTextureCache.cpp
+//! \author Alex Robinson
+//! \brief  The text texture cache class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <string>
+#include <memory>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "TextTextureCache.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    std::shared_ptr<GDev::Surface> test_surface(
+		     new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+struct CommandLineArgsFixture
+{
+  CommandLineArgsFixture()
+  {
+    if( boost::unit_test::framework::master_test_suite().argc > 1 )
+    {
+      test_font_filename =
+	boost::unit_test::framework::master_test_suite().argv[1];
+    }
+    else
+    {
+      std::cerr << "Error: The font filename must be specified (arg 1)"
+		<< std::endl;
+
+      exit(1);
+    }
+  }
+
+  // The font filename
+  std::string test_font_filename;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+BOOST_FIXTURE_TEST_SUITE( TextTextureCache, CommandLineArgsFixture )
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the cache can be constructed
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  GDev::TextTextureCache cache( 1024 );
+
+  BOOST_CHECK_EQUAL( cache.getMemoryBudget(), 1024 );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0u );
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getHitRate(), 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that cached textures are shared
+BOOST_AUTO_TEST_CASE( getTexture )
+{
+  GDev::TextTextureCache cache;
+
+  GDev::Font font( test_font_filename, 20 );
+
+  SDL_Color black = {0,0,0,0xFF};
+  SDL_Color white = {0xFF,0xFF,0xFF,0xFF};
+
+  std::shared_ptr<GDev::StaticTexture> texture_a =
+    cache.getTexture( test_surface_renderer, "Start", font, black );
+
+  std::shared_ptr<GDev::StaticTexture> texture_b =
+    cache.getTexture( test_surface_renderer, "Start", font, black );
+
+  BOOST_CHECK( texture_a == texture_b );
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 1ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 1ul );
+  BOOST_CHECK_EQUAL( cache.getHitRate(), 0.5 );
+
+  // The colors are part of the key
+  std::shared_ptr<GDev::StaticTexture> texture_c =
+    cache.getTexture( test_surface_renderer, "Start", font, white );
+
+  std::shared_ptr<GDev::StaticTexture> texture_d =
+    cache.getTexture( test_surface_renderer, "Start", font, black, &white );
+
+  BOOST_CHECK( texture_c != texture_a );
+  BOOST_CHECK( texture_d != texture_a );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 3u );
+
+  // The font is part of the key
+  GDev::Font large_font( test_font_filename, 40 );
+
+  std::shared_ptr<GDev::StaticTexture> texture_e =
+    cache.getTexture( test_surface_renderer, "Start", large_font, black );
+
+  BOOST_CHECK( texture_e != texture_a );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 4u );
+
+  cache.removeFont( large_font );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 3u );
+
+  cache.resetCounters();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 0ul );
+
+  cache.clear();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0u );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the least recently used textures are evicted
+BOOST_AUTO_TEST_CASE( evict )
+{
+  GDev::TextTextureCache cache;
+
+  GDev::Font font( test_font_filename, 20 );
+
+  SDL_Color black = {0,0,0,0xFF};
+
+  std::shared_ptr<GDev::StaticTexture> texture =
+    cache.getTexture( test_surface_renderer, "Menu", font, black );
+
+  const size_t memory = cache.getMemoryUsage();
+
+  BOOST_CHECK( memory > 0 );
+
+  cache.getTexture( test_surface_renderer, "Menu", font, black, &black );
+
+  // Use the first texture so that the second becomes least recently used
+  cache.getTexture( test_surface_renderer, "Menu", font, black );
+
+  cache.setMemoryBudget( memory );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+  BOOST_CHECK( cache.getTexture( test_surface_renderer, "Menu", font, black ) ==
+	       texture );
+
+  // Textures larger than the budget are not cached
+  cache.setMemoryBudget( 0 );
+
+  cache.getTexture( test_surface_renderer, "Menu", font, black );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0u );
+}
+
+//---------------------------------------------------------------------------//
+// Check that fonts are identified by their filename and size
+BOOST_AUTO_TEST_CASE( font_identity )
+{
+  GDev::TextTextureCache cache;
+
+  SDL_Color black = {0,0,0,0xFF};
+
+  std::shared_ptr<GDev::StaticTexture> texture;
+
+  {
+    GDev::Font font( test_font_filename, 20 );
+
+    texture = cache.getTexture( test_surface_renderer, "Quit", font, black );
+
+    // A moved font keeps its textures
+    GDev::Font moved_font( std::move( font ) );
+
+    BOOST_CHECK( cache.getTexture( test_surface_renderer, 
+				   "Quit", 
+				   moved_font, 
+				   black ) == texture );
+  }
+
+  // A new font with a different size never reuses the textures of a
+  // destroyed font (even if it is created at the same address)
+  {
+    GDev::Font font( test_font_filename, 30 );
+
+    BOOST_CHECK( cache.getTexture( test_surface_renderer, 
+				   "Quit", 
+				   font, 
+				   black ) != texture );
+    BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 2u );
+  }
+
+  // A new font with the same filename and size shares the textures
+  GDev::Font font( test_font_filename, 20 );
+
+  BOOST_CHECK( cache.getTexture( test_surface_renderer, 
+				 "Quit", 
+				 font, 
+				 black ) == texture );
+
+  cache.removeFont( font );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//---------------------------------------------------------------------------//
+// end tstTextTextureCache.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,190 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstTextureAtlas.cpp
+//! \author Alex Robinson
+//! \brief  The texture atlas class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "TextureAtlas.hpp"
+#include "SpriteBatch.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+#include "Rectangle.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface
+std::shared_ptr<GDev::Surface> test_surface;
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    test_surface.reset( new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+//---------------------------------------------------------------------------//
+// Testing Functions
+//---------------------------------------------------------------------------//
+
+// Get the color of a test surface pixel (ARGB)
+Uint32 getTestSurfacePixel( const int x_position, const int y_position )
+{
+  const Uint8* pixels = (const Uint8*)test_surface->getPixels();
+
+  return *((const Uint32*)(pixels + y_position*test_surface->getPitch()) +
+	   x_position);
+}
+
+// Clear the test surface
+void clearTestSurface()
+{
+  SDL_Color black = {0,0,0,0xFF};
+  test_surface_renderer->setDrawColor( black );
+  test_surface_renderer->clear();
+}
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the atlas can be constructed
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  GDev::TextureAtlas atlas( test_surface_renderer, 256, 128 );
+
+  BOOST_CHECK_EQUAL( atlas.getPageWidth(), 256 );
+  BOOST_CHECK_EQUAL( atlas.getPageHeight(), 128 );
+  BOOST_CHECK_EQUAL( atlas.getPadding(), 1u );
+  BOOST_CHECK_EQUAL( atlas.getFormat(),
+		     test_surface_renderer->getNativeTextureFormat( true ) );
+  BOOST_CHECK_EQUAL( atlas.getNumberOfPages(), 0u );
+  BOOST_CHECK_EQUAL( atlas.getNumberOfRegions(), 0u );
+  BOOST_CHECK_EQUAL( atlas.getTotalArea(), 0ul );
+  BOOST_CHECK_EQUAL( atlas.getOccupancy(), 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that surfaces can be inserted
+BOOST_AUTO_TEST_CASE( insert )
+{
+  GDev::TextureAtlas atlas( test_surface_renderer, 64, 64 );
+
+  SDL_Color red = {0xFF,0,0,0xFF};
+  GDev::Rectangle area( 0, 0, 20, 10 );
+
+  GDev::Surface surface( area, red, red, red );
+
+  GDev::TextureRegion region_a = atlas.insert( surface );
+  GDev::TextureRegion region_b = atlas.insert( surface );
+
+  BOOST_CHECK( !region_a.isEmpty() );
+  BOOST_CHECK_EQUAL( region_a.getWidth(), 20 );
+  BOOST_CHECK_EQUAL( region_a.getHeight(), 10 );
+  BOOST_CHECK( region_a.getTexture() == region_b.getTexture() );
+  BOOST_CHECK( !SDL_HasIntersection( &region_a.getClip(),
+				     &region_b.getClip() ) );
+
+  BOOST_CHECK_EQUAL( atlas.getNumberOfPages(), 1u );
+  BOOST_CHECK_EQUAL( atlas.getNumberOfRegions(), 2u );
+  BOOST_CHECK_EQUAL( atlas.getUsedArea(), 400ul );
+  BOOST_CHECK_EQUAL( atlas.getTotalArea(), 64ul*64ul );
+  BOOST_CHECK_EQUAL( atlas.getPage( 0 )->getWidth(), 64 );
+
+  // Fill the first page
+  for( int i = 0; i < 18; ++i )
+    atlas.insert( surface );
+
+  BOOST_CHECK_EQUAL( atlas.getNumberOfPages(), 2u );
+
+  // Large surfaces get their own page
+  GDev::Rectangle large_area( 0, 0, 100, 10 );
+
+  GDev::Surface large_surface( large_area, red, red, red );
+
+  GDev::TextureRegion large_region = atlas.insert( large_surface );
+
+  BOOST_CHECK_EQUAL( atlas.getNumberOfPages(), 3u );
+  BOOST_CHECK( large_region.getTexture() == atlas.getPage( 2 ) );
+  BOOST_CHECK_EQUAL( atlas.getPage( 2 )->getWidth(), 101 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that regions can be rendered
+BOOST_AUTO_TEST_CASE( render_regions )
+{
+  GDev::TextureAtlas atlas( test_surface_renderer, 64, 64 );
+
+  SDL_Color red = {0xFF,0,0,0xFF};
+  SDL_Color blue = {0,0,0xFF,0xFF};
+  GDev::Rectangle area( 0, 0, 10, 10 );
+
+  GDev::Surface red_surface( area, red, red, red );
+  GDev::Surface blue_surface( area, blue, blue, blue );
+
+  GDev::TextureRegion red_region = atlas.insert( red_surface );
+  GDev::TextureRegion blue_region = atlas.insert( blue_surface );
+
+  clearTestSurface();
+
+  red_region.render( 0, 0 );
+
+  SDL_Rect region_clip = {0,0,5,5};
+
+  blue_region.render( 20, 0, &region_clip );
+
+  test_surface_renderer->present();
+
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 5, 5 ), 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 12, 5 ), 0xFF000000 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 22, 2 ), 0xFF0000FF );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 22, 7 ), 0xFF000000 );
+
+  // Regions in the same page are rendered in one sprite group
+  GDev::SpriteBatch batch;
+
+  batch.add( red_region, 0, 40, 0 );
+  batch.add( blue_region, 0, 60, 0 );
+  batch.add( red_region, 0, 80, 0 );
+
+  batch.render();
+
+  BOOST_CHECK_EQUAL( batch.getNumberOfSubmittedGroups(), 1u );
+
+  test_surface_renderer->present();
+
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 45, 5 ), 0xFFFF0000 );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 65, 5 ), 0xFF0000FF );
+  BOOST_CHECK_EQUAL( getTestSurfacePixel( 85, 5 ), 0xFFFF0000 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstTextureAtlas.cpp
+//---------------------------------------------------------------------------//
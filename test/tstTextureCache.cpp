@@ -0,0 +1,150 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstTextureCache.cpp
+//! \author Alex Robinson
+//! \brief  The texture cache class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <string>
+#include <memory>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "TextureCache.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+// A texture that only has a size and a format
+struct TestTexture
+{
+  TestTexture( const int width, const int height )
+    : width( width ), height( height )
+  { /* ... */ }
+
+  int getWidth() const
+  { return width; }
+
+  int getHeight() const
+  { return height; }
+
+  Uint32 getFormat() const
+  { return SDL_PIXELFORMAT_ARGB8888; }
+
+  int width;
+  int height;
+};
+
+// The test cache type
+typedef GDev::TextureCache<std::string,TestTexture> TestCache;
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that the cache can be constructed
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  TestCache cache( 1024 );
+
+  BOOST_CHECK_EQUAL( cache.getMemoryBudget(), 1024 );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0u );
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getHitRate(), 0.0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that textures can be found and the lookups are counted
+BOOST_AUTO_TEST_CASE( find_insert )
+{
+  TestCache cache( 1024 );
+
+  BOOST_CHECK( !cache.find( "a" ) );
+
+  std::shared_ptr<TestTexture> texture( new TestTexture( 4, 4 ) );
+
+  cache.insert( "a", texture );
+
+  BOOST_CHECK( cache.find( "a" ) == texture );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 64 );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 1ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 1ul );
+  BOOST_CHECK_EQUAL( cache.getHitRate(), 0.5 );
+
+  cache.resetCounters();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfHits(), 0ul );
+  BOOST_CHECK_EQUAL( cache.getNumberOfMisses(), 0ul );
+
+  // Textures larger than the budget are not cached
+  cache.insert( "b", 
+		std::shared_ptr<TestTexture>( new TestTexture( 32, 32 ) ) );
+
+  BOOST_CHECK( !cache.find( "b" ) );
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+
+  cache.clear();
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 0u );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the least recently used textures are evicted
+BOOST_AUTO_TEST_CASE( evict )
+{
+  TestCache cache( 192 );
+
+  cache.insert( "a", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+  cache.insert( "b", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+  cache.insert( "c", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+
+  // Use the first texture so that the second becomes least recently used
+  cache.find( "a" );
+
+  cache.insert( "d", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 3u );
+  BOOST_CHECK( cache.find( "a" ) );
+  BOOST_CHECK( !cache.find( "b" ) );
+  BOOST_CHECK( cache.find( "c" ) );
+  BOOST_CHECK( cache.find( "d" ) );
+
+  cache.setMemoryBudget( 64 );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+  BOOST_CHECK( cache.find( "d" ) );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 64 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that the textures with keys that satisfy a predicate can be removed
+BOOST_AUTO_TEST_CASE( removeIf )
+{
+  TestCache cache( 1024 );
+
+  cache.insert( "a1", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+  cache.insert( "a2", std::shared_ptr<TestTexture>( new TestTexture( 2, 2 ) ) );
+  cache.insert( "b1", std::shared_ptr<TestTexture>( new TestTexture( 4, 4 ) ) );
+
+  cache.removeIf( []( const std::string& key ){ return key[0] == 'a'; } );
+
+  BOOST_CHECK_EQUAL( cache.getNumberOfTextures(), 1u );
+  BOOST_CHECK_EQUAL( cache.getMemoryUsage(), 64 );
+  BOOST_CHECK( !cache.find( "a1" ) );
+  BOOST_CHECK( !cache.find( "a2" ) );
+  BOOST_CHECK( cache.find( "b1" ) );
+}
+
+//---------------------------------------------------------------------------//
+// end tstTextureCache.cpp
+//---------------------------------------------------------------------------//
@@ -0,0 +1,167 @@
+//---------------------------------------------------------------------------//
+//!
+//! \file   tstTextureRegistry.cpp
+//! \author Alex Robinson
+//! \brief  The texture registry class unit tests
+//!
+//---------------------------------------------------------------------------//
+
+// Std Lib Includes
+#include <iostream>
+#include <memory>
+#include <utility>
+
+// Boost Includes
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+// GDev Includes
+#include "TextureRegistry.hpp"
+#include "StaticTexture.hpp"
+#include "StreamingTexture.hpp"
+#include "SurfaceRenderer.hpp"
+#include "GlobalSDLSession.hpp"
+
+//---------------------------------------------------------------------------//
+// Testing Variables
+//---------------------------------------------------------------------------//
+
+// The test surface
+std::shared_ptr<GDev::Surface> test_surface;
+
+// The test surface renderer
+std::shared_ptr<GDev::Renderer> test_surface_renderer;
+
+//---------------------------------------------------------------------------//
+// Testing Structs
+//---------------------------------------------------------------------------//
+
+struct GlobalInitFixture
+{
+  GlobalInitFixture()
+    : session()
+  {
+    test_surface.reset( new GDev::Surface( 200, 100, SDL_PIXELFORMAT_ARGB8888 ) );
+    test_surface_renderer.reset( new GDev::SurfaceRenderer( test_surface ) );
+  }
+
+private:
+
+  GDev::GlobalSDLSession session;
+};
+
+BOOST_GLOBAL_FIXTURE( GlobalInitFixture );
+
+//---------------------------------------------------------------------------//
+// Tests.
+//---------------------------------------------------------------------------//
+// Check that textures can be created and found
+BOOST_AUTO_TEST_CASE( create_find )
+{
+  GDev::TextureRegistry& registry = test_surface_renderer->getTextureRegistry();
+
+  registry.clear();
+
+  BOOST_CHECK_EQUAL( registry.getNumberOfTextures(), 0 );
+  BOOST_CHECK( !registry.isValid( GDev::NULL_TEXTURE_HANDLE ) );
+  BOOST_CHECK( registry.find( GDev::NULL_TEXTURE_HANDLE ) == NULL );
+
+  GDev::Surface surface( 16, 8, SDL_PIXELFORMAT_ARGB8888 );
+
+  GDev::TextureHandle handle = registry.create( surface );
+
+  BOOST_CHECK( handle != GDev::NULL_TEXTURE_HANDLE );
+  BOOST_CHECK( registry.isValid( handle ) );
+  BOOST_CHECK_EQUAL( registry.getNumberOfTextures(), 1 );
+  BOOST_REQUIRE( registry.find( handle ) != NULL );
+  BOOST_CHECK_EQUAL( registry.get( handle ).getWidth(), 16 );
+  BOOST_CHECK_EQUAL( registry.get( handle ).getHeight(), 8 );
+  BOOST_CHECK_NO_THROW( registry.get( handle ).render( 0, 0 ) );
+}
+
+//---------------------------------------------------------------------------//
+// Check that removed textures leave stale handles
+BOOST_AUTO_TEST_CASE( remove_stale )
+{
+  GDev::TextureRegistry& registry = test_surface_renderer->getTextureRegistry();
+
+  registry.clear();
+
+  GDev::Surface surface( 16, 8, SDL_PIXELFORMAT_ARGB8888 );
+
+  GDev::TextureHandle old_handle = registry.create( surface );
+
+  registry.remove( old_handle );
+
+  BOOST_CHECK( !registry.isValid( old_handle ) );
+  BOOST_CHECK( registry.find( old_handle ) == NULL );
+  BOOST_CHECK_EQUAL( registry.getNumberOfTextures(), 0 );
+
+  // Removing a stale handle does nothing
+  BOOST_CHECK_NO_THROW( registry.remove( old_handle ) );
+
+  // The slot is reused with a new generation
+  GDev::TextureHandle new_handle = registry.create( surface );
+
+  BOOST_CHECK_EQUAL( GDev::TextureRegistry::getSlotIndex( new_handle ),
+		     GDev::TextureRegistry::getSlotIndex( old_handle ) );
+  BOOST_CHECK( GDev::TextureRegistry::getGeneration( new_handle ) !=
+	       GDev::TextureRegistry::getGeneration( old_handle ) );
+  BOOST_CHECK( registry.isValid( new_handle ) );
+  BOOST_CHECK( !registry.isValid( old_handle ) );
+
+  registry.clear();
+
+  BOOST_CHECK( !registry.isValid( new_handle ) );
+  BOOST_CHECK_EQUAL( registry.getNumberOfTextures(), 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Check that textures can be moved into the registry
+BOOST_AUTO_TEST_CASE( add_moved )
+{
+  GDev::TextureRegistry& registry = test_surface_renderer->getTextureRegistry();
+
+  registry.clear();
+
+  const long renderer_use_count = test_surface_renderer.use_count();
+
+  GDev::StaticTexture texture( test_surface_renderer,
+			       GDev::Surface( 4, 4, SDL_PIXELFORMAT_ARGB8888 ) );
+  
+  const SDL_Texture* raw_texture = texture.getRawTexturePtr();
+
+  GDev::TextureHandle static_handle = registry.add( std::move( texture ) );
+
+  BOOST_CHECK_EQUAL( registry.get( static_handle ).getRawTexturePtr(),
+		     raw_texture );
+  BOOST_CHECK_EQUAL( registry.get( static_handle ).getAccessPattern(),
+		     SDL_TEXTUREACCESS_STATIC );
+
+  GDev::TextureHandle streaming_handle = registry.add(
+		     std::unique_ptr<GDev::Texture>( 
+		       new GDev::StreamingTexture( test_surface_renderer, 8, 8 ) ) );
+
+  BOOST_CHECK_EQUAL( registry.get( streaming_handle ).getAccessPattern(),
+		     SDL_TEXTUREACCESS_STREAMING );
+  BOOST_CHECK_EQUAL( registry.getNumberOfTextures(), 2 );
+
+  // The registered textures do not keep the renderer alive
+  BOOST_CHECK_EQUAL( test_surface_renderer.use_count(), renderer_use_count );
+
+  registry.clear();
+}
+
+//---------------------------------------------------------------------------//
+// Check that the handles can address every slot
+BOOST_AUTO_TEST_CASE( getSlotIndex_getGeneration )
+{
+  BOOST_CHECK_EQUAL( GDev::TextureRegistry::getMaxNumberOfTextures(), 
+		     1u << 20 );
+  BOOST_CHECK_EQUAL( GDev::TextureRegistry::getSlotIndex( 0x00300005 ), 0x5 );
+  BOOST_CHECK_EQUAL( GDev::TextureRegistry::getGeneration( 0x00300005 ), 0x3 );
+}
+
+//---------------------------------------------------------------------------//
+// end tstTextureRegistry.cpp
+//---------------------------------------------------------------------------//
@@ -9,6 +9,7 @@
 // Std Lib Includes
 #include <iostream>
 #include <string>
+#include <utility>
 
 // Boost Includes
 #define BOOST_TEST_MAIN
@@ -50,6 +51,30 @@ BOOST_AUTO_TEST_CASE( constructor )
 						  SDL_WINDOW_OPENGL ));
 }
 
+//---------------------------------------------------------------------------//
+// Check that a window can be moved
+BOOST_AUTO_TEST_CASE( move )
+{
+  GDev::Window window( "test",
+		       SDL_WINDOWPOS_CENTERED,
+		       SDL_WINDOWPOS_CENTERED,
+		       640,
+		       480,
+		       SDL_WINDOW_OPENGL );
+
+  const Uint32 id = window.getId();
+
+  GDev::Window moved_window( std::move( window ) );
+
+  BOOST_CHECK_EQUAL( moved_window.getId(), id );
+  BOOST_CHECK( window.getRawWindowPtr() == NULL );
+
+  window = std::move( moved_window );
+
+  BOOST_CHECK_EQUAL( window.getId(), id );
+  BOOST_CHECK( moved_window.getRawWindowPtr() == NULL );
+}
+
 //---------------------------------------------------------------------------//
 // Check that the window id can be retrieved
 BOOST_AUTO_TEST_CASE( getId )